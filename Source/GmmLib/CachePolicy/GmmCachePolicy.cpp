@@ -52,7 +52,13 @@ uint8_t GMM_STDCALL GmmCachePolicyIsUsagePTECached(void *pLibContext, GMM_RESOUR
 {
     GMM_DPF_ENTER;
     GMM_LIB_CONTEXT *pGmmLibContext = (GMM_LIB_CONTEXT *)pLibContext;
-    return pGmmLibContext->GetCachePolicyObj()->CachePolicyIsUsagePTECached(Usage);
+    uint8_t          Cached         = pGmmLibContext->GetCachePolicyObj()->CachePolicyIsUsagePTECached(Usage);
+
+    if(pGmmLibContext->IsCachePolicyStatsEnabled())
+    {
+        pGmmLibContext->CountPteQuery(Usage, Cached);
+    }
+    return Cached;
 }
 /////////////////////////////////////////////////////////////////////////////////////
 /// C Wrapper function to return L1 Cache Control on DG2 for a given resource type
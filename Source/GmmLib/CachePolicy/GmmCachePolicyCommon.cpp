@@ -93,8 +93,10 @@ MEMORY_OBJECT_CONTROL_STATE GMM_STDCALL GmmLib::GmmCachePolicyCommon::CachePolic
 MEMORY_OBJECT_CONTROL_STATE GMM_STDCALL GmmLib::GmmCachePolicyCommon::CachePolicyGetMemoryObject(GMM_RESOURCE_INFO *pResInfo, GMM_RESOURCE_USAGE_TYPE Usage)
 {
     const GMM_CACHE_POLICY_ELEMENT *CachePolicy = NULL;
+    const GMM_CACHE_POLICY_LOOKUP * pLookup     = NULL;
     __GMM_ASSERT(pGmmLibContext->GetCachePolicyElement(Usage).Initialized);
     CachePolicy = pGmmLibContext->GetCachePolicyUsage();
+    pLookup     = pGmmLibContext->GetCachePolicyLookup();
     // Prevent wrong Usage for XAdapter resources. UMD does not call GetMemoryObject on shader resources but,
     // when they add it someone could call it without knowing the restriction.
     if(pResInfo &&
@@ -104,14 +106,25 @@ MEMORY_OBJECT_CONTROL_STATE GMM_STDCALL GmmLib::GmmCachePolicyCommon::CachePolic
         __GMM_ASSERT(false);
     }
 
+    // The lookup table is built right after the cache policy, calls made while
+    // the cache policy is initialized, or counted, take the long way below
+    if(pLookup && !pGmmLibContext->IsCachePolicyStatsEnabled())
+    {
+        return GmmCachePolicyLookupMemoryObject(pLookup,
+                                                pResInfo ? pResInfo->GetCachePolicyUsage() : GMM_CACHE_POLICY_LOOKUP_NO_RESOURCE,
+                                                Usage);
+    }
+
     if(!pResInfo ||
        (CachePolicy[Usage].Override & CachePolicy[pResInfo->GetCachePolicyUsage()].IDCode) ||
        (CachePolicy[Usage].Override == ALWAYS_OVERRIDE))
     {
+        pGmmLibContext->CountMocsQuery(Usage, CachePolicy[Usage].MemoryObjectOverride, 1);
         return CachePolicy[Usage].MemoryObjectOverride;
     }
     else
     {
+        pGmmLibContext->CountMocsQuery(Usage, CachePolicy[Usage].MemoryObjectNoOverride, 0);
         return CachePolicy[Usage].MemoryObjectNoOverride;
     }
 
@@ -128,5 +141,288 @@ MEMORY_OBJECT_CONTROL_STATE GMM_STDCALL GmmLib::GmmCachePolicyCommon::CachePolic
 GMM_PTE_CACHE_CONTROL_BITS GMM_STDCALL GmmLib::GmmCachePolicyCommon::CachePolicyGetPteType(GMM_RESOURCE_USAGE_TYPE Usage)
 {
     __GMM_ASSERT(pGmmLibContext->GetCachePolicyElement(Usage).Initialized);
+    if(pGmmLibContext->IsCachePolicyStatsEnabled())
+    {
+        pGmmLibContext->CountPteQuery(Usage, CachePolicyIsUsagePTECached(Usage));
+    }
     return pGmmLibContext->GetCachePolicyElement(Usage).PTE;
 }
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Precomputes the MOCS and PTE of every usage for the branchless lookups in
+/// GmmCachePolicy.h. Called once the cache policy is initialized.
+///
+/// The override decision of CachePolicyGetMemoryObject() is folded into the masks:
+/// ALWAYS_OVERRIDE usages match every resource through ANY_RESOURCE, and the
+/// "no resource" entry matches every usage through NULL_RESOURCE.
+///
+/// @param[out]    pLookup: Table of GMM_CACHE_POLICY_LOOKUP_ENTRIES entries
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::GmmCachePolicyCommon::InitCachePolicyLookup(GMM_CACHE_POLICY_LOOKUP *pLookup)
+{
+    __GMM_ASSERTPTR(pLookup, VOIDRETURN);
+
+    for(uint32_t Usage = 0; Usage < GMM_RESOURCE_USAGE_MAX; Usage++)
+    {
+        pLookup[Usage].MemoryObject[0] = pCachePolicy[Usage].MemoryObjectNoOverride;
+        pLookup[Usage].MemoryObject[1] = pCachePolicy[Usage].MemoryObjectOverride;
+        pLookup[Usage].PTE             = pCachePolicy[Usage].PTE;
+        pLookup[Usage].OverrideMask    = pCachePolicy[Usage].Override | GMM_CACHE_POLICY_LOOKUP_NULL_RESOURCE;
+        pLookup[Usage].IDCode          = pCachePolicy[Usage].IDCode | GMM_CACHE_POLICY_LOOKUP_ANY_RESOURCE;
+
+        if(pCachePolicy[Usage].Override == ALWAYS_OVERRIDE)
+        {
+            pLookup[Usage].OverrideMask |= GMM_CACHE_POLICY_LOOKUP_ANY_RESOURCE;
+        }
+    }
+
+    pLookup[GMM_CACHE_POLICY_LOOKUP_NO_RESOURCE].MemoryObject[0] = pCachePolicy[GMM_RESOURCE_USAGE_UNKNOWN].MemoryObjectOverride;
+    pLookup[GMM_CACHE_POLICY_LOOKUP_NO_RESOURCE].MemoryObject[1] = pCachePolicy[GMM_RESOURCE_USAGE_UNKNOWN].MemoryObjectOverride;
+    pLookup[GMM_CACHE_POLICY_LOOKUP_NO_RESOURCE].PTE             = pCachePolicy[GMM_RESOURCE_USAGE_UNKNOWN].PTE;
+    pLookup[GMM_CACHE_POLICY_LOOKUP_NO_RESOURCE].OverrideMask    = GMM_CACHE_POLICY_LOOKUP_NULL_RESOURCE;
+    pLookup[GMM_CACHE_POLICY_LOOKUP_NO_RESOURCE].IDCode          = GMM_CACHE_POLICY_LOOKUP_NULL_RESOURCE;
+}
+
+#define GMM_CACHE_POLICY_USAGE_PREFIX "GMM_RESOURCE_USAGE_"
+
+// Usage names, indexed by GMM_RESOURCE_USAGE_TYPE
+static const char *const GmmCachePolicyUsageNames[GMM_RESOURCE_USAGE_MAX] =
+{
+    GMM_CACHE_POLICY_USAGE_PREFIX "UNKNOWN",
+#define DEFINE_RESOURCE_USAGE(Usage) #Usage,
+#include "GmmCachePolicyResourceUsageDefinitions.h"
+#undef DEFINE_RESOURCE_USAGE
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns the name of a usage, without its GMM_RESOURCE_USAGE_ prefix.
+/// @param[in]     Usage: Usage type
+/// @return        Name, "?" for invalid usages
+/////////////////////////////////////////////////////////////////////////////////////
+const char *GMM_STDCALL GmmLib::GmmCachePolicyCommon::GetUsageName(GMM_RESOURCE_USAGE_TYPE Usage)
+{
+    if((uint32_t)Usage >= GMM_RESOURCE_USAGE_MAX)
+    {
+        return "?";
+    }
+
+    return GmmCachePolicyUsageNames[Usage] + sizeof(GMM_CACHE_POLICY_USAGE_PREFIX) - 1;
+}
+
+#ifdef GMM_CACHE_POLICY_FILE_OVERRIDE_SUPPORTED
+// Overridable fields, named as the registry override keys
+static const struct
+{
+    const char *Name;
+    uint32_t    Field; // GMM_CACHE_POLICY_FIELD
+    uint32_t    Max;
+} GmmCachePolicyOverrideFields[] =
+{
+    {"LLC",        GMM_CACHE_POLICY_FIELD_LLC,         1},
+    {"ELLC",       GMM_CACHE_POLICY_FIELD_ELLC,        1},
+    {"L3",         GMM_CACHE_POLICY_FIELD_L3,          1},
+    {"WT",         GMM_CACHE_POLICY_FIELD_WT,          1},
+    {"Age",        GMM_CACHE_POLICY_FIELD_AGE,         3},
+    {"AOM",        GMM_CACHE_POLICY_FIELD_AOM,         1},
+    {"LeCC_SCC",   GMM_CACHE_POLICY_FIELD_LECC_SCC,    7},
+    {"L3_SCC",     GMM_CACHE_POLICY_FIELD_L3_SCC,      7},
+    {"SCF",        GMM_CACHE_POLICY_FIELD_SCF,         1},
+    {"SSO",        GMM_CACHE_POLICY_FIELD_SSO,         3},
+    {"CoS",        GMM_CACHE_POLICY_FIELD_COS,         3},
+    {"HDCL1",      GMM_CACHE_POLICY_FIELD_HDCL1,       1},
+    {"L3Eviction", GMM_CACHE_POLICY_FIELD_L3_EVICTION, 3},
+    {"GlbGo",      GMM_CACHE_POLICY_FIELD_GLB_GO,      1},
+    {"UcLookup",   GMM_CACHE_POLICY_FIELD_UC_LOOKUP,   1},
+    {"L1CC",       GMM_CACHE_POLICY_FIELD_L1CC,        7},
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Sets one field of a cache policy element.
+/// @param[in]  Element: Element to update
+/// @param[in]  Field: GMM_CACHE_POLICY_FIELD to set
+/// @param[in]  Value: Value, already range checked
+/////////////////////////////////////////////////////////////////////////////////////
+static void GmmCachePolicySetField(GMM_CACHE_POLICY_ELEMENT &Element, uint32_t Field, uint32_t Value)
+{
+    switch(Field)
+    {
+        case GMM_CACHE_POLICY_FIELD_LLC:         Element.LLC        = Value; break;
+        case GMM_CACHE_POLICY_FIELD_ELLC:        Element.ELLC       = Value; break;
+        case GMM_CACHE_POLICY_FIELD_L3:          Element.L3         = Value; break;
+        case GMM_CACHE_POLICY_FIELD_WT:          Element.WT         = Value; break;
+        case GMM_CACHE_POLICY_FIELD_AGE:         Element.AGE        = Value; break;
+        case GMM_CACHE_POLICY_FIELD_AOM:         Element.AOM        = Value; break;
+        case GMM_CACHE_POLICY_FIELD_LECC_SCC:    Element.LeCC_SCC   = Value; break;
+        case GMM_CACHE_POLICY_FIELD_L3_SCC:      Element.L3_SCC     = Value; break;
+        case GMM_CACHE_POLICY_FIELD_SCF:         Element.SCF        = Value; break;
+        case GMM_CACHE_POLICY_FIELD_SSO:         Element.SSO        = Value; break;
+        case GMM_CACHE_POLICY_FIELD_COS:         Element.CoS        = Value; break;
+        case GMM_CACHE_POLICY_FIELD_HDCL1:       Element.HDCL1      = Value; break;
+        case GMM_CACHE_POLICY_FIELD_L3_EVICTION: Element.L3Eviction = Value; break;
+        case GMM_CACHE_POLICY_FIELD_GLB_GO:      Element.GlbGo      = Value; break;
+        case GMM_CACHE_POLICY_FIELD_UC_LOOKUP:   Element.UcLookup   = Value; break;
+        case GMM_CACHE_POLICY_FIELD_L1CC:        Element.L1CC       = Value; break;
+        default:                                 __GMM_ASSERT(0);              break;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Applies one line of a cache policy override file, see
+/// GmmCachePolicyCommon::OverrideCachePolicyFromFile(). Nothing is applied
+/// unless the whole line is valid.
+/// @param[in]  pLine: Line, modified by the parsing
+/// @param[in]  Fields: GMM_CACHE_POLICY_FIELD bits the generation defines
+/// @param[in]  pCachePolicy: Cache policy table to update
+/// @return     NULL on success or for blank lines, otherwise the reason the
+///             line was rejected
+/////////////////////////////////////////////////////////////////////////////////////
+static const char *GmmCachePolicyOverrideLine(char *pLine, uint32_t Fields, GMM_CACHE_POLICY_ELEMENT *pCachePolicy)
+{
+    const size_t             PrefixLen = sizeof(GMM_CACHE_POLICY_USAGE_PREFIX) - 1;
+    GMM_CACHE_POLICY_ELEMENT Element;
+    char *                   pSave    = NULL;
+    char *                   pToken   = NULL;
+    char *                   pComment = strchr(pLine, '#');
+    uint32_t                 Usage    = 0;
+
+    if(pComment)
+    {
+        *pComment = '\0';
+    }
+
+    pToken = strtok_r(pLine, " \t\r\n", &pSave);
+    if(pToken == NULL)
+    {
+        return NULL;
+    }
+
+    for(; Usage < GMM_RESOURCE_USAGE_MAX; Usage++)
+    {
+        if(!strcmp(pToken, GmmCachePolicyUsageNames[Usage]) ||
+           !strcmp(pToken, GmmCachePolicyUsageNames[Usage] + PrefixLen))
+        {
+            break;
+        }
+    }
+    if(Usage == GMM_RESOURCE_USAGE_MAX)
+    {
+        return "unknown usage";
+    }
+    if(!pCachePolicy[Usage].Initialized)
+    {
+        return "usage not defined for this platform";
+    }
+
+    Element = pCachePolicy[Usage];
+
+    while((pToken = strtok_r(NULL, " \t\r\n", &pSave)) != NULL)
+    {
+        char *        pValue = strchr(pToken, '=');
+        char *        pEnd   = NULL;
+        unsigned long Value  = 0;
+        uint32_t      i      = 0;
+
+        if(pValue == NULL)
+        {
+            return "expected <field>=<value>";
+        }
+        *pValue++ = '\0';
+
+        for(; i < sizeof(GmmCachePolicyOverrideFields) / sizeof(GmmCachePolicyOverrideFields[0]); i++)
+        {
+            if(!strcmp(pToken, GmmCachePolicyOverrideFields[i].Name))
+            {
+                break;
+            }
+        }
+        if(i == sizeof(GmmCachePolicyOverrideFields) / sizeof(GmmCachePolicyOverrideFields[0]))
+        {
+            return "unknown field";
+        }
+        if(!(Fields & GmmCachePolicyOverrideFields[i].Field))
+        {
+            return "field not defined for this platform";
+        }
+
+        Value = strtoul(pValue, &pEnd, 0);
+        if(pEnd == pValue || *pEnd != '\0' || Value > GmmCachePolicyOverrideFields[i].Max)
+        {
+            return "invalid value";
+        }
+
+        GmmCachePolicySetField(Element, GmmCachePolicyOverrideFields[i].Field, (uint32_t)Value);
+    }
+
+    Element.IsOverridenByRegkey = 1;
+    pCachePolicy[Usage]         = Element;
+
+    return NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Applies the per-usage overrides of the file named by GMM_CACHE_POLICY_OVERRIDE_FILE,
+/// the Linux counterpart of the registry overrides. Called by InitCachePolicy()
+/// once the usages are defined, before the MOCS and PAT indexes are selected
+/// from them.
+///
+/// One usage per line, '#' starts a comment:
+///     <usage> <field>=<value> [<field>=<value> ...]
+/// <usage> is a GMM_RESOURCE_USAGE_TYPE name, with or without its
+/// GMM_RESOURCE_USAGE_ prefix. <field> is a registry override name (LLC, ELLC,
+/// L3, Age, ...) and must be one the platform defines its cache policy with.
+/// Invalid lines are logged and skipped, and the error is returned through
+/// InitCachePolicy() so context creation fails.
+///
+/// @param[in]  Fields: GMM_CACHE_POLICY_FIELD bits the generation defines
+/// @return     GMM_SUCCESS if there is no file or all of it was applied
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_STATUS GmmLib::GmmCachePolicyCommon::OverrideCachePolicyFromFile(uint32_t Fields)
+{
+    const char *pPath = getenv(GMM_CACHE_POLICY_OVERRIDE_FILE_ENV);
+    char        Line[GMM_CACHE_POLICY_OVERRIDE_MAX_LINE];
+    uint32_t    LineNum     = 0;
+    uint32_t    NumRejected = 0;
+    FILE *      pFile       = NULL;
+
+    if(!pPath || !*pPath)
+    {
+        return GMM_SUCCESS;
+    }
+
+    pFile = fopen(pPath, "r");
+    if(pFile == NULL)
+    {
+        GMM_DPF(GFXDBG_CRITICAL, "Cache policy override file %s cannot be opened\n", pPath);
+        return GMM_ERROR;
+    }
+
+    while(fgets(Line, sizeof(Line), pFile))
+    {
+        const char *pError = NULL;
+
+        LineNum++;
+
+        if(!strchr(Line, '\n') && !feof(pFile))
+        {
+            int c;
+            while((c = fgetc(pFile)) != EOF && c != '\n')
+                ;
+            pError = "line too long";
+        }
+        else
+        {
+            pError = GmmCachePolicyOverrideLine(Line, Fields, pCachePolicy);
+        }
+
+        if(pError)
+        {
+            GMM_DPF(GFXDBG_CRITICAL, "Cache policy override file %s:%u rejected: %s\n", pPath, LineNum, pError);
+            NumRejected++;
+        }
+    }
+
+    fclose(pFile);
+
+    return NumRejected ? GMM_ERROR : GMM_SUCCESS;
+}
+#endif
@@ -29,9 +29,9 @@ OTHER DEALINGS IN THE SOFTWARE.
 #define WA(WaXxx)   (pGmmLibContext->GetWaTable().WaXxx != 0)
 
 // Underscored to prevent name collision with the GMM_CACHE_POLICY_ELEMENT fields named L3 and LLC
-#define _L3           (pGmmLibContext->GetGtSysInfo()->L3CacheSizeInKb)
-#define _LLC          (pGmmLibContext->GetGtSysInfo()->LLCCacheSizeInKb)
-#define _ELLC         (pGmmLibContext->GetGtSysInfo()->EdramSizeInKb)
+#define _L3           (pGmmLibContext->GetGtSysInfoPtr()->L3CacheSizeInKb)
+#define _LLC          (pGmmLibContext->GetGtSysInfoPtr()->LLCCacheSizeInKb)
+#define _ELLC         (pGmmLibContext->GetGtSysInfoPtr()->EdramSizeInKb)
 #define CAM$          (SKU(FtrCameraCaptureCaching))
 
 // Units are already in KB in the system information, so these helper macros need to account for that
@@ -37,6 +37,7 @@ OTHER DEALINGS IN THE SOFTWARE.
 //-----------------------------------------------------------------------------
 GMM_STATUS GmmLib::GmmGen10CachePolicy::InitCachePolicy()
 {
+    GMM_STATUS Status = GMM_SUCCESS;
 
     __GMM_ASSERTPTR(pCachePolicy, GMM_ERROR);
 
@@ -85,6 +86,19 @@ GMM_STATUS GmmLib::GmmGen10CachePolicy::InitCachePolicy()
             Entry0->HDCL1                        = 0;
         }
 
+#ifdef GMM_CACHE_POLICY_FILE_OVERRIDE_SUPPORTED
+        Status = OverrideCachePolicyFromFile(GMM_CACHE_POLICY_FIELD_LLC |
+                                             GMM_CACHE_POLICY_FIELD_ELLC |
+                                             GMM_CACHE_POLICY_FIELD_L3 |
+                                             GMM_CACHE_POLICY_FIELD_WT |
+                                             GMM_CACHE_POLICY_FIELD_AGE |
+                                             GMM_CACHE_POLICY_FIELD_LECC_SCC |
+                                             GMM_CACHE_POLICY_FIELD_L3_SCC |
+                                             GMM_CACHE_POLICY_FIELD_SSO |
+                                             GMM_CACHE_POLICY_FIELD_COS |
+                                             GMM_CACHE_POLICY_FIELD_HDCL1);
+#endif
+
         // Process the cache policy and fill in the look up table
         for(; Usage < GMM_RESOURCE_USAGE_MAX; Usage++)
         {
@@ -240,7 +254,7 @@ GMM_STATUS GmmLib::GmmGen10CachePolicy::InitCachePolicy()
         CurrentMaxL1HdcMocsIndex = CurrentMaxHDCL1Index;
     }
 
-    return GMM_SUCCESS;
+    return Status;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -257,7 +271,10 @@ GMM_STATUS GmmLib::GmmGen10CachePolicy::SetPATInitWA()
 #if(defined(__GMM_KMD__))
     if(pGmmLibContext->GetGtSysInfoPtr()->EdramSizeInKb)
     {
-        const_cast<WA_TABLE &>(pGmmLibContext->GetWaTable()).WaNoMocsEllcOnly = 1;
+        WA_TABLE *pWaTable = pGmmLibContext->GetWaTableForUpdate();
+        __GMM_ASSERTPTR(pWaTable, GMM_ERROR);
+
+        pWaTable->WaNoMocsEllcOnly = 1;
     }
 #else
     Status = GMM_ERROR;
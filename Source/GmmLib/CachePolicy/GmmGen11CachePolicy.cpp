@@ -76,6 +76,8 @@ int32_t GmmLib::GmmGen11CachePolicy::IsSpecialMOCSUsage(GMM_RESOURCE_USAGE_TYPE
 //-----------------------------------------------------------------------------
 GMM_STATUS GmmLib::GmmGen11CachePolicy::InitCachePolicy()
 {
+    GMM_STATUS Status = GMM_SUCCESS;
+
     GMM_DPF_ENTER;
     __GMM_ASSERTPTR(pCachePolicy, GMM_ERROR);
 
@@ -115,6 +117,20 @@ GMM_STATUS GmmLib::GmmGen11CachePolicy::InitCachePolicy()
         OverrideCachePolicy();
 #endif
 
+#ifdef GMM_CACHE_POLICY_FILE_OVERRIDE_SUPPORTED
+        Status = OverrideCachePolicyFromFile(GMM_CACHE_POLICY_FIELD_LLC |
+                                             GMM_CACHE_POLICY_FIELD_ELLC |
+                                             GMM_CACHE_POLICY_FIELD_L3 |
+                                             GMM_CACHE_POLICY_FIELD_WT |
+                                             GMM_CACHE_POLICY_FIELD_AGE |
+                                             GMM_CACHE_POLICY_FIELD_AOM |
+                                             GMM_CACHE_POLICY_FIELD_LECC_SCC |
+                                             GMM_CACHE_POLICY_FIELD_L3_SCC |
+                                             GMM_CACHE_POLICY_FIELD_SCF |
+                                             GMM_CACHE_POLICY_FIELD_SSO |
+                                             GMM_CACHE_POLICY_FIELD_COS);
+#endif
+
         // Process the cache policy and fill in the look up table
         for(; Usage < GMM_RESOURCE_USAGE_MAX; Usage++)
         {
@@ -280,7 +296,7 @@ GMM_STATUS GmmLib::GmmGen11CachePolicy::InitCachePolicy()
         CurrentMaxSpecialMocsIndex = CurrentMaxSpecialIndex;
     }
 
-    return GMM_SUCCESS;
+    return Status;
 }
 
 //=============================================================================
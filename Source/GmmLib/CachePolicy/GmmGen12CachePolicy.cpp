@@ -123,6 +123,7 @@ int32_t GmmLib::GmmGen12CachePolicy::IsSpecialMOCSUsage(GMM_RESOURCE_USAGE_TYPE
 //-----------------------------------------------------------------------------
 GMM_STATUS GmmLib::GmmGen12CachePolicy::InitCachePolicy()
 {
+    GMM_STATUS Status = GMM_SUCCESS;
 
     __GMM_ASSERTPTR(pCachePolicy, GMM_ERROR);
 
@@ -163,6 +164,22 @@ GMM_STATUS GmmLib::GmmGen12CachePolicy::InitCachePolicy()
 
         OverrideCachePolicy(pKmdGmmContext);
 #endif
+#ifdef GMM_CACHE_POLICY_FILE_OVERRIDE_SUPPORTED
+        Status = OverrideCachePolicyFromFile(GMM_CACHE_POLICY_FIELD_LLC |
+                                             GMM_CACHE_POLICY_FIELD_ELLC |
+                                             GMM_CACHE_POLICY_FIELD_L3 |
+                                             GMM_CACHE_POLICY_FIELD_WT |
+                                             GMM_CACHE_POLICY_FIELD_AGE |
+                                             GMM_CACHE_POLICY_FIELD_AOM |
+                                             GMM_CACHE_POLICY_FIELD_LECC_SCC |
+                                             GMM_CACHE_POLICY_FIELD_L3_SCC |
+                                             GMM_CACHE_POLICY_FIELD_SCF |
+                                             GMM_CACHE_POLICY_FIELD_SSO |
+                                             GMM_CACHE_POLICY_FIELD_COS |
+                                             GMM_CACHE_POLICY_FIELD_HDCL1 |
+                                             GMM_CACHE_POLICY_FIELD_L3_EVICTION);
+#endif
+
         // Process the cache policy and fill in the look up table
         for(; Usage < GMM_RESOURCE_USAGE_MAX; Usage++)
         {
@@ -369,7 +386,7 @@ GMM_STATUS GmmLib::GmmGen12CachePolicy::InitCachePolicy()
         }
     }
 
-    return GMM_SUCCESS;
+    return Status;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -413,7 +430,7 @@ uint32_t GmmLib::GmmGen12CachePolicy::BestMatchingPATIdx(GMM_CACHE_POLICY_ELEMEN
     uint32_t            i;
     uint32_t            PATIdx           = 0;
     GMM_GFX_MEMORY_TYPE WantedMemoryType = GMM_GFX_UC_WITH_FENCE, MemoryType;
-    WA_TABLE *          pWaTable         = &const_cast<WA_TABLE &>(pGmmLibContext->GetWaTable());
+    const WA_TABLE *    pWaTable         = &pGmmLibContext->GetWaTable();
 
     WantedMemoryType = GetWantedMemoryType(CachePolicy);
 
@@ -457,10 +474,12 @@ uint32_t GmmLib::GmmGen12CachePolicy::BestMatchingPATIdx(GMM_CACHE_POLICY_ELEMEN
 /////////////////////////////////////////////////////////////////////////////////////
 GMM_STATUS GmmLib::GmmGen12CachePolicy::SetPATInitWA()
 {
-    GMM_STATUS Status   = GMM_SUCCESS;
-    WA_TABLE * pWaTable = &const_cast<WA_TABLE &>(pGmmLibContext->GetWaTable());
+    GMM_STATUS Status = GMM_SUCCESS;
 
 #if(defined(__GMM_KMD__))
+    WA_TABLE *pWaTable = pGmmLibContext->GetWaTableForUpdate();
+    __GMM_ASSERTPTR(pWaTable, GMM_ERROR);
+
     __GMM_ASSERT(pGmmLibContext->GetSkuTable().FtrMemTypeMocsDeferPAT == 0x0); //MOCS.TargetCache supports eLLC only, PAT.TC -> reserved bits.
     pWaTable->WaGttPat0WB = 0;                                                 //Override PAT #0
 #else
@@ -86,6 +86,7 @@ int32_t GmmLib::GmmGen12dGPUCachePolicy::IsSpecialMOCSUsage(GMM_RESOURCE_USAGE_T
 //-----------------------------------------------------------------------------
 GMM_STATUS GmmLib::GmmGen12dGPUCachePolicy::InitCachePolicy()
 {
+    GMM_STATUS Status = GMM_SUCCESS;
 
     __GMM_ASSERTPTR(pCachePolicy, GMM_ERROR);
 
@@ -116,6 +117,15 @@ GMM_STATUS GmmLib::GmmGen12dGPUCachePolicy::InitCachePolicy()
 	OverrideCachePolicy(pKmdGmmContext);
 #endif
 
+#ifdef GMM_CACHE_POLICY_FILE_OVERRIDE_SUPPORTED
+        Status = OverrideCachePolicyFromFile(GMM_CACHE_POLICY_FIELD_L3 |
+                                             GMM_CACHE_POLICY_FIELD_L3_SCC |
+                                             GMM_CACHE_POLICY_FIELD_HDCL1 |
+                                             GMM_CACHE_POLICY_FIELD_GLB_GO |
+                                             GMM_CACHE_POLICY_FIELD_UC_LOOKUP |
+                                             GMM_CACHE_POLICY_FIELD_L1CC);
+#endif
+
         // Process the cache policy and fill in the look up table
         for(; Usage < GMM_RESOURCE_USAGE_MAX; Usage++)
         {
@@ -281,7 +291,7 @@ GMM_STATUS GmmLib::GmmGen12dGPUCachePolicy::InitCachePolicy()
         }
     }
 
-    return GMM_SUCCESS;
+    return Status;
 }
 
 #pragma optimize("", on)
@@ -36,6 +36,7 @@ OTHER DEALINGS IN THE SOFTWARE.
 //-----------------------------------------------------------------------------
 GMM_STATUS GmmLib::GmmGen8CachePolicy::InitCachePolicy()
 {
+    GMM_STATUS Status = GMM_SUCCESS;
 
     __GMM_ASSERTPTR(pCachePolicy, GMM_ERROR);
 
@@ -57,6 +58,14 @@ GMM_STATUS GmmLib::GmmGen8CachePolicy::InitCachePolicy()
         // Define index of cache element
         uint32_t Usage = 0;
 
+#ifdef GMM_CACHE_POLICY_FILE_OVERRIDE_SUPPORTED
+        Status = OverrideCachePolicyFromFile(GMM_CACHE_POLICY_FIELD_LLC |
+                                             GMM_CACHE_POLICY_FIELD_ELLC |
+                                             GMM_CACHE_POLICY_FIELD_L3 |
+                                             GMM_CACHE_POLICY_FIELD_WT |
+                                             GMM_CACHE_POLICY_FIELD_AGE);
+#endif
+
         // Process Cache Policy and fill in look up table
         for(; Usage < GMM_RESOURCE_USAGE_MAX; Usage++)
         {
@@ -100,7 +109,7 @@ GMM_STATUS GmmLib::GmmGen8CachePolicy::InitCachePolicy()
         }
     }
 
-    return GMM_SUCCESS;
+    return Status;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -282,10 +291,11 @@ GMM_STATUS GmmLib::GmmGen8CachePolicy::SetupPAT()
 /////////////////////////////////////////////////////////////////////////////////////
 GMM_STATUS GmmLib::GmmGen8CachePolicy::SetPATInitWA()
 {
-    GMM_STATUS Status   = GMM_SUCCESS;
-    WA_TABLE * pWaTable = &const_cast<WA_TABLE &>(pGmmLibContext->GetWaTable());
+    GMM_STATUS Status = GMM_SUCCESS;
 
 #if(defined(__GMM_KMD__))
+    WA_TABLE *pWaTable = pGmmLibContext->GetWaTableForUpdate();
+    __GMM_ASSERTPTR(pWaTable, GMM_ERROR);
 
     pWaTable->WaGttPat0                         = 1;
     pWaTable->WaGttPat0WB                       = 1;
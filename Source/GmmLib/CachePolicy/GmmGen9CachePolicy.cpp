@@ -37,6 +37,8 @@ OTHER DEALINGS IN THE SOFTWARE.
 //-----------------------------------------------------------------------------
 GMM_STATUS GmmLib::GmmGen9CachePolicy::InitCachePolicy()
 {
+    GMM_STATUS Status = GMM_SUCCESS;
+
     __GMM_ASSERTPTR(pCachePolicy, GMM_ERROR);
 
 #if defined(GMM_DYNAMIC_MOCS_TABLE)
@@ -82,7 +84,7 @@ GMM_STATUS GmmLib::GmmGen9CachePolicy::InitCachePolicy()
         uint32_t                      CurrentMaxIndex        = 0;
         GMM_CACHE_POLICY_TBL_ELEMENT *pCachePolicyTblElement = pGmmLibContext->GetCachePolicyTlbElement();
 
-        bool LLC = (pGmmLibContext->GetGtSysInfo()->LLCCacheSizeInKb > 0); // aka "Core -vs- Atom".
+        bool LLC = (pGmmLibContext->GetGtSysInfoPtr()->LLCCacheSizeInKb > 0); // aka "Core -vs- Atom".
 
 #if defined(_WIN32)
         {
@@ -114,6 +116,13 @@ GMM_STATUS GmmLib::GmmGen9CachePolicy::InitCachePolicy()
         }
 #endif
 
+#ifdef GMM_CACHE_POLICY_FILE_OVERRIDE_SUPPORTED
+        Status = OverrideCachePolicyFromFile(GMM_CACHE_POLICY_FIELD_LLC |
+                                             GMM_CACHE_POLICY_FIELD_ELLC |
+                                             GMM_CACHE_POLICY_FIELD_L3 |
+                                             GMM_CACHE_POLICY_FIELD_AGE);
+#endif
+
         // Process the cache policy and fill in the look up table
         for(uint32_t Usage = 0; Usage < GMM_RESOURCE_USAGE_MAX; Usage++)
         {
@@ -240,7 +249,7 @@ GMM_STATUS GmmLib::GmmGen9CachePolicy::InitCachePolicy()
         CurrentMaxL1HdcMocsIndex = 0;
     }
 
-    return GMM_SUCCESS;
+    return Status;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -22,6 +22,7 @@ OTHER DEALINGS IN THE SOFTWARE.
 
 #include "Internal/Common/GmmLibInc.h"
 #include "External/Common/GmmClientContext.h"
+#include "Internal/Common/GmmLayoutCache.h"
 
 #if !__GMM_KMD__ && LHDM
 #include "..\..\inc\common\gfxEscape.h"
@@ -101,7 +102,13 @@ MEMORY_OBJECT_CONTROL_STATE GMM_STDCALL GmmLib::GmmClientContext::CachePolicyGet
 /////////////////////////////////////////////////////////////////////////////////////
 uint8_t GMM_STDCALL GmmLib::GmmClientContext::CachePolicyIsUsagePTECached(GMM_RESOURCE_USAGE_TYPE Usage)
 {
-    return pGmmLibContext->GetCachePolicyObj()->CachePolicyIsUsagePTECached(Usage);
+    uint8_t Cached = pGmmLibContext->GetCachePolicyObj()->CachePolicyIsUsagePTECached(Usage);
+
+    if(pGmmLibContext->IsCachePolicyStatsEnabled())
+    {
+        pGmmLibContext->CountPteQuery(Usage, Cached);
+    }
+    return Cached;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -270,9 +277,7 @@ uint8_t GMM_STDCALL GmmLib::GmmClientContext::IsUVPacked(GMM_RESOURCE_FORMAT For
 /////////////////////////////////////////////////////////////////////////////////////
 uint8_t GMM_STDCALL GmmLib::GmmClientContext::IsCompressed(GMM_RESOURCE_FORMAT Format)
 {
-    return (Format > GMM_FORMAT_INVALID) &&
-           (Format < GMM_RESOURCE_FORMATS) &&
-           pGmmLibContext->GetPlatformInfo().FormatTable[Format].Compressed;
+    return GMM_FORMAT_HAS_CLASS(Format, GMM_FORMAT_CLASS_BLOCK_COMPRESSED);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -297,7 +302,7 @@ GMM_SURFACESTATE_FORMAT GMM_STDCALL GmmLib::GmmClientContext::GetSurfaceStateFor
     // ToDo: Remove the definition of GmmGetSurfaceStateFormat(Format)
     return ((Format > GMM_FORMAT_INVALID) &&
             (Format < GMM_RESOURCE_FORMATS)) ?
-           pGmmLibContext->GetPlatformInfo().FormatTable[Format].SurfaceStateFormat :
+           __GmmFormatTraits.SurfaceStateFormat[Format] :
            GMM_SURFACESTATE_FORMAT_INVALID;
 }
 
@@ -425,6 +430,75 @@ ERROR_CASE:
 }
 #endif
 
+/////////////////////////////////////////////////////////////////////////////////////
+/// Runs GmmResourceInfoCommon::Create() on a constructed ResourceInfo Object, taking
+/// the layout from the Context's persistent layout cache when it has one.
+///
+/// @param[in]      GmmLibContext: Context to create the resource in
+/// @param[in]      pClientContext: ClientContext the ResourceInfo Object belongs to
+/// @param[in]      pRes: constructed ResourceInfo Object
+/// @param[in/out]  CreateParams: Flags which specify what sort of resource to create
+/// @return         ::GMM_STATUS
+/////////////////////////////////////////////////////////////////////////////////////
+static GMM_STATUS GmmCreateResLayout(GmmLib::Context &           GmmLibContext,
+                                     GmmLib::GmmClientContext *  pClientContext,
+                                     GMM_RESOURCE_INFO *         pRes,
+                                     GMM_RESCREATE_PARAMS &      CreateParams)
+{
+#ifdef GMM_LAYOUT_CACHE_SUPPORTED
+    GmmLib::LayoutCache *pLayoutCache = GmmLibContext.GetLayoutCache();
+
+    if(pLayoutCache)
+    {
+        GMM_RESCREATE_PARAMS InParams   = CreateParams;
+        GMM_CLIENT           ClientType = pClientContext ? pClientContext->GetClientType() : GMM_UNDEFINED_CLIENT;
+        GMM_STATUS           Status;
+
+        if(pLayoutCache->Lookup(ClientType, CreateParams, *pRes))
+        {
+            return GMM_SUCCESS;
+        }
+
+        Status = pRes->Create(GmmLibContext, CreateParams);
+        if(Status == GMM_SUCCESS)
+        {
+            pLayoutCache->Insert(ClientType, InParams, CreateParams, *pRes);
+        }
+        return Status;
+    }
+#else
+    GMM_UNREFERENCED_PARAMETER(pClientContext);
+#endif
+
+    return pRes->Create(GmmLibContext, CreateParams);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Lays out a new resource, see GmmCreateResLayout(), and adds its padding to
+/// the context's padding stats when those are enabled.
+/////////////////////////////////////////////////////////////////////////////////////
+static GMM_STATUS GmmCreateResInfo(GmmLib::Context &           GmmLibContext,
+                                   GmmLib::GmmClientContext *  pClientContext,
+                                   GMM_RESOURCE_INFO *         pRes,
+                                   GMM_RESCREATE_PARAMS &      CreateParams)
+{
+    GMM_STATUS Status;
+
+    CreateParams.Flags.Info.__SizeOnly = 0; // Internal flag, only set by size estimation
+
+    Status = GmmCreateResLayout(GmmLibContext, pClientContext, pRes, CreateParams);
+
+    if((Status == GMM_SUCCESS) && GmmLibContext.IsPaddingStatsEnabled())
+    {
+        GMM_RESOURCE_PADDING_INFO PaddingInfo;
+
+        pRes->GetPaddingInfo(PaddingInfo);
+        GmmLibContext.AccountPadding(PaddingInfo);
+    }
+
+    return Status;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////
 /// Member function of ClientContext class for creation of ResourceInfo Object .
 /// @see        GmmLib::GmmResourceInfoCommon::Create()
@@ -461,7 +535,7 @@ GMM_RESOURCE_INFO *GMM_STDCALL GmmLib::GmmClientContext::CreateResInfoObject(GMM
         }
     }
 
-    if(pRes->Create(*pGmmLibContext, *pCreateParams) != GMM_SUCCESS)
+    if(GmmCreateResInfo(*pGmmLibContext, pClientContextIn, pRes, *pCreateParams) != GMM_SUCCESS)
     {
         goto ERROR_CASE;
     }
@@ -479,6 +553,605 @@ ERROR_CASE:
     return (NULL);
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function of ClientContext class for estimating the memory footprint of a
+/// resource without creating a ResourceInfo Object. Runs the same layout as
+/// CreateResInfoObject() on a stack object, skipping the per-mip offset fill.
+/// @see        GmmLib::GmmResourceInfoCommon::Create()
+///
+/// @param[in]  pCreateParams: Flags which specify what sort of resource to estimate.
+///                            Not modified.
+/// @param[out] pSizeInfo: Allocation, main and aux sizes and base alignment.
+/// @return     ::GMM_STATUS
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_STATUS GMM_STDCALL GmmLib::GmmClientContext::EstimateResourceSize(GMM_RESCREATE_PARAMS *  pCreateParams,
+                                                                      GMM_RESOURCE_SIZE_INFO *pSizeInfo)
+{
+    GmmClientContext *pClientContextIn = NULL;
+
+#if(!defined(GMM_UNIFIED_LIB))
+    pClientContextIn = pGmmLibContext->pGmmGlobalClientContext;
+#else
+    pClientContextIn = this;
+#endif
+
+    GMM_DPF_ENTER;
+
+    __GMM_ASSERTPTR(pCreateParams, GMM_INVALIDPARAM);
+    __GMM_ASSERTPTR(pSizeInfo, GMM_INVALIDPARAM);
+
+    // ExistingSysMem layouts would make Create() allocate the backing memory.
+    if(pCreateParams->Flags.Info.ExistingSysMem)
+    {
+        GMM_ASSERTDPF(0, "Size estimation not supported for ExistingSysMem!");
+        return GMM_INVALIDPARAM;
+    }
+
+    GMM_RESCREATE_PARAMS CreateParams = *pCreateParams;
+    CreateParams.pPreallocatedResInfo  = NULL;
+    CreateParams.Flags.Info.__SizeOnly = 1;
+
+    GmmLib::GmmResourceInfo ResInfo(pClientContextIn);
+
+    if(ResInfo.Create(*pGmmLibContext, CreateParams) != GMM_SUCCESS)
+    {
+        return GMM_ERROR;
+    }
+
+    pSizeInfo->SizeAllocation  = ResInfo.GetSizeAllocation();
+    pSizeInfo->SizeMainSurface = ResInfo.GetSizeMainSurface();
+    pSizeInfo->SizeAuxSurface  = ResInfo.GetSizeAuxSurface(GMM_AUX_SURF);
+    pSizeInfo->BaseAlignment   = ResInfo.GetBaseAlignment();
+
+    GMM_DPF_EXIT;
+
+    return GMM_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Built-in access costs of the "auto" tiling policy, see GMM_TILE_COST_MODEL.
+/////////////////////////////////////////////////////////////////////////////////////
+static const uint32_t GmmDefaultTileAccessCost[GMM_TILE_SELECT_TILINGS][GMM_TILE_ACCESS_PATTERNS] =
+{
+    // Render Sample Display  CPU
+    {      60,    80,     10,   0 }, // Linear
+    {      30,    50,      0,  40 }, // TileX
+    {      10,    10,     20,  60 }, // TileY/Tile4
+    {       8,     5,    100,  70 }, // TileYf
+    {       5,     5,    100,  80 }, // TileYs/Tile64
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Replaces the tiling flags of a create request with those of a tile-select
+/// candidate.
+///
+/// @param[in]      GmmLibContext: Context the request is for
+/// @param[in/out]  Flags: Resource flags of the request
+/// @param[in]      Tiling: Candidate tiling
+/////////////////////////////////////////////////////////////////////////////////////
+static void GmmTileSelectSetTiling(GmmLib::Context &GmmLibContext, GMM_RESOURCE_FLAG &Flags, GMM_TILE_SELECT_TILING Tiling)
+{
+    GmmLib::Context *pGmmLibContext = &GmmLibContext;
+
+    Flags.Info.Linear  = 0;
+    Flags.Info.TiledW  = 0;
+    Flags.Info.TiledX  = 0;
+    Flags.Info.TiledY  = 0;
+    Flags.Info.TiledYf = 0;
+    Flags.Info.TiledYs = 0;
+    Flags.Info.Tile4   = 0;
+    Flags.Info.Tile64  = 0;
+
+    switch(Tiling)
+    {
+        case GMM_TILE_SELECT_LINEAR:
+            Flags.Info.Linear = 1;
+            break;
+        case GMM_TILE_SELECT_TILEX:
+            Flags.Info.TiledX = 1;
+            break;
+        case GMM_TILE_SELECT_TILE_4KB:
+            GMM_SET_4KB_TILE(Flags, 1, pGmmLibContext);
+            break;
+        case GMM_TILE_SELECT_TILEYF:
+            Flags.Info.TiledY  = 1;
+            Flags.Info.TiledYf = 1;
+            break;
+        case GMM_TILE_SELECT_TILE_64KB:
+            if(pGmmLibContext->GetSkuTable().FtrTileY)
+            {
+                Flags.Info.TiledY = 1;
+            }
+            GMM_SET_64KB_TILE(Flags, 1, pGmmLibContext);
+            break;
+        default:
+            __GMM_ASSERT(0);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns whether a tile-select candidate can be laid out for the request at all.
+/// Filters out the combinations Create() would reject, so evaluating the
+/// candidates never trips the layout asserts.
+///
+/// @param[in]  GmmLibContext: Context the request is for
+/// @param[in]  CreateParams: Create request
+/// @param[in]  Tiling: Candidate tiling
+/// @return     true if the candidate should be evaluated
+/////////////////////////////////////////////////////////////////////////////////////
+static bool GmmTileSelectIsCandidate(GmmLib::Context &GmmLibContext, const GMM_RESCREATE_PARAMS &CreateParams, GMM_TILE_SELECT_TILING Tiling)
+{
+    const GMM_PLATFORM_INFO &Platform     = GmmLibContext.GetPlatformInfo();
+    const SKU_FEATURE_TABLE &SkuTable     = GmmLibContext.GetSkuTable();
+    uint32_t                 BitsPerPixel = __GmmFormatTraits.BitsPerElement[CreateParams.Format];
+    bool                     Display      = CreateParams.Flags.Gpu.FlipChain ||
+                           CreateParams.Flags.Gpu.Overlay ||
+                           CreateParams.Flags.Gpu.Presentable;
+    bool Planar = GmmIsPlanar(CreateParams.Format) != 0;
+
+    if(Tiling == GMM_TILE_SELECT_LINEAR)
+    {
+        return true;
+    }
+
+    if(!GMM_IS_SUPPORTED_BPP_ON_TILE_64_YF_YS(BitsPerPixel) && !Planar)
+    {
+        return false;
+    }
+
+    switch(Tiling)
+    {
+        case GMM_TILE_SELECT_TILEX:
+            return (CreateParams.BaseWidth64 * (BitsPerPixel >> 3)) <= Platform.TileInfo[LEGACY_TILE_X].MaxPitch;
+        case GMM_TILE_SELECT_TILE_4KB:
+            return !Display || SkuTable.FtrDisplayYTiling;
+        case GMM_TILE_SELECT_TILEYF:
+            return !Display && !Planar && SkuTable.FtrTileY &&
+                   !Platform.FormatTable[CreateParams.Format].Compressed;
+        case GMM_TILE_SELECT_TILE_64KB:
+            return !Display && !Planar &&
+                   !Platform.FormatTable[CreateParams.Format].Compressed;
+        default:
+            return false;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns whether a laid out candidate is usable for the request: within the
+/// caller's pitch and size limits from the cost model, aligned to the request's
+/// BaseAlignment, and within the platform's max pitch for its tile mode and
+/// surface type and its max surface size. Create() pads a layout to its own
+/// restrictions but doesn't fail it for exceeding these.
+/////////////////////////////////////////////////////////////////////////////////////
+static bool GmmTileSelectMeetsRestrictions(GmmLib::Context &             GmmLibContext,
+                                           const GMM_RESCREATE_PARAMS &  CreateParams,
+                                           const GMM_TILE_COST_MODEL &   CostModel,
+                                           GmmLib::GmmResourceInfo &     ResInfo)
+{
+    const GMM_PLATFORM_INFO &Platform     = GmmLibContext.GetPlatformInfo();
+    __GMM_BUFFER_TYPE        Restrictions = {0};
+    GMM_TILE_MODE            TileMode     = ResInfo.GmmGetTileMode();
+    GMM_GFX_SIZE_T           Pitch        = ResInfo.GetRenderPitch();
+    GMM_GFX_SIZE_T           Size         = ResInfo.GetSizeAllocation();
+
+    ResInfo.GetRestrictions(Restrictions);
+
+    return (!CostModel.MaxPitch || (Pitch <= CostModel.MaxPitch)) &&
+           (!CostModel.MaxAllocationSize || (Size <= CostModel.MaxAllocationSize)) &&
+           (!CreateParams.BaseAlignment || GFX_IS_ALIGNED(ResInfo.GetBaseAlignment(), CreateParams.BaseAlignment)) &&
+           (!Restrictions.MaxPitch || (Pitch <= Restrictions.MaxPitch)) &&
+           ((TileMode >= GMM_TILE_MODES) || !Platform.TileInfo[TileMode].MaxPitch ||
+            (Pitch <= Platform.TileInfo[TileMode].MaxPitch)) &&
+           ((Platform.SurfaceMaxSize <= 0) || (Size <= (GMM_GFX_SIZE_T)Platform.SurfaceMaxSize));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function of ClientContext class for filling in the built-in cost model
+/// of the "auto" tiling policy for a create request. Clients adjust the returned
+/// model and pass it to SelectTileMode().
+///
+/// @param[in]  pCreateParams: Create request; its usage flags set the access weights
+/// @param[out] pCostModel: Default cost model
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::GmmClientContext::GetDefaultTileCostModel(const GMM_RESCREATE_PARAMS *pCreateParams,
+                                                                   GMM_TILE_COST_MODEL *       pCostModel)
+{
+    __GMM_ASSERT(pCreateParams && pCostModel);
+    if(!pCreateParams || !pCostModel)
+    {
+        return;
+    }
+
+    memset(pCostModel, 0, sizeof(*pCostModel));
+    memcpy(pCostModel->AccessCost, GmmDefaultTileAccessCost, sizeof(pCostModel->AccessCost));
+
+    pCostModel->AccessWeight[GMM_TILE_ACCESS_RENDER]  = pCreateParams->Flags.Gpu.RenderTarget ? 4 : 0;
+    pCostModel->AccessWeight[GMM_TILE_ACCESS_SAMPLE]  = pCreateParams->Flags.Gpu.Texture ? 4 : 0;
+    pCostModel->AccessWeight[GMM_TILE_ACCESS_DISPLAY] = (pCreateParams->Flags.Gpu.FlipChain ||
+                                                         pCreateParams->Flags.Gpu.Overlay ||
+                                                         pCreateParams->Flags.Gpu.Presentable) ? 4 : 0;
+    pCostModel->AccessWeight[GMM_TILE_ACCESS_CPU]     = pCreateParams->Flags.Info.NotLockable ? 0 : 1;
+
+    pCostModel->PaddingCost = 1;
+    pCostModel->AuxLossCost = 30;
+    pCostModel->Page4KBCost = 5;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function of ClientContext class implementing the "auto" tiling policy.
+/// Lays out every tiling the request is eligible for (Linear, TileX, TileY/Tile4,
+/// Yf, Ys/Tile64, each with and without 64KB pages where the platform has them),
+/// drops candidates over the caller's or platform's pitch/size limits or off the
+/// requested BaseAlignment, scores the rest with the
+/// cost model and rewrites the request's tiling flags to the cheapest one.
+/// Compression flags are dropped when the chosen tiling can't carry aux.
+/// Per-candidate scores are returned in pResult and logged.
+///
+/// Requests with fixed tiling needs (depth/stencil, HiZ, MCS, separate CCS, MSAA,
+/// tiled resources, ESM, 1D/buffers) are rejected and left untouched.
+///
+/// @param[in/out] pCreateParams: Create request; tiling flags replaced on success
+/// @param[in]     pCostModel: Cost model, NULL for GetDefaultTileCostModel()
+/// @param[out]    pResult: Optional per-candidate scores
+/// @return        ::GMM_STATUS
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_STATUS GMM_STDCALL GmmLib::GmmClientContext::SelectTileMode(GMM_RESCREATE_PARAMS *     pCreateParams,
+                                                                const GMM_TILE_COST_MODEL *pCostModel,
+                                                                GMM_TILE_SELECT_RESULT *   pResult)
+{
+    GmmClientContext *     pClientContextIn = NULL;
+    GMM_TILE_COST_MODEL    CostModel;
+    GMM_TILE_SELECT_RESULT Result;
+    GMM_RESOURCE_FLAG      SelectedFlags = {};
+    uint64_t               BestScore     = 0;
+    uint32_t               AccessWeight  = 0;
+    bool                   Found         = false;
+    bool                   AuxRequested, Has64KBPages;
+
+#if(!defined(GMM_UNIFIED_LIB))
+    pClientContextIn = pGmmLibContext->pGmmGlobalClientContext;
+#else
+    pClientContextIn = this;
+#endif
+
+    GMM_DPF_ENTER;
+
+    __GMM_ASSERTPTR(pCreateParams, GMM_INVALIDPARAM);
+
+    const GMM_RESOURCE_FLAG &Flags = pCreateParams->Flags;
+
+    AuxRequested = Flags.Gpu.UnifiedAuxSurface || Flags.Gpu.CCS ||
+                   Flags.Info.RenderCompressed || Flags.Info.MediaCompressed;
+
+    if((pCreateParams->Format <= GMM_FORMAT_INVALID) ||
+       (pCreateParams->Format >= GMM_RESOURCE_FORMATS) ||
+       ((pCreateParams->Type != RESOURCE_2D) &&
+        (pCreateParams->Type != RESOURCE_3D) &&
+        (pCreateParams->Type != RESOURCE_CUBE)) ||
+       (pCreateParams->MSAA.NumSamples > 1) ||
+       Flags.Info.ExistingSysMem ||
+       Flags.Info.StdSwizzle ||
+       Flags.Gpu.TiledResource ||
+       Flags.Gpu.Depth ||
+       Flags.Gpu.SeparateStencil ||
+       Flags.Gpu.HiZ ||
+       Flags.Gpu.MCS ||
+       (Flags.Gpu.CCS && !Flags.Gpu.UnifiedAuxSurface) ||
+       (AuxRequested && (GFX_GET_CURRENT_RENDERCORE(pGmmLibContext->GetPlatformInfo().Platform) < IGFX_GEN12_CORE)))
+    {
+        GMM_DPF_CRITICAL("Auto tiling not supported for this resource!");
+        return GMM_INVALIDPARAM;
+    }
+
+    if(!pCostModel)
+    {
+        GetDefaultTileCostModel(pCreateParams, &CostModel);
+        pCostModel = &CostModel;
+    }
+
+    for(uint32_t a = 0; a < GMM_TILE_ACCESS_PATTERNS; a++)
+    {
+        AccessWeight += pCostModel->AccessWeight[a];
+    }
+
+    Has64KBPages = pGmmLibContext->GetSkuTable().FtrWddm2_1_64kbPages;
+
+    memset(&Result, 0, sizeof(Result));
+
+    for(uint32_t t = 0; t < GMM_TILE_SELECT_TILINGS; t++)
+    {
+        GMM_TILE_SELECT_TILING Tiling      = static_cast<GMM_TILE_SELECT_TILING>(t);
+        bool                   AuxEligible = (Tiling == GMM_TILE_SELECT_TILE_4KB) ||
+                           (Tiling == GMM_TILE_SELECT_TILEYF) ||
+                           (Tiling == GMM_TILE_SELECT_TILE_64KB);
+        int32_t PrevPage64KB = -1;
+
+        if(!GmmTileSelectIsCandidate(*pGmmLibContext, *pCreateParams, Tiling))
+        {
+            continue;
+        }
+
+        // Variant 0 lets 64KB paging kick in as usual, variant 1 opts out of the padding.
+        for(uint32_t NoPadding = 0; NoPadding <= ((Has64KBPages && !Flags.Info.NoOptimizationPadding) ? 1u : 0u); NoPadding++)
+        {
+            GMM_RESCREATE_PARAMS       CreateParams = *pCreateParams;
+            GMM_RESOURCE_PADDING_INFO  PaddingInfo;
+            GMM_TILE_SELECT_SCORE &    Candidate = Result.Candidates[Result.NumCandidates];
+            GmmLib::GmmResourceInfo    ResInfo(pClientContextIn);
+
+            GmmTileSelectSetTiling(*pGmmLibContext, CreateParams.Flags, Tiling);
+            CreateParams.Flags.Info.NoOptimizationPadding |= NoPadding;
+            if(AuxRequested && !AuxEligible)
+            {
+                CreateParams.Flags.Gpu.UnifiedAuxSurface  = 0;
+                CreateParams.Flags.Gpu.CCS                = 0;
+                CreateParams.Flags.Info.RenderCompressed  = 0;
+                CreateParams.Flags.Info.MediaCompressed   = 0;
+            }
+            CreateParams.pPreallocatedResInfo  = NULL;
+            CreateParams.Flags.Info.__SizeOnly = 1;
+
+            if(ResInfo.Create(*pGmmLibContext, CreateParams) != GMM_SUCCESS)
+            {
+                break;
+            }
+
+            ResInfo.GetPaddingInfo(PaddingInfo);
+
+            Candidate.Tiling         = Tiling;
+            Candidate.Page64KB       = ResInfo.Is64KBPageSuitable();
+            Candidate.AuxEligible    = AuxRequested && AuxEligible;
+            Candidate.Valid          = GmmTileSelectMeetsRestrictions(*pGmmLibContext, *pCreateParams, *pCostModel, ResInfo);
+            Candidate.AllocationSize = PaddingInfo.AllocationSize;
+            Candidate.PaddingSize    = PaddingInfo.AllocationSize - PaddingInfo.LogicalSize;
+
+            // Opting out of the padding only adds a candidate if it changed the paging.
+            if(Candidate.Page64KB == PrevPage64KB)
+            {
+                memset(&Candidate, 0, sizeof(Candidate));
+                continue;
+            }
+            PrevPage64KB = Candidate.Page64KB;
+
+            Candidate.Score = pCostModel->PaddingCost * ((Candidate.PaddingSize * 100) / GFX_MAX(PaddingInfo.LogicalSize, 1));
+            if(AccessWeight)
+            {
+                uint64_t AccessCost = 0;
+                for(uint32_t a = 0; a < GMM_TILE_ACCESS_PATTERNS; a++)
+                {
+                    AccessCost += (uint64_t)pCostModel->AccessWeight[a] * pCostModel->AccessCost[Tiling][a];
+                }
+                Candidate.Score += AccessCost / AccessWeight;
+            }
+            if(AuxRequested && !AuxEligible)
+            {
+                Candidate.Score += pCostModel->AuxLossCost;
+            }
+            if(Has64KBPages && !Candidate.Page64KB)
+            {
+                Candidate.Score += pCostModel->Page4KBCost;
+            }
+
+            GMM_DPF(GFXDBG_NORMAL, "Auto tiling: tiling %u page64KB %u aux %u size 0x%llx padding 0x%llx score %llu%s\n",
+                    (uint32_t)Tiling, (uint32_t)Candidate.Page64KB, (uint32_t)Candidate.AuxEligible,
+                    (unsigned long long)Candidate.AllocationSize, (unsigned long long)Candidate.PaddingSize,
+                    (unsigned long long)Candidate.Score, Candidate.Valid ? "" : " (violates restrictions)");
+
+            if(Candidate.Valid && (!Found || (Candidate.Score < BestScore)))
+            {
+                Found           = true;
+                Result.Selected = Result.NumCandidates;
+                BestScore       = Candidate.Score;
+                SelectedFlags   = CreateParams.Flags;
+            }
+
+            Result.NumCandidates++;
+        }
+    }
+
+    if(pResult)
+    {
+        *pResult = Result;
+    }
+
+    if(!Found)
+    {
+        GMM_DPF_CRITICAL("Auto tiling found no valid layout!");
+        return GMM_ERROR;
+    }
+
+    SelectedFlags.Info.__SizeOnly = 0;
+    pCreateParams->Flags          = SelectedFlags;
+
+    GMM_DPF_EXIT;
+
+    return GMM_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function of ClientContext class for exporting the computed layout of a
+/// ResourceInfo Object as a versioned, pointer-free blob that a peer process can
+/// import with ImportResInfoObject().
+/// @see        GmmLib::GmmResourceInfoCommon::SerializeLayout()
+///
+/// @param[in]  pResInfo: ResInfoObj to export
+/// @param[out] pBlob: Destination, may be NULL to query the required size
+/// @param[in]  BlobSize: Size of pBlob in bytes
+/// @return     Blob size in bytes (written only if it fit), 0 on failure.
+/////////////////////////////////////////////////////////////////////////////////////
+uint32_t GMM_STDCALL GmmLib::GmmClientContext::SerializeResInfoObject(GMM_RESOURCE_INFO *pResInfo,
+                                                                     void *             pBlob,
+                                                                     uint32_t           BlobSize)
+{
+    __GMM_ASSERTPTR(pResInfo, 0);
+
+    return pResInfo->SerializeLayout(pBlob, BlobSize);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function of ClientContext class for creation of ResourceInfo Object from
+/// a blob written by SerializeResInfoObject(), without recomputing the layout.
+/// @see        GmmLib::GmmResourceInfoCommon::CreateFromLayout()
+///
+/// @param[in] pBlob: Layout blob
+/// @param[in] BlobSize: Size of pBlob in bytes
+/// @param[in] pPreallocatedResInfo: Optional memory to construct the ResInfoObj in,
+///                                  as with GMM_RESCREATE_PARAMS::pPreallocatedResInfo
+/// @return     Pointer to GmmResourceInfo class, NULL if the blob was rejected.
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_RESOURCE_INFO *GMM_STDCALL GmmLib::GmmClientContext::ImportResInfoObject(const void *pBlob,
+                                                                             uint32_t    BlobSize,
+                                                                             void *      pPreallocatedResInfo)
+{
+    GMM_RESOURCE_INFO *pRes             = NULL;
+    GmmClientContext * pClientContextIn = NULL;
+
+#if(!defined(GMM_UNIFIED_LIB))
+    pClientContextIn = pGmmLibContext->pGmmGlobalClientContext;
+#else
+    pClientContextIn = this;
+#endif
+
+    __GMM_ASSERTPTR(pBlob, NULL);
+
+    if(pPreallocatedResInfo)
+    {
+        pRes = new(pPreallocatedResInfo) GmmLib::GmmResourceInfo(pClientContextIn);
+    }
+    else if((pRes = new GMM_RESOURCE_INFO(pClientContextIn)) == NULL)
+    {
+        GMM_ASSERTDPF(0, "Allocation failed!");
+        return NULL;
+    }
+
+    if(pRes->CreateFromLayout(*pGmmLibContext, pBlob, BlobSize) != GMM_SUCCESS)
+    {
+        if(pPreallocatedResInfo)
+        {
+            *pRes = GmmLib::GmmResourceInfo();
+        }
+        else
+        {
+            delete pRes;
+        }
+        return NULL;
+    }
+
+    if(pPreallocatedResInfo)
+    {
+        pRes->GetResFlags().Info.__PreallocatedResInfo = 1;
+    }
+
+    return pRes;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function of ClientContext class for turning padding-waste accounting on
+/// or off. While on, every resource created through CreateResInfoObject() adds its
+/// GmmResourceInfoCommon::GetPaddingInfo() breakdown to per-Context totals, which
+/// are logged when the Context is destroyed. Turning it on clears the totals.
+///
+/// @param[in]  Enable: 1 to start accounting, 0 to stop
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::GmmClientContext::EnablePaddingStats(uint8_t Enable)
+{
+    pGmmLibContext->EnablePaddingStats(Enable);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function of ClientContext class for querying the per-Context padding
+/// totals.
+///
+/// @param[out] pStats: Totals since EnablePaddingStats(1)
+/// @return     ::GMM_STATUS
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_STATUS GMM_STDCALL GmmLib::GmmClientContext::GetPaddingStats(GMM_RESOURCE_PADDING_STATS *pStats)
+{
+    __GMM_ASSERTPTR(pStats, GMM_INVALIDPARAM);
+
+    pGmmLibContext->GetPaddingStats(*pStats);
+
+    return GMM_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function of ClientContext class for logging the per-Context padding
+/// totals.
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::GmmClientContext::DumpPaddingStats()
+{
+    pGmmLibContext->DumpPaddingStats();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function of ClientContext class for querying the startup timings of the
+/// Context, including subsystems that were initialized on first use.
+///
+/// @param[out] pStats: Startup timings
+/// @return     ::GMM_STATUS
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_STATUS GMM_STDCALL GmmLib::GmmClientContext::GetLibInitStats(GMM_LIB_INIT_STATS *pStats)
+{
+    __GMM_ASSERTPTR(pStats, GMM_INVALIDPARAM);
+
+    pGmmLibContext->GetInitStats(*pStats);
+
+    return GMM_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function of ClientContext class for getting the precomputed MOCS/PTE
+/// table of the Context. Clients fetch it once and then use the inline
+/// GmmCachePolicyLookupMemoryObject()/GmmCachePolicyLookupPteType() for every
+/// binding instead of the virtual CachePolicyGetMemoryObject()/GetPteType().
+///
+/// @return     Lookup table of GMM_CACHE_POLICY_LOOKUP_ENTRIES entries, valid for
+///             the lifetime of the Context
+/////////////////////////////////////////////////////////////////////////////////////
+const GMM_CACHE_POLICY_LOOKUP *GMM_STDCALL GmmLib::GmmClientContext::GetCachePolicyLookup()
+{
+    return pGmmLibContext->GetCachePolicyLookup();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function of ClientContext class for turning cache policy query counting
+/// on or off. While on, CachePolicyGetMemoryObject(), CachePolicyGetPteType() and
+/// CachePolicyIsUsagePTECached() count every query per usage and MOCS index; the
+/// counts are logged when the Context is destroyed. Turning it on clears the counts.
+/// Lookups through GetCachePolicyLookup() are not counted.
+///
+/// @param[in]  Enable: 1 to start counting, 0 to stop
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::GmmClientContext::EnableCachePolicyStats(uint8_t Enable)
+{
+    pGmmLibContext->EnableCachePolicyStats(Enable);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function of ClientContext class for querying the per-Context cache policy
+/// query counts.
+///
+/// @param[out] pStats: Counts since EnableCachePolicyStats(1)
+/// @return     ::GMM_STATUS
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_STATUS GMM_STDCALL GmmLib::GmmClientContext::GetCachePolicyStats(GMM_CACHE_POLICY_STATS *pStats)
+{
+    __GMM_ASSERTPTR(pStats, GMM_INVALIDPARAM);
+
+    pGmmLibContext->GetCachePolicyStats(*pStats);
+
+    return GMM_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function of ClientContext class for logging the per-Context cache policy
+/// query counts.
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::GmmClientContext::DumpCachePolicyStats()
+{
+    pGmmLibContext->DumpCachePolicyStats();
+}
+
 /////////////////////////////////////////////////////////////////////////////////////
 /// Member function of ClientContext class for creation of ResourceInfo Object from
 /// already created Src ResInfo object
@@ -667,7 +1340,7 @@ GMM_RESOURCE_INFO *GMM_STDCALL GmmLib::GmmClientContext::CreateResInfoObject(GMM
             }
         }
 
-        if(pRes->Create(*pGmmLibContext, *pCreateParams) != GMM_SUCCESS)
+        if(GmmCreateResInfo(*pGmmLibContext, this, pRes, *pCreateParams) != GMM_SUCCESS)
         {
             goto ERROR_CASE;
         }
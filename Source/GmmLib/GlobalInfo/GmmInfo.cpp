@@ -21,11 +21,33 @@ OTHER DEALINGS IN THE SOFTWARE.
 ============================================================================*/
 
 #include "Internal/Common/GmmLibInc.h"
+#include "Internal/Common/GmmLayoutCache.h"
+#include "Internal/Common/GmmSharedTable.h"
+#if(!defined(__GMM_KMD__))
+#include <chrono>
+#endif
 
 #if(!defined(__GMM_KMD__) && !GMM_LIB_DLL_MA)
 int32_t GmmLib::Context::RefCount = 0;
 #endif
 
+// Time spent in GmmCreateMultiAdapterContext, reported with every context's init stats
+static uint64_t GmmMultiAdapterContextInitNs = 0;
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns a monotonic timestamp in nanoseconds for the startup instrumentation.
+/////////////////////////////////////////////////////////////////////////////////////
+static uint64_t GmmInitTimeNs()
+{
+#if(!defined(__GMM_KMD__))
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+#else
+    return 0;
+#endif
+}
+
 #ifdef GMM_LIB_DLL
 
 // Create Mutex Object used for syncronization of ProcessSingleton Context
@@ -71,9 +93,13 @@ extern "C" GMM_LIB_API_CONSTRUCTOR void GmmCreateMultiAdapterContext()
 {
     if(!pGmmMALibContext)
     {
+        uint64_t StartNs = GmmInitTimeNs();
+
         // This is called only during dll load
         // Initializes the MA context.
 	pGmmMALibContext = new GMM_MA_LIB_CONTEXT();
+
+        GmmMultiAdapterContextInitNs = GmmInitTimeNs() - StartNs;
     }
 }
 
@@ -89,11 +115,14 @@ extern "C" GMM_LIB_API_DESTRUCTOR void GmmDestroyMultiAdapterContext()
     {
         // Before destroying GmmMultiAdapterContext, check if all the Adapters have
         // their GmmLibContext destroyed.
-        // At this point the linked list is empty and pHeadNode = NULL & NumAdapter=0.
+        // At this point the adapter table is empty & NumAdapter=0.
 	if(!pGmmMALibContext->GetNumAdapters())
         {
             delete pGmmMALibContext;
             pGmmMALibContext = NULL;
+
+            // Cache policy tables kept for contexts that will no longer come
+            GmmLib::SharedTable::ReleaseKept();
         }
     }
 }
@@ -150,10 +179,17 @@ extern "C" GMM_STATUS GMM_STDCALL GmmCreateLibContext(const PLATFORM Platform,
         return GMM_ERROR;
     }
 
+    // Fast path, the adapter already has a LibContext. Taking a reference only
+    // succeeds while the RefCount is non-zero, so the context cannot be freed under us.
+    if(pGmmMALibContext->IncrementRefCountIfRegistered(sBdf))
+    {
+        return GMM_SUCCESS;
+    }
+
     GMM_STATUS SyncLockStatus = pGmmMALibContext->LockMAContextSyncMutex();
     if(SyncLockStatus == GMM_SUCCESS)
     {
-        // Create the dynamic vectored linked list to register each new BDF.
+        // Register the new BDF in the adapter table.
 	Status = pGmmMALibContext->IntializeAdapterInfo(sBdf);
         if(GMM_SUCCESS != Status)
         {
@@ -161,8 +197,7 @@ extern "C" GMM_STATUS GMM_STDCALL GmmCreateLibContext(const PLATFORM Platform,
             return GMM_ERROR;
         }
 
-        int32_t ContextRefCount = pGmmMALibContext->IncrementRefCount(sBdf);
-        if(ContextRefCount)
+        if(pGmmMALibContext->IncrementRefCountIfRegistered(sBdf))
         {
             // The requested Adapter is already registered.
             // Do not create new LibContext.
@@ -171,16 +206,24 @@ extern "C" GMM_STATUS GMM_STDCALL GmmCreateLibContext(const PLATFORM Platform,
             return GMM_SUCCESS;
         }
         // Requested Adapter is new, Lets create a new LibContext
+        uint64_t StartNs = GmmInitTimeNs();
 	pGmmLibContext = new GMM_LIB_CONTEXT();
         if(!pGmmLibContext)
         {
-            pGmmMALibContext->DecrementRefCount(sBdf);
             pGmmMALibContext->ReleaseAdapterInfo(sBdf);
             pGmmMALibContext->UnLockMAContextSyncMutex();
             return GMM_ERROR;
         }
 
         Status = (pGmmLibContext->InitContext(Platform, skuTable, waTable, sysInfo, GMM_KMD_VISTA));
+        if(Status != GMM_SUCCESS)
+        {
+            pGmmLibContext->DestroyContext();
+            delete pGmmLibContext;
+            pGmmMALibContext->ReleaseAdapterInfo(sBdf);
+            pGmmMALibContext->UnLockMAContextSyncMutex();
+            return Status;
+        }
 
 #if LHDM
         // Intialize SingletonContext Data.
@@ -202,7 +245,13 @@ extern "C" GMM_STATUS GMM_STDCALL GmmCreateLibContext(const PLATFORM Platform,
 
         pGmmLibContext->sBdf = sBdf;
 
+        pGmmLibContext->SetLibContextInitTime(GmmInitTimeNs() - StartNs);
+        pGmmLibContext->DumpInitStats();
+
+        // Publish the LibContext before the first reference, lock-free attaches only
+        // succeed once the RefCount is non-zero and must see the context by then.
         pGmmMALibContext->SetAdapterLibContext(sBdf, pGmmLibContext);
+        pGmmMALibContext->IncrementRefCount(sBdf);
 
         pGmmMALibContext->UnLockMAContextSyncMutex();
 
@@ -227,6 +276,12 @@ extern "C" void GMM_STDCALL GmmLibContextFree(ADAPTER_BDF sBdf)
     {
         __GMM_ASSERTPTR(pGmmMALibContext->GetAdapterLibContext(sBdf), VOIDRETURN);
 
+        // Fast path, other clients still hold the LibContext.
+        if(pGmmMALibContext->DecrementRefCountIfShared(sBdf))
+        {
+            return;
+        }
+
         GMM_STATUS SyncLockStatus = pGmmMALibContext->LockMAContextSyncMutex();
         if(SyncLockStatus == GMM_SUCCESS)
         {
@@ -240,7 +295,7 @@ extern "C" void GMM_STDCALL GmmLibContextFree(ADAPTER_BDF sBdf)
                 pGmmMALibContext->GetAdapterLibContext(sBdf)->DestroyContext();
                 // Delete/free the LibContext object
                 delete pGmmMALibContext->GetAdapterLibContext(sBdf);
-                // Delete/free the AdapterNode from the Linked List
+                // Release the AdapterNode from the adapter table
                 pGmmMALibContext->ReleaseAdapterInfo(sBdf);
             }
             // RefCount !=0
@@ -252,24 +307,83 @@ extern "C" void GMM_STDCALL GmmLibContextFree(ADAPTER_BDF sBdf)
 }
 
 
+/////////////////////////////////////////////////////////////////////////////////////
+/// Atomic accessors for the adapter table. Slot keys and LibContext pointers are
+/// read without MAContextSyncMutex, so writers publish with release semantics and
+/// readers observe them with acquire semantics.
+/////////////////////////////////////////////////////////////////////////////////////
+static inline uint32_t GmmAdapterLoadKey(uint32_t *pKey)
+{
+#if defined(_WIN32)
+    return (uint32_t)InterlockedCompareExchange((LONG *)pKey, 0, 0);
+#else
+    return __atomic_load_n(pKey, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void GmmAdapterStoreKey(uint32_t *pKey, uint32_t Key)
+{
+#if defined(_WIN32)
+    InterlockedExchange((LONG *)pKey, (LONG)Key);
+#else
+    __atomic_store_n(pKey, Key, __ATOMIC_RELEASE);
+#endif
+}
+
+static inline GmmLib::Context *GmmAdapterLoadLibContext(GmmLib::Context **ppLibContext)
+{
+#if defined(_WIN32)
+    return (GmmLib::Context *)InterlockedCompareExchangePointer((PVOID *)ppLibContext, NULL, NULL);
+#else
+    return __atomic_load_n(ppLibContext, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void GmmAdapterStoreLibContext(GmmLib::Context **ppLibContext, GmmLib::Context *pLibContext)
+{
+#if defined(_WIN32)
+    InterlockedExchangePointer((PVOID *)ppLibContext, pLibContext);
+#else
+    __atomic_store_n(ppLibContext, pLibContext, __ATOMIC_RELEASE);
+#endif
+}
+
+static inline int32_t GmmAdapterLoadRefCount(int32_t *pRefCount)
+{
+#if defined(_WIN32)
+    return (int32_t)InterlockedCompareExchange((LONG *)pRefCount, 0, 0);
+#else
+    return __atomic_load_n(pRefCount, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline bool GmmAdapterCompareExchangeRefCount(int32_t *pRefCount, int32_t Expected, int32_t Desired)
+{
+#if defined(_WIN32)
+    return (InterlockedCompareExchange((LONG *)pRefCount, Desired, Expected) == Expected);
+#else
+    return __atomic_compare_exchange_n(pRefCount, &Expected, Desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
 /////////////////////////////////////////////////////////////////////////////////////
 /// Constructor to zero initialize the GmmLib::GmmMultiAdapterContext object and create
 /// GmmMultiAdapterContext class object
 /////////////////////////////////////////////////////////////////////////////////////
 GmmLib::GmmMultiAdapterContext::GmmMultiAdapterContext()
 {
-    NumAdapters     = 0;
-    pCpuReserveBase = NULL;
+    NumAdapters        = 0;
+    NumLockFreeLookups = 0;
+    pCpuReserveBase    = NULL;
     CpuReserveSize  = 0;
-    // The Multi-Adapter Initialization is done dynamiclly using a Single Linked list Vector
-    // pHeadNode points to the root node of the linked list and registers the first
-    // adapter received from UMD.
-    // Initializing to NULL at DLL load.
-    pHeadNode = NULL;
+    // The Multi-Adapter Initialization is done dynamiclly using an open-addressed
+    // table keyed by the adapter BDF. All slots start out empty at DLL load.
+    memset(AdapterInfo, 0, sizeof(AdapterInfo));
 
     // Initializes the GmmLib::GmmMultiAdapterContext sync Mutex
     // This is required whenever any update has to be done Multiadapter context
-    // This includes Addition, deletion and search operations of the GMM_ADAPTER_INFO linked list
+    // This includes Addition and deletion of GMM_ADAPTER_INFO table entries and the
+    // RefCount transitions to and from zero. Searching the table does not take the mutex.
 
     MAContextSyncMutex = PTHREAD_MUTEX_INITIALIZER;
 }
@@ -279,181 +393,154 @@ GmmLib::GmmMultiAdapterContext::GmmMultiAdapterContext()
 /////////////////////////////////////////////////////////////////////////////////////
 GmmLib::GmmMultiAdapterContext::~GmmMultiAdapterContext()
 {
+    // Released adapter slots keep their sync mutex, close them along with the table
+    for(uint32_t Slot = 0; Slot < GMM_ADAPTER_TABLE_SIZE; Slot++)
+    {
+        if(AdapterInfo[Slot].Key != GMM_ADAPTER_SLOT_EMPTY)
+        {
+            pthread_mutex_destroy(&AdapterInfo[Slot].SyncMutex);
+        }
+    }
+
 // Un-initializes the GmmLib::GmmMultiAdapterContext sync Mutex
     pthread_mutex_destroy(&MAContextSyncMutex);
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function of GmmMultiAdapterContext class for packing an adapter BDF into
+/// the key stored in its adapter table slot
+///
+/// @param[in]  sBdf       : Adpater Bus, Device and Function details
+/// @return     Slot key, always has GMM_ADAPTER_SLOT_ACTIVE set
+/////////////////////////////////////////////////////////////////////////////////////
+uint32_t GMM_STDCALL GmmLib::GmmMultiAdapterContext::GetAdapterKey(ADAPTER_BDF sBdf)
+{
+    return GMM_ADAPTER_SLOT_ACTIVE | (sBdf.Bus << 16) | (sBdf.Device << 8) | sBdf.Function;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function of GmmMultiAdapterContext class for returning the home slot of
+/// an adapter key. BDFs tend to differ only in a few low bits of Bus, so the key
+/// is mixed with a multiplicative hash before it is masked.
+///
+/// @param[in]  Key        : Adapter key returned by GetAdapterKey
+/// @return     Index of the first slot to probe
+/////////////////////////////////////////////////////////////////////////////////////
+uint32_t GMM_STDCALL GmmLib::GmmMultiAdapterContext::GetAdapterHash(uint32_t Key)
+{
+    return ((Key * 0x9E3779B1) >> 16) & (GMM_ADAPTER_TABLE_SIZE - 1);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////
 /// Member function of GmmMultiAdapterContext class for initializing Adapter details
+/// Must be called with MAContextSyncMutex held.
 ///
 /// @param[in]  sBdf       : Adpater Bus, Device and Function details
 /// @return     GMM_STATUS
 /////////////////////////////////////////////////////////////////////////////////////
 GMM_STATUS GMM_STDCALL GmmLib::GmmMultiAdapterContext::IntializeAdapterInfo(ADAPTER_BDF sBdf)
 {
-    GMM_STATUS        Status = GMM_SUCCESS;
-    uint32_t          i      = 0;
-    GMM_ADAPTER_INFO *pNode = NULL, *pPrev = NULL;
+    GMM_ADAPTER_INFO *pNode     = NULL;
+    GMM_ADAPTER_INFO *pReleased = NULL;
+    uint32_t          Key   = GetAdapterKey(sBdf);
+    uint32_t          Slot  = GetAdapterHash(Key);
+    uint32_t          Probe = 0;
+
+    // Adapter is already active in MA context.
+    // Going forward, Lets just incremnent the number of clients using this libContext
+    // i.e Increment the RefCount in on this sBdf Adapter Node
+    if(GetAdapterNode(sBdf))
+    {
+        return GMM_SUCCESS;
+    }
 
-    // Create the Root Node
-    // If the list is empty, this is the first adapter initialization. This node will
-    // be root node of the list. Any further Adapter additions will be appeneded to this
-    // list i.e pNext
-    if(!pHeadNode)
+    // New Adapter. An UMD might have requested this for the first time on a new GPU
+    // adpater, Or Requested Adapter LibContext have been already destroyed/Un-registered
+    // for the same adpater before. A released slot keeps its BDF, so reuse the adapter's
+    // own released slot, else claim the first empty one on its probe sequence.
+    for(Probe = 0; Probe < GMM_ADAPTER_TABLE_SIZE; Probe++)
     {
-        pNode = (GMM_ADAPTER_INFO *)malloc(sizeof(GMM_ADAPTER_INFO));
-        if(pNode)
+        uint32_t SlotKey = GmmAdapterLoadKey(&AdapterInfo[Slot].Key);
+        if(SlotKey == GMM_ADAPTER_RELEASED_KEY(Key))
         {
-            NumAdapters++;
-
-            pNode->sBdf.Bus      = sBdf.Bus;
-            pNode->sBdf.Device   = sBdf.Device;
-            pNode->sBdf.Function = sBdf.Function;
+            pNode = &AdapterInfo[Slot];
+            break;
+        }
+        if(SlotKey == GMM_ADAPTER_SLOT_EMPTY)
+        {
+            pNode = &AdapterInfo[Slot];
 
             //Protect this adapter node with the sync mutex. Initialize sync mutex
-            pNode->SyncMutex     = PTHREAD_MUTEX_INITIALIZER;
-
-            pNode->pGmmLibContext = NULL;
-            pNode->RefCount       = 0;
-            pNode->pNext          = NULL;
-
-            pHeadNode = pNode;
+            pNode->SyncMutex = PTHREAD_MUTEX_INITIALIZER;
+            break;
         }
-        else
+        if(!pReleased && !(SlotKey & GMM_ADAPTER_SLOT_ACTIVE))
         {
-            // No memory for new node, return error
-            Status = GMM_ERROR;
+            pReleased = &AdapterInfo[Slot];
         }
+        Slot = (Slot + 1) & (GMM_ADAPTER_TABLE_SIZE - 1);
     }
-    else
+
+    if(!pNode && pReleased)
     {
-        // This happens if atleast 1 adapter is still registered in a Gmmlib
-        // MA context.
+        // No empty slot is left, take over a slot released by another adapter. A
+        // lock-free attach that looked the old adapter up may still hold the node, so
+        // wait for those to drain before rebinding it. They never block, and later
+        // lookups cannot match the released key.
+        WaitForLockFreeLookups();
 
-        pNode = pHeadNode;
-        // Check if the Adapter Node already exists in the list
-        // Search the list if the Adapter is already registerted or not.
-        while(pNode)
-        {
-            if((sBdf.Bus == pNode->sBdf.Bus) &&
-               (sBdf.Device == pNode->sBdf.Device) &&
-               (sBdf.Function == pNode->sBdf.Function))
-            {
-                break;
-            }
-            else
-            {
-                pPrev = pNode;
-                pNode = pNode->pNext;
-            }
-        }
+        pNode = pReleased;
 
-        // New Adapter adding to the list, add it to the end
-        // After search, If pNode = NULL, It means that
-        // The requested adapter is not yet registered before. An UMD might have
-        // requested this for the first time on a new GPU adpater, Or
-        // Requested Adapter LibContext have been already destroyed/Un-registered
-        // for the same adpater before.
-        if(!pNode)
-        {
-            pNode = (GMM_ADAPTER_INFO *)malloc(sizeof(GMM_ADAPTER_INFO));
-            if(pNode)
-            {
-                NumAdapters++;
+        // Close the Mutex of the previous adapter and initialize a fresh one
+        pthread_mutex_destroy(&pNode->SyncMutex);
+        pNode->SyncMutex = PTHREAD_MUTEX_INITIALIZER;
+    }
 
-                pNode->sBdf.Bus      = sBdf.Bus;
-                pNode->sBdf.Device   = sBdf.Device;
-                pNode->sBdf.Function = sBdf.Function;
+    if(!pNode)
+    {
+        GMM_DPF_CRITICAL("Adapter table is full, cannot register another adapter!");
+        return GMM_ERROR;
+    }
 
-                //Protect this adapter node with the sync mutex. Initialize sync mutex
-                pNode->SyncMutex = PTHREAD_MUTEX_INITIALIZER;
+    NumAdapters++;
 
-                pNode->pGmmLibContext = NULL;
-                pNode->RefCount       = 0;
-                pNode->pNext          = NULL;
+    pNode->sBdf.Data     = 0;
+    pNode->sBdf.Bus      = sBdf.Bus;
+    pNode->sBdf.Device   = sBdf.Device;
+    pNode->sBdf.Function = sBdf.Function;
 
-                // Add the new node at the end
-                // Appending the newly created Adapter Node to the end of the list.
-                pPrev->pNext = pNode;
-            }
-            else
-            {
-                // No memory for new node, return error
-                Status = GMM_ERROR;
-            }
-        }
-        else // Adapter node already exists in the list
-        {
-            // Already intialized, do nothing
-            // Adapter is already active in MA context.
-            // Going forward, Lets just incremnent the number of clients using this libContext
-            // i.e Increment the RefCount in on this sBdf Adapter Node
-        }
-    }
+    GmmAdapterStoreLibContext(&pNode->pGmmLibContext, NULL);
+    pNode->RefCount = 0;
 
-    return Status;
+    // Publish the slot last, lock-free readers must never see a half initialized node.
+    GmmAdapterStoreKey(&pNode->Key, Key);
+
+    return GMM_SUCCESS;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
 /// Member function of GmmMultiAdapterContext class for releasing Adapter Node
+/// Must be called with MAContextSyncMutex held.
 ///
 /// @param[in]  sBdf       : Adpater Bus, Device and Fucntion details
-/// @return     Void       : Deletes the Adpter Node either at Head, Tail or in between
+/// @return     Void       : Marks the Adapter's slot released
 /////////////////////////////////////////////////////////////////////////////////////
 void GMM_STDCALL GmmLib::GmmMultiAdapterContext::ReleaseAdapterInfo(ADAPTER_BDF sBdf)
 {
-    GMM_ADAPTER_INFO *pNode = NULL, *pPrev = NULL;
-
-    pNode = pHeadNode;
-
-    // Search the linked list for the node with the sBdf value to be freed
-    while(pNode)
-    {
-        if((sBdf.Bus == pNode->sBdf.Bus) &&
-           (sBdf.Device == pNode->sBdf.Device) &&
-           (sBdf.Function == pNode->sBdf.Function))
-        {
-            // If sBdf was registered as the first Node i.e HeadNode
-            // Delete the first Node and make the second node as HeadNode
-            if(pNode == pHeadNode)
-            {
-                pHeadNode = pNode->pNext;
-            }
-            else
-            {
-                // If Adapter sBdf was registered as second Node or any in-between node or the Tail Node,
-                // Delete this Adapter Node and connect the adjacent Nodes if second or Middle
-                // i.e pNode->pNext != NULL,
-                // Or
-                // Completely delete the tail Node, i.e. pNode->pNext = NULL, if its a Tail Node.
-                pPrev->pNext = pNode->pNext;
-            }
-            // Decrement the Adapter Node count tracker variable
-            NumAdapters--;
-
-            break;
-        }
-        else
-        {
-            // If sBdf is not registered as this pNode, then search next Node
-            // Do this till the end of the list if necessary
-            pPrev = pNode;
-            pNode = pNode->pNext;
-        }
-    }
+    GMM_ADAPTER_INFO *pNode = NULL;
 
-    // Free the deleted Node above.
-    // This can either be HeadNode, TailNode or Any node between Head and Tail
+    pNode = (GMM_ADAPTER_INFO *)GetAdapterNode(sBdf);
     if(pNode)
     {
-        pNode->pGmmLibContext = NULL;
-        pNode->pNext          = NULL;
-        pNode->RefCount       = 0;
-
-        // Close the Mutex protecting thsi Adapter node
-        pthread_mutex_destroy(&pNode->SyncMutex);
-
-        free(pNode);
+        // Unpublish first so that new lookups miss this adapter, then clear the node.
+        // The slot keeps its BDF and sync mutex until it is reactivated, for another
+        // adapter only once no lock-free lookup can still hold it. A reader that raced
+        // with the release never touches freed memory or a node of another adapter.
+        GmmAdapterStoreKey(&pNode->Key, GMM_ADAPTER_RELEASED_KEY(pNode->Key));
+        GmmAdapterStoreLibContext(&pNode->pGmmLibContext, NULL);
+
+        // Decrement the Adapter Node count tracker variable
+        NumAdapters--;
     }
 }
 
@@ -461,22 +548,14 @@ void GMM_STDCALL GmmLib::GmmMultiAdapterContext::ReleaseAdapterInfo(ADAPTER_BDF
 /// Member function of GmmMultiAdapterContext class for returning the AdapterIdx
 ///
 /// @param[in]  sBdf       : Adpater Bus, Device and Fucntion details
-/// @return     Adpater Idx corresponding the given BDF.
+/// @return     Adpater table slot corresponding the given BDF, or
+///             GMM_ADAPTER_TABLE_SIZE if the adapter is not registered.
 /////////////////////////////////////////////////////////////////////////////////////
 uint32_t GMM_STDCALL GmmLib::GmmMultiAdapterContext::GetAdapterIndex(ADAPTER_BDF sBdf)
 {
-    uint32_t AdapterIdx = 0;
-    for(AdapterIdx = 0; AdapterIdx < MAX_NUM_ADAPTERS; AdapterIdx++)
-    {
-        if((sBdf.Bus == AdapterInfo[AdapterIdx].sBdf.Bus) &&
-           (sBdf.Device == AdapterInfo[AdapterIdx].sBdf.Device) &&
-           (sBdf.Function == AdapterInfo[AdapterIdx].sBdf.Function))
-        {
-            break;
-        }
-    }
+    GMM_ADAPTER_INFO *pNode = (GMM_ADAPTER_INFO *)GetAdapterNode(sBdf);
 
-    return AdapterIdx;
+    return pNode ? (uint32_t)(pNode - AdapterInfo) : GMM_ADAPTER_TABLE_SIZE;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -493,7 +572,7 @@ GmmLib::Context *GMM_STDCALL GmmLib::GmmMultiAdapterContext::GetAdapterLibContex
     pNode = (GMM_ADAPTER_INFO *)GetAdapterNode(sBdf);
     if(pNode)
     {
-        return pNode->pGmmLibContext;
+        return GmmAdapterLoadLibContext(&pNode->pGmmLibContext);
     }
     else
     {
@@ -515,7 +594,7 @@ void GMM_STDCALL GmmLib::GmmMultiAdapterContext::SetAdapterLibContext(ADAPTER_BD
     pNode = (GMM_ADAPTER_INFO *)GetAdapterNode(sBdf);
     if(pNode)
     {
-        pNode->pGmmLibContext = pGmmLibContext;
+        GmmAdapterStoreLibContext(&pNode->pGmmLibContext, pGmmLibContext);
     }
 }
 
@@ -709,29 +788,28 @@ GMM_STATUS GMM_STDCALL GmmLib::GmmMultiAdapterContext::UnlockSingletonContextSyn
 /////////////////////////////////////////////////////////////////////////////////////
 void *GMM_STDCALL GmmLib::GmmMultiAdapterContext::GetAdapterNode(ADAPTER_BDF sBdf)
 {
-    GMM_ADAPTER_INFO *pNode = NULL;
+    uint32_t Key   = GetAdapterKey(sBdf);
+    uint32_t Slot  = GetAdapterHash(Key);
+    uint32_t Probe = 0;
 
-    pNode = pHeadNode;
-    // Search the entire linked list if the Adapter Node with sBdf is found or not
-    while(pNode)
+    // Lock-free linear probe from the adapter's home slot. An empty slot ends the
+    // probe sequence; slots of released adapters are skipped.
+    for(Probe = 0; Probe < GMM_ADAPTER_TABLE_SIZE; Probe++)
     {
-        if((sBdf.Bus == pNode->sBdf.Bus) &&
-           (sBdf.Device == pNode->sBdf.Device) &&
-           (sBdf.Function == pNode->sBdf.Function))
+        uint32_t SlotKey = GmmAdapterLoadKey(&AdapterInfo[Slot].Key);
+        if(SlotKey == Key)
         {
             // Yes, Found!. This is the Adapter Node
-            // pNode != NULL, will be valid pointer.
-            break;
+            return &AdapterInfo[Slot];
         }
-        else
+        if(SlotKey == GMM_ADAPTER_SLOT_EMPTY)
         {
-            // Not found, Search Next
-            // pNode = NULL if traversed till the tail and not found
-            pNode = pNode->pNext;
+            break;
         }
+        Slot = (Slot + 1) & (GMM_ADAPTER_TABLE_SIZE - 1);
     }
 
-    return pNode;
+    return NULL;
 }
 
 
@@ -756,8 +834,10 @@ int32_t GMM_STDCALL GmmLib::GmmMultiAdapterContext::IncrementRefCount(ADAPTER_BD
     {
         int32_t *Ref = &pNode->RefCount;
 
-#if defined(__linux__)
         // returns 0 only when registering the first client
+#if defined(_WIN32)
+        return (InterlockedIncrement((LONG *)Ref) - 1);
+#else
         return (__sync_fetch_and_add(Ref, 1));
 #endif
     }
@@ -787,11 +867,11 @@ int32_t GMM_STDCALL GmmLib::GmmMultiAdapterContext::DecrementRefCount(ADAPTER_BD
     if(pNode)
     {
         int32_t *Ref          = &pNode->RefCount;
-	int      CurrentValue = 0;
-        int      TargetValue  = 0;
+	int32_t  CurrentValue = 0;
+        int32_t  TargetValue  = 0;
         do
         {
-            CurrentValue = *Ref;
+            CurrentValue = GmmAdapterLoadRefCount(Ref);
             if(CurrentValue > 0)
             {
                 TargetValue = CurrentValue - 1;
@@ -800,11 +880,7 @@ int32_t GMM_STDCALL GmmLib::GmmMultiAdapterContext::DecrementRefCount(ADAPTER_BD
             {
                 break;
             }
-#if defined(_WIN32)
-        } while(!(InterlockedCompareExchange((LONG *)Ref, TargetValue, CurrentValue) == CurrentValue));
-#elif defined(__linux__) 
-        } while(!__sync_bool_compare_and_swap(Ref, CurrentValue, TargetValue));
-#endif
+        } while(!GmmAdapterCompareExchangeRefCount(Ref, CurrentValue, TargetValue));
 
         return TargetValue;
     }
@@ -814,6 +890,110 @@ int32_t GMM_STDCALL GmmLib::GmmMultiAdapterContext::DecrementRefCount(ADAPTER_BD
     }
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function of GmmMultiAdapterContext class for taking a reference on an
+/// adapter's LibContext without MAContextSyncMutex.
+/// The RefCount only leaves zero under MAContextSyncMutex, after the LibContext has
+/// been published, so a reference is only taken while the RefCount is non-zero.
+///
+/// @param1     sBdf        Adpater's Bus, Device and Fucntion
+/// @return     true if a reference was taken, false if the caller has to register
+///             the adapter under MAContextSyncMutex.
+/////////////////////////////////////////////////////////////////////////////////////
+bool GMM_STDCALL GmmLib::GmmMultiAdapterContext::IncrementRefCountIfRegistered(ADAPTER_BDF sBdf)
+{
+    GMM_ADAPTER_INFO *pNode  = NULL;
+    bool              Result = false;
+
+    // The caller holds no reference yet, keep the node from being rebound to another
+    // adapter while we use it.
+#if defined(_WIN32)
+    InterlockedIncrement((LONG *)&NumLockFreeLookups);
+#else
+    __atomic_fetch_add(&NumLockFreeLookups, 1, __ATOMIC_SEQ_CST);
+#endif
+
+    pNode = (GMM_ADAPTER_INFO *)GetAdapterNode(sBdf);
+    if(pNode)
+    {
+        int32_t *Ref          = &pNode->RefCount;
+        int32_t  CurrentValue = GmmAdapterLoadRefCount(Ref);
+
+        while(CurrentValue > 0)
+        {
+            if(GmmAdapterCompareExchangeRefCount(Ref, CurrentValue, CurrentValue + 1))
+            {
+                Result = true;
+                break;
+            }
+            CurrentValue = GmmAdapterLoadRefCount(Ref);
+        }
+    }
+
+#if defined(_WIN32)
+    InterlockedDecrement((LONG *)&NumLockFreeLookups);
+#else
+    __atomic_fetch_sub(&NumLockFreeLookups, 1, __ATOMIC_RELEASE);
+#endif
+
+    return Result;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function of GmmMultiAdapterContext class for waiting until no lock-free
+/// lookup started by IncrementRefCountIfRegistered is in flight.
+/// Must be called with MAContextSyncMutex held, after the slot to be rebound has
+/// been released.
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::GmmMultiAdapterContext::WaitForLockFreeLookups()
+{
+#if defined(_WIN32)
+    while(InterlockedCompareExchange((LONG *)&NumLockFreeLookups, 0, 0))
+    {
+        YieldProcessor();
+    }
+#else
+    // Orders the release of the slot before the check, pairs with the increment
+    // in IncrementRefCountIfRegistered.
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    while(__atomic_load_n(&NumLockFreeLookups, __ATOMIC_ACQUIRE))
+    {
+    }
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function of GmmMultiAdapterContext class for dropping a reference on an
+/// adapter's LibContext without MAContextSyncMutex.
+/// Dropping the last reference frees the LibContext and has to be done under
+/// MAContextSyncMutex, so only RefCount > 1 is decremented here.
+///
+/// @param1     sBdf        Adpater's Bus, Device and Fucntion
+/// @return     true if a reference was dropped, false if the caller holds the last
+///             reference and has to call DecrementRefCount under MAContextSyncMutex.
+/////////////////////////////////////////////////////////////////////////////////////
+bool GMM_STDCALL GmmLib::GmmMultiAdapterContext::DecrementRefCountIfShared(ADAPTER_BDF sBdf)
+{
+    GMM_ADAPTER_INFO *pNode = (GMM_ADAPTER_INFO *)GetAdapterNode(sBdf);
+
+    if(pNode)
+    {
+        int32_t *Ref          = &pNode->RefCount;
+        int32_t  CurrentValue = GmmAdapterLoadRefCount(Ref);
+
+        while(CurrentValue > 1)
+        {
+            if(GmmAdapterCompareExchangeRefCount(Ref, CurrentValue, CurrentValue - 1))
+            {
+                return true;
+            }
+            CurrentValue = GmmAdapterLoadRefCount(Ref);
+        }
+    }
+
+    return false;
+}
+
 #ifdef _WIN32
 /////////////////////////////////////////////////////////////////////////
 /// Get ProcessHeapVA Singleton HeapObj
@@ -980,17 +1160,38 @@ GmmLib::Context::Context()
     : ClientType(),
       pPlatformInfo(),
       pTextureCalc(),
-      SkuTable(),
-      WaTable(),
-      GtSysInfo(),
+      pLayoutCache(),
+      pSkuTable(),
+      pWaTable(),
+      pGtSysInfo(),
       pGmmKmdContext(),
       pGmmUmdContext(),
       pKmdHwDev(),
       pUmdAdapter(),
-      pGmmCachePolicy()
+      pCachePolicyTables(),
+      pCachePolicyKey(),
+      pCachePolicy(),
+      pCachePolicyTbl(),
+      pCachePolicyLookup(),
+      pGmmCachePolicy(),
+      PaddingStatsEnabled(),
+      PaddingStats(),
+      CachePolicyStatsEnabled(),
+      pCachePolicyStats(),
+      SubsystemInitMask(),
+      SubsystemBusyMask(),
+      InitStats(),
+      RetiredTables()
 {
-    memset(CachePolicy, 0, sizeof(CachePolicy));
-    memset(CachePolicyTbl, 0, sizeof(CachePolicyTbl));
+#if defined(_WIN32) && !defined(__GMM_KMD__)
+    SubsystemInitMutex = ::CreateMutex(NULL, FALSE, NULL);
+#elif !defined(__GMM_KMD__)
+    pthread_mutexattr_t MutexAttr;
+    pthread_mutexattr_init(&MutexAttr);
+    pthread_mutexattr_settype(&MutexAttr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&SubsystemInitMutex, &MutexAttr);
+    pthread_mutexattr_destroy(&MutexAttr);
+#endif
 
     //Default initialize 64KB Page padding percentage.
     AllowedPaddingFor64KbPagesPercentage = 10;
@@ -1007,6 +1208,15 @@ GmmLib::Context::Context()
 /////////////////////////////////////////////////////////////////////////////////////
 GmmLib::Context::~Context()
 {
+#if defined(_WIN32) && !defined(__GMM_KMD__)
+    if(SubsystemInitMutex)
+    {
+        ::CloseHandle(SubsystemInitMutex);
+        SubsystemInitMutex = NULL;
+    }
+#elif !defined(__GMM_KMD__)
+    pthread_mutex_destroy(&SubsystemInitMutex);
+#endif
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -1028,23 +1238,41 @@ GMM_CLIENT               ClientType)
 {
     this->ClientType = ClientType;
 
-    // Save the SKU and WA
-    this->SkuTable  = *pSkuTable;
-    this->WaTable   = *pWaTable;
-    this->GtSysInfo = *pGtSysInfo;
-    
+    // Save the SKU and WA. The copies stay private until the overrides below are
+    // applied, then they are interned.
+    this->pSkuTable  = SharedTable::Alloc(pSkuTable);
+    this->pWaTable   = SharedTable::Alloc(pWaTable);
+    this->pGtSysInfo = SharedTable::Alloc(pGtSysInfo);
+    SetCachePolicyTables(SharedTable::Alloc<GMM_CACHE_POLICY_TABLES>(NULL));
+    if(!this->pSkuTable || !this->pWaTable || !this->pGtSysInfo || !this->pCachePolicyTables)
+    {
+        return GMM_ERROR;
+    }
+
+    // Platform info and texture calc are needed by every size query and are what
+    // rejects unsupported platforms, so they are built right away.
+    uint64_t StartNs = GmmInitTimeNs();
+
     this->pPlatformInfo = CreatePlatformInfo(Platform, false);
 
     OverrideSkuWa();
 
-  
+    InitStats.SubsystemNs[GMM_LIB_SUBSYSTEM_PLATFORM_INFO] = GmmInitTimeNs() - StartNs;
+    SubsystemInitMask |= GMM_LIB_SUBSYSTEM_BIT(GMM_LIB_SUBSYSTEM_PLATFORM_INFO);
+
+    // The cache policy object is created here so platform errors still surface from
+    // InitContext, but the per-usage tables, MOCS and PAT are built on first use.
+    StartNs = GmmInitTimeNs();
+
     this->pGmmCachePolicy = CreateCachePolicyCommon();
     if(this->pGmmCachePolicy == NULL)
     {
         return GMM_ERROR;
     }
 
-    this->pGmmCachePolicy->InitCachePolicy();
+    InitStats.SubsystemNs[GMM_LIB_SUBSYSTEM_CACHE_POLICY] = GmmInitTimeNs() - StartNs;
+
+    StartNs = GmmInitTimeNs();
 
     this->pTextureCalc = CreateTextureCalc(Platform, false);
     if(this->pTextureCalc == NULL)
@@ -1052,6 +1280,35 @@ GMM_CLIENT               ClientType)
         return GMM_ERROR;
     }
 
+    InitStats.SubsystemNs[GMM_LIB_SUBSYSTEM_TEXTURE_CALC] = GmmInitTimeNs() - StartNs;
+    SubsystemInitMask |= GMM_LIB_SUBSYSTEM_BIT(GMM_LIB_SUBSYSTEM_TEXTURE_CALC);
+
+#if(defined(__GMM_KMD__))
+    // KMD programs MOCS and PAT from the cache policy tables straight away
+    InitSubsystem(GMM_LIB_SUBSYSTEM_CACHE_POLICY);
+#endif
+
+    this->pSkuTable  = SharedTable::Intern(const_cast<SKU_FEATURE_TABLE *>(this->pSkuTable));
+    this->pWaTable   = SharedTable::Intern(const_cast<WA_TABLE *>(this->pWaTable));
+    this->pGtSysInfo = SharedTable::Intern(const_cast<GT_SYSTEM_INFO *>(this->pGtSysInfo));
+
+#ifdef GMM_CACHE_POLICY_FILE_OVERRIDE_SUPPORTED
+    // Overridden tables are built right away, so a bad override file fails
+    // context creation, and are never shared by key with other contexts
+    const char *pOverrideFile = getenv(GMM_CACHE_POLICY_OVERRIDE_FILE_ENV);
+    if(pOverrideFile && *pOverrideFile)
+    {
+        if(InitSubsystem(GMM_LIB_SUBSYSTEM_CACHE_POLICY) != GMM_SUCCESS)
+        {
+            return GMM_ERROR;
+        }
+    }
+    else
+#endif
+    {
+        LoadCachePolicyTables();
+    }
+
     return GMM_SUCCESS;
 }
 
@@ -1061,6 +1318,27 @@ GMM_CLIENT               ClientType)
 /////////////////////////////////////////////////////////////////////////////////////
 void GMM_STDCALL GmmLib::Context::DestroyContext()
 {
+    if(this->PaddingStatsEnabled)
+    {
+        DumpPaddingStats();
+    }
+
+    if(this->CachePolicyStatsEnabled)
+    {
+        DumpCachePolicyStats();
+    }
+    this->CachePolicyStatsEnabled = 0;
+    delete[] this->pCachePolicyStats;
+    this->pCachePolicyStats = NULL;
+
+#ifdef GMM_LAYOUT_CACHE_SUPPORTED
+    if(this->pLayoutCache)
+    {
+            delete this->pLayoutCache;
+            this->pLayoutCache = NULL;
+    }
+#endif
+
     if(this->pGmmCachePolicy)
     {
             delete this->pGmmCachePolicy;
@@ -1078,30 +1356,617 @@ void GMM_STDCALL GmmLib::Context::DestroyContext()
             delete this->pPlatformInfo;
             this->pPlatformInfo = NULL;
     }
+
+    SubsystemInitMask = 0;
+
+    ReleaseTables();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Atomically adds to a stats counter; resources may be created, and cache
+/// policies queried, concurrently from several client threads.
+/////////////////////////////////////////////////////////////////////////////////////
+static GMM_INLINE void GmmStatsAdd(uint64_t *pCounter, uint64_t Value)
+{
+#if defined(_WIN32)
+    InterlockedExchangeAdd64((LONGLONG *)pCounter, (LONGLONG)Value);
+#else
+    __sync_fetch_and_add(pCounter, Value);
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to turn padding-waste accounting of created resources on or
+/// off. Turning it on clears the totals.
+/// @param[in]  Enable: 1 to start accounting, 0 to stop
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::EnablePaddingStats(uint8_t Enable)
+{
+    if(Enable && !PaddingStatsEnabled)
+    {
+        memset(&PaddingStats, 0, sizeof(PaddingStats));
+    }
+    PaddingStatsEnabled = Enable ? 1 : 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to add one resource's padding breakdown to the context totals.
+/// @param[in]  PaddingInfo: Breakdown from GmmResourceInfoCommon::GetPaddingInfo()
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::AccountPadding(const GMM_RESOURCE_PADDING_INFO &PaddingInfo)
+{
+    GMM_RESOURCE_PADDING_INFO &Total = PaddingStats.Total;
+
+    GmmStatsAdd(&PaddingStats.NumResources, 1);
+    GmmStatsAdd(&Total.LogicalSize, PaddingInfo.LogicalSize);
+    GmmStatsAdd(&Total.AllocationSize, PaddingInfo.AllocationSize);
+    GmmStatsAdd(&Total.TileAlignment, PaddingInfo.TileAlignment);
+    GmmStatsAdd(&Total.MipTail, PaddingInfo.MipTail);
+    GmmStatsAdd(&Total.Page64KB, PaddingInfo.Page64KB);
+    GmmStatsAdd(&Total.Aux, PaddingInfo.Aux);
+    GmmStatsAdd(&Total.PlaneAlignment, PaddingInfo.PlaneAlignment);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to snapshot the context's padding totals. Counters are read
+/// individually, so a snapshot taken during concurrent creates may be torn
+/// across fields.
+/// @param[out] Stats: Totals since accounting was enabled
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::GetPaddingStats(GMM_RESOURCE_PADDING_STATS &Stats)
+{
+    Stats = PaddingStats;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to log the context's padding totals. Called on context
+/// destroy while accounting is enabled.
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::DumpPaddingStats()
+{
+    GMM_RESOURCE_PADDING_STATS Stats;
+
+    GetPaddingStats(Stats);
+
+    GMM_DPF(GFXDBG_NORMAL, "GMM padding stats: %llu resources, %llu logical / %llu allocated bytes\n",
+            (unsigned long long)Stats.NumResources,
+            (unsigned long long)Stats.Total.LogicalSize,
+            (unsigned long long)Stats.Total.AllocationSize);
+    GMM_DPF(GFXDBG_NORMAL, "GMM padding stats: tile %llu, mip tail %llu, 64KB page %llu, aux %llu, plane %llu\n",
+            (unsigned long long)Stats.Total.TileAlignment,
+            (unsigned long long)Stats.Total.MipTail,
+            (unsigned long long)Stats.Total.Page64KB,
+            (unsigned long long)Stats.Total.Aux,
+            (unsigned long long)Stats.Total.PlaneAlignment);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns the calling thread's GMM_CACHE_POLICY_STATS_SHARDS slot. Threads are
+/// spread round-robin in the order they first query.
+/////////////////////////////////////////////////////////////////////////////////////
+static uint32_t GmmCachePolicyStatsShard()
+{
+#if defined(__GMM_KMD__)
+    return 0;
+#else
+    static uint32_t              NumThreads = 0;
+    static thread_local uint32_t Shard      = GMM_CACHE_POLICY_STATS_SHARDS;
+
+    if(Shard == GMM_CACHE_POLICY_STATS_SHARDS)
+    {
+#if defined(_WIN32)
+        Shard = (uint32_t)(InterlockedIncrement((LONG *)&NumThreads) - 1) % GMM_CACHE_POLICY_STATS_SHARDS;
+#else
+        Shard = __sync_fetch_and_add(&NumThreads, 1) % GMM_CACHE_POLICY_STATS_SHARDS;
+#endif
+    }
+
+    return Shard;
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to turn counting of cache policy queries on or off. Turning it
+/// on clears the counters. Not to be called concurrently with itself.
+/// @param[in]  Enable: 1 to start counting, 0 to stop
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::EnableCachePolicyStats(uint8_t Enable)
+{
+    if(Enable && !CachePolicyStatsEnabled)
+    {
+        if(!pCachePolicyStats)
+        {
+            pCachePolicyStats = new GMM_CACHE_POLICY_STATS_SHARD[GMM_CACHE_POLICY_STATS_SHARDS];
+            if(!pCachePolicyStats)
+            {
+                return;
+            }
+        }
+        memset(pCachePolicyStats, 0, sizeof(GMM_CACHE_POLICY_STATS_SHARD) * GMM_CACHE_POLICY_STATS_SHARDS);
+    }
+    CachePolicyStatsEnabled = (Enable && pCachePolicyStats) ? 1 : 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to count a MOCS query, if counting is on.
+/// @param[in]  Usage: Queried usage
+/// @param[in]  MOCS: MOCS returned
+/// @param[in]  Override: 1 if the usage's override MOCS was returned
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::CountMocsQuery(GMM_RESOURCE_USAGE_TYPE Usage, MEMORY_OBJECT_CONTROL_STATE MOCS, uint8_t Override)
+{
+    if(!CachePolicyStatsEnabled || (uint32_t)Usage >= GMM_RESOURCE_USAGE_MAX)
+    {
+        return;
+    }
+
+    GMM_CACHE_POLICY_STATS &Stats = pCachePolicyStats[GmmCachePolicyStatsShard()].Stats;
+
+    GmmStatsAdd(&Stats.Usage[Usage].MocsQueries, 1);
+    GmmStatsAdd(&Stats.Usage[Usage].OverrideQueries, Override ? 1 : 0);
+    GmmStatsAdd(&Stats.MocsIndexQueries[MOCS.Gen9.Index], 1);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to count a PTE query, if counting is on.
+/// @param[in]  Usage: Queried usage
+/// @param[in]  Cached: 1 if the usage's PTE is cached
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::CountPteQuery(GMM_RESOURCE_USAGE_TYPE Usage, uint8_t Cached)
+{
+    if(!CachePolicyStatsEnabled || (uint32_t)Usage >= GMM_RESOURCE_USAGE_MAX)
+    {
+        return;
+    }
+
+    GMM_CACHE_POLICY_STATS &Stats = pCachePolicyStats[GmmCachePolicyStatsShard()].Stats;
+
+    GmmStatsAdd(&Stats.Usage[Usage].PteQueries, 1);
+    GmmStatsAdd(&Stats.Usage[Usage].PteCachedQueries, Cached ? 1 : 0);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to sum the cache policy query counters of all threads. Counters
+/// are read individually, so a snapshot taken during concurrent queries may be
+/// torn across fields.
+/// @param[out] Stats: Counts since counting was enabled, zero if it never was
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::GetCachePolicyStats(GMM_CACHE_POLICY_STATS &Stats)
+{
+    memset(&Stats, 0, sizeof(Stats));
+
+    for(uint32_t i = 0; pCachePolicyStats && (i < GMM_CACHE_POLICY_STATS_SHARDS); i++)
+    {
+        const GMM_CACHE_POLICY_STATS &Shard = pCachePolicyStats[i].Stats;
+
+        for(uint32_t Usage = 0; Usage < GMM_RESOURCE_USAGE_MAX; Usage++)
+        {
+            Stats.Usage[Usage].MocsQueries += Shard.Usage[Usage].MocsQueries;
+            Stats.Usage[Usage].OverrideQueries += Shard.Usage[Usage].OverrideQueries;
+            Stats.Usage[Usage].PteQueries += Shard.Usage[Usage].PteQueries;
+            Stats.Usage[Usage].PteCachedQueries += Shard.Usage[Usage].PteCachedQueries;
+        }
+        for(uint32_t Index = 0; Index < GMM_MAX_NUMBER_MOCS_INDEXES; Index++)
+        {
+            Stats.MocsIndexQueries[Index] += Shard.MocsIndexQueries[Index];
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to log the queried usages and MOCS indexes. Called on context
+/// destroy while counting is enabled.
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::DumpCachePolicyStats()
+{
+    GMM_CACHE_POLICY_STATS *pStats = new GMM_CACHE_POLICY_STATS;
+    uint32_t                NumIndexes = 0;
+
+    if(!pStats)
+    {
+        return;
+    }
+
+    GetCachePolicyStats(*pStats);
+
+    for(uint32_t Usage = 0; Usage < GMM_RESOURCE_USAGE_MAX; Usage++)
+    {
+        const GMM_CACHE_POLICY_USAGE_STATS &UsageStats = pStats->Usage[Usage];
+
+        if(UsageStats.MocsQueries || UsageStats.PteQueries)
+        {
+            GMM_DPF(GFXDBG_NORMAL, "GMM cache policy stats: %s: %llu MOCS (%llu override), %llu PTE (%llu cached)\n",
+                    GmmCachePolicyCommon::GetUsageName((GMM_RESOURCE_USAGE_TYPE)Usage),
+                    (unsigned long long)UsageStats.MocsQueries,
+                    (unsigned long long)UsageStats.OverrideQueries,
+                    (unsigned long long)UsageStats.PteQueries,
+                    (unsigned long long)UsageStats.PteCachedQueries);
+        }
+    }
+
+    for(uint32_t Index = 0; Index < GMM_MAX_NUMBER_MOCS_INDEXES; Index++)
+    {
+        if(pStats->MocsIndexQueries[Index])
+        {
+            GMM_DPF(GFXDBG_NORMAL, "GMM cache policy stats: MOCS index %u: %llu queries\n",
+                    Index, (unsigned long long)pStats->MocsIndexQueries[Index]);
+            NumIndexes++;
+        }
+    }
+
+    GMM_DPF(GFXDBG_NORMAL, "GMM cache policy stats: %u MOCS indexes in use\n", NumIndexes);
+
+    delete pStats;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to initialize a subsystem that InitContext left for first use.
+/// Thread safe; concurrent callers block until the first one is done. A call made
+/// by the initializing thread itself (cache policy init reads its tables back
+/// through the accessors) returns right away.
+/// @param[in]  Subsystem: subsystem to initialize
+/// @return     Status of the initialization done by this call, GMM_SUCCESS if
+///             the subsystem was already initialized
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_STATUS GMM_STDCALL GmmLib::Context::InitSubsystem(GMM_LIB_SUBSYSTEM Subsystem)
+{
+    GMM_STATUS Status = GMM_SUCCESS;
+    uint32_t   Bit    = GMM_LIB_SUBSYSTEM_BIT(Subsystem);
+
+#if defined(_WIN32) && !defined(__GMM_KMD__)
+    while(WAIT_OBJECT_0 != ::WaitForSingleObject(SubsystemInitMutex, INFINITE))
+        ;
+#elif !defined(__GMM_KMD__)
+    pthread_mutex_lock(&SubsystemInitMutex);
+#endif
+
+    if(!(SubsystemInitMask & Bit) && !(SubsystemBusyMask & Bit) &&
+       (Subsystem != GMM_LIB_SUBSYSTEM_CACHE_POLICY || pGmmCachePolicy))
+    {
+        uint64_t StartNs = GmmInitTimeNs();
+
+        SubsystemBusyMask |= Bit;
+
+        switch(Subsystem)
+        {
+            case GMM_LIB_SUBSYSTEM_CACHE_POLICY:
+            {
+                GMM_CACHE_POLICY_TABLES *pTables = const_cast<GMM_CACHE_POLICY_TABLES *>(pCachePolicyTables);
+
+                Status = pGmmCachePolicy->InitCachePolicy();
+
+                // MOCS/PTE of every usage for the inline lookups in GmmCachePolicy.h,
+                // and the state later contexts restore when loading these tables
+                pGmmCachePolicy->InitCachePolicyLookup(pTables->Lookup);
+                pGmmCachePolicy->SaveState(pTables->State);
+
+                // Nobody outside this thread has seen the tables yet, so swapping
+                // in the shared copy needs no retiring
+                SetCachePolicyTables(SharedTable::Intern(pTables, pCachePolicyKey));
+                SharedTable::Release(pCachePolicyKey);
+                pCachePolicyKey = NULL;
+                pCachePolicyLookup = pCachePolicyTables->Lookup;
+                break;
+            }
+            case GMM_LIB_SUBSYSTEM_LAYOUT_CACHE:
+#ifdef GMM_LAYOUT_CACHE_SUPPORTED
+                pLayoutCache = LayoutCache::Create(this);
+#endif
+                break;
+            default:
+                // Platform info and texture calc are built by InitContext
+                break;
+        }
+
+        SubsystemBusyMask &= ~Bit;
+
+        InitStats.SubsystemNs[Subsystem] += GmmInitTimeNs() - StartNs;
+
+        GMM_DPF(GFXDBG_NORMAL, "GMM init stats: subsystem %d initialized on first use in %llu ns\n",
+                Subsystem, (unsigned long long)InitStats.SubsystemNs[Subsystem]);
+
+        // Publish last so lock-free EnsureSubsystem() callers see complete tables
+#if defined(_WIN32)
+        InterlockedOr((LONG *)&SubsystemInitMask, (LONG)Bit);
+#else
+        __atomic_fetch_or(&SubsystemInitMask, Bit, __ATOMIC_RELEASE);
+#endif
+    }
+
+#if defined(_WIN32) && !defined(__GMM_KMD__)
+    ::ReleaseMutex(SubsystemInitMutex);
+#elif !defined(__GMM_KMD__)
+    pthread_mutex_unlock(&SubsystemInitMutex);
+#endif
+
+    return Status;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to record the time GmmCreateLibContext spent creating this
+/// context.
+/// @param[in]  TimeNs: Creation time in nanoseconds
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::SetLibContextInitTime(uint64_t TimeNs)
+{
+    InitStats.LibContextNs = TimeNs;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to snapshot the context's startup timings.
+/// @param[out] Stats: Startup timings and the set of initialized subsystems
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::GetInitStats(GMM_LIB_INIT_STATS &Stats)
+{
+#if defined(_WIN32)
+    uint32_t InitMask = *(volatile uint32_t *)&SubsystemInitMask;
+#else
+    uint32_t InitMask = __atomic_load_n(&SubsystemInitMask, __ATOMIC_ACQUIRE);
+#endif
+
+    Stats                       = InitStats;
+    Stats.MultiAdapterContextNs = GmmMultiAdapterContextInitNs;
+    Stats.InitializedMask       = InitMask;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to log the context's startup timings. Called once the context
+/// has been created; lazily initialized subsystems log on first use.
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::DumpInitStats()
+{
+    GMM_LIB_INIT_STATS Stats;
+
+    GetInitStats(Stats);
+
+    GMM_DPF(GFXDBG_NORMAL, "GMM init stats: MA context %llu ns, lib context %llu ns\n",
+            (unsigned long long)Stats.MultiAdapterContextNs,
+            (unsigned long long)Stats.LibContextNs);
+    GMM_DPF(GFXDBG_NORMAL, "GMM init stats: platform info %llu ns, cache policy %llu ns, texture calc %llu ns, layout cache %llu ns (initialized mask 0x%x, reused mask 0x%x)\n",
+            (unsigned long long)Stats.SubsystemNs[GMM_LIB_SUBSYSTEM_PLATFORM_INFO],
+            (unsigned long long)Stats.SubsystemNs[GMM_LIB_SUBSYSTEM_CACHE_POLICY],
+            (unsigned long long)Stats.SubsystemNs[GMM_LIB_SUBSYSTEM_TEXTURE_CALC],
+            (unsigned long long)Stats.SubsystemNs[GMM_LIB_SUBSYSTEM_LAYOUT_CACHE],
+            Stats.InitializedMask, Stats.ReusedMask);
 }
 
 void GMM_STDCALL GmmLib::Context::OverrideSkuWa()
 {
+    SKU_FEATURE_TABLE *pSku = GetSkuTableForUpdate();
+    __GMM_ASSERTPTR(pSku, VOIDRETURN);
+
     if((GFX_GET_CURRENT_PRODUCT(this->GetPlatformInfo().Platform) < IGFX_XE_HP_SDV))
     {
-        SkuTable.FtrTileY = true;
+        pSku->FtrTileY = true;
     }
 
     if(GFX_GET_CURRENT_PRODUCT(this->GetPlatformInfo().Platform) == IGFX_PVC)
     {
-        SkuTable.Ftr57bGPUAddressing = true;
+        pSku->Ftr57bGPUAddressing = true;
     }
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to keep a shared table replaced by copy-on-write alive until
+/// DestroyContext, as lock-free readers may still be using it. Tables beyond the
+/// inline block are kept in chained blocks, so none is ever released early.
+/// @param[in]  pTable: Shared table no longer referenced by this context
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::RetireTable(const void *pTable)
+{
+    if(RetiredTables.NumTables == GMM_LIB_MAX_RETIRED_TABLES)
+    {
+        // Move the full inline block to the chain
+        GMM_LIB_RETIRED_TABLES *pBlock = new GMM_LIB_RETIRED_TABLES(RetiredTables);
+        if(!pBlock)
+        {
+            // Readers may still use the table, keeping it for the process lifetime
+            // is the only safe option left.
+            GMM_DPF_CRITICAL("Out of memory retiring a copy-on-write table, leaking it!");
+            return;
+        }
+
+        RetiredTables       = GMM_LIB_RETIRED_TABLES();
+        RetiredTables.pNext     = pBlock;
+    }
+
+    RetiredTables.pTables[RetiredTables.NumTables++] = pTable;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to drop this context's references on its tables.
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::ReleaseTables()
+{
+    SharedTable::Release(pSkuTable);
+    SharedTable::Release(pWaTable);
+    SharedTable::Release(pGtSysInfo);
+    SharedTable::Release(pCachePolicyTables);
+    SharedTable::Release(pCachePolicyKey);
+
+    pSkuTable          = NULL;
+    pWaTable           = NULL;
+    pGtSysInfo         = NULL;
+    pCachePolicyTables = NULL;
+    pCachePolicyKey    = NULL;
+    pCachePolicy       = NULL;
+    pCachePolicyTbl    = NULL;
+    pCachePolicyLookup = NULL;
+
+    GMM_LIB_RETIRED_TABLES *pBlock = &RetiredTables;
+    while(pBlock)
+    {
+        GMM_LIB_RETIRED_TABLES *pNext = pBlock->pNext;
+
+        for(uint32_t i = 0; i < pBlock->NumTables; i++)
+        {
+            SharedTable::Release(pBlock->pTables[i]);
+        }
+
+        if(pBlock != &RetiredTables)
+        {
+            delete pBlock;
+        }
+        pBlock = pNext;
+    }
+    RetiredTables = GMM_LIB_RETIRED_TABLES();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to point the cache policy accessors, and the cache policy
+/// object, at a set of cache policy tables.
+/// @param[in]  pTables: Cache policy tables, may be NULL
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::SetCachePolicyTables(const GMM_CACHE_POLICY_TABLES *pTables)
+{
+    GMM_CACHE_POLICY_TABLES *pTablesRW = const_cast<GMM_CACHE_POLICY_TABLES *>(pTables);
+
+    pCachePolicyTables = pTables;
+    pCachePolicy       = pTablesRW ? pTablesRW->CachePolicy : NULL;
+    pCachePolicyTbl    = pTablesRW ? pTablesRW->CachePolicyTbl : NULL;
+
+    if(pGmmCachePolicy)
+    {
+        pGmmCachePolicy->pCachePolicy = pCachePolicy;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to load the cache policy tables generated by an earlier context
+/// with the same platform and SKU/WA/GT system info, so the cache policy is ready
+/// without running its init. Unknown configurations are left to the lazy init,
+/// which then publishes its tables under pCachePolicyKey for later contexts.
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::LoadCachePolicyTables()
+{
+#if(!defined(__GMM_KMD__) && !(defined(_WIN32) && (_DEBUG || _RELEASE_INTERNAL)))
+    // KMD has to program MOCS/PAT, and registry overrides are not part of the key
+    const PLATFORM Platform = GetPlatformInfo().Platform;
+    uint64_t       StartNs  = GmmInitTimeNs();
+
+    // Zeroed by Alloc(), so padding compares equal too
+    pCachePolicyKey = SharedTable::Alloc<GMM_CACHE_POLICY_KEY>(NULL);
+    if(!pCachePolicyKey)
+    {
+        return;
+    }
+
+    pCachePolicyKey->Platform = Platform;
+    memcpy(&pCachePolicyKey->SkuTable, pSkuTable, sizeof(SKU_FEATURE_TABLE));
+    memcpy(&pCachePolicyKey->WaTable, pWaTable, sizeof(WA_TABLE));
+    memcpy(&pCachePolicyKey->GtSysInfo, pGtSysInfo, sizeof(GT_SYSTEM_INFO));
+
+    const GMM_CACHE_POLICY_TABLES *pTables = SharedTable::Find<GMM_CACHE_POLICY_TABLES>(pCachePolicyKey);
+    if(pTables)
+    {
+        SharedTable::Release(pCachePolicyKey);
+        pCachePolicyKey = NULL;
+
+        SharedTable::Release(pCachePolicyTables);
+
+        SetCachePolicyTables(pTables);
+        pCachePolicyLookup = pTables->Lookup;
+        pGmmCachePolicy->RestoreState(pTables->State);
+
+        InitStats.SubsystemNs[GMM_LIB_SUBSYSTEM_CACHE_POLICY] += GmmInitTimeNs() - StartNs;
+        InitStats.ReusedMask |= GMM_LIB_SUBSYSTEM_BIT(GMM_LIB_SUBSYSTEM_CACHE_POLICY);
+        SubsystemInitMask |= GMM_LIB_SUBSYSTEM_BIT(GMM_LIB_SUBSYSTEM_CACHE_POLICY);
+    }
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to get a writable SKU table. The table may be shared with other
+/// adapters, in which case this context switches to a private copy of it.
+/// @return     SKU table, NULL on allocation failure
+/////////////////////////////////////////////////////////////////////////////////////
+SKU_FEATURE_TABLE *GMM_STDCALL GmmLib::Context::GetSkuTableForUpdate()
+{
+    SKU_FEATURE_TABLE *pSku = SharedTable::Unshare(pSkuTable);
+
+    if(pSku && (pSku != pSkuTable))
+    {
+        RetireTable(pSkuTable);
+        pSkuTable = pSku;
+    }
+
+    return pSku;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to get a writable WA table, see GetSkuTableForUpdate().
+/// @return     WA table, NULL on allocation failure
+/////////////////////////////////////////////////////////////////////////////////////
+WA_TABLE *GMM_STDCALL GmmLib::Context::GetWaTableForUpdate()
+{
+    WA_TABLE *pWa = SharedTable::Unshare(pWaTable);
+
+    if(pWa && (pWa != pWaTable))
+    {
+        RetireTable(pWaTable);
+        pWaTable = pWa;
+    }
+
+    return pWa;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Member function to get a writable GT system info, see GetSkuTableForUpdate().
+/// Read-only users should call GetGtSysInfoPtr() instead.
+/// @return     GT system info, NULL on allocation failure
+/////////////////////////////////////////////////////////////////////////////////////
+GT_SYSTEM_INFO *GMM_STDCALL GmmLib::Context::GetGtSysInfo()
+{
+    GT_SYSTEM_INFO *pSysInfo = SharedTable::Unshare(pGtSysInfo);
+
+    if(pSysInfo && (pSysInfo != pGtSysInfo))
+    {
+        RetireTable(pGtSysInfo);
+        pGtSysInfo = pSysInfo;
+    }
+
+    return pSysInfo;
+}
+
+#ifdef __GMM_KMD__
+/////////////////////////////////////////////////////////////////////////////////////
+/// Resets  the sku Table after  GmmInitContext() could have changed them
+/// since original latching
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::SetSkuTable(SKU_FEATURE_TABLE SkuTable)
+{
+    SKU_FEATURE_TABLE *pSku = GetSkuTableForUpdate();
+    __GMM_ASSERTPTR(pSku, VOIDRETURN);
+
+    *pSku     = SkuTable;
+    pSkuTable = SharedTable::Intern(pSku);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Resets  the Wa Table after  GmmInitContext() could have changed them
+/// since original latching
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::SetWaTable(WA_TABLE WaTable)
+{
+    WA_TABLE *pWa = GetWaTableForUpdate();
+    __GMM_ASSERTPTR(pWa, VOIDRETURN);
+
+    *pWa     = WaTable;
+    pWaTable = SharedTable::Intern(pWa);
+}
+#endif
+
 GMM_CACHE_POLICY *GMM_STDCALL GmmLib::Context::CreateCachePolicyCommon()
 {
     GMM_CACHE_POLICY *        pGmmCachePolicy = NULL;
     GMM_CACHE_POLICY_ELEMENT *CachePolicy     = NULL;
-    CachePolicy                               = GetCachePolicyUsage();
+    CachePolicy                               = this->pCachePolicy;
 
-    if(GetCachePolicyObj())
+    // Raw members on purpose: the lazy accessors would try to initialize the
+    // cache policy that is being created here.
+    if(this->pGmmCachePolicy)
     {
-        return GetCachePolicyObj();
+        return this->pGmmCachePolicy;
     }
 
     switch(GFX_GET_CURRENT_RENDERCORE(this->GetPlatformInfo().Platform))
@@ -1151,32 +2016,41 @@ GMM_TEXTURE_CALC *GMM_STDCALL GmmLib::Context::CreateTextureCalc(PLATFORM Platfo
         }
     }
 
+#ifdef GMM_SPECIALIZED_TEXTURE_CALC
+// Sealed per-platform texture calc; AllocateTexture stages are statically bound.
+#define GMM_NEW_TEXTURE_CALC(GenTextureCalc) new GmmPlatformTextureCalc<GenTextureCalc>(this)
+#else
+#define GMM_NEW_TEXTURE_CALC(GenTextureCalc) new GenTextureCalc(this)
+#endif
+
     switch(GFX_GET_CURRENT_RENDERCORE(Platform))
     {
         case IGFX_GEN7_CORE:
         case IGFX_GEN7_5_CORE:
-            return new GmmGen7TextureCalc(this);
+            return GMM_NEW_TEXTURE_CALC(GmmGen7TextureCalc);
             break;
         case IGFX_GEN8_CORE:
-            return new GmmGen8TextureCalc(this);
+            return GMM_NEW_TEXTURE_CALC(GmmGen8TextureCalc);
             break;
         case IGFX_GEN9_CORE:
-            return new GmmGen9TextureCalc(this);
+            return GMM_NEW_TEXTURE_CALC(GmmGen9TextureCalc);
             break;
         case IGFX_GEN10_CORE:
-            return new GmmGen10TextureCalc(this);
+            return GMM_NEW_TEXTURE_CALC(GmmGen10TextureCalc);
             break;
         case IGFX_GEN11_CORE:
-            return new GmmGen11TextureCalc(this);
+            return GMM_NEW_TEXTURE_CALC(GmmGen11TextureCalc);
             break;
         case IGFX_GEN12LP_CORE:
         case IGFX_GEN12_CORE:
         case IGFX_XE_HP_CORE:
 	case IGFX_XE_HPG_CORE:
         default:
-            return new GmmGen12TextureCalc(this);
+            return GMM_NEW_TEXTURE_CALC(GmmGen12TextureCalc);
             break;
     }
+
+#undef GMM_NEW_TEXTURE_CALC
 }
 
 GMM_PLATFORM_INFO_CLASS *GMM_STDCALL GmmLib::Context::CreatePlatformInfo(PLATFORM Platform, bool Override)
@@ -0,0 +1,337 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+
+#include "Internal/Common/GmmLibInc.h"
+#include "Internal/Common/GmmSharedTable.h"
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Header in front of every table handed out by GmmLib::SharedTable. Tables are
+/// private (owned by one context, writable) until interned, then shared, read-only
+/// and reference counted on the process wide list.
+/////////////////////////////////////////////////////////////////////////////////////
+typedef struct GMM_SHARED_TABLE_HEADER_REC
+{
+    struct GMM_SHARED_TABLE_HEADER_REC *pNext;
+    uint64_t                            Hash;
+    uint64_t                            KeyHash;    // Hash of the key, 0 if none
+    void *                              pKey;       // Copy of the inputs the table was derived from, NULL if none
+    uint64_t                            Size;
+    uint32_t                            RefCount;   // Shared tables only, under GmmSharedTableLock
+    uint32_t                            Shared;
+} GMM_SHARED_TABLE_HEADER;
+
+#define GMM_SHARED_TABLE_HEADER(pTable) (((GMM_SHARED_TABLE_HEADER *)(pTable)) - 1)
+
+static GMM_SHARED_TABLE_HEADER *pGmmSharedTables   = NULL;
+static uint32_t                 GmmNumSharedTables   = 0;
+static const void *             pGmmKeptTables[GMM_SHARED_TABLE_MAX_KEPT];
+static uint32_t                 GmmNumKeptTables     = 0;
+
+#if defined(__GMM_KMD__)
+// KMD has one context per adapter and no use for the shared store
+#define GMM_SHARED_TABLE_LOCK()
+#define GMM_SHARED_TABLE_UNLOCK()
+#elif defined(_WIN32)
+static SRWLOCK GmmSharedTableLock = SRWLOCK_INIT;
+#define GMM_SHARED_TABLE_LOCK() AcquireSRWLockExclusive(&GmmSharedTableLock)
+#define GMM_SHARED_TABLE_UNLOCK() ReleaseSRWLockExclusive(&GmmSharedTableLock)
+#else
+static pthread_mutex_t GmmSharedTableLock = PTHREAD_MUTEX_INITIALIZER;
+#define GMM_SHARED_TABLE_LOCK() pthread_mutex_lock(&GmmSharedTableLock)
+#define GMM_SHARED_TABLE_UNLOCK() pthread_mutex_unlock(&GmmSharedTableLock)
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns whether a shared table was interned under the given key.
+/// @param[in]  pNode: Shared table header
+/// @param[in]  pKey: Key table from Alloc(), NULL for none
+/// @param[in]  KeyHash: Hash of pKey, 0 for none
+/////////////////////////////////////////////////////////////////////////////////////
+static bool __GmmSharedTableKeyMatch(const GMM_SHARED_TABLE_HEADER *pNode, const void *pKey, uint64_t KeyHash)
+{
+    if(!pKey || !pNode->pKey)
+    {
+        return (pKey == pNode->pKey);
+    }
+
+    const GMM_SHARED_TABLE_HEADER *pKeyHeader  = GMM_SHARED_TABLE_HEADER(pKey);
+    const GMM_SHARED_TABLE_HEADER *pNodeHeader = GMM_SHARED_TABLE_HEADER(pNode->pKey);
+
+    return (pNode->KeyHash == KeyHash) &&
+           (pNodeHeader->Size == pKeyHeader->Size) &&
+           !memcmp(pNode->pKey, pKey, (size_t)pKeyHeader->Size);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Allocates a private table.
+/// @param[in]  pData: Initial contents, NULL to zero the table
+/// @param[in]  Size: Size of the table in bytes
+/// @return     Writable table, NULL on allocation failure
+/////////////////////////////////////////////////////////////////////////////////////
+void *GMM_STDCALL GmmLib::SharedTable::Alloc(const void *pData, size_t Size)
+{
+    uint8_t *pBlob = new uint8_t[sizeof(GMM_SHARED_TABLE_HEADER) + Size];
+    __GMM_ASSERTPTR(pBlob, NULL);
+
+    GMM_SHARED_TABLE_HEADER *pHeader = (GMM_SHARED_TABLE_HEADER *)pBlob;
+    void *                   pTable  = pHeader + 1;
+
+    pHeader->pNext    = NULL;
+    pHeader->Hash     = 0;
+    pHeader->KeyHash  = 0;
+    pHeader->pKey     = NULL;
+    pHeader->Size     = Size;
+    pHeader->RefCount = 1;
+    pHeader->Shared   = 0;
+
+    if(pData)
+    {
+        memcpy(pTable, pData, Size);
+    }
+    else
+    {
+        memset(pTable, 0, Size);
+    }
+
+    return pTable;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Turns a private table into a shared one. If an identical table is already
+/// shared, that one is referenced and the private table is freed.
+/// @param[in]  pTable: Table from Alloc() or Unshare(). Interning a table that is
+///                     already shared returns it unchanged.
+/// @param[in]  pKey: Private table from Alloc() holding the inputs the table was
+///                   derived from, for Find(). NULL if the table is not derived.
+///                   The caller keeps ownership, the store keeps its own copy.
+/// @return     Shared, read-only table
+/////////////////////////////////////////////////////////////////////////////////////
+const void *GMM_STDCALL GmmLib::SharedTable::Intern(void *pTable, const void *pKey)
+{
+    if(pTable == NULL)
+    {
+        return NULL;
+    }
+
+#if defined(__GMM_KMD__)
+    GMM_UNREFERENCED_PARAMETER(pKey);
+    return pTable;
+#else
+    GMM_SHARED_TABLE_HEADER *pHeader = GMM_SHARED_TABLE_HEADER(pTable);
+    uint64_t                 KeyHash = 0;
+
+    if(pHeader->Shared)
+    {
+        return pTable;
+    }
+
+    pHeader->Hash = __GmmHash64(pTable, (size_t)pHeader->Size, 0);
+    if(pKey)
+    {
+        KeyHash = __GmmHash64(pKey, (size_t)GMM_SHARED_TABLE_HEADER(pKey)->Size, 0);
+    }
+
+    GMM_SHARED_TABLE_LOCK();
+
+    for(GMM_SHARED_TABLE_HEADER *pNode = pGmmSharedTables; pNode; pNode = pNode->pNext)
+    {
+        if((pNode->Hash == pHeader->Hash) &&
+           (pNode->Size == pHeader->Size) &&
+           __GmmSharedTableKeyMatch(pNode, pKey, KeyHash) &&
+           !memcmp(pNode + 1, pTable, (size_t)pHeader->Size))
+        {
+            pNode->RefCount++;
+            GMM_SHARED_TABLE_UNLOCK();
+
+            delete[](uint8_t *) pHeader;
+            return pNode + 1;
+        }
+    }
+
+    if(pKey)
+    {
+        pHeader->pKey = Alloc(pKey, (size_t)GMM_SHARED_TABLE_HEADER(pKey)->Size);
+        if(!pHeader->pKey)
+        {
+            // Share the table without a key, Find() just won't return it
+            pKey = NULL;
+        }
+        pHeader->KeyHash = pHeader->pKey ? KeyHash : 0;
+    }
+
+    pHeader->Shared   = 1;
+    pHeader->RefCount = 1;
+    pHeader->pNext    = pGmmSharedTables;
+    pGmmSharedTables  = pHeader;
+    GmmNumSharedTables++;
+
+    // Keep derived tables for later Find()s once their last user is gone
+    if(pKey && (GmmNumKeptTables < GMM_SHARED_TABLE_MAX_KEPT))
+    {
+        pHeader->RefCount++;
+        pGmmKeptTables[GmmNumKeptTables++] = pTable;
+    }
+
+    GMM_SHARED_TABLE_UNLOCK();
+
+    return pTable;
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Looks up a shared table by the inputs it was derived from.
+/// @param[in]  pKey: Private table from Alloc(), compared in full with the key the
+///                   table was interned with
+/// @param[in]  Size: Size of the table in bytes
+/// @return     Shared table, referenced for the caller. NULL if there is none.
+/////////////////////////////////////////////////////////////////////////////////////
+const void *GMM_STDCALL GmmLib::SharedTable::Find(const void *pKey, size_t Size)
+{
+    const void *pTable = NULL;
+
+#if defined(__GMM_KMD__)
+    GMM_UNREFERENCED_PARAMETER(pKey);
+    GMM_UNREFERENCED_PARAMETER(Size);
+#else
+    if(pKey == NULL)
+    {
+        return NULL;
+    }
+
+    uint64_t KeyHash = __GmmHash64(pKey, (size_t)GMM_SHARED_TABLE_HEADER(pKey)->Size, 0);
+
+    GMM_SHARED_TABLE_LOCK();
+
+    for(GMM_SHARED_TABLE_HEADER *pNode = pGmmSharedTables; pNode; pNode = pNode->pNext)
+    {
+        if(pNode->pKey && (pNode->Size == Size) && __GmmSharedTableKeyMatch(pNode, pKey, KeyHash))
+        {
+            pNode->RefCount++;
+            pTable = pNode + 1;
+            break;
+        }
+    }
+
+    GMM_SHARED_TABLE_UNLOCK();
+#endif
+
+    return pTable;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns a writable copy of a shared table. The caller keeps its reference on the
+/// shared table and Release()s it when no other thread can still be reading it.
+/// @param[in]  pTable: Table to update
+/// @return     pTable itself if it is private, otherwise a new private copy.
+///             NULL on allocation failure.
+/////////////////////////////////////////////////////////////////////////////////////
+void *GMM_STDCALL GmmLib::SharedTable::Unshare(const void *pTable)
+{
+    __GMM_ASSERTPTR(pTable, NULL);
+
+    GMM_SHARED_TABLE_HEADER *pHeader = GMM_SHARED_TABLE_HEADER(pTable);
+
+    if(!pHeader->Shared)
+    {
+        return const_cast<void *>(pTable);
+    }
+
+    return Alloc(pTable, (size_t)pHeader->Size);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Drops a reference on a table, freeing it with the last one.
+/// @param[in]  pTable: Private or shared table, may be NULL
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::SharedTable::Release(const void *pTable)
+{
+    if(pTable == NULL)
+    {
+        return;
+    }
+
+    GMM_SHARED_TABLE_HEADER *pHeader = GMM_SHARED_TABLE_HEADER(pTable);
+
+    if(pHeader->Shared)
+    {
+        GMM_SHARED_TABLE_LOCK();
+
+        __GMM_ASSERT(pHeader->RefCount > 0);
+        if(--pHeader->RefCount)
+        {
+            GMM_SHARED_TABLE_UNLOCK();
+            return;
+        }
+
+        GMM_SHARED_TABLE_HEADER **ppNode = &pGmmSharedTables;
+        while(*ppNode != pHeader)
+        {
+            ppNode = &(*ppNode)->pNext;
+        }
+        *ppNode = pHeader->pNext;
+        GmmNumSharedTables--;
+
+        GMM_SHARED_TABLE_UNLOCK();
+    }
+
+    Release(pHeader->pKey);
+    delete[](uint8_t *) pHeader;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Drops the store's references on kept keyed tables. Called at library unload.
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::SharedTable::ReleaseKept()
+{
+    const void *pKept[GMM_SHARED_TABLE_MAX_KEPT];
+    uint32_t    NumKept;
+
+    GMM_SHARED_TABLE_LOCK();
+    NumKept = GmmNumKeptTables;
+    for(uint32_t i = 0; i < NumKept; i++)
+    {
+        pKept[i]          = pGmmKeptTables[i];
+        pGmmKeptTables[i] = NULL;
+    }
+    GmmNumKeptTables = 0;
+    GMM_SHARED_TABLE_UNLOCK();
+
+    for(uint32_t i = 0; i < NumKept; i++)
+    {
+        Release(pKept[i]);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns the number of distinct tables currently shared, for debug and ULTs.
+/////////////////////////////////////////////////////////////////////////////////////
+uint32_t GMM_STDCALL GmmLib::SharedTable::GetNumShared()
+{
+    uint32_t NumShared;
+
+    GMM_SHARED_TABLE_LOCK();
+    NumShared = GmmNumSharedTables;
+    GMM_SHARED_TABLE_UNLOCK();
+
+    return NumShared;
+}
@@ -208,6 +208,6 @@ uint32_t GMM_STDCALL GmmPlatformGetBppFromGmmResourceFormat(void *pLibContext, G
 
     __GMM_ASSERT((Format > GMM_FORMAT_INVALID) && (Format < GMM_RESOURCE_FORMATS));
     __GMM_ASSERT(pGmmLibContext);
-    __GMM_ASSERT(pGmmLibContext->GetPlatformInfo().FormatTable[Format].Element.BitsPer >> 3);
-    return pGmmLibContext->GetPlatformInfo().FormatTable[Format].Element.BitsPer;
+    __GMM_ASSERT(__GmmFormatTraits.BitsPerElement[Format] >> 3);
+    return __GmmFormatTraits.BitsPerElement[Format];
 }
@@ -0,0 +1,604 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+#include "Internal/Common/GmmLibInc.h"
+#include "Internal/Common/GmmLayoutCache.h"
+
+#ifdef GMM_LAYOUT_CACHE_SUPPORTED
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define GMM_LAYOUT_CACHE_ALIGN(x) GFX_ALIGN((x), sizeof(uint64_t))
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Anchor used to find the gmmlib binary the cache is keyed to.
+/////////////////////////////////////////////////////////////////////////////////////
+static void GmmLayoutCacheAnchor()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Clears the process-local parts of create params, so equal requests from
+/// different processes produce identical bytes.
+/// @param[in/out]  Params: create params to normalize
+/////////////////////////////////////////////////////////////////////////////////////
+static void GmmLayoutCacheNormalize(GMM_RESCREATE_PARAMS &Params)
+{
+    const size_t PadStart = offsetof(GMM_RESCREATE_PARAMS, NoGfxMemory) + sizeof(Params.NoGfxMemory);
+
+    Params.pPreallocatedResInfo             = NULL;
+    Params.Flags.Info.__PreallocatedResInfo = 0;
+
+    // Padding before pPreallocatedResInfo, left uninitialized by most clients.
+    memset((uint8_t *)&Params + PadStart, 0, offsetof(GMM_RESCREATE_PARAMS, pPreallocatedResInfo) - PadStart);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns the lookup hash of a normalized create request.
+/////////////////////////////////////////////////////////////////////////////////////
+static uint64_t GmmLayoutCacheHash(uint64_t ContextState, uint32_t ClientType, const GMM_RESCREATE_PARAMS &Params)
+{
+    return __GmmHash64(&Params, sizeof(Params), ContextState ^ ((uint64_t)ClientType << 32));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns true if the layout of a resource created with these params depends
+/// only on the params and the Context, i.e. can be reused by another process.
+/////////////////////////////////////////////////////////////////////////////////////
+static bool GmmLayoutCacheEligible(const GMM_RESCREATE_PARAMS &Params)
+{
+    return !Params.Flags.Info.ExistingSysMem && !Params.pExistingSysMem;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Writes Size bytes, retrying on short writes.
+/// @return true if all bytes were written
+/////////////////////////////////////////////////////////////////////////////////////
+static bool GmmLayoutCacheWrite(int Fd, const void *pData, size_t Size)
+{
+    const uint8_t *pByte = (const uint8_t *)pData;
+
+    while(Size)
+    {
+        ssize_t Written = write(Fd, pByte, Size);
+        if(Written < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        pByte += Written;
+        Size -= Written;
+    }
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Constructor. The cache file is named after the key, so contexts for different
+/// platforms or gmmlib builds never share a file.
+/// @param[in]  pGmmLibContext: Context the layouts are computed with
+/// @param[in]  pDir: directory holding the cache files
+/////////////////////////////////////////////////////////////////////////////////////
+GmmLib::LayoutCache::LayoutCache(Context *pGmmLibContext, const char *pDir)
+    : pGmmLibContext(pGmmLibContext),
+      Path(),
+      Key(),
+      pMapped(),
+      MappedSize(),
+      ValidSize(),
+      MappedIndex(),
+      Writer(),
+      WriterStarted(),
+      StopWriter(),
+      Writing(),
+      RewriteFile(),
+      FileSize(),
+      Added(),
+      Pending()
+{
+    const PLATFORM Platform = pGmmLibContext->GetPlatformInfo().Platform;
+    Dl_info        LibInfo;
+    struct stat    LibStat;
+    char           Name[32];
+
+    pthread_mutex_init(&Mutex, NULL);
+    pthread_cond_init(&WorkCond, NULL);
+    pthread_cond_init(&IdleCond, NULL);
+
+    Key = __GmmHash64(&Platform, sizeof(Platform), GMM_LAYOUT_CACHE_VERSION);
+    Key = __GmmHash64(&pGmmLibContext->GetSkuTable(), sizeof(SKU_FEATURE_TABLE), Key);
+    Key = __GmmHash64(&pGmmLibContext->GetWaTable(), sizeof(WA_TABLE), Key);
+    Key = __GmmHash64(pGmmLibContext->GetGtSysInfoPtr(), sizeof(GT_SYSTEM_INFO), Key);
+    Key = __GmmHash64(GMMLIB_VERSION_STRING, sizeof(GMMLIB_VERSION_STRING), Key);
+
+    // Layout code can change without a version bump (e.g. a rebuilt dev tree),
+    // so also key to the identity of the binary computing the layouts.
+    if(dladdr((void *)&GmmLayoutCacheAnchor, &LibInfo) && LibInfo.dli_fname &&
+       stat(LibInfo.dli_fname, &LibStat) == 0)
+    {
+        uint64_t Ident[] = {(uint64_t)LibStat.st_dev, (uint64_t)LibStat.st_ino, (uint64_t)LibStat.st_size,
+                            (uint64_t)LibStat.st_mtim.tv_sec, (uint64_t)LibStat.st_mtim.tv_nsec};
+        Key = __GmmHash64(Ident, sizeof(Ident), Key);
+    }
+
+    snprintf(Name, sizeof(Name), "/gmmlayout_%016llx.bin", (unsigned long long)Key);
+    Path = std::string(pDir) + Name;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Destructor. Writes out the queued records before releasing the mapping.
+/////////////////////////////////////////////////////////////////////////////////////
+GmmLib::LayoutCache::~LayoutCache()
+{
+    pthread_mutex_lock(&Mutex);
+    StopWriter = true;
+    pthread_cond_signal(&WorkCond);
+    pthread_mutex_unlock(&Mutex);
+
+    if(WriterStarted)
+    {
+        pthread_join(Writer, NULL);
+    }
+
+    if(pMapped)
+    {
+        munmap((void *)pMapped, MappedSize);
+    }
+
+    pthread_cond_destroy(&IdleCond);
+    pthread_cond_destroy(&WorkCond);
+    pthread_mutex_destroy(&Mutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Creates the layout cache for a Context if GMM_LAYOUT_CACHE_DIR is set.
+/// @param[in]  pGmmLibContext: Context the layouts are computed with
+/// @return     LayoutCache object, NULL if caching is off
+/////////////////////////////////////////////////////////////////////////////////////
+GmmLib::LayoutCache *GmmLib::LayoutCache::Create(Context *pGmmLibContext)
+{
+    const char * pDir   = getenv(GMM_LAYOUT_CACHE_DIR_ENV);
+    LayoutCache *pCache = NULL;
+
+    if(!pDir || !*pDir)
+    {
+        return NULL;
+    }
+
+    pCache = new LayoutCache(pGmmLibContext, pDir);
+    if(pCache)
+    {
+        pCache->Open();
+    }
+
+    return pCache;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Maps the cache file read-only and indexes its records. Stops at the first
+/// record that fails validation; the file is then rewritten without the bad
+/// tail on the first append. A missing or mismatched file is treated as empty.
+/////////////////////////////////////////////////////////////////////////////////////
+void GmmLib::LayoutCache::Open()
+{
+    const GMM_LAYOUT_CACHE_FILE_HEADER *pHdr;
+    struct stat                         FileStat;
+    void *                              pMap;
+    size_t                              Offset;
+    int                                 Fd;
+
+    RewriteFile = true;
+    FileSize    = sizeof(GMM_LAYOUT_CACHE_FILE_HEADER);
+
+    Fd = open(Path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(Fd < 0)
+    {
+        return;
+    }
+
+    if(fstat(Fd, &FileStat) != 0 ||
+       FileStat.st_size < (off_t)sizeof(GMM_LAYOUT_CACHE_FILE_HEADER) ||
+       FileStat.st_size > GMM_LAYOUT_CACHE_MAX_FILE_SIZE)
+    {
+        close(Fd);
+        return;
+    }
+
+    pMap = mmap(NULL, FileStat.st_size, PROT_READ, MAP_PRIVATE, Fd, 0);
+    close(Fd);
+    if(pMap == MAP_FAILED)
+    {
+        return;
+    }
+
+    pMapped    = (const uint8_t *)pMap;
+    MappedSize = FileStat.st_size;
+
+    pHdr = (const GMM_LAYOUT_CACHE_FILE_HEADER *)pMapped;
+    if(pHdr->Magic != GMM_LAYOUT_CACHE_MAGIC ||
+       pHdr->Version != GMM_LAYOUT_CACHE_VERSION ||
+       pHdr->Key != Key ||
+       pHdr->ParamsSize != sizeof(GMM_RESCREATE_PARAMS) ||
+       pHdr->LayoutVersion != GMM_RESOURCE_LAYOUT_VERSION)
+    {
+        GMM_DPF_CRITICAL("Stale layout cache file ignored!");
+        munmap(pMap, MappedSize);
+        pMapped    = NULL;
+        MappedSize = 0;
+        return;
+    }
+
+    Offset = sizeof(GMM_LAYOUT_CACHE_FILE_HEADER);
+    while(Offset < MappedSize)
+    {
+        const GMM_LAYOUT_CACHE_RECORD *pRecord = (const GMM_LAYOUT_CACHE_RECORD *)(pMapped + Offset);
+
+        if(!ValidateRecord(pRecord, MappedSize - Offset))
+        {
+            GMM_DPF_CRITICAL("Corrupt layout cache record, ignoring rest of file!");
+            break;
+        }
+
+        MappedIndex.emplace(pRecord->Hash, pRecord);
+        Offset += pRecord->Size;
+    }
+
+    ValidSize   = Offset;
+    FileSize    = Offset;
+    RewriteFile = (Offset != MappedSize);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns the Context settings that feed into texture calc but can be changed
+/// after the Context is created.
+/////////////////////////////////////////////////////////////////////////////////////
+uint64_t GmmLib::LayoutCache::GetContextState()
+{
+    uint64_t State[] = {pGmmLibContext->GetAllowedPaddingFor64KbPagesPercentage(),
+                        pGmmLibContext->GetAllowedPaddingFor64KBTileSurf(),
+                        pGmmLibContext->GetInternalGpuVaRangeLimit()};
+
+    return __GmmHash64(State, sizeof(State), Key);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Checks that a record read from the file is complete and intact.
+/// @param[in]  pRecord: record to check
+/// @param[in]  Avail: bytes of file left at pRecord
+/// @return     true if the record can be used
+/////////////////////////////////////////////////////////////////////////////////////
+bool GmmLib::LayoutCache::ValidateRecord(const GMM_LAYOUT_CACHE_RECORD *pRecord, size_t Avail)
+{
+    const size_t ChecksumStart = offsetof(GMM_LAYOUT_CACHE_RECORD, Params);
+
+    if(Avail < sizeof(GMM_LAYOUT_CACHE_RECORD) ||
+       pRecord->Magic != GMM_LAYOUT_CACHE_RECORD_MAGIC ||
+       pRecord->Size < sizeof(GMM_LAYOUT_CACHE_RECORD) ||
+       pRecord->Size > Avail ||
+       pRecord->Size != GMM_LAYOUT_CACHE_ALIGN(pRecord->Size) ||
+       pRecord->BlobSize > pRecord->Size - sizeof(GMM_LAYOUT_CACHE_RECORD))
+    {
+        return false;
+    }
+
+    if(pRecord->Checksum != __GmmHash64((const uint8_t *)pRecord + ChecksumStart, pRecord->Size - ChecksumStart, 0))
+    {
+        return false;
+    }
+
+    return pRecord->Hash == GmmLayoutCacheHash(pRecord->ContextState, pRecord->ClientType, pRecord->Params);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Finds the record for a normalized create request, in the mapped file first
+/// and then among the records added by this process.
+/// @return     matching record, NULL if none
+/////////////////////////////////////////////////////////////////////////////////////
+const GMM_LAYOUT_CACHE_RECORD *GmmLib::LayoutCache::Find(uint64_t Hash, uint64_t ContextState, GMM_CLIENT ClientType,
+                                                         const GMM_RESCREATE_PARAMS &Params)
+{
+    const GMM_LAYOUT_CACHE_RECORD *pRecord = NULL;
+
+    // MappedIndex is immutable after Open(), so it's read without the lock.
+    auto Mapped = MappedIndex.find(Hash);
+    if(Mapped != MappedIndex.end())
+    {
+        pRecord = Mapped->second;
+    }
+    else
+    {
+        pthread_mutex_lock(&Mutex);
+        auto Local = Added.find(Hash);
+        if(Local != Added.end())
+        {
+            pRecord = (const GMM_LAYOUT_CACHE_RECORD *)Local->second.data();
+        }
+        pthread_mutex_unlock(&Mutex);
+    }
+
+    if(pRecord &&
+       pRecord->ContextState == ContextState &&
+       pRecord->ClientType == (uint32_t)ClientType &&
+       memcmp(&pRecord->Params, &Params, sizeof(Params)) == 0)
+    {
+        return pRecord;
+    }
+
+    return NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Looks up a create request and, on a hit, initializes ResInfo from the cached
+/// layout instead of running texture calc. On a miss or a layout that no longer
+/// imports, ResInfo is left as constructed for the caller to Create().
+/// @param[in]      ClientType: client creating the resource
+/// @param[in/out]  CreateParams: create params; updated like Create() would on a hit
+/// @param[out]     ResInfo: freshly constructed resource info object
+/// @return         true on a hit
+/////////////////////////////////////////////////////////////////////////////////////
+bool GmmLib::LayoutCache::Lookup(GMM_CLIENT ClientType, GMM_RESCREATE_PARAMS &CreateParams, GmmResourceInfoCommon &ResInfo)
+{
+    const GMM_LAYOUT_CACHE_RECORD *pRecord;
+    GMM_RESCREATE_PARAMS           Params;
+    GMM_RESOURCE_INFO *            pPreallocatedResInfo = CreateParams.pPreallocatedResInfo;
+    uint32_t                       PreallocatedFlag     = CreateParams.Flags.Info.__PreallocatedResInfo;
+    uint64_t                       ContextState;
+
+    if(!GmmLayoutCacheEligible(CreateParams))
+    {
+        return false;
+    }
+
+    Params = CreateParams;
+    GmmLayoutCacheNormalize(Params);
+    ContextState = GetContextState();
+
+    pRecord = Find(GmmLayoutCacheHash(ContextState, ClientType, Params), ContextState, ClientType, Params);
+    if(!pRecord ||
+       ResInfo.CreateFromLayout(*pGmmLibContext, pRecord + 1, pRecord->BlobSize) != GMM_SUCCESS)
+    {
+        return false;
+    }
+
+    CreateParams                                  = pRecord->OutParams;
+    CreateParams.pPreallocatedResInfo             = pPreallocatedResInfo;
+    CreateParams.Flags.Info.__PreallocatedResInfo = PreallocatedFlag;
+    ResInfo.GetResFlags().Info.__PreallocatedResInfo = PreallocatedFlag;
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Adds a freshly created resource to the cache. The record is usable by this
+/// process right away and written to the file by a background thread.
+/// @param[in]  ClientType: client that created the resource
+/// @param[in]  CreateParams: create params as passed to Create()
+/// @param[in]  OutParams: create params after Create()
+/// @param[in]  ResInfo: created resource info object
+/////////////////////////////////////////////////////////////////////////////////////
+void GmmLib::LayoutCache::Insert(GMM_CLIENT ClientType, const GMM_RESCREATE_PARAMS &CreateParams,
+                                 const GMM_RESCREATE_PARAMS &OutParams, GmmResourceInfoCommon &ResInfo)
+{
+    GMM_LAYOUT_CACHE_RECORD *pRecord;
+    GMM_RESCREATE_PARAMS     Params;
+    std::vector<uint8_t>     Bytes;
+    uint64_t                 ContextState;
+    uint64_t                 Hash;
+    uint32_t                 BlobSize;
+    uint32_t                 Size;
+
+    if(!GmmLayoutCacheEligible(CreateParams))
+    {
+        return;
+    }
+
+    Params = CreateParams;
+    GmmLayoutCacheNormalize(Params);
+    ContextState = GetContextState();
+    Hash         = GmmLayoutCacheHash(ContextState, ClientType, Params);
+
+    if(Find(Hash, ContextState, ClientType, Params))
+    {
+        return;
+    }
+
+    BlobSize = ResInfo.SerializeLayout(NULL, 0);
+    if(!BlobSize)
+    {
+        return;
+    }
+
+    Size = GMM_LAYOUT_CACHE_ALIGN(sizeof(GMM_LAYOUT_CACHE_RECORD) + BlobSize);
+    Bytes.resize(Size);
+
+    pRecord               = (GMM_LAYOUT_CACHE_RECORD *)Bytes.data();
+    pRecord->Magic        = GMM_LAYOUT_CACHE_RECORD_MAGIC;
+    pRecord->Size         = Size;
+    pRecord->Hash         = Hash;
+    pRecord->ContextState = ContextState;
+    pRecord->ClientType   = ClientType;
+    pRecord->BlobSize     = BlobSize;
+    pRecord->Params       = Params;
+    memcpy(&pRecord->OutParams, &OutParams, sizeof(OutParams));
+    GmmLayoutCacheNormalize(pRecord->OutParams);
+
+    if(ResInfo.SerializeLayout(pRecord + 1, BlobSize) != BlobSize)
+    {
+        return;
+    }
+
+    pRecord->Checksum = __GmmHash64(&pRecord->Params, Size - offsetof(GMM_LAYOUT_CACHE_RECORD, Params), 0);
+
+    pthread_mutex_lock(&Mutex);
+    if(FileSize + Size <= GMM_LAYOUT_CACHE_MAX_FILE_SIZE)
+    {
+        auto Inserted = Added.emplace(Hash, std::move(Bytes));
+        if(Inserted.second)
+        {
+            FileSize += Size;
+            Pending.push_back(&Inserted.first->second);
+
+            if(!WriterStarted)
+            {
+                WriterStarted = (pthread_create(&Writer, NULL, WriterThread, this) == 0);
+            }
+            pthread_cond_signal(&WorkCond);
+        }
+    }
+    pthread_mutex_unlock(&Mutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Waits until all records added so far have been written to the file.
+/////////////////////////////////////////////////////////////////////////////////////
+void GmmLib::LayoutCache::Flush()
+{
+    pthread_mutex_lock(&Mutex);
+    while(WriterStarted && (!Pending.empty() || Writing))
+    {
+        pthread_cond_wait(&IdleCond, &Mutex);
+    }
+    pthread_mutex_unlock(&Mutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Opens the cache file for appending. A missing, stale or corrupt file is
+/// first replaced by a fresh one holding the records that were still valid;
+/// the replacement is renamed into place so concurrent readers never see a
+/// partially written header.
+/// @return     file descriptor, -1 on failure
+/////////////////////////////////////////////////////////////////////////////////////
+int GmmLib::LayoutCache::OpenForAppend()
+{
+    if(RewriteFile)
+    {
+        GMM_LAYOUT_CACHE_FILE_HEADER Hdr = {};
+        std::string                  TmpPath = Path + "." + std::to_string(getpid()) + ".tmp";
+        bool                         Written;
+        int                          Fd;
+
+        Hdr.Magic         = GMM_LAYOUT_CACHE_MAGIC;
+        Hdr.Version       = GMM_LAYOUT_CACHE_VERSION;
+        Hdr.Key           = Key;
+        Hdr.ParamsSize    = sizeof(GMM_RESCREATE_PARAMS);
+        Hdr.LayoutVersion = GMM_RESOURCE_LAYOUT_VERSION;
+
+        Fd = open(TmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if(Fd < 0)
+        {
+            return -1;
+        }
+
+        Written = GmmLayoutCacheWrite(Fd, &Hdr, sizeof(Hdr));
+        if(Written && ValidSize > sizeof(Hdr))
+        {
+            Written = GmmLayoutCacheWrite(Fd, pMapped + sizeof(Hdr), ValidSize - sizeof(Hdr));
+        }
+        close(Fd);
+
+        if(!Written || rename(TmpPath.c_str(), Path.c_str()) != 0)
+        {
+            unlink(TmpPath.c_str());
+            return -1;
+        }
+
+        RewriteFile = false;
+    }
+
+    return open(Path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Writer thread body: appends queued records until the cache is destroyed.
+/// Each batch is written under an advisory lock so records from concurrent
+/// processes don't interleave.
+/////////////////////////////////////////////////////////////////////////////////////
+void GmmLib::LayoutCache::WriterLoop()
+{
+    std::vector<const std::vector<uint8_t> *> Batch;
+    int                                       Fd     = -1;
+    bool                                      Failed = false;
+
+    pthread_mutex_lock(&Mutex);
+    for(;;)
+    {
+        while(Pending.empty() && !StopWriter)
+        {
+            pthread_cond_wait(&WorkCond, &Mutex);
+        }
+
+        if(Pending.empty())
+        {
+            break;
+        }
+
+        Batch.swap(Pending);
+        Writing = true;
+        pthread_mutex_unlock(&Mutex);
+
+        if(Fd < 0 && !Failed)
+        {
+            Fd     = OpenForAppend();
+            Failed = (Fd < 0);
+        }
+
+        if(Fd >= 0)
+        {
+            flock(Fd, LOCK_EX);
+            for(auto pBytes : Batch)
+            {
+                if(!GmmLayoutCacheWrite(Fd, pBytes->data(), pBytes->size()))
+                {
+                    break;
+                }
+            }
+            flock(Fd, LOCK_UN);
+        }
+        Batch.clear();
+
+        pthread_mutex_lock(&Mutex);
+        Writing = false;
+        pthread_cond_broadcast(&IdleCond);
+    }
+    pthread_mutex_unlock(&Mutex);
+
+    if(Fd >= 0)
+    {
+        close(Fd);
+    }
+}
+
+void *GmmLib::LayoutCache::WriterThread(void *pCache)
+{
+    static_cast<LayoutCache *>(pCache)->WriterLoop();
+    return NULL;
+}
+
+#endif // GMM_LAYOUT_CACHE_SUPPORTED
@@ -57,6 +57,8 @@ GMM_RESOURCE_INFO *GMM_STDCALL GmmResCreate(GMM_RESCREATE_PARAMS *pCreateParams,
         }
     }
 
+    pCreateParams->Flags.Info.__SizeOnly = 0; // Internal flag, only set by size estimation
+
     if(pRes->Create(*pLibContext, *pCreateParams) != GMM_SUCCESS)
     {
         goto ERROR_CASE;
@@ -1199,7 +1201,7 @@ GMM_SURFACESTATE_FORMAT GMM_STDCALL GmmGetSurfaceStateFormat(GMM_RESOURCE_FORMAT
     GMM_DPF_ENTER;
     return ((Format > GMM_FORMAT_INVALID) &&
             (Format < GMM_RESOURCE_FORMATS)) ?
-           pGmmLibContext->GetPlatformInfo().FormatTable[Format].SurfaceStateFormat :
+           __GmmFormatTraits.SurfaceStateFormat[Format] :
            GMM_SURFACESTATE_FORMAT_INVALID;
 }
 
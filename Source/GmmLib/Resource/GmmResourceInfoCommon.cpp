@@ -101,6 +101,7 @@ GMM_STATUS GMM_STDCALL GmmLib::GmmResourceInfoCommon::Create(GMM_RESCREATE_PARAM
     GMM_STATUS Status = GMM_ERROR;
     // ToDo: Only Vk is using this Create API directly. Derive the GmmLibCOntext from the ClientContext stored in
     // ResInfo object.
+    CreateParams.Flags.Info.__SizeOnly = 0; // Internal flag, only set by size estimation
     Status = Create(*(reinterpret_cast<GMM_CLIENT_CONTEXT *>(pClientContext)->GetLibContext()), CreateParams);
 
     return Status;
@@ -133,7 +134,7 @@ GMM_STATUS GMM_STDCALL GmmLib::GmmResourceInfoCommon::CreateCustomRes(Context &G
     if((CreateParams.Format > GMM_FORMAT_INVALID) &&
        (CreateParams.Format < GMM_RESOURCE_FORMATS))
     {
-        BitsPerPixel = GetGmmLibContext()->GetPlatformInfo().FormatTable[CreateParams.Format].Element.BitsPer;
+        BitsPerPixel = __GmmFormatTraits.BitsPerElement[CreateParams.Format];
     }
     else
     {
@@ -157,6 +158,7 @@ GMM_STATUS GMM_STDCALL GmmLib::GmmResourceInfoCommon::CreateCustomRes(Context &G
     Surf.MaxLod                  = 1;
     Surf.ArraySize               = 1;
     Surf.CpTag                   = CreateParams.CpTag;
+    Surf.Flags.Info.__SizeOnly   = 0; // Internal flag, only set by size estimation
 
 #if(_DEBUG || _RELEASE_INTERNAL)
     Surf.Platform = GetGmmLibContext()->GetPlatformInfo().Platform;
@@ -267,7 +269,7 @@ GMM_STATUS GMM_STDCALL GmmLib::GmmResourceInfoCommon::CreateCustomRes_2(Context
     if((CreateParams.Format > GMM_FORMAT_INVALID) &&
        (CreateParams.Format < GMM_RESOURCE_FORMATS))
     {
-        BitsPerPixel = GetGmmLibContext()->GetPlatformInfo().FormatTable[CreateParams.Format].Element.BitsPer;
+        BitsPerPixel = __GmmFormatTraits.BitsPerElement[CreateParams.Format];
     }
     else
     {
@@ -291,6 +293,7 @@ GMM_STATUS GMM_STDCALL GmmLib::GmmResourceInfoCommon::CreateCustomRes_2(Context
     Surf.MaxLod                  = 1;
     Surf.ArraySize               = 1;
     Surf.CpTag                   = CreateParams.CpTag;
+    Surf.Flags.Info.__SizeOnly   = 0; // Internal flag, only set by size estimation
 
 #if(_DEBUG || _RELEASE_INTERNAL)
     Surf.Platform = GetGmmLibContext()->GetPlatformInfo().Platform;
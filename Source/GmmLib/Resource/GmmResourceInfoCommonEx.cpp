@@ -37,7 +37,7 @@ bool GmmLib::GmmResourceInfoCommon::CopyClientParams(GMM_RESCREATE_PARAMS &Creat
     if((CreateParams.Format > GMM_FORMAT_INVALID) &&
        (CreateParams.Format < GMM_RESOURCE_FORMATS))
     {
-        BitsPerPixel = GetGmmLibContext()->GetPlatformInfo().FormatTable[CreateParams.Format].Element.BitsPer;
+        BitsPerPixel = __GmmFormatTraits.BitsPerElement[CreateParams.Format];
     }
     else
     {
@@ -201,7 +201,7 @@ bool GmmLib::GmmResourceInfoCommon::CopyClientParams(GMM_RESCREATE_PARAMS &Creat
             CreateParams.MultiTileArch.GpuVaMappingSet = __BIT(GpuTile);
 #else
             GpuTile                                    = 0;
-            CreateParams.MultiTileArch.GpuVaMappingSet = GetGmmLibContext()->GetGtSysInfo()->MultiTileArchInfo.TileMask;
+            CreateParams.MultiTileArch.GpuVaMappingSet = GetGmmLibContext()->GetGtSysInfoPtr()->MultiTileArchInfo.TileMask;
 #endif
 
             CreateParams.MultiTileArch.Enable = true;
@@ -856,8 +856,8 @@ uint8_t GMM_STDCALL GmmLib::GmmResourceInfoCommon::ValidateParams()
            // Legitimate cases
            MultiTileArch.Enable &&
            (Surf.Flags.Info.NonLocalOnly || MultiTileArch.LocalMemEligibilitySet) &&
-           ((MultiTileArch.GpuVaMappingSet & GetGmmLibContext()->GetGtSysInfo()->MultiTileArchInfo.TileMask) == MultiTileArch.GpuVaMappingSet) &&
-           ((MultiTileArch.LocalMemEligibilitySet & GetGmmLibContext()->GetGtSysInfo()->MultiTileArchInfo.TileMask) == MultiTileArch.LocalMemEligibilitySet) &&
+           ((MultiTileArch.GpuVaMappingSet & GetGmmLibContext()->GetGtSysInfoPtr()->MultiTileArchInfo.TileMask) == MultiTileArch.GpuVaMappingSet) &&
+           ((MultiTileArch.LocalMemEligibilitySet & GetGmmLibContext()->GetGtSysInfoPtr()->MultiTileArchInfo.TileMask) == MultiTileArch.LocalMemEligibilitySet) &&
            ((MultiTileArch.LocalMemEligibilitySet & MultiTileArch.LocalMemPreferredSet) == MultiTileArch.LocalMemPreferredSet)))
         {
             GMM_ASSERTDPF(0, "Invalid MultiTileArch allocation params");
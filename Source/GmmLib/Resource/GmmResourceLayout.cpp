@@ -0,0 +1,753 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+
+#include "Internal/Common/GmmLibInc.h"
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// @file GmmResourceLayout.cpp
+/// @brief Export/import of a resource's computed layout as a versioned, pointer-
+///        free blob (see GMM_RESOURCE_LAYOUT_HEADER in GmmResourceInfoExt.h).
+/////////////////////////////////////////////////////////////////////////////////////
+
+#define GMM_LAYOUT_ALIGN(Size) GFX_ALIGN((Size), sizeof(uint64_t))
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Folds the 64-bit content hash of the section area into the header checksum.
+/////////////////////////////////////////////////////////////////////////////////////
+static uint32_t GmmLayoutChecksum(const uint8_t *pSections, uint32_t Size)
+{
+    uint64_t Hash = __GmmHash64(pSections, Size, GMM_RESOURCE_LAYOUT_VERSION);
+    return (uint32_t)(Hash ^ (Hash >> 32));
+}
+
+// The surface payload must not depend on the compiler's padding, nor drift from
+// the structs it is converted from.
+C_ASSERT(sizeof(GMM_RESOURCE_LAYOUT_SURFACE) ==
+         (7 + GMM_RESOURCE_LAYOUT_OFFSET_WORDS) * sizeof(uint64_t) + 42 * sizeof(uint32_t) + 2 * GMM_RESOURCE_LAYOUT_MMC_ENTRIES);
+C_ASSERT(GMM_RESOURCE_LAYOUT_MMC_ENTRIES == GMM_MAX_MMC_INDEX);
+C_ASSERT(offsetof(GMM_PLANAR_OFFSET_INFO, NoOfPlanes) == GMM_RESOURCE_LAYOUT_OFFSET_WORDS * sizeof(uint64_t));
+C_ASSERT(sizeof(GMM_2D_TEXTURE_OFFSET_INFO_T) == GMM_RESOURCE_LAYOUT_OFFSET_WORDS * sizeof(uint64_t));
+
+// GMM_RESOURCE_FLAG fields as stored in the surface payload: each group is
+// packed from bit 0 of its Flags* words, in list order, at the given width.
+// Append new flags only; moving or dropping one changes the payload and needs
+// a GMM_RESOURCE_LAYOUT_VERSION bump.
+#define GMM_LAYOUT_FLAGS_GPU(FLAG)  \
+    FLAG(CameraCapture, 1)          \
+    FLAG(CCS, 1)                    \
+    FLAG(ColorDiscard, 1)           \
+    FLAG(ColorSeparation, 1)        \
+    FLAG(ColorSeparationRGBX, 1)    \
+    FLAG(Constant, 1)               \
+    FLAG(Depth, 1)                  \
+    FLAG(FlipChain, 1)              \
+    FLAG(FlipChainPreferred, 1)     \
+    FLAG(HistoryBuffer, 1)          \
+    FLAG(HiZ, 1)                    \
+    FLAG(Index, 1)                  \
+    FLAG(IndirectClearColor, 1)     \
+    FLAG(InstructionFlat, 1)        \
+    FLAG(InterlacedScan, 1)         \
+    FLAG(MCS, 1)                    \
+    FLAG(MMC, 1)                    \
+    FLAG(MotionComp, 1)             \
+    FLAG(NoRestriction, 1)          \
+    FLAG(Overlay, 1)                \
+    FLAG(Presentable, 1)            \
+    FLAG(ProceduralTexture, 1)      \
+    FLAG(Query, 1)                  \
+    FLAG(RenderTarget, 1)           \
+    FLAG(S3d, 1)                    \
+    FLAG(S3dDx, 1)                  \
+    FLAG(__S3dNonPacked, 1)         \
+    FLAG(__S3dWidi, 1)              \
+    FLAG(ScratchFlat, 1)            \
+    FLAG(SeparateStencil, 1)        \
+    FLAG(State, 1)                  \
+    FLAG(StateDx9ConstantBuffer, 1) \
+    FLAG(Stream, 1)                 \
+    FLAG(TextApi, 1)                \
+    FLAG(Texture, 1)                \
+    FLAG(TiledResource, 1)          \
+    FLAG(TilePool, 1)               \
+    FLAG(UnifiedAuxSurface, 1)      \
+    FLAG(Vertex, 1)                 \
+    FLAG(Video, 1)                  \
+    FLAG(__NonMsaaTileXCcs, 1)      \
+    FLAG(__NonMsaaTileYCcs, 1)      \
+    FLAG(__MsaaTileMcs, 1)          \
+    FLAG(__NonMsaaLinearCCS, 1)
+
+#define GMM_LAYOUT_FLAGS_INFO(FLAG)   \
+    FLAG(AllowVirtualPadding, 1)      \
+    FLAG(BigPage, 1)                  \
+    FLAG(Cacheable, 1)                \
+    FLAG(ContigPhysMemoryForiDART, 1) \
+    FLAG(CornerTexelMode, 1)          \
+    FLAG(ExistingSysMem, 1)           \
+    FLAG(ForceResidency, 1)           \
+    FLAG(Gfdt, 1)                     \
+    FLAG(GttMapType, 5)               \
+    FLAG(HardwareProtected, 1)        \
+    FLAG(KernelModeMapped, 1)         \
+    FLAG(LayoutBelow, 1)              \
+    FLAG(LayoutMono, 1)               \
+    FLAG(LayoutRight, 1)              \
+    FLAG(LocalOnly, 1)                \
+    FLAG(Linear, 1)                   \
+    FLAG(MediaCompressed, 1)          \
+    FLAG(NoOptimizationPadding, 1)    \
+    FLAG(NoPhysMemory, 1)             \
+    FLAG(NotLockable, 1)              \
+    FLAG(NonLocalOnly, 1)             \
+    FLAG(StdSwizzle, 1)               \
+    FLAG(PseudoStdSwizzle, 1)         \
+    FLAG(Undefined64KBSwizzle, 1)     \
+    FLAG(RedecribedPlanes, 1)         \
+    FLAG(RenderCompressed, 1)         \
+    FLAG(Rotated, 1)                  \
+    FLAG(Shared, 1)                   \
+    FLAG(SoftwareProtected, 1)        \
+    FLAG(SVM, 1)                      \
+    FLAG(TiledW, 1)                   \
+    FLAG(TiledX, 1)                   \
+    FLAG(TiledY, 1)                   \
+    FLAG(TiledYf, 1)                  \
+    FLAG(TiledYs, 1)                  \
+    FLAG(WddmProtected, 1)            \
+    FLAG(XAdapter, 1)                 \
+    FLAG(__PreallocatedResInfo, 1)    \
+    FLAG(__PreWddm2SVM, 1)            \
+    FLAG(Tile4, 1)                    \
+    FLAG(Tile64, 1)                   \
+    FLAG(__SizeOnly, 1)
+
+#define GMM_LAYOUT_FLAGS_WA(FLAG)                  \
+    FLAG(GTMfx2ndLevelBatchRingSizeAlign, 1)       \
+    FLAG(ILKNeedAvcMprRowStore32KAlign, 1)         \
+    FLAG(ILKNeedAvcDmvBuffer32KAlign, 1)           \
+    FLAG(NoBufferSamplerPadding, 1)                \
+    FLAG(NoLegacyPlanarLinearVideoRestrictions, 1) \
+    FLAG(CHVAstcSkipVirtualMips, 1)                \
+    FLAG(DisablePackedMipTail, 1)                  \
+    FLAG(__ForceOtherHVALIGN4, 1)                  \
+    FLAG(DisableDisplayCcsClearColor, 1)           \
+    FLAG(DisableDisplayCcsCompression, 1)          \
+    FLAG(PreGen12FastClearOnly, 1)                 \
+    FLAG(MediaPipeUsage, 1)                        \
+    FLAG(ForceStdAllocAlign, 1)                    \
+    FLAG(DeniableLocalOnlyForCompression, 1)
+
+#define GMM_LAYOUT_FLAG_BITS(Name, Bits) +(Bits)
+
+// Gpu has its spare bits declared, so every flag must be listed; the other
+// groups have to fit their payload words.
+C_ASSERT(0 GMM_LAYOUT_FLAGS_GPU(GMM_LAYOUT_FLAG_BITS) + 20 == 8 * sizeof(((GMM_RESOURCE_FLAG *)0)->Gpu));
+C_ASSERT(0 GMM_LAYOUT_FLAGS_GPU(GMM_LAYOUT_FLAG_BITS) <= 8 * sizeof(((GMM_RESOURCE_LAYOUT_SURFACE *)0)->FlagsGpu));
+C_ASSERT(0 GMM_LAYOUT_FLAGS_INFO(GMM_LAYOUT_FLAG_BITS) <= 8 * sizeof(((GMM_RESOURCE_LAYOUT_SURFACE *)0)->FlagsInfo));
+C_ASSERT(0 GMM_LAYOUT_FLAGS_WA(GMM_LAYOUT_FLAG_BITS) <= 8 * sizeof(((GMM_RESOURCE_LAYOUT_SURFACE *)0)->FlagsWa));
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Stores a Bits wide flag value at bit Pos of pWords and advances Pos.
+/////////////////////////////////////////////////////////////////////////////////////
+static void GmmLayoutPutFlag(uint32_t *pWords, uint32_t &Pos, uint32_t Bits, uint32_t Value)
+{
+    for(uint32_t i = 0; i < Bits; i++, Pos++)
+    {
+        pWords[Pos / 32] |= ((Value >> i) & 1) << (Pos % 32);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns the Bits wide flag value at bit Pos of pWords and advances Pos.
+/////////////////////////////////////////////////////////////////////////////////////
+static uint32_t GmmLayoutGetFlag(const uint32_t *pWords, uint32_t &Pos, uint32_t Bits)
+{
+    uint32_t Value = 0;
+
+    for(uint32_t i = 0; i < Bits; i++, Pos++)
+    {
+        Value |= ((pWords[Pos / 32] >> (Pos % 32)) & 1) << i;
+    }
+
+    return Value;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Converts GMM_RESOURCE_FLAG into the surface payload's flag words.
+///
+/// @param[in]  Flags: Flags to export
+/// @param[out] Surf: Payload, zeroed by the caller
+/////////////////////////////////////////////////////////////////////////////////////
+static void GmmLayoutPackFlags(const GMM_RESOURCE_FLAG &Flags, GMM_RESOURCE_LAYOUT_SURFACE &Surf)
+{
+    uint32_t Pos;
+
+#define GMM_LAYOUT_PACK_FLAG(Name, Bits) GmmLayoutPutFlag(pWords, Pos, (Bits), Group.Name);
+    {
+        const auto &Group  = Flags.Gpu;
+        uint32_t *  pWords = Surf.FlagsGpu;
+        Pos                = 0;
+        GMM_LAYOUT_FLAGS_GPU(GMM_LAYOUT_PACK_FLAG)
+    }
+    {
+        const auto &Group  = Flags.Info;
+        uint32_t *  pWords = Surf.FlagsInfo;
+        Pos                = 0;
+        GMM_LAYOUT_FLAGS_INFO(GMM_LAYOUT_PACK_FLAG)
+    }
+    {
+        const auto &Group  = Flags.Wa;
+        uint32_t *  pWords = Surf.FlagsWa;
+        Pos                = 0;
+        GMM_LAYOUT_FLAGS_WA(GMM_LAYOUT_PACK_FLAG)
+    }
+#undef GMM_LAYOUT_PACK_FLAG
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Converts the surface payload's flag words back into GMM_RESOURCE_FLAG.
+///
+/// @param[in]  Surf: Payload from the blob
+/// @param[out] Flags: Flags, zeroed by the caller
+/////////////////////////////////////////////////////////////////////////////////////
+static void GmmLayoutUnpackFlags(const GMM_RESOURCE_LAYOUT_SURFACE &Surf, GMM_RESOURCE_FLAG &Flags)
+{
+    uint32_t Pos;
+
+#define GMM_LAYOUT_UNPACK_FLAG(Name, Bits) Group.Name = GmmLayoutGetFlag(pWords, Pos, (Bits));
+    {
+        auto &          Group  = Flags.Gpu;
+        const uint32_t *pWords = Surf.FlagsGpu;
+        Pos                    = 0;
+        GMM_LAYOUT_FLAGS_GPU(GMM_LAYOUT_UNPACK_FLAG)
+    }
+    {
+        auto &          Group  = Flags.Info;
+        const uint32_t *pWords = Surf.FlagsInfo;
+        Pos                    = 0;
+        GMM_LAYOUT_FLAGS_INFO(GMM_LAYOUT_UNPACK_FLAG)
+    }
+    {
+        auto &          Group  = Flags.Wa;
+        const uint32_t *pWords = Surf.FlagsWa;
+        Pos                    = 0;
+        GMM_LAYOUT_FLAGS_WA(GMM_LAYOUT_UNPACK_FLAG)
+    }
+#undef GMM_LAYOUT_UNPACK_FLAG
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Converts a GMM_TEXTURE_INFO into the fixed-width surface section payload.
+///
+/// @param[in]  TexInfo: Texture info to export
+/// @param[out] Surf: Payload, zeroed by the caller
+/////////////////////////////////////////////////////////////////////////////////////
+static void GmmLayoutPackSurface(const GMM_TEXTURE_INFO &TexInfo, GMM_RESOURCE_LAYOUT_SURFACE &Surf)
+{
+    const GMM_2D_TEXTURE_OFFSET_INFO_T &Offset2D = TexInfo.OffsetInfo.Texture2DOffsetInfo;
+
+    Surf.BaseWidth      = TexInfo.BaseWidth;
+    Surf.Pitch          = TexInfo.Pitch;
+    Surf.OverridePitch  = TexInfo.OverridePitch;
+    Surf.Size           = TexInfo.Size;
+    Surf.CCSize         = TexInfo.CCSize;
+    Surf.UnpaddedSize   = TexInfo.UnpaddedSize;
+    Surf.SizeReportToOS = TexInfo.SizeReportToOS;
+
+    Surf.OffsetInfo[0] = Offset2D.ArrayQPitchLock;
+    Surf.OffsetInfo[1] = Offset2D.ArrayQPitchRender;
+    for(uint32_t i = 0; i < GMM_MAX_MIPMAP; i++)
+    {
+        Surf.OffsetInfo[2 + i] = Offset2D.Offset[i];
+    }
+    Surf.NoOfPlanes          = TexInfo.OffsetInfo.Plane.NoOfPlanes;
+    Surf.IsTileAlignedPlanes = TexInfo.OffsetInfo.Plane.IsTileAlignedPlanes ? 1 : 0;
+
+    Surf.Type         = TexInfo.Type;
+    Surf.Format       = TexInfo.Format;
+    Surf.BitsPerPixel = TexInfo.BitsPerPixel;
+    GmmLayoutPackFlags(TexInfo.Flags, Surf);
+    Surf.BaseHeight        = TexInfo.BaseHeight;
+    Surf.Depth             = TexInfo.Depth;
+    Surf.MaxLod            = TexInfo.MaxLod;
+    Surf.ArraySize         = TexInfo.ArraySize;
+    Surf.CpTag             = TexInfo.CpTag;
+    Surf.CachePolicyUsage  = TexInfo.CachePolicy.Usage;
+    Surf.MsaaSamplePattern = TexInfo.MSAA.SamplePattern;
+    Surf.MsaaNumSamples    = TexInfo.MSAA.NumSamples;
+
+    Surf.ArraySpacingSingleLod = TexInfo.Alignment.ArraySpacingSingleLod;
+    Surf.BaseAlignment         = TexInfo.Alignment.BaseAlignment;
+    Surf.HAlign                = TexInfo.Alignment.HAlign;
+    Surf.VAlign                = TexInfo.Alignment.VAlign;
+    Surf.DAlign                = TexInfo.Alignment.DAlign;
+    Surf.MipTailStartLod       = TexInfo.Alignment.MipTailStartLod;
+    Surf.PackedMipStartLod     = TexInfo.Alignment.PackedMipStartLod;
+    Surf.PackedMipWidth        = TexInfo.Alignment.PackedMipWidth;
+    Surf.PackedMipHeight       = TexInfo.Alignment.PackedMipHeight;
+    Surf.QPitch                = TexInfo.Alignment.QPitch;
+
+    Surf.TileMode     = TexInfo.TileMode;
+    Surf.CCSModeAlign = TexInfo.CCSModeAlign;
+    Surf.LegacyFlags  = TexInfo.LegacyFlags;
+
+    Surf.S3dDisplayModeHeight   = TexInfo.S3d.DisplayModeHeight;
+    Surf.S3dNumBlankActiveLines = TexInfo.S3d.NumBlankActiveLines;
+    Surf.S3dRFrameOffset        = TexInfo.S3d.RFrameOffset;
+    Surf.S3dBlankAreaOffset     = TexInfo.S3d.BlankAreaOffset;
+    Surf.S3dTallBufferHeight    = TexInfo.S3d.TallBufferHeight;
+    Surf.S3dTallBufferSize      = TexInfo.S3d.TallBufferSize;
+    Surf.S3dIsRFrame            = TexInfo.S3d.IsRFrame;
+#if(LHDM)
+    Surf.MsFormat = TexInfo.MsFormat;
+#endif
+    Surf.SegmentOverrideSeg1       = TexInfo.SegmentOverride.Seg1;
+    Surf.SegmentOverrideEvict      = TexInfo.SegmentOverride.Evict;
+    Surf.MaximumRenamingListLength = TexInfo.MaximumRenamingListLength;
+
+    memcpy(Surf.MmcMode, TexInfo.MmcMode, sizeof(Surf.MmcMode));
+    memcpy(Surf.MmcHint, TexInfo.MmcHint, sizeof(Surf.MmcHint));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Converts a surface section payload back into a GMM_TEXTURE_INFO.
+///
+/// @param[in]  Surf: Payload from the blob
+/// @param[out] TexInfo: Texture info, fields not in the payload are zeroed
+/////////////////////////////////////////////////////////////////////////////////////
+static void GmmLayoutUnpackSurface(const GMM_RESOURCE_LAYOUT_SURFACE &Surf, GMM_TEXTURE_INFO &TexInfo)
+{
+    GMM_2D_TEXTURE_OFFSET_INFO_T &Offset2D = TexInfo.OffsetInfo.Texture2DOffsetInfo;
+
+    TexInfo = GMM_TEXTURE_INFO();
+
+    TexInfo.BaseWidth      = Surf.BaseWidth;
+    TexInfo.Pitch          = Surf.Pitch;
+    TexInfo.OverridePitch  = Surf.OverridePitch;
+    TexInfo.Size           = Surf.Size;
+    TexInfo.CCSize         = Surf.CCSize;
+    TexInfo.UnpaddedSize   = Surf.UnpaddedSize;
+    TexInfo.SizeReportToOS = Surf.SizeReportToOS;
+
+    Offset2D.ArrayQPitchLock   = Surf.OffsetInfo[0];
+    Offset2D.ArrayQPitchRender = Surf.OffsetInfo[1];
+    for(uint32_t i = 0; i < GMM_MAX_MIPMAP; i++)
+    {
+        Offset2D.Offset[i] = Surf.OffsetInfo[2 + i];
+    }
+    TexInfo.OffsetInfo.Plane.NoOfPlanes          = Surf.NoOfPlanes;
+    TexInfo.OffsetInfo.Plane.IsTileAlignedPlanes = (Surf.IsTileAlignedPlanes != 0);
+
+    TexInfo.Type         = (GMM_RESOURCE_TYPE)Surf.Type;
+    TexInfo.Format       = (GMM_RESOURCE_FORMAT)Surf.Format;
+    TexInfo.BitsPerPixel = Surf.BitsPerPixel;
+    GmmLayoutUnpackFlags(Surf, TexInfo.Flags);
+    TexInfo.BaseHeight           = Surf.BaseHeight;
+    TexInfo.Depth                = Surf.Depth;
+    TexInfo.MaxLod               = Surf.MaxLod;
+    TexInfo.ArraySize            = Surf.ArraySize;
+    TexInfo.CpTag                = Surf.CpTag;
+    TexInfo.CachePolicy.Usage    = (GMM_RESOURCE_USAGE_TYPE)Surf.CachePolicyUsage;
+    TexInfo.MSAA.SamplePattern   = (GMM_MSAA_SAMPLE_PATTERN)Surf.MsaaSamplePattern;
+    TexInfo.MSAA.NumSamples      = Surf.MsaaNumSamples;
+
+    TexInfo.Alignment.ArraySpacingSingleLod = (uint8_t)Surf.ArraySpacingSingleLod;
+    TexInfo.Alignment.BaseAlignment         = Surf.BaseAlignment;
+    TexInfo.Alignment.HAlign                = Surf.HAlign;
+    TexInfo.Alignment.VAlign                = Surf.VAlign;
+    TexInfo.Alignment.DAlign                = Surf.DAlign;
+    TexInfo.Alignment.MipTailStartLod       = Surf.MipTailStartLod;
+    TexInfo.Alignment.PackedMipStartLod     = Surf.PackedMipStartLod;
+    TexInfo.Alignment.PackedMipWidth        = Surf.PackedMipWidth;
+    TexInfo.Alignment.PackedMipHeight       = Surf.PackedMipHeight;
+    TexInfo.Alignment.QPitch                = Surf.QPitch;
+
+    TexInfo.TileMode     = (GMM_TILE_MODE)Surf.TileMode;
+    TexInfo.CCSModeAlign = Surf.CCSModeAlign;
+    TexInfo.LegacyFlags  = Surf.LegacyFlags;
+
+    TexInfo.S3d.DisplayModeHeight   = Surf.S3dDisplayModeHeight;
+    TexInfo.S3d.NumBlankActiveLines = Surf.S3dNumBlankActiveLines;
+    TexInfo.S3d.RFrameOffset        = Surf.S3dRFrameOffset;
+    TexInfo.S3d.BlankAreaOffset     = Surf.S3dBlankAreaOffset;
+    TexInfo.S3d.TallBufferHeight    = Surf.S3dTallBufferHeight;
+    TexInfo.S3d.TallBufferSize      = Surf.S3dTallBufferSize;
+    TexInfo.S3d.IsRFrame            = (uint8_t)Surf.S3dIsRFrame;
+#if(LHDM)
+    TexInfo.MsFormat = (D3DDDIFORMAT)Surf.MsFormat;
+#endif
+    TexInfo.SegmentOverride.Seg1      = Surf.SegmentOverrideSeg1;
+    TexInfo.SegmentOverride.Evict     = Surf.SegmentOverrideEvict;
+    TexInfo.MaximumRenamingListLength = Surf.MaximumRenamingListLength;
+
+    memcpy(TexInfo.MmcMode, Surf.MmcMode, sizeof(TexInfo.MmcMode));
+    memcpy(TexInfo.MmcHint, Surf.MmcHint, sizeof(TexInfo.MmcHint));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Sanity checks a GMM_TEXTURE_INFO read from a layout blob before it replaces
+/// the computed one: enums in range, no process-local flags, and sizes, mip and
+/// plane offsets within the platform's limits and the surface itself.
+///
+/// @param[in]  PlatformInfo: Platform of the importing context
+/// @param[in]  TexInfo: Texture info from the blob
+/// @return     true if usable
+/////////////////////////////////////////////////////////////////////////////////////
+static bool GmmLayoutValidateTexInfo(const GMM_PLATFORM_INFO &PlatformInfo, const GMM_TEXTURE_INFO &TexInfo)
+{
+    const GMM_GFX_SIZE_T MaxSize = (GMM_GFX_SIZE_T)GFX_MAX(PlatformInfo.SurfaceMaxSize, (int64_t)PlatformInfo.NoRestriction.MaxWidth);
+    uint32_t             MaxArraySize;
+
+    if(!((TexInfo.Type > RESOURCE_INVALID) &&
+         (TexInfo.Type < GMM_MAX_HW_RESOURCE_TYPE) &&
+         (TexInfo.Format > GMM_FORMAT_INVALID) &&
+         (TexInfo.Format < GMM_RESOURCE_FORMATS) &&
+         (TexInfo.TileMode < GMM_TILE_MODES) &&
+         (TexInfo.CachePolicy.Usage < GMM_RESOURCE_USAGE_MAX) &&
+         !TexInfo.Flags.Info.ExistingSysMem &&
+         !TexInfo.Flags.Info.__PreallocatedResInfo &&
+         !TexInfo.Flags.Info.__SizeOnly))
+    {
+        return false;
+    }
+
+    MaxArraySize = (TexInfo.Type == RESOURCE_CUBE) ? PlatformInfo.CubeSurface.MaxArraySize :
+                                                     PlatformInfo.Texture2DSurface.MaxArraySize;
+
+    if((TexInfo.MaxLod >= GMM_MAX_MIPMAP) ||
+       (TexInfo.ArraySize > MaxArraySize) ||
+       (TexInfo.Size > MaxSize) ||
+       (TexInfo.Pitch > MaxSize))
+    {
+        return false;
+    }
+
+    if(GmmIsPlanar(TexInfo.Format))
+    {
+        const GMM_PLANAR_OFFSET_INFO &Plane   = TexInfo.OffsetInfo.Plane;
+        const GMM_GFX_SIZE_T          MaxRows = TexInfo.Pitch ? (TexInfo.Size / TexInfo.Pitch) : TexInfo.Size;
+
+        if((Plane.NoOfPlanes >= GMM_MAX_PLANE) ||
+           (Plane.ArrayQPitch > TexInfo.Size))
+        {
+            return false;
+        }
+
+        for(uint32_t i = 0; i < GMM_MAX_PLANE; i++)
+        {
+            if((Plane.X[i] > TexInfo.Pitch) ||
+               (Plane.Y[i] > MaxRows) ||
+               (Plane.UnAligned.Height[i] > MaxRows) ||
+               (Plane.Aligned.Height[i] > MaxRows))
+            {
+                return false;
+            }
+        }
+    }
+    else if(TexInfo.Type == RESOURCE_3D)
+    {
+        const GMM_3D_TEXTURE_OFFSET_INFO_T &Offset3D = TexInfo.OffsetInfo.Texture3DOffsetInfo;
+
+        if(Offset3D.Mip0SlicePitch > TexInfo.Size)
+        {
+            return false;
+        }
+
+        for(uint32_t Mip = 0; Mip <= TexInfo.MaxLod; Mip++)
+        {
+            if(Offset3D.Offset[Mip] > TexInfo.Size)
+            {
+                return false;
+            }
+        }
+    }
+    else
+    {
+        const GMM_2D_TEXTURE_OFFSET_INFO_T &Offset2D = TexInfo.OffsetInfo.Texture2DOffsetInfo;
+
+        if((Offset2D.ArrayQPitchLock > TexInfo.Size) ||
+           (Offset2D.ArrayQPitchRender > TexInfo.Size))
+        {
+            return false;
+        }
+
+        for(uint32_t Mip = 0; Mip <= TexInfo.MaxLod; Mip++)
+        {
+            if(Offset2D.Offset[Mip] > TexInfo.Size)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Writes the computed layout of this resource (main, aux and secondary aux
+/// surfaces incl. their mip/plane offsets, MOCS and multi-tile placement) into
+/// a versioned blob. Process-local state (SVM/system memory addresses, private
+/// data, context pointers) is not exported.
+///
+/// @param[out] pBlob: Destination, may be NULL to query the required size
+/// @param[in]  BlobSize: Size of pBlob in bytes
+/// @return     Size of the blob in bytes (written only if it fit in BlobSize),
+///             0 if the resource can't be exported.
+/////////////////////////////////////////////////////////////////////////////////////
+uint32_t GMM_STDCALL GmmLib::GmmResourceInfoCommon::SerializeLayout(void *pBlob, uint32_t BlobSize)
+{
+    const GMM_TEXTURE_INFO *pSurfs[]   = {&Surf, &AuxSurf, &AuxSecSurf};
+    const uint32_t          SurfIds[]  = {GMM_LAYOUT_SECTION_MAIN_SURF, GMM_LAYOUT_SECTION_AUX_SURF, GMM_LAYOUT_SECTION_AUX_SEC_SURF};
+    uint32_t                NumSections = 1;
+    uint32_t                Size;
+
+    // System memory backed resources are tied to the creating process.
+    if(Surf.Flags.Info.ExistingSysMem)
+    {
+        GMM_ASSERTDPF(0, "ExistingSysMem resources can't be serialized!");
+        return 0;
+    }
+
+    Size = sizeof(GMM_RESOURCE_LAYOUT_HEADER) +
+           sizeof(GMM_RESOURCE_LAYOUT_SECTION) + GMM_LAYOUT_ALIGN(sizeof(GMM_RESOURCE_LAYOUT_RESOURCE));
+    for(uint32_t i = 0; i < sizeof(pSurfs) / sizeof(pSurfs[0]); i++)
+    {
+        if(pSurfs[i]->Type != RESOURCE_INVALID)
+        {
+            Size += sizeof(GMM_RESOURCE_LAYOUT_SECTION) + GMM_LAYOUT_ALIGN(sizeof(GMM_RESOURCE_LAYOUT_SURFACE));
+            NumSections++;
+        }
+    }
+
+    if(!pBlob || BlobSize < Size)
+    {
+        return Size;
+    }
+
+    uint8_t *                    pByte  = (uint8_t *)pBlob;
+    GMM_RESOURCE_LAYOUT_HEADER * pHdr   = (GMM_RESOURCE_LAYOUT_HEADER *)pByte;
+    GMM_RESOURCE_LAYOUT_SECTION *pSect  = (GMM_RESOURCE_LAYOUT_SECTION *)(pHdr + 1);
+    GMM_RESOURCE_LAYOUT_RESOURCE Res    = {};
+
+    memset(pBlob, 0, Size);
+
+    pHdr->Magic            = GMM_RESOURCE_LAYOUT_MAGIC;
+    pHdr->Version          = GMM_RESOURCE_LAYOUT_VERSION;
+    pHdr->NumSections      = NumSections;
+    pHdr->Size             = Size;
+    pHdr->ProductFamily    = GetGmmLibContext()->GetPlatformInfo().Platform.eProductFamily;
+    pHdr->RenderCoreFamily = GetGmmLibContext()->GetPlatformInfo().Platform.eRenderCoreFamily;
+
+    Res.RotateInfo             = RotateInfo;
+    Res.MOCS                   = GetMOCS().DwordValue;
+    Res.MultiTileEnable        = MultiTileArch.Enable;
+    Res.MultiTileInstanced     = MultiTileArch.TileInstanced;
+    Res.GpuVaMappingSet        = MultiTileArch.GpuVaMappingSet;
+    Res.LocalMemEligibilitySet = MultiTileArch.LocalMemEligibilitySet;
+    Res.LocalMemPreferredSet   = MultiTileArch.LocalMemPreferredSet;
+
+    pSect->Id   = GMM_LAYOUT_SECTION_RESOURCE;
+    pSect->Size = sizeof(Res);
+    memcpy(pSect + 1, &Res, sizeof(Res));
+    pSect = (GMM_RESOURCE_LAYOUT_SECTION *)((uint8_t *)(pSect + 1) + GMM_LAYOUT_ALIGN(sizeof(Res)));
+
+    for(uint32_t i = 0; i < sizeof(pSurfs) / sizeof(pSurfs[0]); i++)
+    {
+        if(pSurfs[i]->Type == RESOURCE_INVALID)
+        {
+            continue;
+        }
+
+        GMM_TEXTURE_INFO            TexInfo = *pSurfs[i];
+        GMM_RESOURCE_LAYOUT_SURFACE SurfOut = {};
+
+        TexInfo.Flags.Info.__PreallocatedResInfo = 0; // Describes this process' allocation only.
+        GmmLayoutPackSurface(TexInfo, SurfOut);
+
+        pSect->Id   = SurfIds[i];
+        pSect->Size = sizeof(SurfOut);
+        memcpy(pSect + 1, &SurfOut, sizeof(SurfOut));
+        pSect = (GMM_RESOURCE_LAYOUT_SECTION *)((uint8_t *)(pSect + 1) + GMM_LAYOUT_ALIGN(sizeof(SurfOut)));
+    }
+
+    pHdr->Checksum = GmmLayoutChecksum(pByte + sizeof(*pHdr), Size - sizeof(*pHdr));
+
+    return Size;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Populates this resource from a blob written by SerializeLayout() instead of
+/// running texture calc. The blob is validated (magic, version, size, checksum,
+/// platform, section sizes and surface fields) and the MOCS it was exported
+/// with must match this context's cache policy for the resource usage.
+///
+/// @param[in]  GmmLib Context: Reference to ::GmmLibContext
+/// @param[in]  pBlob: Layout blob
+/// @param[in]  BlobSize: Size of pBlob in bytes
+/// @return     ::GMM_STATUS
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_STATUS GMM_STDCALL GmmLib::GmmResourceInfoCommon::CreateFromLayout(Context &GmmLibContext, const void *pBlob, uint32_t BlobSize)
+{
+    const uint8_t *                   pByte = (const uint8_t *)pBlob;
+    const GMM_RESOURCE_LAYOUT_HEADER *pHdr  = (const GMM_RESOURCE_LAYOUT_HEADER *)pBlob;
+    const GMM_PLATFORM_INFO &         PlatformInfo = GmmLibContext.GetPlatformInfo();
+    const GMM_CACHE_POLICY_ELEMENT *  pCachePolicy = GmmLibContext.GetCachePolicyUsage();
+    GMM_RESOURCE_LAYOUT_RESOURCE      Res;
+    GMM_TEXTURE_INFO                  TexInfo[3];
+    bool                              Found[3]    = {false, false, false};
+    bool                              FoundRes    = false;
+    uint32_t                          Offset;
+
+    GMM_DPF_ENTER;
+
+    __GMM_ASSERTPTR(pBlob, GMM_INVALIDPARAM);
+
+    // Blobs come from another process; reject bad ones without asserting.
+    if(BlobSize < sizeof(GMM_RESOURCE_LAYOUT_HEADER) ||
+       pHdr->Magic != GMM_RESOURCE_LAYOUT_MAGIC ||
+       pHdr->Version != GMM_RESOURCE_LAYOUT_VERSION ||
+       pHdr->Size < sizeof(GMM_RESOURCE_LAYOUT_HEADER) ||
+       pHdr->Size > BlobSize)
+    {
+        GMM_DPF_CRITICAL("Invalid resource layout blob!");
+        return GMM_INVALIDPARAM;
+    }
+
+    if(pHdr->ProductFamily != (uint32_t)PlatformInfo.Platform.eProductFamily ||
+       pHdr->RenderCoreFamily != (uint32_t)PlatformInfo.Platform.eRenderCoreFamily)
+    {
+        GMM_DPF_CRITICAL("Resource layout computed for another platform!");
+        return GMM_INVALIDPARAM;
+    }
+
+    if(pHdr->Checksum != GmmLayoutChecksum(pByte + sizeof(*pHdr), pHdr->Size - sizeof(*pHdr)))
+    {
+        GMM_DPF_CRITICAL("Resource layout blob corrupted!");
+        return GMM_INVALIDPARAM;
+    }
+
+    Offset = sizeof(*pHdr);
+    for(uint32_t i = 0; i < pHdr->NumSections; i++)
+    {
+        GMM_RESOURCE_LAYOUT_SECTION Sect;
+
+        if(Offset + sizeof(Sect) > pHdr->Size)
+        {
+            return GMM_INVALIDPARAM;
+        }
+        memcpy(&Sect, pByte + Offset, sizeof(Sect));
+        Offset += sizeof(Sect);
+
+        if(Sect.Size > pHdr->Size - Offset)
+        {
+            return GMM_INVALIDPARAM;
+        }
+
+        switch(Sect.Id)
+        {
+            case GMM_LAYOUT_SECTION_RESOURCE:
+                if(Sect.Size != sizeof(Res))
+                {
+                    return GMM_INVALIDPARAM;
+                }
+                memcpy(&Res, pByte + Offset, sizeof(Res));
+                FoundRes = true;
+                break;
+            case GMM_LAYOUT_SECTION_MAIN_SURF:
+            case GMM_LAYOUT_SECTION_AUX_SURF:
+            case GMM_LAYOUT_SECTION_AUX_SEC_SURF:
+            {
+                GMM_RESOURCE_LAYOUT_SURFACE SurfIn;
+                uint32_t                    SurfIdx = Sect.Id - GMM_LAYOUT_SECTION_MAIN_SURF;
+                if(Sect.Size != sizeof(SurfIn))
+                {
+                    return GMM_INVALIDPARAM;
+                }
+                memcpy(&SurfIn, pByte + Offset, sizeof(SurfIn));
+                GmmLayoutUnpackSurface(SurfIn, TexInfo[SurfIdx]);
+                if(!GmmLayoutValidateTexInfo(PlatformInfo, TexInfo[SurfIdx]))
+                {
+                    return GMM_INVALIDPARAM;
+                }
+                Found[SurfIdx] = true;
+                break;
+            }
+            default:
+                // Newer section within the same version; not needed here.
+                break;
+        }
+
+        Offset += GMM_LAYOUT_ALIGN(Sect.Size);
+    }
+
+    if(!FoundRes || !Found[0])
+    {
+        GMM_DPF_CRITICAL("Resource layout blob missing sections!");
+        return GMM_INVALIDPARAM;
+    }
+
+    if(!pCachePolicy[TexInfo[0].CachePolicy.Usage].Initialized)
+    {
+        GMM_DPF_CRITICAL("Resource layout usage not initialized!");
+        return GMM_INVALIDPARAM;
+    }
+
+    GET_GMM_CLIENT_TYPE(pClientContext, ClientType);
+    pGmmUmdLibContext = reinterpret_cast<uint64_t>(&GmmLibContext);
+
+    Surf          = TexInfo[0];
+    AuxSurf       = Found[1] ? TexInfo[1] : GMM_TEXTURE_INFO();
+    AuxSecSurf    = Found[2] ? TexInfo[2] : GMM_TEXTURE_INFO();
+    RotateInfo    = Res.RotateInfo;
+
+    MultiTileArch                        = GMM_MULTI_TILE_ARCH();
+    MultiTileArch.Enable                 = Res.MultiTileEnable ? 1 : 0;
+    MultiTileArch.TileInstanced          = Res.MultiTileInstanced ? 1 : 0;
+    MultiTileArch.GpuVaMappingSet        = Res.GpuVaMappingSet;
+    MultiTileArch.LocalMemEligibilitySet = Res.LocalMemEligibilitySet;
+    MultiTileArch.LocalMemPreferredSet   = Res.LocalMemPreferredSet;
+
+    // The exported MOCS must still be what this context programs for the usage,
+    // otherwise the peers disagree on cache policy and the layout isn't shareable.
+    if(GetMOCS().DwordValue != Res.MOCS)
+    {
+        GMM_DPF_CRITICAL("Resource layout MOCS mismatch!");
+
+        // Leave the object as constructed, so callers can fall back to Create().
+        Surf          = GMM_TEXTURE_INFO();
+        AuxSurf       = GMM_TEXTURE_INFO();
+        AuxSecSurf    = GMM_TEXTURE_INFO();
+        RotateInfo    = 0;
+        MultiTileArch = GMM_MULTI_TILE_ARCH();
+        return GMM_ERROR;
+    }
+
+#if(_DEBUG || _RELEASE_INTERNAL)
+    Surf.Platform = PlatformInfo.Platform;
+#endif
+
+    GMM_DPF_EXIT;
+
+    return GMM_SUCCESS;
+}
@@ -0,0 +1,165 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+
+#include "Internal/Common/GmmLibInc.h"
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// @file GmmResourcePadding.cpp
+/// @brief Accounting of the bytes a resource allocates beyond its natural texel
+///        footprint (see GMM_RESOURCE_PADDING_INFO in GmmResourceInfoExt.h).
+/////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns the densely packed size of one slice/sample of the given mip.
+///
+/// @param[in]  pTexInfo: Texture info of the resource
+/// @param[in]  pPlatform: Platform info, for the compression block dimensions
+/// @param[in]  pTextureCalc: Texture calc, for the mip dimensions
+/// @param[in]  MipLevel: Mip to size
+/// @return     Size in bytes
+/////////////////////////////////////////////////////////////////////////////////////
+static uint64_t GmmPaddingMipLogicalSize(GMM_TEXTURE_INFO *       pTexInfo,
+                                         const GMM_PLATFORM_INFO *pPlatform,
+                                         GMM_TEXTURE_CALC *       pTextureCalc,
+                                         uint32_t                 MipLevel)
+{
+    const GMM_FORMAT_ENTRY &FormatEntry = pPlatform->FormatTable[pTexInfo->Format];
+
+    uint64_t BlockWidth  = GFX_MAX(FormatEntry.Element.Width, 1);
+    uint64_t BlockHeight = GFX_MAX(FormatEntry.Element.Height, 1);
+    uint64_t BlockDepth  = GFX_MAX(FormatEntry.Element.Depth, 1);
+
+    uint64_t Width  = pTextureCalc->GmmTexGetMipWidth(pTexInfo, MipLevel);
+    uint64_t Height = GFX_MAX(pTextureCalc->GmmTexGetMipHeight(pTexInfo, MipLevel), 1);
+    uint64_t Depth  = (pTexInfo->Type == RESOURCE_3D) ?
+                     GFX_MAX(pTextureCalc->GmmTexGetMipDepth(pTexInfo, MipLevel), 1) :
+                     1;
+
+    return GFX_CEIL_DIV(Width, BlockWidth) *
+           GFX_CEIL_DIV(Height, BlockHeight) *
+           GFX_CEIL_DIV(Depth, BlockDepth) *
+           (pTexInfo->BitsPerPixel >> 3);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Breaks the allocation size of the resource down into its logical texel size
+/// and the padding added on top of it, by cause. The cause fields plus
+/// LogicalSize always sum to GetSizeAllocation(); main-surface padding that
+/// can't be attributed to the mip tail or plane gaps is reported as
+/// TileAlignment.
+///
+/// @param[out] PaddingInfo: Size breakdown, see ::GMM_RESOURCE_PADDING_INFO
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::GmmResourceInfoCommon::GetPaddingInfo(GMM_RESOURCE_PADDING_INFO &PaddingInfo)
+{
+    const GMM_PLATFORM_INFO *pPlatform;
+    GMM_TEXTURE_CALC *       pTextureCalc;
+    uint64_t                 Slices, Samples, Remaining;
+    uint64_t                 Logical = 0, MipTail = 0, PlaneGap = 0;
+
+    memset(&PaddingInfo, 0, sizeof(PaddingInfo));
+
+    pPlatform    = GMM_OVERRIDE_PLATFORM_INFO(&Surf, GetGmmLibContext());
+    pTextureCalc = GMM_OVERRIDE_TEXTURE_CALC(&Surf, GetGmmLibContext());
+
+    Slices  = GFX_MAX(Surf.ArraySize, 1) * ((Surf.Type == RESOURCE_CUBE) ? 6 : 1);
+    Samples = GFX_MAX(Surf.MSAA.NumSamples, 1);
+
+    if((Surf.Format > GMM_FORMAT_INVALID) && (Surf.Format < GMM_RESOURCE_FORMATS) &&
+       pPlatform && pTextureCalc)
+    {
+        if(GmmIsPlanar(Surf.Format) && (Surf.OffsetInfo.Plane.NoOfPlanes > 1))
+        {
+            // Planes are counted at the full row width of the Y plane, as laid out.
+            GMM_PLANAR_OFFSET_INFO &Plane     = Surf.OffsetInfo.Plane;
+            uint64_t                RowBytes  = Surf.BaseWidth * (Surf.BitsPerPixel >> 3);
+            uint64_t                Rows      = Plane.UnAligned.Height[GMM_PLANE_Y];
+            uint64_t                PlaneEnd  = Plane.Y[GMM_PLANE_Y] + Plane.UnAligned.Height[GMM_PLANE_Y];
+            uint32_t                LastPlane = GFX_MIN(Plane.NoOfPlanes, (uint32_t)GMM_MAX_PLANE - 1);
+
+            for(uint32_t p = GMM_PLANE_U; p <= LastPlane; p++)
+            {
+                Rows += Plane.UnAligned.Height[p];
+                if(Plane.Y[p] > PlaneEnd)
+                {
+                    PlaneGap += Plane.Y[p] - PlaneEnd;
+                }
+                PlaneEnd = GFX_MAX(PlaneEnd, Plane.Y[p] + Plane.UnAligned.Height[p]);
+            }
+
+            Logical  = RowBytes * Rows * Slices;
+            PlaneGap = PlaneGap * Surf.Pitch * Slices;
+        }
+        else
+        {
+            uint32_t MipTailStartLod = GMM_TILED_RESOURCE_NO_MIP_TAIL;
+
+            if((Surf.Flags.Info.TiledYf || GMM_IS_64KB_TILE(Surf.Flags)) &&
+               (Surf.Alignment.MipTailStartLod <= Surf.MaxLod) &&
+               (Surf.TileMode < GMM_TILE_MODES))
+            {
+                MipTailStartLod = Surf.Alignment.MipTailStartLod;
+            }
+
+            for(uint32_t MipLevel = 0; MipLevel <= Surf.MaxLod; MipLevel++)
+            {
+                uint64_t MipSize = GmmPaddingMipLogicalSize(&Surf, pPlatform, pTextureCalc, MipLevel);
+
+                Logical += MipSize;
+                if(MipLevel >= MipTailStartLod)
+                {
+                    MipTail += MipSize;
+                }
+            }
+
+            Logical *= Slices * Samples;
+
+            if(MipTailStartLod != GMM_TILED_RESOURCE_NO_MIP_TAIL)
+            {
+                // Every 2D slice gets its own tail tile; a 3D tail is a single tile.
+                uint64_t TailSlots = (Surf.Type == RESOURCE_3D) ? 1 : Slices;
+                uint64_t TailBytes = pPlatform->TileInfo[Surf.TileMode].LogicalSize * TailSlots;
+                uint64_t TailUsed  = MipTail * Slices;
+
+                MipTail = (TailBytes > TailUsed) ? (TailBytes - TailUsed) : 0;
+            }
+            else
+            {
+                MipTail = 0;
+            }
+        }
+    }
+
+    PaddingInfo.AllocationSize = GetSizeAllocation();
+    PaddingInfo.Aux            = AuxSurf.Size + AuxSecSurf.Size;
+    PaddingInfo.Page64KB       = PaddingInfo.AllocationSize - (Surf.Size + PaddingInfo.Aux);
+
+    // Keep the breakdown summing to the allocation even where the estimates overshoot.
+    PaddingInfo.LogicalSize    = GFX_MIN(Logical, (uint64_t)Surf.Size);
+    Remaining                  = Surf.Size - PaddingInfo.LogicalSize;
+    PaddingInfo.PlaneAlignment = GFX_MIN(PlaneGap, Remaining);
+    Remaining -= PaddingInfo.PlaneAlignment;
+    PaddingInfo.MipTail = GFX_MIN(MipTail, Remaining);
+    Remaining -= PaddingInfo.MipTail;
+    PaddingInfo.TileAlignment = Remaining;
+}
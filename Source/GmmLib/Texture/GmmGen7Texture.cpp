@@ -497,9 +497,13 @@ void GmmLib::GmmGen7TextureCalc::Fill2DTexOffsetAddress(GMM_TEXTURE_INFO *pTexIn
         pTexInfo->OffsetInfo.Texture2DOffsetInfo.ArrayQPitchLock   = ArrayQPitch * pTexInfo->Pitch;
     }
 
-    for(i = 0; i <= pTexInfo->MaxLod; i++)
+    // Size-only estimates never query per-mip offsets.
+    if(!pTexInfo->Flags.Info.__SizeOnly)
     {
-        pTexInfo->OffsetInfo.Texture2DOffsetInfo.Offset[i] = Get2DTexOffsetAddressPerMip(pTexInfo, i);
+        for(i = 0; i <= pTexInfo->MaxLod; i++)
+        {
+            pTexInfo->OffsetInfo.Texture2DOffsetInfo.Offset[i] = Get2DTexOffsetAddressPerMip(pTexInfo, i);
+        }
     }
 
     GMM_DPF_EXIT;
@@ -378,9 +378,14 @@ void GmmLib::GmmGen8TextureCalc::Fill2DTexOffsetAddress(GMM_TEXTURE_INFO *pTexIn
         pTexInfo->OffsetInfo.Texture2DOffsetInfo.ArrayQPitchLock   = ArrayQPitch * pTexInfo->Pitch;
     }
 
-    for(i = 0; i <= pTexInfo->MaxLod; i++)
+    // Size-only estimates never query per-mip offsets, except for the CHV ASTC
+    // WA which trims mip0 tiles based on Offset[1].
+    if(!pTexInfo->Flags.Info.__SizeOnly || pTexInfo->Flags.Wa.CHVAstcSkipVirtualMips)
     {
-        pTexInfo->OffsetInfo.Texture2DOffsetInfo.Offset[i] = Get2DTexOffsetAddressPerMip(pTexInfo, i);
+        for(i = 0; i <= pTexInfo->MaxLod; i++)
+        {
+            pTexInfo->OffsetInfo.Texture2DOffsetInfo.Offset[i] = Get2DTexOffsetAddressPerMip(pTexInfo, i);
+        }
     }
 
     GMM_DPF_EXIT;
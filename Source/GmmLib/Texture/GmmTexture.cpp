@@ -547,9 +547,9 @@ void GmmLib::GmmTextureCalc::GetCompressionBlockDimensions(GMM_RESOURCE_FORMAT F
     {
         if((Format > GMM_FORMAT_INVALID) && (Format < GMM_RESOURCE_FORMATS))
         {
-            *pWidth  = pGmmLibContext->GetPlatformInfo().FormatTable[Format].Element.Width;
-            *pHeight = pGmmLibContext->GetPlatformInfo().FormatTable[Format].Element.Height;
-            *pDepth  = pGmmLibContext->GetPlatformInfo().FormatTable[Format].Element.Depth;
+            *pWidth  = __GmmFormatTraits.BlockWidth[Format];
+            *pHeight = __GmmFormatTraits.BlockHeight[Format];
+            *pDepth  = __GmmFormatTraits.BlockDepth[Format];
         }
         else
         {
@@ -191,23 +191,31 @@ GMM_STATUS GmmTexLinearCCS(GMM_LIB_CONTEXT *pGmmLibContext, GMM_TEXTURE_INFO *pT
 /// outputs offset, size and pitch information by enforcing all the h/w alignment
 /// and restrictions.
 ///
+/// The pipeline is a template over the texture calc class it runs on. The
+/// default AllocateTexture instantiates it for GmmTextureCalc, i.e. every stage
+/// is a virtual call; GmmPlatformTextureCalc instantiates it for a sealed
+/// platform class so the stages are bound at compile time.
+///
+/// @param[in]  pTextureCalc: Texture calc object to run the stages on
 /// @param[in]  pTexInfo: Reference to GMM_TEXTURE_INFO
 ///
 /// @return     ::GMM_STATUS
 /////////////////////////////////////////////////////////////////////////////////////
-GMM_STATUS GmmLib::GmmTextureCalc::AllocateTexture(GMM_TEXTURE_INFO *pTexInfo)
+template <class TextureCalcT>
+GMM_STATUS GmmLib::GmmTextureCalc::AllocateTextureT(TextureCalcT *pTextureCalc, GMM_TEXTURE_INFO *pTexInfo)
 {
     __GMM_BUFFER_TYPE Restrictions = {0};
     GMM_STATUS        Status;
 
     __GMM_ASSERTPTR(pTexInfo, GMM_ERROR);
-    __GMM_ASSERTPTR(pGmmLibContext, GMM_ERROR);
+    __GMM_ASSERTPTR(pTextureCalc, GMM_ERROR);
+    __GMM_ASSERTPTR(pTextureCalc->pGmmLibContext, GMM_ERROR);
 
     GMM_DPF_ENTER;
 
-    GetTexRestrictions(pTexInfo, &Restrictions);
+    pTextureCalc->GetTexRestrictions(pTexInfo, &Restrictions);
 
-    if((Status = __GmmTexFillHAlignVAlign(pTexInfo, pGmmLibContext)) != GMM_SUCCESS)
+    if((Status = __GmmTexFillHAlignVAlign(pTexInfo, pTextureCalc->pGmmLibContext)) != GMM_SUCCESS)
     {
         return Status;
     }
@@ -215,14 +223,14 @@ GMM_STATUS GmmLib::GmmTextureCalc::AllocateTexture(GMM_TEXTURE_INFO *pTexInfo)
     // Planar YUV resources treated special. Packed YUV treated like 2D/3D/Cube...
     if(GmmIsPlanar(pTexInfo->Format))
     {
-        Status = FillTexPlanar(pTexInfo, &Restrictions);
+        Status = pTextureCalc->FillTexPlanar(pTexInfo, &Restrictions);
 
         if((Status == GMM_SUCCESS) &&
-           (ValidateTexInfo(pTexInfo, &Restrictions) == false))
+           (pTextureCalc->ValidateTexInfo(pTexInfo, &Restrictions) == false))
         {
             return GMM_ERROR;
         }
-        if(GMM_SUCCESS != FillTexCCS(pTexInfo, pTexInfo))
+        if(GMM_SUCCESS != pTextureCalc->FillTexCCS(pTexInfo, pTexInfo))
         {
             return GMM_ERROR;
         }
@@ -230,7 +238,7 @@ GMM_STATUS GmmLib::GmmTextureCalc::AllocateTexture(GMM_TEXTURE_INFO *pTexInfo)
     }
     else
     {
-        SetTileMode(pTexInfo);
+        pTextureCalc->SetTileMode(pTexInfo);
     }
 
     switch(pTexInfo->Type)
@@ -249,25 +257,25 @@ GMM_STATUS GmmLib::GmmTextureCalc::AllocateTexture(GMM_TEXTURE_INFO *pTexInfo)
         case RESOURCE_WGBOX_ENCODE_REFERENCE:
 #endif
         {
-            Status = FillTex2D(pTexInfo, &Restrictions);
+            Status = pTextureCalc->FillTex2D(pTexInfo, &Restrictions);
 
             break;
         }
         case RESOURCE_1D:
         {
-            Status = FillTex1D(pTexInfo, &Restrictions);
+            Status = pTextureCalc->FillTex1D(pTexInfo, &Restrictions);
 
             break;
         }
         case RESOURCE_3D:
         {
-            Status = FillTex3D(pTexInfo, &Restrictions);
+            Status = pTextureCalc->FillTex3D(pTexInfo, &Restrictions);
 
             break;
         }
         case RESOURCE_CUBE:
         {
-            Status = FillTexCube(pTexInfo, &Restrictions);
+            Status = pTextureCalc->FillTexCube(pTexInfo, &Restrictions);
 
             break;
         }
@@ -290,7 +298,7 @@ GMM_STATUS GmmLib::GmmTextureCalc::AllocateTexture(GMM_TEXTURE_INFO *pTexInfo)
         case RESOURCE_WGBOX_ENCODE_TFD:
 #endif
         {
-            Status = FillTexBlockMem(pTexInfo, &Restrictions);
+            Status = pTextureCalc->FillTexBlockMem(pTexInfo, &Restrictions);
             break;
         }
         default:
@@ -300,12 +308,12 @@ GMM_STATUS GmmLib::GmmTextureCalc::AllocateTexture(GMM_TEXTURE_INFO *pTexInfo)
         }
     };
 
-    if(ValidateTexInfo(pTexInfo, &Restrictions) == false)
+    if(pTextureCalc->ValidateTexInfo(pTexInfo, &Restrictions) == false)
     {
         return GMM_ERROR;
     }
 
-    if(GMM_SUCCESS != FillTexCCS(pTexInfo, pTexInfo))
+    if(GMM_SUCCESS != pTextureCalc->FillTexCCS(pTexInfo, pTexInfo))
     {
         return GMM_ERROR;
     }
@@ -313,6 +321,28 @@ GMM_STATUS GmmLib::GmmTextureCalc::AllocateTexture(GMM_TEXTURE_INFO *pTexInfo)
     return Status;
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+/// Top level function for allocating a mip map or planar surface through the
+/// virtual texture calc hierarchy.
+///
+/// @param[in]  pTexInfo: Reference to GMM_TEXTURE_INFO
+///
+/// @return     ::GMM_STATUS
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_STATUS GmmLib::GmmTextureCalc::AllocateTexture(GMM_TEXTURE_INFO *pTexInfo)
+{
+    return AllocateTextureT(this, pTexInfo);
+}
+
+#ifdef GMM_SPECIALIZED_TEXTURE_CALC
+template GMM_STATUS GmmLib::GmmTextureCalc::AllocateTextureT(GmmLib::GmmPlatformTextureCalc<GmmLib::GmmGen7TextureCalc> *, GMM_TEXTURE_INFO *);
+template GMM_STATUS GmmLib::GmmTextureCalc::AllocateTextureT(GmmLib::GmmPlatformTextureCalc<GmmLib::GmmGen8TextureCalc> *, GMM_TEXTURE_INFO *);
+template GMM_STATUS GmmLib::GmmTextureCalc::AllocateTextureT(GmmLib::GmmPlatformTextureCalc<GmmLib::GmmGen9TextureCalc> *, GMM_TEXTURE_INFO *);
+template GMM_STATUS GmmLib::GmmTextureCalc::AllocateTextureT(GmmLib::GmmPlatformTextureCalc<GmmLib::GmmGen10TextureCalc> *, GMM_TEXTURE_INFO *);
+template GMM_STATUS GmmLib::GmmTextureCalc::AllocateTextureT(GmmLib::GmmPlatformTextureCalc<GmmLib::GmmGen11TextureCalc> *, GMM_TEXTURE_INFO *);
+template GMM_STATUS GmmLib::GmmTextureCalc::AllocateTextureT(GmmLib::GmmPlatformTextureCalc<GmmLib::GmmGen12TextureCalc> *, GMM_TEXTURE_INFO *);
+#endif
+
 GMM_STATUS GmmLib::GmmTextureCalc::FillTexCCS(GMM_TEXTURE_INFO *pBaseSurf, GMM_TEXTURE_INFO *pTexInfo)
 {
     GMM_UNREFERENCED_PARAMETER(pBaseSurf);
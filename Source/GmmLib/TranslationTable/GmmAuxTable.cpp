@@ -52,12 +52,11 @@ GMM_STATUS GmmLib::AuxTable::MapNullCCS(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX
     GMM_GFX_SIZE_T  L1TableSize  = (GMM_L1_SIZE(AUXTT, GetGmmLibContext())) * (!WA16K(GetGmmLibContext()) ? GMM_KBYTE(64) : GMM_KBYTE(16)); //Each AuxTable entry maps 16K main-surface
     GMM_GFX_ADDRESS Addr         = 0;
     GMM_GFX_ADDRESS L3GfxAddress = 0;
+    uint8_t         PoolUnused   = 0;
     GMM_CLIENT      ClientType;
 
     GET_GMM_CLIENT_TYPE(pClientContext, ClientType);
 
-    EnterCriticalSection(&TTLock);
-
     DoNotWait |= (!UmdContext || !UmdContext->pCommandQueueHandle);
 
     if(TTL3.L3Handle)
@@ -66,7 +65,6 @@ GMM_STATUS GmmLib::AuxTable::MapNullCCS(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX
     }
     else
     {
-        LeaveCriticalSection(&TTLock);
         return GMM_ERROR;
     }
 
@@ -76,6 +74,8 @@ GMM_STATUS GmmLib::AuxTable::MapNullCCS(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX
         UmdContext->pCommandQueueHandle);
     }
 
+    TableEntryWriter Writer(PageTableMgr->TTCb, PageTableMgr->GetTranslationTableCallbacksExt(), DoNotWait ? NULL : UmdContext->pCommandQueueHandle);
+
     // For each L1 table
     for(Addr = GFX_ALIGN_FLOOR(BaseAdr, L1TableSize); // Start at begining of L1 table
         Addr < BaseAdr + Size;
@@ -95,6 +95,8 @@ GMM_STATUS GmmLib::AuxTable::MapNullCCS(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX
             EndAddress = BaseAdr + Size;
         }
 
+        EnterL2CriticalSection(GMM_L3_ENTRY_IDX(AUXTT, StartAddress));
+
         GetL1L2TableAddr(StartAddress,
                          &L1GfxAddress,
                          &L2GfxAddress);
@@ -111,6 +113,7 @@ GMM_STATUS GmmLib::AuxTable::MapNullCCS(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX
             uint32_t        TableEntryIdx   = (L2GfxAddress == GMM_NO_TABLE) ? static_cast<uint32_t>(GMM_L3_ENTRY_IDX(AUXTT, StartAddress)) : static_cast<uint32_t>(GMM_L2_ENTRY_IDX(AUXTT, StartAddress));
             L2CPUAddress                    = (L2GfxAddress == GMM_NO_TABLE) ? 0 : TableCPUAddress;
 
+            EnterCriticalSection(&TTLock); //dummy tables are shared by all L2 tables
             if(!NullL1Table || !NullL2Table)
             {
                 AllocateDummyTables(&NullL2Table, &NullL1Table);
@@ -118,6 +121,7 @@ GMM_STATUS GmmLib::AuxTable::MapNullCCS(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX
                 {
                     //report error
                     LeaveCriticalSection(&TTLock);
+                    LeaveL2CriticalSection(GMM_L3_ENTRY_IDX(AUXTT, StartAddress));
                     return GMM_OUT_OF_MEMORY;
                 }
                 else
@@ -127,24 +131,19 @@ GMM_STATUS GmmLib::AuxTable::MapNullCCS(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX
                     GMM_AUXTTL2e    L2e       = {0};
                     L2e.Valid                 = 1;
                     L2e.L1GfxAddr             = (NullL1Table->GetPool()->GetGfxAddress() + PAGE_SIZE * NullL1Table->GetNodeIdx()) >> 13;
-                    for(int i = 0; i < GMM_AUX_L2_SIZE; i++)
-                    {
-                        //initialize L2e ie clear Valid bit for all entries
-                        ((GMM_AUXTTL2e *)TableAddr)[i].Value = L2e.Value;
-                    }
+                    //initialize L2e to point to null L1 table
+                    FillTableEntries(TableAddr, GMM_AUX_L2_SIZE, L2e.Value);
 
                     TableAddr = NullL1Table->GetCPUAddress();
 
                     GMM_AUXTTL1e L1e = {0};
                     L1e.Valid        = 1;
                     L1e.GfxAddress   = (NullCCSTile >> 8);
-                    for(int i = 0; i < GMM_AUX_L1_SIZE(GetGmmLibContext()); i++)
-                    {
-                        //initialize L1e with null ccs tile
-                        ((GMM_AUXTTL1e *)TableAddr)[i].Value = L1e.Value;
-                    }
+                    //initialize L1e with null ccs tile
+                    FillTableEntries(TableAddr, (uint32_t)GMM_AUX_L1_SIZE(GetGmmLibContext()), L1e.Value);
                 }
             }
+            LeaveCriticalSection(&TTLock);
 
             if(L2GfxAddress == GMM_NO_TABLE)
             {
@@ -172,10 +171,9 @@ GMM_STATUS GmmLib::AuxTable::MapNullCCS(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX
                 {
                     pTTL2[GMM_L3_ENTRY_IDX(AUXTT, StartAddress)].UpdatePoolFence(UmdContext, false);
                 }
-                PageTableMgr->TTCb.pfWriteL2L3Entry(UmdContext->pCommandQueueHandle,
-                                                    TableGfxAddress + TableEntryIdx * GMM_AUX_L2e_SIZE,
-                                                    Data);
+                Writer.Write(TableGfxAddress + TableEntryIdx * GMM_AUX_L2e_SIZE, Data);
             }
+            LeaveL2CriticalSection(GMM_L3_ENTRY_IDX(AUXTT, StartAddress));
             continue;
         }
         else
@@ -198,20 +196,14 @@ GMM_STATUS GmmLib::AuxTable::MapNullCCS(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX
                 GMM_AUXTTL3e L3e = {0};
                 L3e.Valid        = 1;
                 L3e.L2GfxAddr    = L2GfxAddress >> 15;
-                PageTableMgr->TTCb.pfWriteL2L3Entry(
-                UmdContext->pCommandQueueHandle,
-                L3GfxAddress + (L3eIdx * GMM_AUX_L3e_SIZE),
-                L3e.Value);
+                Writer.Write(L3GfxAddress + (L3eIdx * GMM_AUX_L3e_SIZE), L3e.Value);
 
                 pTTL2[L3eIdx].UpdatePoolFence(UmdContext, false);
 
                 GMM_AUXTTL2e L2e = {0};
                 L2e.Valid        = 1;
                 L2e.L1GfxAddr    = L1GfxAddress >> 13;
-                PageTableMgr->TTCb.pfWriteL2L3Entry(
-                UmdContext->pCommandQueueHandle,
-                L2GfxAddress + (L2eIdx * GMM_AUX_L2e_SIZE),
-                L2e.Value);
+                Writer.Write(L2GfxAddress + (L2eIdx * GMM_AUX_L2e_SIZE), L2e.Value);
             }
         }
 
@@ -224,7 +216,7 @@ GMM_STATUS GmmLib::AuxTable::MapNullCCS(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX
             GMM_GFX_SIZE_T          L1eIdx = GMM_L1_ENTRY_IDX(AUXTT, TileAddr, GetGmmLibContext());
             GmmLib::LastLevelTable *pL1Tbl = NULL;
 
-            pL1Tbl       = pTTL2[GMM_AUX_L3_ENTRY_IDX(TileAddr)].GetL1Table(L2eIdx, NULL);
+            pL1Tbl       = pTTL2[GMM_AUX_L3_ENTRY_IDX(TileAddr)].GetL1Table(L2eIdx);
             L1CPUAddress = pL1Tbl->GetCPUAddress();
             if(DoNotWait)
             {
@@ -242,19 +234,16 @@ GMM_STATUS GmmLib::AuxTable::MapNullCCS(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX
                     2,
                     L1GfxAddress + (L1eIdx * GMM_AUX_L1e_SIZE),
                     (uint32_t*)(&Data));*/ //**********REQUIRE UMD CHANGE TO UPDATE 64-bit ENTRY - both DWORDs must be updated atomically*******/
-                PageTableMgr->TTCb.pfWriteL2L3Entry(
-                UmdContext->pCommandQueueHandle,
-                L1GfxAddress + (L1eIdx * GMM_AUX_L1e_SIZE),
-                Data);
+                Writer.Write(L1GfxAddress + (L1eIdx * GMM_AUX_L1e_SIZE), Data);
             }
 
             if(pL1Tbl->TrackTableUsage(AUXTT, true, TileAddr, true, GetGmmLibContext()))
             { // L1 Table is not being used anymore
                 GMM_AUXTTL2e               L2e      = {0};
                 GmmLib::GMM_PAGETABLEPool *PoolElem = NULL;
-                GmmLib::LastLevelTable *   pL1Tbl = NULL, *Prev = NULL;
+                GmmLib::LastLevelTable *   pL1Tbl   = NULL;
 
-                pL1Tbl = pTTL2[GMM_L3_ENTRY_IDX(AUXTT, TileAddr)].GetL1Table(L2eIdx, &Prev);
+                pL1Tbl = pTTL2[GMM_L3_ENTRY_IDX(AUXTT, TileAddr)].GetL1Table(L2eIdx);
                 // Map L2-entry to Null-L1Table
                 L2e.Valid     = 1;
                 L2e.L1GfxAddr = (NullL1Table->GetPool()->GetGfxAddress() + PAGE_SIZE * NullL1Table->GetNodeIdx()) >> 13;
@@ -266,11 +255,11 @@ GMM_STATUS GmmLib::AuxTable::MapNullCCS(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX
                 else
                 {
                     pTTL2[GMM_L3_ENTRY_IDX(AUXTT, TileAddr)].UpdatePoolFence(UmdContext, false);
-                    PageTableMgr->TTCb.pfWriteL2L3Entry(UmdContext->pCommandQueueHandle,
-                                                        L2GfxAddress + L2eIdx * GMM_AUX_L2e_SIZE,
-                                                        L2e.Value);
+                    Writer.Write(L2GfxAddress + L2eIdx * GMM_AUX_L2e_SIZE, L2e.Value);
                 }
                 //Update usage for PoolNode assigned to L1Table, and free L1Tbl
+                //(issue pending writes before pool node may be released)
+                Writer.Flush();
                 if(pL1Tbl)
                 {
                     PoolElem = pL1Tbl->GetPool();
@@ -278,11 +267,13 @@ GMM_STATUS GmmLib::AuxTable::MapNullCCS(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX
                     {
                         if(pL1Tbl->GetBBInfo().BBQueueHandle)
                         {
-                            PoolElem->GetNodeBBInfoAtIndex(pL1Tbl->GetNodeIdx()) = pL1Tbl->GetBBInfo();
+                            PoolElem->SetNodeBBInfoAtIndex(pL1Tbl->GetNodeIdx(), pL1Tbl->GetBBInfo());
                         }
-                        DEASSIGN_POOLNODE(PageTableMgr, UmdContext, PoolElem, pL1Tbl->GetNodeIdx(), AUX_L1TABLE_SIZE_IN_POOLNODES)
+                        DEASSIGN_POOLNODE(PageTableMgr, PoolElem, pL1Tbl->GetNodeIdx(), AUX_L1TABLE_SIZE_IN_POOLNODES, PoolUnused)
                     }
-                    pTTL2[GMM_L3_ENTRY_IDX(AUXTT, TileAddr)].DeleteFromList(pL1Tbl, Prev);
+                    EnterCriticalSection(&TTLock); //L1Slab is shared by all L2 tables
+                    pTTL2[GMM_L3_ENTRY_IDX(AUXTT, TileAddr)].DeleteL1Table(pL1Tbl, L1Slab);
+                    LeaveCriticalSection(&TTLock);
                 }
 
                 // The L1 table is unused -- meaning everything else in this table is
@@ -290,15 +281,23 @@ GMM_STATUS GmmLib::AuxTable::MapNullCCS(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX
                 break;
             }
         }
+
+        LeaveL2CriticalSection(GMM_L3_ENTRY_IDX(AUXTT, StartAddress));
     }
 
     if(!DoNotWait)
     {
+        Writer.Flush();
         PageTableMgr->TTCb.pfEpilogTranslationTable(
         UmdContext->pCommandQueueHandle,
         1); // ForceFlush
     }
-    LeaveCriticalSection(&TTLock);
+
+    //Reclaim pools the walk emptied, now that no L2 lock is held
+    if(PoolUnused)
+    {
+        PageTableMgr->__ReleaseUnusedPool(UmdContext);
+    }
 
     return Status;
 }
@@ -316,14 +315,18 @@ GMM_STATUS GmmLib::AuxTable::MapNullCCS(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX
 //      BaseAdr: Start adr of main surface
 //      Size:   Main-surface size in bytes? (or take GmmResInfo?)
 //      DoNotWait: 1 for CPU update, 0 for async(Gpu) update
+//      pBatchWriter: writer of an enclosing batch (FlushAuxTableUpdates), which
+//                    owns Prolog/Epilog; NULL to bracket this update on its own
 //-----------------------------------------------------------------------------
-GMM_STATUS GmmLib::AuxTable::InvalidateTable(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX_ADDRESS BaseAdr, GMM_GFX_SIZE_T Size, uint8_t DoNotWait)
+GMM_STATUS GmmLib::AuxTable::InvalidateTable(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX_ADDRESS BaseAdr, GMM_GFX_SIZE_T Size, uint8_t DoNotWait,
+                                             TableEntryWriter *pBatchWriter)
 {
     GMM_STATUS      Status       = GMM_SUCCESS;
     GMM_GFX_SIZE_T  L1TableSize  = (GMM_L1_SIZE(AUXTT, GetGmmLibContext())) * (!WA16K(GetGmmLibContext()) ? GMM_KBYTE(64) : GMM_KBYTE(16)); //Each AuxTable entry maps 16K main-surface
     GMM_GFX_ADDRESS Addr         = 0;
     GMM_GFX_ADDRESS L3GfxAddress = 0;
     uint8_t         isTRVA       = 0; 
+    uint8_t         PoolUnused   = 0;
 
     GMM_CLIENT ClientType;
 
@@ -332,8 +335,6 @@ GMM_STATUS GmmLib::AuxTable::InvalidateTable(GMM_UMD_SYNCCONTEXT *UmdContext, GM
     //NullCCSTile isn't initialized, disable TRVA path
     isTRVA = (NullCCSTile ? isTRVA : 0);
 
-    EnterCriticalSection(&TTLock);
-
     DoNotWait |= (!UmdContext || !UmdContext->pCommandQueueHandle);
 
     if(TTL3.L3Handle)
@@ -342,16 +343,18 @@ GMM_STATUS GmmLib::AuxTable::InvalidateTable(GMM_UMD_SYNCCONTEXT *UmdContext, GM
     }
     else
     {
-        LeaveCriticalSection(&TTLock);
         return GMM_ERROR;
     }
 
-    if(!DoNotWait)
+    if(!DoNotWait && !pBatchWriter)
     {
         PageTableMgr->TTCb.pfPrologTranslationTable(
         UmdContext->pCommandQueueHandle);
     }
 
+    TableEntryWriter  LocalWriter(PageTableMgr->TTCb, PageTableMgr->GetTranslationTableCallbacksExt(), (DoNotWait || pBatchWriter) ? NULL : UmdContext->pCommandQueueHandle);
+    TableEntryWriter &Writer = pBatchWriter ? *pBatchWriter : LocalWriter;
+
     // For each L1 table
     for(Addr = GFX_ALIGN_FLOOR(BaseAdr, L1TableSize); // Start at begining of L1 table
         Addr < BaseAdr + Size;
@@ -371,6 +374,8 @@ GMM_STATUS GmmLib::AuxTable::InvalidateTable(GMM_UMD_SYNCCONTEXT *UmdContext, GM
             EndAddress = BaseAdr + Size;
         }
 
+        EnterL2CriticalSection(GMM_L3_ENTRY_IDX(AUXTT, StartAddress));
+
         GetL1L2TableAddr(StartAddress,
                          &L1GfxAddress,
                          &L2GfxAddress);
@@ -422,10 +427,9 @@ GMM_STATUS GmmLib::AuxTable::InvalidateTable(GMM_UMD_SYNCCONTEXT *UmdContext, GM
                 {
                     pTTL2[GMM_L3_ENTRY_IDX(AUXTT, StartAddress)].UpdatePoolFence(UmdContext, false);
                 }
-                PageTableMgr->TTCb.pfWriteL2L3Entry(UmdContext->pCommandQueueHandle,
-                                                    TableGfxAddress + TableEntryIdx * GMM_AUX_L2e_SIZE,
-                                                    L2e.Value);
+                Writer.Write(TableGfxAddress + TableEntryIdx * GMM_AUX_L2e_SIZE, L2e.Value);
             }
+            LeaveL2CriticalSection(GMM_L3_ENTRY_IDX(AUXTT, StartAddress));
             continue;
         }
         else
@@ -448,20 +452,14 @@ GMM_STATUS GmmLib::AuxTable::InvalidateTable(GMM_UMD_SYNCCONTEXT *UmdContext, GM
                 GMM_AUXTTL3e L3e = {0};
                 L3e.Valid        = 1;
                 L3e.L2GfxAddr    = L2GfxAddress >> 15;
-                PageTableMgr->TTCb.pfWriteL2L3Entry(
-                UmdContext->pCommandQueueHandle,
-                L3GfxAddress + (L3eIdx * GMM_AUX_L3e_SIZE),
-                L3e.Value);
+                Writer.Write(L3GfxAddress + (L3eIdx * GMM_AUX_L3e_SIZE), L3e.Value);
 
                 pTTL2[L3eIdx].UpdatePoolFence(UmdContext, false);
 
                 GMM_AUXTTL2e L2e = {0};
                 L2e.Valid        = 1;
                 L2e.L1GfxAddr    = L1GfxAddress >> 13;
-                PageTableMgr->TTCb.pfWriteL2L3Entry(
-                UmdContext->pCommandQueueHandle,
-                L2GfxAddress + (L2eIdx * GMM_AUX_L2e_SIZE),
-                L2e.Value);
+                Writer.Write(L2GfxAddress + (L2eIdx * GMM_AUX_L2e_SIZE), L2e.Value);
             }
         }
 
@@ -475,14 +473,20 @@ GMM_STATUS GmmLib::AuxTable::InvalidateTable(GMM_UMD_SYNCCONTEXT *UmdContext, GM
             GMM_GFX_SIZE_T          L1eIdx = GMM_L1_ENTRY_IDX(AUXTT, TileAddr, GetGmmLibContext());
             GmmLib::LastLevelTable *pL1Tbl = NULL;
 
-            pL1Tbl       = pTTL2[GMM_AUX_L3_ENTRY_IDX(TileAddr)].GetL1Table(L2eIdx, NULL);
+            bool                    TableUnused = false;
+
+            pL1Tbl       = pTTL2[GMM_AUX_L3_ENTRY_IDX(TileAddr)].GetL1Table(L2eIdx);
             L1CPUAddress = pL1Tbl->GetCPUAddress();
             if(DoNotWait)
             {
-                //Sync update on CPU
-                ((GMM_AUXTTL1e *)L1CPUAddress)[L1eIdx].Value = Data;
+                //Sync update on CPU, invalidate rest of run in one go
+                GMM_GFX_SIZE_T TileSize   = !WA16K(GetGmmLibContext()) ? GMM_KBYTE(64) : GMM_KBYTE(16);
+                uint32_t       NumEntries = static_cast<uint32_t>((EndAddress - TileAddr + TileSize - 1) / TileSize);
+
+                FillTableEntries(L1CPUAddress + L1eIdx * GMM_AUX_L1e_SIZE, NumEntries, Data);
+                TableUnused = pL1Tbl->TrackTableUsageRange(AUXTT, true, TileAddr, NumEntries, true, GetGmmLibContext());
 
-                GMM_DPF(GFXDBG_NORMAL, "UnMap | Table Entry: [0x%06x] L2Addr[0x%016llX] Value[0x%016llX] :: [0x%06x] L1Addr[0x%016llX] Value[0x%016llX]\n", L2eIdx, ((GMM_AUXTTL2e *)L2CPUAddress)[L2eIdx], ((GMM_AUXTTL2e *)L2CPUAddress)[L2eIdx].L1GfxAddr << 13, L1eIdx, &((GMM_AUXTTL1e *)L1CPUAddress)[L1eIdx], Data);
+                GMM_DPF(GFXDBG_NORMAL, "UnMap | Table Entries: [0x%06x] L2Addr[0x%016llX] Value[0x%016llX] :: [0x%06x-0x%06x] Value[0x%016llX]\n", L2eIdx, ((GMM_AUXTTL2e *)L2CPUAddress)[L2eIdx], ((GMM_AUXTTL2e *)L2CPUAddress)[L2eIdx].L1GfxAddr << 13, L1eIdx, L1eIdx + NumEntries - 1, Data);
             }
             else
             {
@@ -493,19 +497,18 @@ GMM_STATUS GmmLib::AuxTable::InvalidateTable(GMM_UMD_SYNCCONTEXT *UmdContext, GM
                     2,
                     L1GfxAddress + (L1eIdx * GMM_AUX_L1e_SIZE),
                     (uint32_t*)(&Data));*/ //**********REQUIRE UMD CHANGE TO UPDATE 64-bit ENTRY - both DWORDs must be updated atomically*******/
-                PageTableMgr->TTCb.pfWriteL2L3Entry(
-                UmdContext->pCommandQueueHandle,
-                L1GfxAddress + (L1eIdx * GMM_AUX_L1e_SIZE),
-                Data);
+                Writer.Write(L1GfxAddress + (L1eIdx * GMM_AUX_L1e_SIZE), Data);
+
+                TableUnused = pL1Tbl->TrackTableUsage(AUXTT, true, TileAddr, true, GetGmmLibContext());
             }
 
-            if(pL1Tbl->TrackTableUsage(AUXTT, true, TileAddr, true, GetGmmLibContext()))
+            if(TableUnused)
             { // L1 Table is not being used anymore
                 GMM_AUXTTL2e               L2e      = {0};
                 GmmLib::GMM_PAGETABLEPool *PoolElem = NULL;
-                GmmLib::LastLevelTable *   pL1Tbl = NULL, *Prev = NULL;
+                GmmLib::LastLevelTable *   pL1Tbl   = NULL;
 
-                pL1Tbl = pTTL2[GMM_L3_ENTRY_IDX(AUXTT, TileAddr)].GetL1Table(L2eIdx, &Prev);
+                pL1Tbl = pTTL2[GMM_L3_ENTRY_IDX(AUXTT, TileAddr)].GetL1Table(L2eIdx);
 
                 if(isTRVA && NullL1Table &&
                    ((TileAddr > GFX_ALIGN_FLOOR(BaseAdr, L1TableSize) && TileAddr < GFX_ALIGN_NP2(BaseAdr, L1TableSize)) ||
@@ -529,11 +532,11 @@ GMM_STATUS GmmLib::AuxTable::InvalidateTable(GMM_UMD_SYNCCONTEXT *UmdContext, GM
                 else
                 {
                     pTTL2[GMM_L3_ENTRY_IDX(AUXTT, TileAddr)].UpdatePoolFence(UmdContext, false);
-                    PageTableMgr->TTCb.pfWriteL2L3Entry(UmdContext->pCommandQueueHandle,
-                                                        L2GfxAddress + L2eIdx * GMM_AUX_L2e_SIZE,
-                                                        L2e.Value);
+                    Writer.Write(L2GfxAddress + L2eIdx * GMM_AUX_L2e_SIZE, L2e.Value);
                 }
                 //Update usage for PoolNode assigned to L1Table, and free L1Tbl
+                //(issue pending writes before pool node may be released)
+                Writer.Flush();
                 if(pL1Tbl)
                 {
                     PoolElem = pL1Tbl->GetPool();
@@ -541,28 +544,42 @@ GMM_STATUS GmmLib::AuxTable::InvalidateTable(GMM_UMD_SYNCCONTEXT *UmdContext, GM
                     {
                         if(pL1Tbl->GetBBInfo().BBQueueHandle)
                         {
-                            PoolElem->GetNodeBBInfoAtIndex(pL1Tbl->GetNodeIdx()) = pL1Tbl->GetBBInfo();
+                            PoolElem->SetNodeBBInfoAtIndex(pL1Tbl->GetNodeIdx(), pL1Tbl->GetBBInfo());
                         }
-                        DEASSIGN_POOLNODE(PageTableMgr, UmdContext, PoolElem, pL1Tbl->GetNodeIdx(), AUX_L1TABLE_SIZE_IN_POOLNODES)
+                        DEASSIGN_POOLNODE(PageTableMgr, PoolElem, pL1Tbl->GetNodeIdx(), AUX_L1TABLE_SIZE_IN_POOLNODES, PoolUnused)
                     }
-                    pTTL2[GMM_L3_ENTRY_IDX(AUXTT, TileAddr)].DeleteFromList(pL1Tbl, Prev);
+                    EnterCriticalSection(&TTLock); //L1Slab is shared by all L2 tables
+                    pTTL2[GMM_L3_ENTRY_IDX(AUXTT, TileAddr)].DeleteL1Table(pL1Tbl, L1Slab);
+                    LeaveCriticalSection(&TTLock);
                 }
 
                 // The L1 table is unused -- meaning everything else in this table is
                 // already invalid. So, break early.
                 break;
             }
+
+            if(DoNotWait)
+            {
+                break; //whole run invalidated
+            }
         }
+
+        LeaveL2CriticalSection(GMM_L3_ENTRY_IDX(AUXTT, StartAddress));
     }
 
-    if(!DoNotWait)
+    if(!DoNotWait && !pBatchWriter)
     {
+        Writer.Flush();
         PageTableMgr->TTCb.pfEpilogTranslationTable(
         UmdContext->pCommandQueueHandle,
         1); // ForceFlush
     }
 
-    LeaveCriticalSection(&TTLock);
+    //Reclaim pools the walk emptied, now that no L2 lock is held
+    if(PoolUnused)
+    {
+        PageTableMgr->__ReleaseUnusedPool(UmdContext);
+    }
 
     return Status;
 }
@@ -574,7 +591,7 @@ GMM_STATUS GmmLib::AuxTable::InvalidateTable(GMM_UMD_SYNCCONTEXT *UmdContext, GM
 // Desc: Maps given main-surface, on Aux-Table, to get the exact CCS cacheline tied to
 //       different 4x4K pages of main-surface
 //
-// Caller: UpdateAuxTable (map op)
+// Caller: UpdateAuxTable (map op), FlushAuxTableUpdates
 //
 // Parameters:
 //      UmdContext: ptr to thread-data
@@ -585,9 +602,12 @@ GMM_STATUS GmmLib::AuxTable::InvalidateTable(GMM_UMD_SYNCCONTEXT *UmdContext, GM
 //      AuxResInfo: Aux surface ResInfo
 //      PartialData: Aux L1 partial data (ie w/o address)
 //      DoNotWait: true for CPU update, false for async(Gpu) update
+//      pBatchWriter: writer of an enclosing batch (FlushAuxTableUpdates), which
+//                    owns Prolog/Epilog; NULL to bracket this update on its own
 //-----------------------------------------------------------------------------
 GMM_STATUS GmmLib::AuxTable::MapValidEntry(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX_ADDRESS BaseAdr, GMM_GFX_SIZE_T BaseSize,
-                                           GMM_RESOURCE_INFO *BaseResInfo, GMM_GFX_ADDRESS AuxVA, GMM_RESOURCE_INFO *AuxResInfo, uint64_t PartialData, uint8_t DoNotWait)
+                                           GMM_RESOURCE_INFO *BaseResInfo, GMM_GFX_ADDRESS AuxVA, GMM_RESOURCE_INFO *AuxResInfo, uint64_t PartialData, uint8_t DoNotWait,
+                                           TableEntryWriter *pBatchWriter)
 {
     GMM_STATUS      Status = GMM_SUCCESS;
     GMM_GFX_ADDRESS Addr = 0, L3TableAdr = GMM_NO_TABLE;
@@ -602,7 +622,6 @@ GMM_STATUS GmmLib::AuxTable::MapValidEntry(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_
     //NullCCSTile isn't initialized, disable TRVA path
     isTRVA = (NullCCSTile ? isTRVA : 0);
 
-    EnterCriticalSection(&TTLock);
     if(!TTL3.L3Handle || (!DoNotWait && !UmdContext))
     {
         Status = GMM_ERROR;
@@ -611,11 +630,14 @@ GMM_STATUS GmmLib::AuxTable::MapValidEntry(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_
     {
         L3TableAdr = TTL3.GfxAddress;
 
-        if(!DoNotWait)
+        if(!DoNotWait && !pBatchWriter)
         {
             PageTableMgr->TTCb.pfPrologTranslationTable(UmdContext->pCommandQueueHandle);
         }
 
+        TableEntryWriter  LocalWriter(PageTableMgr->TTCb, PageTableMgr->GetTranslationTableCallbacksExt(), DoNotWait ? NULL : UmdContext->pCommandQueueHandle);
+        TableEntryWriter &Writer = pBatchWriter ? *pBatchWriter : LocalWriter;
+
         GMM_DPF(GFXDBG_NORMAL, "Mapping surface: GPUVA=0x%016llX Size=0x%08X Aux_GPUVA=0x%016llX\n", BaseAdr, BaseSize, AuxVA);
         for(Addr = GFX_ALIGN_FLOOR(BaseAdr, L1TableSize); Addr < BaseAdr + BaseSize; Addr += L1TableSize)
         {
@@ -633,6 +655,8 @@ GMM_STATUS GmmLib::AuxTable::MapValidEntry(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_
             L2eIdx = GMM_L2_ENTRY_IDX(AUXTT, StartAdr);
             L3eIdx = GMM_L3_ENTRY_IDX(AUXTT, StartAdr);
 
+            EnterL2CriticalSection(L3eIdx);
+
             //Allocate L2/L1 Table -- get L2 Table Adr for <StartAdr,EndAdr>
             GetL1L2TableAddr(Addr, &L1TableAdr, &L2TableAdr);
             if(L2TableAdr == GMM_NO_TABLE || L1TableAdr == GMM_NO_TABLE)
@@ -643,13 +667,13 @@ GMM_STATUS GmmLib::AuxTable::MapValidEntry(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_
 
                 if(L2TableAdr == GMM_NO_TABLE || L1TableAdr == GMM_NO_TABLE)
                 {
-                    LeaveCriticalSection(&TTLock);
-                    return GMM_OUT_OF_MEMORY;
+                    LeaveL2CriticalSection(L3eIdx);
+                    Status = GMM_OUT_OF_MEMORY;
+                    break;
                 }
 
                 if(AllocateL2)
                 {
-                    uint32_t     i = 0;
                     GMM_AUXTTL2e InvalidEntry;
                     InvalidEntry.Value = 0;
                     if(isTRVA && NullL1Table)
@@ -665,51 +689,39 @@ GMM_STATUS GmmLib::AuxTable::MapValidEntry(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_
                         ((GMM_AUXTTL3e *)(TTL3.CPUAddress))[L3eIdx].Value     = 0;
                         ((GMM_AUXTTL3e *)(TTL3.CPUAddress))[L3eIdx].L2GfxAddr = L2TableAdr >> 15;
                         ((GMM_AUXTTL3e *)(TTL3.CPUAddress))[L3eIdx].Valid     = 1;
-                        for(i = 0; i < GMM_AUX_L2_SIZE; i++)
-                        {
-                            //initialize L2e ie clear Valid bit for all entries
-                            ((GMM_AUXTTL2e *)L2TableCPUAdr)[i].Value = InvalidEntry.Value;
-                        }
+
+                        //initialize L2e ie clear Valid bit for all entries
+                        FillTableEntries(L2TableCPUAdr, GMM_AUX_L2_SIZE, InvalidEntry.Value);
                     }
                     else
                     {
                         GMM_AUXTTL3e L3e = {0};
                         L3e.Valid        = 1;
                         L3e.L2GfxAddr    = L2TableAdr >> 15;
-                        PageTableMgr->TTCb.pfWriteL2L3Entry(UmdContext->pCommandQueueHandle,
-                                                            L3TableAdr + L3eIdx * GMM_AUX_L3e_SIZE,
-                                                            L3e.Value);
+                        Writer.Write(L3TableAdr + L3eIdx * GMM_AUX_L3e_SIZE, L3e.Value);
 
                         //initialize L2e ie clear valid bit for all entries
-                        for(i = 0; i < GMM_AUX_L2_SIZE; i++)
-                        {
-                            PageTableMgr->TTCb.pfWriteL2L3Entry(UmdContext->pCommandQueueHandle,
-                                                                L2TableAdr + i * GMM_AUX_L2e_SIZE,
-                                                                InvalidEntry.Value);
-                        }
+                        Writer.Fill(L2TableAdr, GMM_AUX_L2_SIZE, InvalidEntry.Value);
                     }
                 }
 
                 if(AllocateL1)
                 {
                     uint64_t InvalidEntry = (!isTRVA) ? GMM_INVALID_AUX_ENTRY : (NullCCSTile | __BIT(0));
-                    uint32_t i            = 0;
 
                     if(DoNotWait)
                     {
                         GmmLib::LastLevelTable *pL1Tbl = NULL;
-                        pL1Tbl                         = pTTL2[L3eIdx].GetL1Table(L2eIdx, NULL);
+                        pL1Tbl                         = pTTL2[L3eIdx].GetL1Table(L2eIdx);
                         L2TableCPUAdr = pTTL2[L3eIdx].GetCPUAddress();
                         L1TableCPUAdr = pL1Tbl->GetCPUAddress();
                         //Sync update on CPU
                         ((GMM_AUXTTL2e *)L2TableCPUAdr)[L2eIdx].Value     = 0;
                         ((GMM_AUXTTL2e *)L2TableCPUAdr)[L2eIdx].L1GfxAddr = L1TableAdr >> 13;
                         ((GMM_AUXTTL2e *)L2TableCPUAdr)[L2eIdx].Valid     = 1;
-                        for(i = 0; i < (uint32_t)GMM_AUX_L1_SIZE(GetGmmLibContext()); i++)
-                        {
-                            //initialize L1e ie mark all entries with Null tile value
-                            ((GMM_AUXTTL1e *)L1TableCPUAdr)[i].Value = InvalidEntry;
-                        }
+
+                        //initialize L1e ie mark all entries with Null tile value
+                        FillTableEntries(L1TableCPUAdr, (uint32_t)GMM_AUX_L1_SIZE(GetGmmLibContext()), InvalidEntry);
                     }
                     else
                     {
@@ -717,23 +729,50 @@ GMM_STATUS GmmLib::AuxTable::MapValidEntry(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_
                         L2e.Valid        = 1;
                         L2e.L1GfxAddr    = L1TableAdr >> 13;
                         pTTL2[L3eIdx].UpdatePoolFence(UmdContext, false);
-                        PageTableMgr->TTCb.pfWriteL2L3Entry(UmdContext->pCommandQueueHandle,
-                                                            L2TableAdr + L2eIdx * GMM_AUX_L2e_SIZE,
-                                                            L2e.Value);
+                        Writer.Write(L2TableAdr + L2eIdx * GMM_AUX_L2e_SIZE, L2e.Value);
 
                         //initialize all L1e with invalid entries
-                        for(i = 0; i < (uint32_t)GMM_AUX_L1_SIZE(GetGmmLibContext()); i++)
-                        {
-                            PageTableMgr->TTCb.pfWriteL2L3Entry(UmdContext->pCommandQueueHandle,
-                                                                L1TableAdr + i * sizeof(uint64_t),
-                                                                InvalidEntry);
-                        }
+                        Writer.Fill(L1TableAdr, (uint32_t)GMM_AUX_L1_SIZE(GetGmmLibContext()), InvalidEntry);
                     }
                 }
             }
 
             GMM_DPF(GFXDBG_NORMAL, "Mapping surface: GPUVA=0x%016llx Size=0x%08x Aux_GPUVA=0x%016llx", StartAdr, BaseSize, CCS$Adr);
 
+            if(DoNotWait && pClientContext->GetLibContext()->GetSkuTable().FtrLinearCCS)
+            {
+                //Sync update on CPU. With linear CCS, run's L1 entries only differ in CCS adr,
+                //which steps by 256B (64B) per 64KB (16KB) tile -- fill them in one go
+                GMM_GFX_SIZE_T          TileSize   = !WA16K(GetGmmLibContext()) ? GMM_KBYTE(64) : GMM_KBYTE(16);
+                GMM_GFX_SIZE_T          CCSStep    = !WA16K(GetGmmLibContext()) ? GMM_BYTES(256) : GMM_BYTES(64);
+                uint32_t                NumEntries = static_cast<uint32_t>((EndAdr - StartAdr + TileSize - 1) / TileSize);
+                GMM_GFX_SIZE_T          L1eIdx     = GMM_L1_ENTRY_IDX(AUXTT, StartAdr, GetGmmLibContext());
+                GmmLib::LastLevelTable *pL1Tbl     = pTTL2[L3eIdx].GetL1Table(L2eIdx);
+                GMM_AUXTTL1e            L1e        = {0};
+                L1e.Value                          = PartialData;
+                L1e.Valid                          = 1;
+
+                if(!WA16K(GetGmmLibContext()))
+                {
+                    __GMM_ASSERT(GFX_IS_ALIGNED(CCS$Adr, GMM_BYTES(256)));
+                    __GMM_ASSERT(GFX_IS_ALIGNED(StartAdr, GMM_KBYTE(64)));
+                    L1e.GfxAddress = CCS$Adr >> 8; /*********** 256B-aligned CCS adr *****/
+                }
+                else
+                {
+                    L1e.Reserved2  = CCS$Adr >> 6; /*********** 2 lsbs of 64B-aligned CCS adr *****/
+                    L1e.GfxAddress = CCS$Adr >> 8; /*********** 256B-aligned CCS adr *****/
+                }
+
+                //CCS adr bits are contiguous in L1e (from bit 6/8), so stepping entry value steps CCS adr
+                FillTableEntriesLinear(pL1Tbl->GetCPUAddress() + L1eIdx * GMM_AUX_L1e_SIZE, NumEntries, L1e.Value, CCSStep);
+                pL1Tbl->TrackTableUsageRange(AUXTT, true, StartAdr, NumEntries, false, GetGmmLibContext());
+                CCS$Adr += NumEntries * CCSStep;
+
+                LeaveL2CriticalSection(L3eIdx);
+                continue;
+            }
+
             for(TileAdr = StartAdr; TileAdr < EndAdr; TileAdr += (!WA16K(pClientContext->GetLibContext()) ? GMM_KBYTE(64) : GMM_KBYTE(16)),
             CCS$Adr += (pClientContext->GetLibContext()->GetSkuTable().FtrLinearCCS ?
                         (!WA16K(pClientContext->GetLibContext()) ? GMM_BYTES(256) : GMM_BYTES(64)) :
@@ -764,7 +803,7 @@ GMM_STATUS GmmLib::AuxTable::MapValidEntry(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_
 
                 GmmLib::LastLevelTable *pL1Tbl = NULL;
 
-                pL1Tbl        = pTTL2[L3eIdx].GetL1Table(L2eIdx, NULL);
+                pL1Tbl        = pTTL2[L3eIdx].GetL1Table(L2eIdx);
                 L1TableCPUAdr = pL1Tbl->GetCPUAddress();
                 if(DoNotWait)
                 {
@@ -776,29 +815,140 @@ GMM_STATUS GmmLib::AuxTable::MapValidEntry(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_
                 else
                 {
                     pL1Tbl->UpdatePoolFence(UmdContext, false);
-                    PageTableMgr->TTCb.pfWriteL2L3Entry(UmdContext->pCommandQueueHandle,
-                                                        L1TableAdr + L1eIdx * GMM_AUX_L1e_SIZE,
-                                                        L1e.Value);
+                    Writer.Write(L1TableAdr + L1eIdx * GMM_AUX_L1e_SIZE, L1e.Value);
                 }
 
                 // Since we are mapping a non-null entry, no need to check whether
                 // L1 table is unused.
                 pL1Tbl->TrackTableUsage(AUXTT, true, TileAdr, false, GetGmmLibContext());
             }
+
+            LeaveL2CriticalSection(L3eIdx);
         }
-        if(!DoNotWait)
+        if(!DoNotWait && !pBatchWriter)
         {
+            Writer.Flush();
             PageTableMgr->TTCb.pfEpilogTranslationTable(
             UmdContext->pCommandQueueHandle,
             1);
         }
     }
 
+    return Status;
+}
+
+//=============================================================================
+//
+// Function: AddMapping
+//
+// Desc: Records given resource mapping in mapped-range index, rejecting any
+//       mapping that overlaps a different one (double-map). Remapping same
+//       resource, at same VA and size, refreshes its record.
+//
+// Caller: UpdateAuxTable (map op), before table update
+//
+// Parameters:
+//      Mapping: main-surface VA range, Aux VA and resources being mapped
+//-----------------------------------------------------------------------------
+GMM_STATUS GmmLib::AuxTable::AddMapping(const GMM_AUXTT_MAPPING_INFO &Mapping)
+{
+    GMM_STATUS Status = GMM_SUCCESS;
+
+    EnterCriticalSection(&TTLock);
+
+    //Ranges are disjoint, so only the last one starting before End can overlap
+    std::map<GMM_GFX_ADDRESS, GMM_AUXTT_MAPPING_INFO>::iterator It = Mappings.lower_bound(Mapping.BaseGpuVA + Mapping.Size);
+    if(It != Mappings.begin() && (--It)->first + It->second.Size > Mapping.BaseGpuVA &&
+       !(It->first == Mapping.BaseGpuVA && It->second.Size == Mapping.Size && It->second.BaseResInfo == Mapping.BaseResInfo))
+    {
+        GMM_DPF(GFXDBG_CRITICAL, "AuxTT double-map: GPUVA=0x%016llX Size=0x%llX overlaps GPUVA=0x%016llX Size=0x%llX\n",
+                Mapping.BaseGpuVA, Mapping.Size, It->first, It->second.Size);
+        Status = GMM_INVALIDPARAM;
+    }
+    else
+    {
+        Mappings[Mapping.BaseGpuVA] = Mapping;
+    }
+
     LeaveCriticalSection(&TTLock);
 
     return Status;
 }
 
+//=============================================================================
+//
+// Function: FindMapping
+//
+// Desc: Looks up mapped resource containing given VA
+//
+// Parameters:
+//      GfxVA: main-surface VA
+//      pMapping: [out] mapping containing GfxVA
+//
+// Returns: true if GfxVA is mapped
+//-----------------------------------------------------------------------------
+bool GmmLib::AuxTable::FindMapping(GMM_GFX_ADDRESS GfxVA, GMM_AUXTT_MAPPING_INFO *pMapping)
+{
+    bool Found = false;
+
+    EnterCriticalSection(&TTLock);
+
+    std::map<GMM_GFX_ADDRESS, GMM_AUXTT_MAPPING_INFO>::iterator It = Mappings.upper_bound(GfxVA);
+    if(It != Mappings.begin() && GfxVA < (--It)->first + It->second.Size)
+    {
+        *pMapping = It->second;
+        Found     = true;
+    }
+
+    LeaveCriticalSection(&TTLock);
+
+    return Found;
+}
+
+//=============================================================================
+//
+// Function: RemoveMappings
+//
+// Desc: Drops records of mappings contained in [Start, End). Mappings straddling
+//       the range are kept, and reported.
+//
+// Caller: UpdateAuxTable/FlushAuxTableUpdates (unmap op), InvalidateAuxTableRange
+//
+// Parameters:
+//      Start, End: main-surface VA range
+//      pRemoved: [out] optional, removed mappings in VA order
+//-----------------------------------------------------------------------------
+void GmmLib::AuxTable::RemoveMappings(GMM_GFX_ADDRESS Start, GMM_GFX_ADDRESS End, std::vector<GMM_AUXTT_MAPPING_INFO> *pRemoved)
+{
+    EnterCriticalSection(&TTLock);
+
+    std::map<GMM_GFX_ADDRESS, GMM_AUXTT_MAPPING_INFO>::iterator It = Mappings.lower_bound(Start);
+    if(It != Mappings.begin())
+    {
+        std::map<GMM_GFX_ADDRESS, GMM_AUXTT_MAPPING_INFO>::iterator Prev = It;
+        if((--Prev)->first + Prev->second.Size > Start)
+        {
+            GMM_DPF(GFXDBG_CRITICAL, "AuxTT mapping GPUVA=0x%016llX straddles invalidated range start\n", Prev->first);
+        }
+    }
+
+    while(It != Mappings.end() && It->first < End)
+    {
+        if(It->first + It->second.Size > End)
+        {
+            GMM_DPF(GFXDBG_CRITICAL, "AuxTT mapping GPUVA=0x%016llX straddles invalidated range end\n", It->first);
+            break;
+        }
+        if(pRemoved)
+        {
+            pRemoved->push_back(It->second);
+        }
+        It = Mappings.erase(It);
+    }
+
+    LeaveCriticalSection(&TTLock);
+}
+
 GMM_AUXTTL1e GmmLib::AuxTable::CreateAuxL1Data(GMM_RESOURCE_INFO *BaseResInfo)
 {
     GMM_FORMAT_ENTRY FormatInfo = pClientContext->GetLibContext()->GetPlatformInfo().FormatTable[BaseResInfo->GetResourceFormat()];
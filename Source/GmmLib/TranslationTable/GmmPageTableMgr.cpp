@@ -27,6 +27,7 @@ Description: UMD-TT manager (manages both TR-TT and AUX-TT in user mode space)
 #include "External/Common/GmmPageTableMgr.h"
 #include "../TranslationTable/GmmUmdTranslationTable.h"
 #include "External/Common/GmmClientContext.h"
+#include <algorithm>
 
 #if defined(__linux__)
 #include "Internal/Linux/GmmResourceInfoLinInt.h"
@@ -161,6 +162,8 @@ GmmLib::GMM_PAGETABLEPool *GmmLib::GmmPageTableMgr::__AllocateNodePool(uint32_t
             NumNodePoolElements = 1;
             pPool               = pTTPool;
         }
+        __AddToFreeList(pTTPool);
+        PoolStats.PeakFootprint = GFX_MAX(PoolStats.PeakFootprint, (GMM_GFX_SIZE_T)NumNodePoolElements * PAGETABLE_POOL_SIZE);
     }
     else
     {
@@ -176,7 +179,14 @@ GmmLib::GMM_PAGETABLEPool *GmmLib::GmmPageTableMgr::__AllocateNodePool(uint32_t
 //
 // Function: __ReleaseUnusedPool
 //
-// Desc: Frees up unused PageTablePools once residency limit is hit
+// Desc: Frees up unused PageTablePools once their size exceeds the high watermark
+//       (PAGETABLE_POOL_MAX_UNUSED_SIZE), trimming down to the low watermark
+//       (PAGETABLE_POOL_MIN_UNUSED_SIZE) so a few table frees/allocs around the
+//       limit don't free and reallocate pools. Least recently used pools go
+//       first. Pools the client reports idle (TTCbExt.pfIsBufferBusy) are freed
+//       without waiting; busy ones are skipped, unless unused size stays above
+//       high watermark, then CPU waits on them. Waits and deallocation happen
+//       after PoolLock is dropped; callers must not hold table (L2/TT) locks.
 //
 // Parameters:
 //      UmdContext: pointer to caller thread's context (containing BBHandle/Fence info)
@@ -184,66 +194,137 @@ GmmLib::GMM_PAGETABLEPool *GmmLib::GmmPageTableMgr::__AllocateNodePool(uint32_t
 //-----------------------------------------------------------------------------
 void GmmLib::GmmPageTableMgr::__ReleaseUnusedPool(GMM_UMD_SYNCCONTEXT *UmdContext)
 {
-    GMM_STATUS                 Status         = GMM_SUCCESS;
-    GMM_GFX_SIZE_T             PoolSizeToFree = {0};
-    GMM_GFX_SIZE_T             FreedSize      = {0};
-    GmmLib::GMM_PAGETABLEPool *Pool = NULL, *PrevPool = NULL;
-    uint32_t                   i = 0;
+    GMM_STATUS                 Status     = GMM_SUCCESS;
+    GMM_GFX_SIZE_T             UnusedSize = 0;
+    GmmLib::GMM_PAGETABLEPool *Pool       = NULL;
     GMM_CLIENT                 ClientType;
     GMM_DEVICE_DEALLOC         Dealloc;
+    SyncInfo                   NextBB = UmdContext ? SyncInfo(UmdContext->BBFenceObj, UmdContext->BBLastFence) : SyncInfo();
+
+    std::vector<GMM_PAGETABLEPool *> Candidates, Idle, Busy;
 
     GET_GMM_CLIENT_TYPE(pClientContext, ClientType);
 
     ENTER_CRITICAL_SECTION
-    if(pPool->__IsUnusedTRTTPoolOverLimit(&PoolSizeToFree))
+    for(Pool = pPool; Pool; Pool = Pool->GetNextPool())
     {
-        for(i = 0; i < NumNodePoolElements && FreedSize < PoolSizeToFree; i++)
+        if(Pool->GetNumFreeNode() == PAGETABLE_POOL_MAX_NODES)
         {
-            Pool = (PrevPool) ? PrevPool->GetNextPool() : pPool;
+            UnusedSize += PAGETABLE_POOL_SIZE;
+            Candidates.push_back(Pool);
+        }
+    }
 
-            if(Pool->IsPoolInUse(UmdContext ? SyncInfo(UmdContext->BBFenceObj, UmdContext->BBLastFence) : SyncInfo()))
+    if(UnusedSize > PAGETABLE_POOL_MAX_UNUSED_SIZE)
+    {
+        std::sort(Candidates.begin(), Candidates.end(),
+                  [](GMM_PAGETABLEPool *a, GMM_PAGETABLEPool *b) { return a->GetLastUsed() < b->GetLastUsed(); });
+
+        for(size_t i = 0; i < Candidates.size() && UnusedSize > PAGETABLE_POOL_MIN_UNUSED_SIZE; i++)
+        {
+            Pool = Candidates[i];
+            if(Pool->IsPoolInUse(NextBB)) //referenced by BB not yet submitted
             {
-                PrevPool = Pool;
+                PoolStats.NumBusySkipped++;
                 continue;
             }
 
-            if(GmmCheckForNullDevCbPfn(ClientType, &DeviceCbInt, GMM_DEV_CB_WAIT_FROM_CPU))
+            if(TTCbExt.pfIsBufferBusy && !TTCbExt.pfIsBufferBusy(Pool->GetPoolHandle()))
             {
-                GMM_DDI_WAITFORSYNCHRONIZATIONOBJECTFROMCPU Wait = {0};
-                Wait.bo                                          = Pool->GetPoolHandle();
-                GmmDeviceCallback(ClientType, &DeviceCbInt, &Wait);
+                Idle.push_back(Pool);
+                UnusedSize -= PAGETABLE_POOL_SIZE;
             }
-
-            Dealloc.Handle = Pool->GetPoolHandle();
-            Dealloc.GfxVA  = Pool->GetGfxAddress();
-            Dealloc.Priv   = Pool->GetGmmResInfo();
-            Dealloc.hCsr   = hCsr;
-
-            Status = __GmmDeviceDealloc(ClientType, &DeviceCbInt, &Dealloc, pClientContext);
-
-            __GMM_ASSERT(GMM_SUCCESS == Status);
-
-            if(PrevPool)
+            else
             {
-                PrevPool->GetNextPool() = Pool->GetNextPool();
+                Busy.push_back(Pool);
             }
-            else
+        }
+
+        //Busy pools (LRU first) are waited on only while unused size stays above high watermark
+        size_t NumWait = 0;
+        if(UnusedSize > PAGETABLE_POOL_MAX_UNUSED_SIZE)
+        {
+            for(; NumWait < Busy.size() && UnusedSize > PAGETABLE_POOL_MIN_UNUSED_SIZE; NumWait++)
             {
-                pPool = Pool->GetNextPool();
+                UnusedSize -= PAGETABLE_POOL_SIZE;
             }
-            delete Pool;
-            FreedSize += PAGETABLE_POOL_SIZE;
         }
+        PoolStats.NumBusySkipped += Busy.size() - NumWait;
+        Busy.resize(NumWait);
+
+        for(size_t i = 0; i < Idle.size(); i++)
+        {
+            __UnlinkPool(Idle[i]);
+        }
+        for(size_t i = 0; i < Busy.size(); i++)
+        {
+            __UnlinkPool(Busy[i]);
+        }
+        PoolStats.NumPoolsReleased += Idle.size() + Busy.size();
+        PoolStats.NumPoolWaits += Busy.size();
     }
     EXIT_CRITICAL_SECTION
+
+    //Unlinked pools are no longer visible to other threads
+    for(size_t i = 0; i < Idle.size() + Busy.size(); i++)
+    {
+        bool NeedWait = (i >= Idle.size());
+        Pool          = NeedWait ? Busy[i - Idle.size()] : Idle[i];
+
+        if(NeedWait && GmmCheckForNullDevCbPfn(ClientType, &DeviceCbInt, GMM_DEV_CB_WAIT_FROM_CPU))
+        {
+            GMM_DDI_WAITFORSYNCHRONIZATIONOBJECTFROMCPU Wait = {0};
+            Wait.bo                                          = Pool->GetPoolHandle();
+            GmmDeviceCallback(ClientType, &DeviceCbInt, &Wait);
+        }
+
+        Dealloc.Handle = Pool->GetPoolHandle();
+        Dealloc.GfxVA  = Pool->GetGfxAddress();
+        Dealloc.Priv   = Pool->GetGmmResInfo();
+        Dealloc.hCsr   = hCsr;
+
+        Status = __GmmDeviceDealloc(ClientType, &DeviceCbInt, &Dealloc, pClientContext);
+
+        __GMM_ASSERT(GMM_SUCCESS == Status);
+
+        delete Pool;
+    }
+}
+
+//=============================================================================
+//
+// Function: __UnlinkPool
+//
+// Desc: Removes PageTablePool from pool list and its free list, before it is
+//       freed. Called under PoolLock.
+//
+// Parameters:
+//      Pool: unused PageTablePool
+//-----------------------------------------------------------------------------
+void GmmLib::GmmPageTableMgr::__UnlinkPool(GMM_PAGETABLEPool *Pool)
+{
+    GMM_PAGETABLEPool **ppLink = &pPool;
+
+    while(*ppLink != Pool)
+    {
+        ppLink = &(*ppLink)->GetNextPool();
+    }
+    *ppLink = Pool->GetNextPool();
+
+    __RemoveFromFreeList(Pool);
+    NumNodePoolElements--;
 }
 
 //=============================================================================
 //
 // Function: __GetFreePoolNode
 //
-// Desc: Finds free node within existing PageTablePool(s), if no such node found,
-//       allocates new PageTablePool. Caller should update Pool Node usage
+// Desc: Finds free node within existing PageTablePool(s) of given type, if no
+//       such node found, allocates new PageTablePool. The node is marked used
+//       before PoolLock is dropped, so concurrent callers never get the same node;
+//       release it with __ReleasePoolNode. Pools of each type that may have free
+//       nodes are kept in a per-type list, and pools found full are dropped from
+//       it on the way, so lookup does not depend on the number of pools.
 //
 // Parameters:
 //      FreePoolNodeIdx: pointer to return Pool's free Node index
@@ -255,62 +336,134 @@ void GmmLib::GmmPageTableMgr::__ReleaseUnusedPool(GMM_UMD_SYNCCONTEXT *UmdContex
 //-----------------------------------------------------------------------------
 GmmLib::GMM_PAGETABLEPool *GmmLib::GmmPageTableMgr::__GetFreePoolNode(uint32_t *FreePoolNodeIdx, POOL_TYPE PoolType)
 {
-    uint32_t PoolNode = -1, i = 0, j = 0, DWdivisor = 1, IdxMultiplier = 1;
-    bool     PoolNodeFound = false, TRTTPool = false;
+    uint32_t IdxMultiplier = (PoolType == POOL_TYPE_AUXTTL2) ? AUX_L2TABLE_SIZE_IN_POOLNODES :
+                             (PoolType == POOL_TYPE_AUXTTL1) ? AUX_L1TABLE_SIZE_IN_POOLNODES :
+                                                               1;
+
+    __GMM_ASSERT(PoolType < POOL_TYPE_MAX);
 
     ENTER_CRITICAL_SECTION
-    GmmLib::GMM_PAGETABLEPool *Pool = pPool;
+    GmmLib::GMM_PAGETABLEPool *Pool = pFreePool[PoolType];
 
-    Pool = (PoolType == POOL_TYPE_TRTTL2) ? Pool : //1st pool reserved for TRTT-L2, since TRTT-L2 pruning not supported yet,
-           (Pool ? Pool->GetNextPool() : NULL);    //other pools can be TR-L1/Aux-L1/Aux-L2 (and support dynamic pruning)
-    TRTTPool      = (PoolType == POOL_TYPE_TRTTL2 || PoolType == POOL_TYPE_TRTTL1) ? true : false;
-    DWdivisor     = TRTTPool ? 8 * sizeof(uint32_t) : (PoolType == POOL_TYPE_AUXTTL2) ? 8 * sizeof(uint32_t) * AUX_L2TABLE_SIZE_IN_POOLNODES : 8 * sizeof(uint32_t) * AUX_L1TABLE_SIZE_IN_POOLNODES;
-    IdxMultiplier = TRTTPool ? 1 : (PoolType == POOL_TYPE_AUXTTL2) ? AUX_L2TABLE_SIZE_IN_POOLNODES : AUX_L1TABLE_SIZE_IN_POOLNODES;
+    //Scan free list for a pool with free node, dropping pools that filled up
+    while(Pool && !Pool->GetFreeNode(FreePoolNodeIdx))
+    {
+        __RemoveFromFreeList(Pool);
+        Pool = pFreePool[PoolType];
+    }
 
-    //Scan existing PageTablePools for free pool node
-    for(i = (PoolType == POOL_TYPE_TRTTL2) ? 0 : 1; Pool && i < NumNodePoolElements; i++)
+    //No free pool node, allocate new
+    if(!Pool)
     {
-        if(Pool->GetNumFreeNode() > 0 && Pool->GetPoolType() == PoolType)
+        if((Pool = __AllocateNodePool(IdxMultiplier * PAGE_SIZE, PoolType)))
         {
-            PoolNodeFound    = true;
             *FreePoolNodeIdx = 0;
-            for(; j < PAGETABLE_POOL_MAX_NODES / DWdivisor; j++)
-            {
-                if(_BitScanForward((uint32_t *)&PoolNode, (uint32_t) ~(Pool->GetNodeUsageAtIndex(j)))) // Get LSB that has value 0
-                {
-                    *FreePoolNodeIdx += PoolNode * IdxMultiplier;
-                    PoolNodeFound = true;
-                    break;
-                }
-                PoolNodeFound = false;
-                *FreePoolNodeIdx += DWdivisor; //DWORD size in bits
-            }
         }
-        if(PoolNodeFound)
+    }
+
+    if(Pool)
+    {
+        __GMM_ASSERT(Pool->GetPoolType() == PoolType);
+        Pool->AssignNode(*FreePoolNodeIdx, IdxMultiplier);
+    }
+    EXIT_CRITICAL_SECTION
+    return Pool;
+}
+
+//=============================================================================
+//
+// Function: __ReleasePoolNode
+//
+// Desc: Marks PageTablePool node (assigned by __GetFreePoolNode) free, folds the
+//       node's BB info into the pool's and puts the pool back on its free list.
+//       Doesn't reclaim the pool, as callers may hold table locks; they call
+//       __ReleaseUnusedPool once they have dropped them.
+//
+// Parameters:
+//      Pool: PageTablePool owning the node
+//      NodeIdx: first pool node of the table
+//      PerTableNodes: pool nodes per table
+//
+// Returns:
+//      1 if all nodes of the pool are free, 0 otherwise
+//-----------------------------------------------------------------------------
+uint8_t GmmLib::GmmPageTableMgr::__ReleasePoolNode(GMM_PAGETABLEPool *Pool, int NodeIdx, int PerTableNodes)
+{
+    uint8_t Unused;
+
+    ENTER_CRITICAL_SECTION
+    Pool->UpdatePoolBBInfo(Pool->GetNodeBBInfoAtIndex(NodeIdx));
+    Pool->ReleaseNode(NodeIdx, PerTableNodes);
+    __AddToFreeList(Pool);
+    Unused = (Pool->GetNumFreeNode() == PAGETABLE_POOL_MAX_NODES);
+    if(Unused)
+    {
+        Pool->GetLastUsed() = ++PoolUseStamp;
+    }
+    EXIT_CRITICAL_SECTION
+
+    return Unused;
+}
+
+//=============================================================================
+//
+// Function: __AddToFreeList
+//
+// Desc: Puts PageTablePool at the head of the free list for its PoolType, if it
+//       has free nodes and is not in the list already
+//
+// Parameters:
+//      Pool: PageTablePool that got a node freed
+//-----------------------------------------------------------------------------
+void GmmLib::GmmPageTableMgr::__AddToFreeList(GMM_PAGETABLEPool *Pool)
+{
+    ENTER_CRITICAL_SECTION
+    if(!Pool->IsInFreeList() && Pool->GetNumFreeNode() > 0)
+    {
+        GMM_PAGETABLEPool *&Head = pFreePool[Pool->GetPoolType()];
+
+        Pool->GetPrevFreePool() = NULL;
+        Pool->GetNextFreePool() = Head;
+        if(Head)
         {
-            __GMM_ASSERT(Pool->GetPoolType() == PoolType);
-            EXIT_CRITICAL_SECTION
-            return Pool;
+            Head->GetPrevFreePool() = Pool;
         }
-        Pool = Pool->GetNextPool();
+        Head                 = Pool;
+        Pool->IsInFreeList() = true;
     }
+    EXIT_CRITICAL_SECTION
+}
 
-    //No free pool node, allocate new
-    if(!PoolNodeFound)
+//=============================================================================
+//
+// Function: __RemoveFromFreeList
+//
+// Desc: Unlinks PageTablePool from the free list for its PoolType, if in it
+//
+// Parameters:
+//      Pool: PageTablePool that is full or about to be freed
+//-----------------------------------------------------------------------------
+void GmmLib::GmmPageTableMgr::__RemoveFromFreeList(GMM_PAGETABLEPool *Pool)
+{
+    ENTER_CRITICAL_SECTION
+    if(Pool->IsInFreeList())
     {
-        GMM_PAGETABLEPool *Pool = NULL;
-        if(Pool = __AllocateNodePool(IdxMultiplier * PAGE_SIZE, PoolType))
+        if(Pool->GetPrevFreePool())
         {
-            __GMM_ASSERT(Pool->GetPoolType() == PoolType);
-
-            *FreePoolNodeIdx = 0;
-            EXIT_CRITICAL_SECTION
-            return Pool;
+            Pool->GetPrevFreePool()->GetNextFreePool() = Pool->GetNextFreePool();
+        }
+        else
+        {
+            pFreePool[Pool->GetPoolType()] = Pool->GetNextFreePool();
+        }
+        if(Pool->GetNextFreePool())
+        {
+            Pool->GetNextFreePool()->GetPrevFreePool() = Pool->GetPrevFreePool();
         }
+        Pool->GetNextFreePool() = Pool->GetPrevFreePool() = NULL;
+        Pool->IsInFreeList()    = false;
     }
-
     EXIT_CRITICAL_SECTION
-    return NULL;
 }
 
 
@@ -371,6 +524,7 @@ GmmLib::GmmPageTableMgr::GmmPageTableMgr(GMM_DEVICE_CALLBACKS_INT *DeviceCB, uin
             if(status != GMM_SUCCESS)
             {
                 InitializeCriticalSection(&(ptr->PoolLock));
+                InitializeCriticalSection(&(ptr->FlushLock));
                 goto ERROR_CASE;
             }
         }
@@ -382,6 +536,7 @@ GmmLib::GmmPageTableMgr::GmmPageTableMgr(GMM_DEVICE_CALLBACKS_INT *DeviceCB, uin
         if(ptr && (AuxTTObj))
         {
             InitializeCriticalSection(&(ptr->PoolLock));
+            InitializeCriticalSection(&(ptr->FlushLock));
         }
         goto ERROR_CASE;
     }
@@ -397,7 +552,7 @@ GmmLib::GmmPageTableMgr::GmmPageTableMgr(GMM_DEVICE_CALLBACKS_INT *DeviceCB, uin
         if(ptr->AuxTTObj )
         {
             InitializeCriticalSection(&PoolLock);
-
+            InitializeCriticalSection(&FlushLock);
         }
         //Delete temporary ptr, but don't release allocated PageTable Obj.
         ptr->AuxTTObj = NULL;
@@ -467,19 +622,134 @@ GMM_STATUS GmmLib::GmmPageTableMgr::InitContextAuxTableRegister(HANDLE CmdQHandl
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
-/// Updates the Aux-PageTables, for given base resource, with appropriate mappings
+/// Maps main surface of given (validated) AuxTable update request on the Aux-Table
 ///
-/// @param[in]  Details of AuxTable update request
+/// @param[in]  AuxTTObj: Aux-Table to update
+/// @param[in]  UpdateReq: Details of AuxTable map request
+/// @param[in]  DoNotWait: 1 for CPU update, 0 for async(Gpu) update
+/// @param[in]  pBatchWriter: writer of an open batch (Prolog issued by caller), or
+///             NULL for a standalone update
 /// @return     GMM_STATUS
 /////////////////////////////////////////////////////////////////////////////////////
-GMM_STATUS GmmLib::GmmPageTableMgr::UpdateAuxTable(const GMM_DDI_UPDATEAUXTABLE *UpdateReq)
+static GMM_STATUS __MapAuxSurface(GmmLib::AuxTable *AuxTTObj, const GMM_DDI_UPDATEAUXTABLE *UpdateReq,
+                                  uint8_t DoNotWait, GmmLib::TableEntryWriter *pBatchWriter)
 {
-    if(GetAuxL3TableAddr() == 0ULL)
+    //Get AuxL1e data (other than CCS-adr) from main surface
+    uint64_t   PartialL1e = AuxTTObj->CreateAuxL1Data(UpdateReq->BaseResInfo).Value;
+    GMM_STATUS Status     = GMM_SUCCESS;
+
+    if(UpdateReq->BaseResInfo->GetResFlags().Gpu.TiledResource)
     {
-        GMM_ASSERTDPF(0, "Invalid AuxTable update request, AuxTable is not initialized");
-        return GMM_INVALIDPARAM;
+        //Aux-TT is sparsely updated, for TRs, upon change in mapping state ie
+        // null->non-null must be mapped
+        // non-null->null        invalidated on AuxTT
+        uint8_t CpuUpdate = UpdateReq->DoNotWait || !(UpdateReq->UmdContext && UpdateReq->UmdContext->pCommandQueueHandle);
+
+        GMM_GFX_ADDRESS AuxVA = UpdateReq->AuxSurfVA;
+        if(UpdateReq->BaseResInfo->GetResFlags().Gpu.UnifiedAuxSurface)
+        {
+            GMM_UNIFIED_AUX_TYPE AuxType = GMM_AUX_CCS;
+            AuxType                      = (UpdateReq->BaseResInfo->GetResFlags().Gpu.Depth && UpdateReq->BaseResInfo->GetResFlags().Gpu.CCS) ? GMM_AUX_ZCS : AuxType;
+            AuxVA                        = UpdateReq->BaseGpuVA + GmmResGetAuxSurfaceOffset(UpdateReq->BaseResInfo, AuxType);
+        }
+
+    }
+    else
+    {
+        GMM_GFX_ADDRESS AuxVA      = {0};
+        GMM_GFX_ADDRESS UVAuxVA    = {0};
+        GMM_GFX_SIZE_T  YPlaneSize = 0;
+        uint32_t        MaxPlanes  = 1;
+
+        if(!UpdateReq->AuxResInfo && UpdateReq->BaseResInfo->GetResFlags().Gpu.UnifiedAuxSurface)
+        {
+            GMM_UNIFIED_AUX_TYPE AuxType = GMM_AUX_CCS;
+            AuxType                      = (UpdateReq->BaseResInfo->GetResFlags().Gpu.Depth &&
+                       UpdateReq->BaseResInfo->GetResFlags().Gpu.CCS) ?
+                      GMM_AUX_ZCS :
+                      AuxType;
+
+            AuxVA = UpdateReq->BaseGpuVA + GmmResGetAuxSurfaceOffset(UpdateReq->BaseResInfo, AuxType);
+
+            //For UV Packed, Gen12 e2e compr supported formats have 2 planes per surface
+            //Each has distinct Aux surface, Y-plane/UV-plane must be mapped to respective Y/UV Aux surface
+            if(GmmIsPlanar(UpdateReq->BaseResInfo->GetResourceFormat()))
+            {
+                GMM_REQ_OFFSET_INFO ReqInfo = {0};
+                ReqInfo.Plane               = GMM_PLANE_U;
+                ReqInfo.ReqRender           = 1;
+
+                MaxPlanes = 2;
+                UpdateReq->BaseResInfo->GetOffset(ReqInfo);
+                YPlaneSize = ReqInfo.Render.Offset64;
+
+                UVAuxVA = UpdateReq->BaseGpuVA + GmmResGetAuxSurfaceOffset(UpdateReq->BaseResInfo, GMM_AUX_UV_CCS);
+            }
+        }
+
+        GMM_AUXTT_MAPPING_INFO Mapping = {0};
+        Mapping.BaseGpuVA              = UpdateReq->BaseGpuVA;
+        Mapping.Size                   = UpdateReq->BaseResInfo->GetSizeMainSurface();
+        Mapping.AuxSurfVA              = UpdateReq->AuxResInfo ? UpdateReq->AuxSurfVA : AuxVA;
+        Mapping.BaseResInfo            = UpdateReq->BaseResInfo;
+        Mapping.AuxResInfo             = UpdateReq->AuxResInfo;
+
+        //Reject double-map before any table is touched
+        if(AuxTTObj->AddMapping(Mapping) != GMM_SUCCESS)
+        {
+            return GMM_INVALIDPARAM;
+        }
+
+        //Per-plane Aux-TT map called with per-plane base/Aux address/size
+        for(uint32_t i = 0; i < MaxPlanes; i++)
+        {
+            GMM_GFX_SIZE_T SurfSize = (MaxPlanes > 1 && UpdateReq->BaseResInfo->GetArraySize() > 1) ?
+                                      (UpdateReq->BaseResInfo->GetQPitchPlanar(GMM_NO_PLANE) * UpdateReq->BaseResInfo->GetRenderPitch()) :
+                                      UpdateReq->BaseResInfo->GetSizeMainSurface();
+            GMM_GFX_SIZE_T MapSize = (i == 0) ? ((MaxPlanes > 1) ? YPlaneSize : SurfSize) : SurfSize - YPlaneSize;
+
+            GMM_GFX_ADDRESS BaseSurfVA = (UpdateReq->AuxResInfo || i == 0) ? UpdateReq->BaseGpuVA :
+                                                                             UpdateReq->BaseGpuVA + YPlaneSize;
+            GMM_GFX_ADDRESS AuxSurfVA = (UpdateReq->AuxResInfo) ? UpdateReq->AuxSurfVA : (i > 0 ? UVAuxVA : AuxVA);
+
+            //Luma plane reset LumaChroma bit
+            ((GMM_AUXTTL1e *)&PartialL1e)->LumaChroma = (i == 0) ? 0 : 1;
+            uint32_t ArrayEle                         = GFX_MAX(((MaxPlanes > 1) ?
+                                         UpdateReq->BaseResInfo->GetArraySize() :
+                                         1),
+                                        1);
+
+            for(uint32_t j = 0; j < ArrayEle; j++)
+            {
+                BaseSurfVA += ((j > 0) ? (UpdateReq->BaseResInfo->GetQPitchPlanar(GMM_PLANE_Y) * UpdateReq->BaseResInfo->GetRenderPitch()) : 0);
+                AuxSurfVA += (UpdateReq->AuxResInfo ?
+                              ((j > 0) ? (UpdateReq->AuxResInfo->GetQPitchPlanar(GMM_PLANE_Y) * UpdateReq->BaseResInfo->GetRenderPitch()) : 0) :
+                              ((j > 0) ? UpdateReq->BaseResInfo->GetAuxQPitch() : 0));
+
+                //(Flat mapping): Remove main/aux resInfo from params
+                Status = AuxTTObj->MapValidEntry(UpdateReq->UmdContext, BaseSurfVA, MapSize, UpdateReq->BaseResInfo,
+                                                 AuxSurfVA, UpdateReq->AuxResInfo, PartialL1e, DoNotWait, pBatchWriter);
+                if(Status != GMM_SUCCESS)
+                {
+                    AuxTTObj->RemoveMappings(Mapping.BaseGpuVA, Mapping.BaseGpuVA + Mapping.Size);
+                    GMM_ASSERTDPF(0, "Insufficient memory, free resources and try again");
+                    return Status;
+                }
+            }
+        }
     }
 
+    return GMM_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Checks given AuxTable update request can be applied on the Aux-PageTables
+///
+/// @param[in]  Details of AuxTable update request
+/// @return     GMM_SUCCESS if request is valid; GMM_INVALIDPARAM otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+static GMM_STATUS __ValidateAuxTableUpdate(const GMM_DDI_UPDATEAUXTABLE *UpdateReq)
+{
     if(!((UpdateReq->BaseResInfo->GetResFlags().Info.RenderCompressed ||
           UpdateReq->BaseResInfo->GetResFlags().Info.MediaCompressed) &&
          ((!UpdateReq->AuxResInfo && UpdateReq->BaseResInfo->GetResFlags().Gpu.UnifiedAuxSurface) ||
@@ -503,109 +773,383 @@ GMM_STATUS GmmLib::GmmPageTableMgr::UpdateAuxTable(const GMM_DDI_UPDATEAUXTABLE
         }
     }
 
-    ENTER_CRITICAL_SECTION
+    return GMM_SUCCESS;
+}
 
+/////////////////////////////////////////////////////////////////////////////////////
+/// Updates the Aux-PageTables, for given base resource, with appropriate mappings
+///
+/// @param[in]  Details of AuxTable update request
+/// @return     GMM_STATUS
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_STATUS GmmLib::GmmPageTableMgr::UpdateAuxTable(const GMM_DDI_UPDATEAUXTABLE *UpdateReq)
+{
+    if(GetAuxL3TableAddr() == 0ULL)
+    {
+        GMM_ASSERTDPF(0, "Invalid AuxTable update request, AuxTable is not initialized");
+        return GMM_INVALIDPARAM;
+    }
+
+    if(__ValidateAuxTableUpdate(UpdateReq) != GMM_SUCCESS)
+    {
+        return GMM_INVALIDPARAM;
+    }
+
+    //AuxTable locks the L2 tables it walks, and pool updates take PoolLock,
+    //so updates of disjoint VA ranges run concurrently
     if(UpdateReq->Map)
     {
-        //Get AuxL1e data (other than CCS-adr) from main surface
-        uint64_t   PartialL1e = AuxTTObj->CreateAuxL1Data(UpdateReq->BaseResInfo).Value;
-        GMM_STATUS Status     = GMM_SUCCESS;
+        return __MapAuxSurface(AuxTTObj, UpdateReq, 1, NULL);
+    }
+    else
+    {
+        //Invalidate all mappings for given main surface
+        AuxTTObj->RemoveMappings(UpdateReq->BaseGpuVA, UpdateReq->BaseGpuVA + UpdateReq->BaseResInfo->GetSizeMainSurface());
+        AuxTTObj->InvalidateTable(UpdateReq->UmdContext, UpdateReq->BaseGpuVA, UpdateReq->BaseResInfo->GetSizeMainSurface(), UpdateReq->DoNotWait);
+    }
+
+    return GMM_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Defers given AuxTable update until FlushAuxTableUpdates, or until the number of
+/// queued requests reaches the flush threshold. BaseResInfo/AuxResInfo of a queued map
+/// must remain valid until it is flushed; a queued unmap only keeps its VA range.
+///
+/// @param[in]  Details of AuxTable update request, its UmdContext/DoNotWait are used
+///             if it triggers a threshold flush
+/// @return     GMM_STATUS
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_STATUS GmmLib::GmmPageTableMgr::QueueAuxTableUpdate(const GMM_DDI_UPDATEAUXTABLE *UpdateReq)
+{
+    AuxTableUpdateQueue::QueuedUpdate Queued = {};
+    uint8_t                           Flush  = 0;
+
+    if(GetAuxL3TableAddr() == 0ULL)
+    {
+        GMM_ASSERTDPF(0, "Invalid AuxTable update request, AuxTable is not initialized");
+        return GMM_INVALIDPARAM;
+    }
+
+    if(__ValidateAuxTableUpdate(UpdateReq) != GMM_SUCCESS)
+    {
+        return GMM_INVALIDPARAM;
+    }
+
+    Queued.Req   = *UpdateReq;
+    Queued.Start = UpdateReq->BaseGpuVA;
+    Queued.End   = UpdateReq->BaseGpuVA + UpdateReq->BaseResInfo->GetSizeMainSurface();
+    if(!UpdateReq->Map)
+    {
+        //Unmap is applied on [Start, End), caller may destroy ResInfo once queued
+        Queued.Req.BaseResInfo = NULL;
+        Queued.Req.AuxResInfo  = NULL;
+    }
+
+    ENTER_CRITICAL_SECTION
+    if(!pUpdateQueue)
+    {
+        pUpdateQueue = new AuxTableUpdateQueue();
+    }
+    Queued.Seq = pUpdateQueue->NextSeq++;
+    pUpdateQueue->Requests.push_back(Queued);
+    Flush = pUpdateQueue->Threshold && (pUpdateQueue->Requests.size() >= pUpdateQueue->Threshold);
+    EXIT_CRITICAL_SECTION
+
+    return Flush ? FlushAuxTableUpdates(UpdateReq->UmdContext, UpdateReq->DoNotWait) : GMM_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Applies all queued AuxTable updates as one batch. Requests are ordered by VA
+/// (overlapping requests keep their queuing order), a map superseded by a later
+/// unmap of its range is dropped, and adjacent unmaps are merged into one table
+/// walk. GPU updates of the batch share one Prolog/Epilog on given UmdContext.
+/// Flushes are serialized, so batches from concurrent callers are applied whole,
+/// in the order they were taken from the queue.
+///
+/// @param[in]  UmdContext: Caller-thread specific info (cmdQ to use etc), applies
+///             to all queued requests
+/// @param[in]  DoNotWait: 1 for CPU update, 0 for async(Gpu) update
+/// @return     GMM_STATUS of first failed request; GMM_SUCCESS otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_STATUS GmmLib::GmmPageTableMgr::FlushAuxTableUpdates(GMM_UMD_SYNCCONTEXT *UmdContext, uint8_t DoNotWait)
+{
+    std::vector<AuxTableUpdateQueue::QueuedUpdate> Batch;
+    GMM_STATUS                                     Status = GMM_SUCCESS;
+
+    if(!AuxTTObj)
+    {
+        return GMM_INVALIDPARAM;
+    }
+
+    //Held until batch is applied, else a later batch taken by another thread could
+    //be applied ahead of it (eg remap applied before unmap of the range)
+    EnterCriticalSection(&FlushLock);
+
+    ENTER_CRITICAL_SECTION
+    if(pUpdateQueue)
+    {
+        Batch.swap(pUpdateQueue->Requests);
+    }
+    EXIT_CRITICAL_SECTION
+
+    if(Batch.empty())
+    {
+        LeaveCriticalSection(&FlushLock);
+        return GMM_SUCCESS;
+    }
+
+    DoNotWait |= (!UmdContext || !UmdContext->pCommandQueueHandle);
+
+    //Sort by VA, then restore queuing order within each group of overlapping requests,
+    //since only overlapping requests depend on each other's order
+    std::sort(Batch.begin(), Batch.end(),
+              [](const AuxTableUpdateQueue::QueuedUpdate &a, const AuxTableUpdateQueue::QueuedUpdate &b) {
+                  return (a.Start != b.Start) ? (a.Start < b.Start) : (a.Seq < b.Seq);
+              });
+
+    for(size_t GroupStart = 0, GroupEnd; GroupStart < Batch.size(); GroupStart = GroupEnd)
+    {
+        GMM_GFX_ADDRESS GroupVAEnd = Batch[GroupStart].End;
 
-        if(UpdateReq->BaseResInfo->GetResFlags().Gpu.TiledResource)
+        for(GroupEnd = GroupStart + 1; GroupEnd < Batch.size() && Batch[GroupEnd].Start < GroupVAEnd; GroupEnd++)
         {
-            //Aux-TT is sparsely updated, for TRs, upon change in mapping state ie
-            // null->non-null must be mapped
-            // non-null->null        invalidated on AuxTT
-            uint8_t CpuUpdate = UpdateReq->DoNotWait || !(UpdateReq->UmdContext && UpdateReq->UmdContext->pCommandQueueHandle);
+            GroupVAEnd = GFX_MAX(GroupVAEnd, Batch[GroupEnd].End);
+        }
 
-            GMM_GFX_ADDRESS AuxVA = UpdateReq->AuxSurfVA;
-            if(UpdateReq->BaseResInfo->GetResFlags().Gpu.UnifiedAuxSurface)
+        if(GroupEnd - GroupStart > 1)
+        {
+            std::sort(Batch.begin() + GroupStart, Batch.begin() + GroupEnd,
+                      [](const AuxTableUpdateQueue::QueuedUpdate &a, const AuxTableUpdateQueue::QueuedUpdate &b) {
+                          return a.Seq < b.Seq;
+                      });
+
+            //Map is cancelled if the next request touching its range unmaps all of it.
+            //The unmap is kept, range may hold a mapping from before this batch.
+            for(size_t i = GroupStart; i < GroupEnd; i++)
             {
-                GMM_UNIFIED_AUX_TYPE AuxType = GMM_AUX_CCS;
-                AuxType                      = (UpdateReq->BaseResInfo->GetResFlags().Gpu.Depth && UpdateReq->BaseResInfo->GetResFlags().Gpu.CCS) ? GMM_AUX_ZCS : AuxType;
-                AuxVA                        = UpdateReq->BaseGpuVA + GmmResGetAuxSurfaceOffset(UpdateReq->BaseResInfo, AuxType);
+                if(!Batch[i].Req.Map)
+                {
+                    continue;
+                }
+                for(size_t j = i + 1; j < GroupEnd; j++)
+                {
+                    if(Batch[j].Start < Batch[i].End && Batch[i].Start < Batch[j].End)
+                    {
+                        Batch[i].Cancelled = !Batch[j].Req.Map &&
+                                             Batch[j].Start <= Batch[i].Start && Batch[i].End <= Batch[j].End;
+                        break;
+                    }
+                }
             }
-
         }
-        else
-        {
-            GMM_GFX_ADDRESS AuxVA      = {0};
-            GMM_GFX_ADDRESS UVAuxVA    = {0};
-            GMM_GFX_SIZE_T  YPlaneSize = 0;
-            uint32_t        MaxPlanes  = 1;
+    }
+
+    {
+        TableEntryWriter Writer(TTCb, TTCbExt, DoNotWait ? NULL : UmdContext->pCommandQueueHandle);
+        GMM_GFX_SIZE_T   EntrySize  = !WA16K(GetLibContext()) ? GMM_KBYTE(64) : GMM_KBYTE(16); //main-surface size per Aux L1e
+        GMM_GFX_ADDRESS  UnmapStart = 0, UnmapEnd = 0;                                      //pending run of merged unmaps
+        uint8_t          InBatch    = 0;                                                    //Prolog issued
 
-            if(!UpdateReq->AuxResInfo && UpdateReq->BaseResInfo->GetResFlags().Gpu.UnifiedAuxSurface)
+        for(size_t i = 0; i <= Batch.size(); i++)
+        {
+            if(i < Batch.size() && Batch[i].Cancelled)
             {
-                GMM_UNIFIED_AUX_TYPE AuxType = GMM_AUX_CCS;
-                AuxType                      = (UpdateReq->BaseResInfo->GetResFlags().Gpu.Depth &&
-                           UpdateReq->BaseResInfo->GetResFlags().Gpu.CCS) ?
-                          GMM_AUX_ZCS :
-                          AuxType;
+                continue;
+            }
 
-                AuxVA = UpdateReq->BaseGpuVA + GmmResGetAuxSurfaceOffset(UpdateReq->BaseResInfo, AuxType);
+            //Merge unmap into pending run if adjacent, else apply the run first. Run's
+            //last Aux entry is invalidated entirely, so a gap within it is still adjacent.
+            if(i < Batch.size() && !Batch[i].Req.Map && UnmapEnd > UnmapStart &&
+               Batch[i].Start <= GFX_ALIGN(UnmapEnd, EntrySize))
+            {
+                UnmapEnd = GFX_MAX(UnmapEnd, Batch[i].End);
+                continue;
+            }
 
-                //For UV Packed, Gen12 e2e compr supported formats have 2 planes per surface
-                //Each has distinct Aux surface, Y-plane/UV-plane must be mapped to respective Y/UV Aux surface
-                if(GmmIsPlanar(UpdateReq->BaseResInfo->GetResourceFormat()))
-                {
-                    GMM_REQ_OFFSET_INFO ReqInfo = {0};
-                    ReqInfo.Plane               = GMM_PLANE_U;
-                    ReqInfo.ReqRender           = 1;
+            if(i < Batch.size() && !DoNotWait && !InBatch)
+            {
+                //One Prolog for all GPU updates of the batch, maps included, so they are
+                //recorded in queuing order with the unmaps they depend on
+                TTCb.pfPrologTranslationTable(UmdContext->pCommandQueueHandle);
+                InBatch = 1;
+            }
 
-                    MaxPlanes = 2;
-                    UpdateReq->BaseResInfo->GetOffset(ReqInfo);
-                    YPlaneSize = ReqInfo.Render.Offset64;
+            if(UnmapEnd > UnmapStart)
+            {
+                AuxTTObj->RemoveMappings(UnmapStart, UnmapEnd);
+                AuxTTObj->InvalidateTable(UmdContext, UnmapStart, UnmapEnd - UnmapStart, DoNotWait, &Writer);
+                UnmapStart = UnmapEnd = 0;
+            }
 
-                    UVAuxVA = UpdateReq->BaseGpuVA + GmmResGetAuxSurfaceOffset(UpdateReq->BaseResInfo, GMM_AUX_UV_CCS);
-                }
+            if(i == Batch.size())
+            {
+                break;
             }
 
-            //Per-plane Aux-TT map called with per-plane base/Aux address/size
-            for(uint32_t i = 0; i < MaxPlanes; i++)
+            if(Batch[i].Req.Map)
             {
-                GMM_GFX_SIZE_T SurfSize = (MaxPlanes > 1 && UpdateReq->BaseResInfo->GetArraySize() > 1) ?
-                                          (UpdateReq->BaseResInfo->GetQPitchPlanar(GMM_NO_PLANE) * UpdateReq->BaseResInfo->GetRenderPitch()) :
-                                          UpdateReq->BaseResInfo->GetSizeMainSurface();
-                GMM_GFX_SIZE_T MapSize = (i == 0) ? ((MaxPlanes > 1) ? YPlaneSize : SurfSize) : SurfSize - YPlaneSize;
-
-                GMM_GFX_ADDRESS BaseSurfVA = (UpdateReq->AuxResInfo || i == 0) ? UpdateReq->BaseGpuVA :
-                                                                                 UpdateReq->BaseGpuVA + YPlaneSize;
-                GMM_GFX_ADDRESS AuxSurfVA = (UpdateReq->AuxResInfo) ? UpdateReq->AuxSurfVA : (i > 0 ? UVAuxVA : AuxVA);
-
-                //Luma plane reset LumaChroma bit
-                ((GMM_AUXTTL1e *)&PartialL1e)->LumaChroma = (i == 0) ? 0 : 1;
-                uint32_t ArrayEle                         = GFX_MAX(((MaxPlanes > 1) ?
-                                             UpdateReq->BaseResInfo->GetArraySize() :
-                                             1),
-                                            1);
-
-                for(uint32_t j = 0; j < ArrayEle; j++)
-                {
-                    BaseSurfVA += ((j > 0) ? (UpdateReq->BaseResInfo->GetQPitchPlanar(GMM_PLANE_Y) * UpdateReq->BaseResInfo->GetRenderPitch()) : 0);
-                    AuxSurfVA += (UpdateReq->AuxResInfo ?
-                                  ((j > 0) ? (UpdateReq->AuxResInfo->GetQPitchPlanar(GMM_PLANE_Y) * UpdateReq->BaseResInfo->GetRenderPitch()) : 0) :
-                                  ((j > 0) ? UpdateReq->BaseResInfo->GetAuxQPitch() : 0));
-
-                    //(Flat mapping): Remove main/aux resInfo from params
-                    Status = AuxTTObj->MapValidEntry(UpdateReq->UmdContext, BaseSurfVA, MapSize, UpdateReq->BaseResInfo,
-                                                     AuxSurfVA, UpdateReq->AuxResInfo, PartialL1e, 1);
-                    if(Status != GMM_SUCCESS)
-                    {
-                        GMM_ASSERTDPF(0, "Insufficient memory, free resources and try again");
-                        EXIT_CRITICAL_SECTION
-                        return Status;
-                    }
-                }
+                GMM_DDI_UPDATEAUXTABLE Req = Batch[i].Req;
+                GMM_STATUS             ReqStatus;
+
+                //Maps write through batch Writer, behind the unmaps buffered in it
+                Req.UmdContext = UmdContext;
+                Req.DoNotWait  = DoNotWait;
+                ReqStatus      = __ValidateAuxTableUpdate(&Req);
+                ReqStatus      = (ReqStatus == GMM_SUCCESS) ? __MapAuxSurface(AuxTTObj, &Req, DoNotWait, &Writer) : ReqStatus;
+                Status         = (Status == GMM_SUCCESS) ? ReqStatus : Status;
             }
+            else
+            {
+                UnmapStart = Batch[i].Start;
+                UnmapEnd   = Batch[i].End;
+            }
+        }
+
+        if(InBatch)
+        {
+            Writer.Flush();
+            TTCb.pfEpilogTranslationTable(UmdContext->pCommandQueueHandle, 1); // ForceFlush
         }
     }
-    else
+
+    LeaveCriticalSection(&FlushLock);
+
+    return Status;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Sets number of queued AuxTable updates that triggers a flush from
+/// QueueAuxTableUpdate
+///
+/// @param[in]  Threshold: request count, 0 to flush on FlushAuxTableUpdates only
+/////////////////////////////////////////////////////////////////////////////////////
+void GmmLib::GmmPageTableMgr::SetAuxTableUpdateThreshold(uint32_t Threshold)
+{
+    if(!AuxTTObj)
     {
-        //Invalidate all mappings for given main surface
-        AuxTTObj->InvalidateTable(UpdateReq->UmdContext, UpdateReq->BaseGpuVA, UpdateReq->BaseResInfo->GetSizeMainSurface(), UpdateReq->DoNotWait);
+        return;
     }
 
+    ENTER_CRITICAL_SECTION
+    if(!pUpdateQueue)
+    {
+        pUpdateQueue = new AuxTableUpdateQueue();
+    }
+    pUpdateQueue->Threshold = Threshold;
     EXIT_CRITICAL_SECTION
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Looks up resource mapped on Aux-Table at given VA
+///
+/// @param[in]  GfxVA: main-surface VA
+/// @param[out] pMapping: mapped resource containing GfxVA
+/// @return     GMM_SUCCESS if GfxVA is mapped; GMM_ERROR otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_STATUS GmmLib::GmmPageTableMgr::GetAuxTableMapping(GMM_GFX_ADDRESS GfxVA, GMM_AUXTT_MAPPING_INFO *pMapping)
+{
+    __GMM_ASSERTPTR(pMapping, GMM_INVALIDPARAM);
+
+    if(!AuxTTObj)
+    {
+        return GMM_INVALIDPARAM;
+    }
+
+    return AuxTTObj->FindMapping(GfxVA, pMapping) ? GMM_SUCCESS : GMM_ERROR;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Unmaps every resource mapped inside given VA range (eg. heap being released)
+/// from the Aux-PageTables, as one batch sharing Prolog/Epilog for GPU update.
+/// Mappings straddling range boundaries are left mapped.
+///
+/// @param[in]  UmdContext: Caller-thread specific info (cmdQ to use etc)
+/// @param[in]  GfxVA: start of VA range
+/// @param[in]  Size: size of VA range in bytes
+/// @param[in]  DoNotWait: 1 for CPU update, 0 for async(Gpu) update
+/// @return     GMM_STATUS
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_STATUS GmmLib::GmmPageTableMgr::InvalidateAuxTableRange(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX_ADDRESS GfxVA, GMM_GFX_SIZE_T Size, uint8_t DoNotWait)
+{
+    std::vector<GMM_AUXTT_MAPPING_INFO> Removed;
+
+    if(GetAuxL3TableAddr() == 0ULL)
+    {
+        GMM_ASSERTDPF(0, "Invalid AuxTable update request, AuxTable is not initialized");
+        return GMM_INVALIDPARAM;
+    }
+
+    AuxTTObj->RemoveMappings(GfxVA, GfxVA + Size, &Removed);
+    if(Removed.empty())
+    {
+        return GMM_SUCCESS;
+    }
+
+    DoNotWait |= (!UmdContext || !UmdContext->pCommandQueueHandle);
+
+    if(!DoNotWait)
+    {
+        TTCb.pfPrologTranslationTable(UmdContext->pCommandQueueHandle);
+    }
+
+    {
+        TableEntryWriter Writer(TTCb, TTCbExt, DoNotWait ? NULL : UmdContext->pCommandQueueHandle);
+
+        for(size_t i = 0; i < Removed.size(); i++)
+        {
+            AuxTTObj->InvalidateTable(UmdContext, Removed[i].BaseGpuVA, Removed[i].Size, DoNotWait, &Writer);
+        }
+    }
+
+    if(!DoNotWait)
+    {
+        TTCb.pfEpilogTranslationTable(UmdContext->pCommandQueueHandle, 1); // ForceFlush
+    }
+
+    return GMM_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns page-table pool footprint and reclamation counters
+///
+/// @param[out] pStats: pool stats
+/// @return     GMM_STATUS
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_STATUS GmmLib::GmmPageTableMgr::GetPageTablePoolStats(GMM_PAGETABLE_POOL_STATS *pStats)
+{
+    __GMM_ASSERTPTR(pStats, GMM_INVALIDPARAM);
+
+    ENTER_CRITICAL_SECTION
+    *pStats                = PoolStats;
+    pStats->NumPools       = 0;
+    pStats->NumUnusedPools = 0;
+    for(GMM_PAGETABLEPool *Pool = pPool; Pool; Pool = Pool->GetNextPool())
+    {
+        pStats->NumPools++;
+        pStats->NumUnusedPools += (Pool->GetNumFreeNode() == PAGETABLE_POOL_MAX_NODES);
+        pStats->MetadataSize[Pool->GetPoolType()] += Pool->GetMetadataSize();
+    }
+    pStats->Footprint = (GMM_GFX_SIZE_T)pStats->NumPools * PAGETABLE_POOL_SIZE;
+    EXIT_CRITICAL_SECTION
+
+    return GMM_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Sets optional TT callbacks, used alongside TTCb for GPU (async) table updates
+/// and page-table pool reclamation.
+/// Clients set them once, before first TT update; NULL members are not used.
+///
+/// @param[in]  pTTCbExt: optional TT callbacks
+/// @return     GMM_STATUS
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_STATUS GmmLib::GmmPageTableMgr::SetTranslationTableCallbacksExt(const GMM_TRANSLATIONTABLE_CALLBACKS_EXT *pTTCbExt)
+{
+    __GMM_ASSERTPTR(pTTCbExt, GMM_INVALIDPARAM);
+
+    TTCbExt = *pTTCbExt;
+
     return GMM_SUCCESS;
 }
 
@@ -689,12 +1233,18 @@ GmmLib::GmmPageTableMgr::~GmmPageTableMgr()
         ENTER_CRITICAL_SECTION
         pPool->__DestroyPageTablePool(&DeviceCbInt, hCsr);
         NumNodePoolElements = 0;
+        memset(pFreePool, 0, sizeof(pFreePool));
         EXIT_CRITICAL_SECTION
     }
 
+    //Pending updates are dropped, clients flush before releasing the tables
+    delete pUpdateQueue;
+    pUpdateQueue = NULL;
+
     if(AuxTTObj)
     {
         DeleteCriticalSection(&PoolLock);
+        DeleteCriticalSection(&FlushLock);
 
         if(AuxTTObj)
         {
@@ -724,10 +1274,16 @@ GmmLib::GmmPageTableMgr::GmmPageTableMgr()
     this->pPool               = NULL;
     this->NumNodePoolElements = 0;
     this->pClientContext      = NULL;
+    this->pUpdateQueue        = NULL;
+    this->PoolUseStamp        = 0;
+    memset(&PoolStats, 0, sizeof(PoolStats));
+    memset(pFreePool, 0, sizeof(pFreePool));
     this->hCsr                = NULL;
 
     memset(&DeviceCb, 0, sizeof(GMM_DEVICE_CALLBACKS));
     memset(&DeviceCbInt, 0, sizeof(GMM_DEVICE_CALLBACKS_INT));
+    memset(&TTCb, 0, sizeof(GMM_TRANSLATIONTABLE_CALLBACKS));
+    memset(&TTCbExt, 0, sizeof(GMM_TRANSLATIONTABLE_CALLBACKS_EXT));
 }
 
 
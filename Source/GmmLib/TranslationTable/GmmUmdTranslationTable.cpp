@@ -90,40 +90,6 @@ GMM_STATUS GmmLib::PageTable::AllocateL3Table(uint32_t L3TableSize, uint32_t L3A
     return Status;
 }
 
-//=============================================================================
-//
-// Function: __IsUnusedTRTTPoolOverLimit
-//
-// Desc: Checks if unused TRTTPools have reached residency limit and must be freed.
-//
-// Parameters:
-//      pTRTT_Obj: per-device TT object. Contains TT node info
-//      OverLimitSize: Size in bytes that can be freed
-//
-// Returns:
-//      True, if unused TTPool reached max. residency limit
-//      False, otherwise
-//-----------------------------------------------------------------------------
-bool GmmLib::GmmPageTablePool::__IsUnusedTRTTPoolOverLimit(GMM_GFX_SIZE_T *OverLimitSize)
-{
-    GMM_GFX_SIZE_T             UnusedTrTTPoolSize = 0;
-    GmmLib::GMM_PAGETABLEPool *Pool               = NULL;
-
-    Pool = this;
-
-    while(Pool)
-    {
-        if(Pool->NumFreeNodes == PAGETABLE_POOL_MAX_NODES)
-        {
-            UnusedTrTTPoolSize += PAGETABLE_POOL_SIZE;
-        }
-        Pool = Pool->NextPool;
-    }
-
-    *OverLimitSize = (UnusedTrTTPoolSize > PAGETABLE_POOL_MAX_UNUSED_SIZE) ? (UnusedTrTTPoolSize - PAGETABLE_POOL_MAX_UNUSED_SIZE) : 0;
-    return (UnusedTrTTPoolSize > PAGETABLE_POOL_MAX_UNUSED_SIZE) ? true : false;
-}
-
 //=============================================================================
 //
 // Function: AllocateL1L2Table
@@ -194,17 +160,27 @@ void GmmLib::PageTable::AllocateL1L2Table(GMM_GFX_ADDRESS TileAddr, GMM_GFX_ADDR
         PoolElem = PageTableMgr->__GetFreePoolNode(&PoolNodeIdx, PoolType); //Recognize if Aux-L1 being allocated
         if(PoolElem)
         {
-            pL1Tbl = new GmmLib::LastLevelTable(PoolElem, PoolNodeIdx, GMM_L1_SIZE_DWORD(TTType, GetGmmLibContext()), L2eIdx); // use TR vs Aux L1_Size_DWORD
+            uint32_t PerTableNodes = (TTType == AUXTT) ? AUX_L1TABLE_SIZE_IN_POOLNODES : 1;
+
+            EnterCriticalSection(&TTLock); //L1Slab is shared by all L2 tables
+            pL1Tbl = L1Slab.Alloc(PoolElem, PoolNodeIdx, GMM_L1_SIZE_DWORD(TTType, GetGmmLibContext()), L2eIdx); // use TR vs Aux L1_Size_DWORD
+
+            if(pL1Tbl && !pTTL2[L3eIdx].InsertL1Table(pL1Tbl))
+            {
+                L1Slab.Free(pL1Tbl);
+                pL1Tbl = NULL;
+            }
+            LeaveCriticalSection(&TTLock);
 
             if(pL1Tbl)
             {
                 *L1TableAdr = PoolElem->GetGfxAddress() + PAGE_SIZE * PoolNodeIdx; //PoolNodeIdx should reflect 1 node per Tr-table and 2 nodes per AUX L1 TABLE
-                if(PoolNodeIdx != PAGETABLE_POOL_MAX_NODES)
-                {
-                    uint32_t PerTableNodes = (TTType == AUXTT) ? AUX_L1TABLE_SIZE_IN_POOLNODES : 1;
-                    ASSIGN_POOLNODE(PoolElem, PoolNodeIdx, PerTableNodes)
-                }
-                pTTL2[L3eIdx].InsertInList(pL1Tbl);
+                ASSIGN_POOLNODE(PoolElem, PoolNodeIdx, PerTableNodes)
+            }
+            else
+            {
+                uint8_t Unused = 0; //left for the next walk's __ReleaseUnusedPool
+                DEASSIGN_POOLNODE(PageTableMgr, PoolElem, PoolNodeIdx, PerTableNodes, Unused)
             }
         }
     }
@@ -260,15 +236,18 @@ void GmmLib::PageTable::AllocateDummyTables(GmmLib::Table **L2Table, GmmLib::Tab
         PoolElem = PageTableMgr->__GetFreePoolNode(&PoolNodeIdx, PoolType); //Recognize if Aux-L1 being allocated
         if(PoolElem)
         {
+            uint32_t PerTableNodes = (TTType == AUXTT) ? AUX_L1TABLE_SIZE_IN_POOLNODES : 1;
+
             *L1Table = new GmmLib::LastLevelTable(PoolElem, PoolNodeIdx, GMM_L1_SIZE_DWORD(TTType, GetGmmLibContext()), 0); // use TR vs Aux L1_Size_DWORD
 
             if(*L1Table)
             {
-                if(PoolNodeIdx != PAGETABLE_POOL_MAX_NODES)
-                {
-                    uint32_t PerTableNodes = (TTType == AUXTT) ? AUX_L1TABLE_SIZE_IN_POOLNODES : 1;
-                    ASSIGN_POOLNODE(PoolElem, PoolNodeIdx, PerTableNodes)
-                }
+                ASSIGN_POOLNODE(PoolElem, PoolNodeIdx, PerTableNodes)
+            }
+            else
+            {
+                uint8_t Unused = 0; //left for the next walk's __ReleaseUnusedPool
+                DEASSIGN_POOLNODE(PageTableMgr, PoolElem, PoolNodeIdx, PerTableNodes, Unused)
             }
         }
     }
@@ -358,7 +337,6 @@ uint8_t GmmLib::PageTable::GetMappingType(GMM_GFX_ADDRESS GfxVA, GMM_GFX_SIZE_T
     L1eIdx      = GMM_L1_ENTRY_IDX(TTType, GfxVA, GetGmmLibContext());
     L1EntrySize = (!WA16K(GetGmmLibContext())) ? GMM_KBYTE(64) : GMM_KBYTE(16);
 
-    EnterCriticalSection(&TTLock);
     __GMM_ASSERT(TTL3.L3Handle);
 
 #define GET_NEXT_L1TABLE(L1eIdx, L2eIdx, L3eIdx) \
@@ -388,6 +366,9 @@ uint8_t GmmLib::PageTable::GetMappingType(GMM_GFX_ADDRESS GfxVA, GMM_GFX_SIZE_T
 
     while(!(bFoundLastVA || bTerminate) && (TileAddr < GfxVA + Size))
     {
+        GMM_GFX_SIZE_T LockedL3eIdx = L3eIdx; //L3eIdx may advance below
+
+        EnterL2CriticalSection(LockedL3eIdx);
         if(pTTL2[L3eIdx].GetPool())
         {
             GmmLib::LastLevelTable *pL1Tbl = NULL;
@@ -473,6 +454,7 @@ uint8_t GmmLib::PageTable::GetMappingType(GMM_GFX_ADDRESS GfxVA, GMM_GFX_SIZE_T
                 GET_NEXT_L2TABLE(L1eIdx, L2eIdx, L3eIdx)
             }
         }
+        LeaveL2CriticalSection(LockedL3eIdx);
     }
 
     if(!bFoundLastVA)
@@ -480,7 +462,6 @@ uint8_t GmmLib::PageTable::GetMappingType(GMM_GFX_ADDRESS GfxVA, GMM_GFX_SIZE_T
         LastAddr = TileAddr;
     }
 
-    LeaveCriticalSection(&TTLock);
     return MapType;
 }
 
@@ -534,6 +515,52 @@ bool GmmLib::Table::TrackTableUsage(TT_TYPE Type, bool IsL1, GMM_GFX_ADDRESS Til
     return NullMapped ? true : false;
 }
 
+//=============================================================================
+//
+// Function: TrackTableUsageRange
+//
+// Desc: TrackTableUsage for a run of consecutive entries, from given tile address
+//       to end of run (within the table), updating usage a DWORD at a time
+//
+// Parameters:
+//      Type:  Translation Table type (Aux)
+//      IsL1:  Is called for L1table or L2 Table
+//      TileAddr: Tiled Resource Virtual address of first entry in run
+//      NumEntries: entries in run
+//      NullMapped: true if run was null mapped, otherwise false
+//
+// Returns:
+//     true, if Table for given tile adr is all null mapped
+//     false,if Table does not exist or has non-null mapping
+//-----------------------------------------------------------------------------
+bool GmmLib::Table::TrackTableUsageRange(TT_TYPE Type, bool IsL1, GMM_GFX_ADDRESS TileAdr, uint32_t NumEntries, bool NullMapped, GMM_LIB_CONTEXT *pGmmLibContext)
+{
+    uint32_t EntryIdx, EndIdx;
+
+    EntryIdx = IsL1 ? static_cast<uint32_t>(GMM_L1_ENTRY_IDX(Type, TileAdr, pGmmLibContext)) : static_cast<uint32_t>(GMM_L2_ENTRY_IDX(Type, TileAdr));
+    EndIdx   = EntryIdx + NumEntries;
+
+    while(EntryIdx < EndIdx)
+    {
+        uint32_t ElemNum = EntryIdx / 32;
+        uint32_t BitNum  = EntryIdx % 32;
+        uint32_t NumBits = GFX_MIN(32 - BitNum, EndIdx - EntryIdx);
+        uint32_t Mask    = (NumBits == 32) ? 0xFFFFFFFF : (((1u << NumBits) - 1) << BitNum);
+
+        if(NullMapped)
+        {
+            UsedEntries[ElemNum] &= ~Mask;
+        }
+        else
+        {
+            UsedEntries[ElemNum] |= Mask;
+        }
+        EntryIdx += NumBits;
+    }
+
+    return NullMapped ? IsTableNullMapped(Type, IsL1, TileAdr, pGmmLibContext) : false;
+}
+
 //=============================================================================
 //
 // Function: __IsTableNullMapped
@@ -568,24 +595,22 @@ bool GmmLib::Table::IsTableNullMapped(TT_TYPE Type, bool IsL1, GMM_GFX_ADDRESS T
 //
 // Function: __UpdatePoolFence
 //
-// Desc: Updates AUXTTPool's or Table's BBFenceObj/value with current BB fence
+// Desc: Updates Table's BBFenceObj/value with current BB fence. Called under
+//       the table's L2 lock; pool's BB info is updated from it under PoolLock,
+//       once the table's pool node is released (__ReleasePoolNode)
 //
 // Parameters:
-//      pAUXTT_Obj: per-device AUX-TT object. Contains AUXTT node info
-//      Table:     L1/L2 table pointer
-//      L1Table:   true for L1 Table, else false
+//      UmdContext: Caller-thread specific info (current BB fence)
 //      ClearNode: if true, Fence info is cleared for table
-//                    false, Fence info is updated for table and pool
+//                    false, Fence info is updated for table
 //-----------------------------------------------------------------------------
 void GmmLib::Table::UpdatePoolFence(GMM_UMD_SYNCCONTEXT *UmdContext, bool ClearNode)
 {
     if(!ClearNode)
     {
-        //update both node and pool with current fence/handle
-        PoolElem->GetPoolBBInfo().BBQueueHandle =
+        //update node with current fence/handle
         BBInfo.BBQueueHandle = UmdContext->BBFenceObj;
-        PoolElem->GetPoolBBInfo().BBFence =
-        BBInfo.BBFence = UmdContext->BBLastFence + 1; //Save incremented fence value, since DX does it during submission
+        BBInfo.BBFence       = UmdContext->BBLastFence + 1; //Save incremented fence value, since DX does it during submission
     }
     else
     {
@@ -595,6 +620,81 @@ void GmmLib::Table::UpdatePoolFence(GMM_UMD_SYNCCONTEXT *UmdContext, bool ClearN
     }
 }
 
+//=============================================================================
+//
+// Function: Write
+//
+// Desc: Queues GPU write of one 64-bit table entry, appending it to pending run
+//       if it's the next consecutive entry, else flushing pending run first.
+//
+// Parameters:
+//      GfxAddress: Gfx adr of table entry
+//      Data: entry value
+//-----------------------------------------------------------------------------
+void GmmLib::TableEntryWriter::Write(GMM_GFX_ADDRESS GfxAddress, uint64_t Data)
+{
+    if(!TTCbExt.pfWriteL2L3Entries)
+    {
+        TTCb.pfWriteL2L3Entry(pCommandQueueHandle, GfxAddress, Data);
+        return;
+    }
+
+    if(NumEntries &&
+       (NumEntries == GMM_TT_ENTRY_WRITE_BATCH ||
+        GfxAddress != StartGfxAddress + NumEntries * sizeof(uint64_t)))
+    {
+        Flush();
+    }
+
+    if(!NumEntries)
+    {
+        StartGfxAddress = GfxAddress;
+    }
+    Entries[NumEntries++] = Data;
+}
+
+//=============================================================================
+//
+// Function: Fill
+//
+// Desc: Queues GPU write of same value to consecutive 64-bit table entries
+//       eg to initialize newly allocated L1/L2 table
+//
+// Parameters:
+//      GfxAddress: Gfx adr of first table entry
+//      Count: number of entries
+//      Data: entry value
+//-----------------------------------------------------------------------------
+void GmmLib::TableEntryWriter::Fill(GMM_GFX_ADDRESS GfxAddress, uint32_t Count, uint64_t Data)
+{
+    if(TTCbExt.pfFillL2L3Entries)
+    {
+        Flush();
+        TTCbExt.pfFillL2L3Entries(pCommandQueueHandle, GfxAddress, Count, Data);
+        return;
+    }
+
+    for(uint32_t i = 0; i < Count; i++)
+    {
+        Write(GfxAddress + i * sizeof(uint64_t), Data);
+    }
+}
+
+//=============================================================================
+//
+// Function: Flush
+//
+// Desc: Issues pending run of consecutive entries as single ranged write
+//-----------------------------------------------------------------------------
+void GmmLib::TableEntryWriter::Flush()
+{
+    if(NumEntries)
+    {
+        TTCbExt.pfWriteL2L3Entries(pCommandQueueHandle, StartGfxAddress, NumEntries, Entries);
+        NumEntries = 0;
+    }
+}
+
 /////////////////////////////////////////////////////////////////////////////////////
 /// Releases all PageTable Pool(s) existing in Linked List
 ///
@@ -78,6 +78,8 @@ static inline int _BitScanForward(uint32_t *index, uint32_t mask)
 
 #define GMM_L1_SIZE(TTType, pGmmLibContext)  GMM_AUX_L1_SIZE(pGmmLibContext)
 #define GMM_L1_SIZE_DWORD(TTType, pGmmLibContext) GMM_AUX_L1_SIZE_DWORD(pGmmLibContext)
+#define GMM_L1_SIZE_DWORD_MAX(TTType)             GFX_CEIL_DIV(1 << (GMM_AUX_L1_HIGH_BIT - GMM_AUX_L1_LOW_BIT + 1), 32) //16K-granular L1
+#define GMM_TT_ENTRY_WRITE_BATCH                  256 //max 64-bit entries per pfWriteL2L3Entries call
 #define GMM_L2_SIZE(TTType)                       GMM_AUX_L2_SIZE
 #define GMM_L2_SIZE_DWORD(TTType)                 GMM_AUX_L2_SIZE_DWORD 
 #define GMM_L3_SIZE(TTType)                       GMM_AUX_L3_SIZE 
@@ -91,6 +93,10 @@ static inline int _BitScanForward(uint32_t *index, uint32_t mask)
 
 #ifdef __cplusplus
 #include "External/Common/GmmMemAllocator.hpp"
+#include <atomic>
+#include <map>
+#include <new>
+#include <vector>
 
 //HW provides single-set of TR/Aux-TT registers for non-privileged programming
 //Engine-specific offsets are HW-updated with programmed values.
@@ -98,18 +104,15 @@ static inline int _BitScanForward(uint32_t *index, uint32_t mask)
            L3AdrOffset = 0x4200;            
 
 
+//Pool node is marked used by __GetFreePoolNode, clear BB info of its previous user
 #define ASSIGN_POOLNODE(Pool, NodeIdx, PerTableNodes)    {       \
-    (Pool)->GetNodeUsageAtIndex((NodeIdx) / (32 *(PerTableNodes))) |= __BIT(((NodeIdx) / (PerTableNodes)) % 32);  \
-    (Pool)->GetNodeBBInfoAtIndex(NodeIdx) = SyncInfo();                              \
-    (Pool)->GetNumFreeNode() -= (PerTableNodes);                      \
+    (Pool)->SetNodeBBInfoAtIndex((NodeIdx), SyncInfo());                             \
                                           }
 
-#define DEASSIGN_POOLNODE(PageTableMgr, UmdContext, Pool, NodeIdx, PerTableNodes)  {            \
-    (Pool)->GetNodeUsageAtIndex((NodeIdx) / (32 * (PerTableNodes))) &= ~__BIT(((NodeIdx) / (PerTableNodes)) % 32 );  \
-    (Pool)->GetNumFreeNode() += (PerTableNodes);                      \
-    if((Pool)->GetNumFreeNode() == PAGETABLE_POOL_MAX_NODES) {        \
-    PageTableMgr->__ReleaseUnusedPool((UmdContext));              \
-                                                    }             \
+//Sets PoolUnused if pool has no table left, caller then reclaims unused pools
+//(__ReleaseUnusedPool) once it holds no table locks
+#define DEASSIGN_POOLNODE(PageTableMgr, Pool, NodeIdx, PerTableNodes, PoolUnused)  {            \
+    (PoolUnused) |= PageTableMgr->__ReleasePoolNode((Pool), (NodeIdx), (PerTableNodes));        \
                                           }
 
 namespace GmmLib
@@ -119,7 +122,10 @@ namespace GmmLib
 #define PAGETABLE_POOL_SIZE              PAGETABLE_POOL_MAX_NODES * PAGE_SIZE   //Pool for L2/L1 table allocation
 #define AUX_L2TABLE_SIZE_IN_POOLNODES    8                                 //Aux L2 is 32KB
 #define AUX_L1TABLE_SIZE_IN_POOLNODES    2                                 //Aux L1 is 8KB
-#define PAGETABLE_POOL_MAX_UNUSED_SIZE   GMM_MBYTE(16)                     //Max. size of unused pool, driver keeps resident
+#define PAGETABLE_L2_LOCKS               64                                //L2 tables (ie L3 entries) striped over locks
+#define PAGETABLE_POOL_MAX_UNUSED_SIZE   GMM_MBYTE(16)                     //Max. size of unused pool, driver keeps resident (reclaim high watermark)
+#define PAGETABLE_POOL_MIN_UNUSED_SIZE   GMM_MBYTE(8)                      //Size of unused pool reclamation trims down to (low watermark)
+#define AUXTT_UPDATE_QUEUE_THRESHOLD     64                                //Default queued Aux-TT updates that trigger a flush
 
 
     //////////////////////////////////////////////////////////////////////////////////////////////
@@ -141,18 +147,25 @@ namespace GmmLib
 
                                       //PageTablePool usage descriptors
         int              NumFreeNodes;    //has value {0 to Pool_Max_nodes}
-        uint32_t*           NodeUsage;       //destined node state (updated during node assignment and removed based on destined state of L1/L2 Table 
+        int              NumTables;       //tables pool holds, ie MaxPoolNodes for TR, /8 for AuxL2, /2 for AuxL1
+        uint32_t         NodeUsageSummary; //1b per NodeUsage DWORD, set while the DWORD has a free table (NodeUsage has at most 32 DWORDs)
+        uint32_t         NodeUsage[PAGETABLE_POOL_SIZE_IN_DWORD];
+                                          //destined node state (updated during node assignment and removed based on destined state of L1/L2 Table 
                                           //that used the pool node) 
                                           //Aux-Pool node-usage tracked at every eighth/second node(for L2 vs L1) 
                                           //ie 1b per node for TR-table, 1b per 8-nodes for Aux-L2table, 1b per 2-nodes for AuxL1-table
-                                          //array size= POOL_SIZE_IN_DWORD for TR, =POOL_SIZE_IN_DWORD/8 for AuxL2, POOL_SIZE_IN_DWORD/2 for AuxL1
+                                          //first NumTables / 32 DWORDs used, kept inline with the summary for __GetFreePoolNode
 
-        SyncInfo*        NodeBBInfo;      //BB info for pending Gpu usage of each pool node
-                                          //array of size MaxPoolNodes for TR, =MaxPoolNodes / 8 for Aux, MaxPoolNodes / 2 for AuxL1
+        std::atomic<SyncInfo*> NodeBBInfo; //BB info for pending Gpu usage of each table (NumTables entries), allocated
+                                           //once a table is released with Gpu usage pending; pools only updated on Cpu have none
 
-        SyncInfo         PoolBBInfo;      //BB info for Gpu usage of the Pool (most recent of pool node BB info)
+        SyncInfo         PoolBBInfo;      //BB info for Gpu usage of the Pool (most recent of released pool node BB info, PoolLock)
 
         GmmPageTablePool* NextPool;       //Next node-Pool in the LinkedList
+        GmmPageTablePool* NextFreePool;   //Next/Prev node-Pool in PageTableMgr's free list for PoolType
+        GmmPageTablePool* PrevFreePool;
+        bool              InFreeList;
+        uint64_t          LastUsed;       //PageTableMgr's PoolUseStamp at last node release, for LRU reclamation
         GmmClientContext    *pClientContext;    ///< ClientContext of the client creating this Object
     public:
         GmmPageTablePool() :
@@ -162,10 +175,16 @@ namespace GmmLib
             CPUAddress(0x0),
             PoolType(POOL_TYPE_TRTTL1),
             NumFreeNodes(PAGETABLE_POOL_MAX_NODES),
-            NodeUsage(NULL),
+            NumTables(PAGETABLE_POOL_MAX_NODES),
+            NodeUsageSummary(0),
+            NodeUsage(),
             NodeBBInfo(NULL),
             PoolBBInfo(),
             NextPool(NULL),
+            NextFreePool(NULL),
+            PrevFreePool(NULL),
+            InFreeList(false),
+            LastUsed(0),
             pClientContext(NULL)
         {
 
@@ -180,11 +199,8 @@ namespace GmmLib
             NextPool = NULL;
             NumFreeNodes = PAGETABLE_POOL_MAX_NODES;
             PoolType = Type;
-            int DwordPoolSize = (Type == POOL_TYPE_AUXTTL1) ? PAGETABLE_POOL_SIZE_IN_DWORD / AUX_L1TABLE_SIZE_IN_POOLNODES
-                                        : (Type == POOL_TYPE_AUXTTL2) ? PAGETABLE_POOL_SIZE_IN_DWORD / AUX_L2TABLE_SIZE_IN_POOLNODES
-                                        : PAGETABLE_POOL_SIZE_IN_DWORD;
-            NodeUsage = new uint32_t[DwordPoolSize]();
-            NodeBBInfo = new SyncInfo[DwordPoolSize * 32]();
+            NumTables = PAGETABLE_POOL_MAX_NODES / GetNodesPerTable();
+            NodeUsageSummary = (uint32_t)((1ULL << (NumTables / 32)) - 1);
             if (pGmmResInfo)
             {
                 pClientContext = pGmmResInfo->GetGmmClientContext();
@@ -197,8 +213,7 @@ namespace GmmLib
         }
         ~GmmPageTablePool()
         {
-            delete[] NodeUsage;
-            delete[] NodeBBInfo;
+            delete[] NodeBBInfo.load();
         }
 
         GmmPageTablePool* InsertInList(GmmPageTablePool* NewNode)
@@ -220,17 +235,99 @@ namespace GmmLib
         }
 
         GmmPageTablePool* &GetNextPool() { return NextPool; }
+        GmmPageTablePool* &GetNextFreePool() { return NextFreePool; }
+        GmmPageTablePool* &GetPrevFreePool() { return PrevFreePool; }
+        bool& IsInFreeList() { return InFreeList; }
+        uint64_t& GetLastUsed() { return LastUsed; }
         HANDLE& GetPoolHandle() { return PoolHandle; }
         POOL_TYPE& GetPoolType() { return PoolType; }
         int& GetNumFreeNode() { return NumFreeNodes; }
-        SyncInfo& GetPoolBBInfo() { return PoolBBInfo; }
         uint32_t& GetNodeUsageAtIndex(int j) { return NodeUsage[j]; }
-        SyncInfo& GetNodeBBInfoAtIndex(int j)
+
+        int GetNodesPerTable()
+        {
+            return (PoolType == POOL_TYPE_AUXTTL1) ? AUX_L1TABLE_SIZE_IN_POOLNODES
+                   : (PoolType == POOL_TYPE_AUXTTL2) ? AUX_L2TABLE_SIZE_IN_POOLNODES
+                   : 1;
+        }
+
+        // Finds the lowest free table in the pool, via the NodeUsageSummary DWORD
+        // then the NodeUsage bit. Returns false if the pool is full.
+        bool GetFreeNode(uint32_t *FreePoolNodeIdx)
+        {
+            uint32_t Dword = 0, Bit = 0;
+            int      PerTableNodes = GetNodesPerTable();
+
+            if(!_BitScanForward((uint32_t *)&Dword, NodeUsageSummary) ||
+               !_BitScanForward((uint32_t *)&Bit, (uint32_t)~NodeUsage[Dword]))
+            {
+                return false;
+            }
+            *FreePoolNodeIdx = (Dword * 32 + Bit) * PerTableNodes;
+            return true;
+        }
+        void AssignNode(int NodeIdx, int PerTableNodes)
         {
-            int BBInfoNodeIdx = (PoolType == POOL_TYPE_AUXTTL1) ? j / AUX_L1TABLE_SIZE_IN_POOLNODES
-                : (PoolType == POOL_TYPE_AUXTTL2) ? j / AUX_L2TABLE_SIZE_IN_POOLNODES
-                : j;
-            return NodeBBInfo[BBInfoNodeIdx];
+            int Dword = NodeIdx / (32 * PerTableNodes);
+
+            NodeUsage[Dword] |= __BIT((NodeIdx / PerTableNodes) % 32);
+            if(NodeUsage[Dword] == 0xFFFFFFFF)
+            {
+                NodeUsageSummary &= ~__BIT(Dword);
+            }
+            NumFreeNodes -= PerTableNodes;
+        }
+        void ReleaseNode(int NodeIdx, int PerTableNodes)
+        {
+            int Dword = NodeIdx / (32 * PerTableNodes);
+
+            NodeUsage[Dword] &= ~__BIT((NodeIdx / PerTableNodes) % 32);
+            NodeUsageSummary |= __BIT(Dword);
+            NumFreeNodes += PerTableNodes;
+        }
+        SyncInfo GetNodeBBInfoAtIndex(int j)
+        {
+            SyncInfo *pBBInfo = NodeBBInfo.load(std::memory_order_acquire);
+            return pBBInfo ? pBBInfo[j / GetNodesPerTable()] : SyncInfo();
+        }
+        // Tables of one pool are released under different L2 locks, so BB info array
+        // is published with compare-exchange by whichever thread needs it first
+        void SetNodeBBInfoAtIndex(int j, const SyncInfo &BBInfo)
+        {
+            SyncInfo *pBBInfo = NodeBBInfo.load(std::memory_order_acquire);
+            if(!pBBInfo)
+            {
+                SyncInfo *pNew = NULL;
+                if(!BBInfo.BBQueueHandle && !BBInfo.BBFence)
+                {
+                    return;
+                }
+                pNew = new SyncInfo[NumTables]();
+                if(NodeBBInfo.compare_exchange_strong(pBBInfo, pNew, std::memory_order_acq_rel))
+                {
+                    pBBInfo = pNew;
+                }
+                else
+                {
+                    delete[] pNew;
+                }
+            }
+            pBBInfo[j / GetNodesPerTable()] = BBInfo;
+        }
+        // Folds BB info of a released table into pool's, called under PoolLock. Tables
+        // still in use keep pool busy by themselves, so only released ones are tracked.
+        void UpdatePoolBBInfo(const SyncInfo &BBInfo)
+        {
+            if(BBInfo.BBQueueHandle &&
+               (PoolBBInfo.BBQueueHandle != BBInfo.BBQueueHandle || PoolBBInfo.BBFence <= BBInfo.BBFence))
+            {
+                PoolBBInfo = BBInfo;
+            }
+        }
+        // Pool bookkeeping bytes, object and per-table BB info
+        size_t GetMetadataSize()
+        {
+            return sizeof(*this) + (NodeBBInfo.load(std::memory_order_relaxed) ? NumTables * sizeof(SyncInfo) : 0);
         }
         GMM_GFX_ADDRESS GetGfxAddress() { return PoolGfxAddress; }
         GMM_GFX_ADDRESS GetCPUAddress() { return CPUAddress; }
@@ -244,7 +341,6 @@ namespace GmmLib
             }
             return false;
         }
-        bool __IsUnusedTRTTPoolOverLimit(GMM_GFX_SIZE_T * OverLimitSize);
         void ClearBBReference(void * BBQHandle);
         GMM_STATUS __DestroyPageTablePool(void * DeviceCallbacks,HANDLE hCsr);
     };
@@ -276,6 +372,7 @@ namespace GmmLib
         SyncInfo& GetBBInfo() { return BBInfo; }
         uint32_t* &GetUsedEntries() { return UsedEntries; }
         bool TrackTableUsage(TT_TYPE Type, bool IsL1, GMM_GFX_ADDRESS TileAdr, bool NullMapped,GMM_LIB_CONTEXT* pGmmLibContext);
+        bool TrackTableUsageRange(TT_TYPE Type, bool IsL1, GMM_GFX_ADDRESS TileAdr, uint32_t NumEntries, bool NullMapped, GMM_LIB_CONTEXT *pGmmLibContext);
         bool IsTableNullMapped(TT_TYPE Type, bool IsL1, GMM_GFX_ADDRESS TileAdr,GMM_LIB_CONTEXT *pGmmLibContext);
         void UpdatePoolFence(GMM_UMD_SYNCCONTEXT * UmdContext, bool ClearNode);
     };
@@ -288,36 +385,103 @@ namespace GmmLib
     {
     private:
         uint32_t         L2eIdx;
-        LastLevelTable *pNext;
+        uint32_t         UsedEntriesL1[GMM_L1_SIZE_DWORD_MAX(AUXTT)]; //UsedEntries storage, sized for 16K-granular L1
 
     public:
         LastLevelTable() : Table(),
             L2eIdx()                             //Pass in Aux vs TR table's GMM_L2_SIZE and initialize L2eIdx?
         {
-            pNext = NULL;
+            memset(UsedEntriesL1, 0, sizeof(UsedEntriesL1));
+            UsedEntries = UsedEntriesL1;
         }
 
         LastLevelTable(GMM_PAGETABLEPool* Elem, int NodeIdx, int DwordL1e, int L2eIndex)
             : LastLevelTable()
         {
+            __GMM_ASSERT(DwordL1e <= GMM_L1_SIZE_DWORD_MAX(AUXTT));
             PoolElem = Elem;
             PoolNodeIdx = NodeIdx;
             BBInfo = Elem->GetNodeBBInfoAtIndex(NodeIdx);
             L2eIdx = L2eIndex;
-            pNext = NULL;
-            UsedEntries = new uint32_t[DwordL1e]();
-        }
-        ~LastLevelTable()
-        {
-            delete[] UsedEntries;
         }
 
         int GetL2eIdx() {
             return L2eIdx;
         }
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// Contains functions and members for LastLevelTableSlab. 
+    /// Hands out LastLevelTable objects from chunks sized for one pool's worth of Aux-L1 tables,
+    /// recycling released ones, instead of allocating each L1 table on the heap.
+    /// Not thread-safe, used under PageTable's TTLock.
+    /////////////////////////////////////////////////////////////////////////////////////////////
+    class LastLevelTableSlab
+    {
+    private:
+        union Slot
+        {
+            Slot*   pNextFree;
+            alignas(LastLevelTable) uint8_t Storage[sizeof(LastLevelTable)];
+        };
+        struct Chunk
+        {
+            Chunk* pNext;
+            Slot   Slots[PAGETABLE_POOL_MAX_NODES / AUX_L1TABLE_SIZE_IN_POOLNODES];
+        };
 
-        LastLevelTable* &Next() {
-            return pNext;
+        Chunk*  pChunks;                 //all chunks, freed with the slab
+        Slot*   pFreeSlots;              //free-list of unused slots
+
+    public:
+        LastLevelTableSlab() :
+            pChunks(NULL),
+            pFreeSlots(NULL)
+        {
+        }
+        ~LastLevelTableSlab()
+        {
+            //LastLevelTable has trivial clean-up, live tables go with their chunk
+            while (pChunks)
+            {
+                Chunk* Next = pChunks->pNext;
+                delete pChunks;
+                pChunks = Next;
+            }
+        }
+
+        LastLevelTable* Alloc(GMM_PAGETABLEPool* Elem, int NodeIdx, int DwordL1e, int L2eIndex)
+        {
+            Slot* pSlot = NULL;
+
+            if (!pFreeSlots)
+            {
+                Chunk* pChunk = new Chunk;
+                if (!pChunk)
+                {
+                    return NULL;
+                }
+                pChunk->pNext = pChunks;
+                pChunks = pChunk;
+                for (int i = sizeof(pChunk->Slots) / sizeof(pChunk->Slots[0]) - 1; i >= 0; i--)
+                {
+                    pChunk->Slots[i].pNextFree = pFreeSlots;
+                    pFreeSlots = &pChunk->Slots[i];
+                }
+            }
+
+            pSlot = pFreeSlots;
+            pFreeSlots = pSlot->pNextFree;
+            return new (pSlot->Storage) LastLevelTable(Elem, NodeIdx, DwordL1e, L2eIndex);
+        }
+
+        void Free(LastLevelTable* pL1Tbl)
+        {
+            Slot* pSlot = reinterpret_cast<Slot*>(pL1Tbl);
+
+            pL1Tbl->~LastLevelTable();
+            pSlot->pNextFree = pFreeSlots;
+            pFreeSlots = pSlot;
         }
     };
 
@@ -328,7 +492,8 @@ namespace GmmLib
     class MidLevelTable : public Table
     {
     private:
-        LastLevelTable  *pTTL1;                    //linked list of L1 tables
+        LastLevelTable  **pTTL1;                   //L1 tables indexed by L2eIdx, array of GMM_AUX_L2_SIZE
+                                                   //allocated with the first L1 table; tables owned by PageTable's slab
 
     public:
         MidLevelTable() :Table()
@@ -343,76 +508,34 @@ namespace GmmLib
         }
         ~MidLevelTable()
         {
-            if (pTTL1)
-            {
-                LastLevelTable* item = pTTL1;
-
-                while (item)
-                {
-                    LastLevelTable* nextItem = item->Next();
-                    delete item;
-                    item = nextItem;
-                }
-
-                pTTL1 = NULL;
-            }
+            delete[] pTTL1;
+            pTTL1 = NULL;
         }
-        LastLevelTable* GetL1Table(GMM_GFX_SIZE_T L2eIdx, LastLevelTable** Prev = NULL)
+        LastLevelTable* GetL1Table(GMM_GFX_SIZE_T L2eIdx)
         {
-            LastLevelTable* pL1Tbl = pTTL1;
-            LastLevelTable* PrevL1Tbl = NULL;
-
-            while (pL1Tbl)
-            {
-                if (pL1Tbl->GetL2eIdx() == L2eIdx)
-                {
-                    break;
-                }
-                PrevL1Tbl = pL1Tbl;
-                pL1Tbl = pL1Tbl->Next();
-            }
-
-            //if requested, save previous node in linked-list
-            if (Prev)
-            {
-                *Prev = PrevL1Tbl;
-            }
-            return pL1Tbl;
+            return pTTL1 ? pTTL1[L2eIdx] : NULL;
         }
-        void InsertInList(LastLevelTable* pL1Tbl)
+        bool InsertL1Table(LastLevelTable* pL1Tbl)
         {
-            LastLevelTable* Prev = pTTL1;
-
-            //Insert at end
-            while (Prev && Prev->Next())
+            if (!pTTL1)
             {
-                Prev = Prev->Next();
-            }
-
-            if (Prev)
-            {
-                Prev->Next() = pL1Tbl;
-            }
-            else
-            {
-                pTTL1 = pL1Tbl;
+                pTTL1 = new LastLevelTable*[GMM_AUX_L2_SIZE]();
+                if (!pTTL1)
+                {
+                    return false;
+                }
             }
+            __GMM_ASSERT(!pTTL1[pL1Tbl->GetL2eIdx()]);
+            pTTL1[pL1Tbl->GetL2eIdx()] = pL1Tbl;
+            return true;
         }
-        void DeleteFromList(LastLevelTable* pL1Tbl, LastLevelTable* PrevL1Tbl)
+        void DeleteL1Table(LastLevelTable* pL1Tbl, LastLevelTableSlab &Slab)
         {
-            //Save next L1Table in list, before deleting current one
             if (pL1Tbl)
             {
-                if (PrevL1Tbl)
-                {
-                    PrevL1Tbl->Next() = pL1Tbl->Next();
-                }
-                else
-                {
-                    pTTL1 = pL1Tbl->Next();
-                }
-
-                delete pL1Tbl;
+                __GMM_ASSERT(pTTL1 && pTTL1[pL1Tbl->GetL2eIdx()] == pL1Tbl);
+                pTTL1[pL1Tbl->GetL2eIdx()] = NULL;
+                Slab.Free(pL1Tbl);
             }
         }
     };
@@ -441,12 +564,15 @@ namespace GmmLib
         } TTL3;
 
         MidLevelTable*   pTTL2;                      //array of L2-Tables
+        LastLevelTableSlab L1Slab;                   //L1-Tables
 
     public:
 #ifdef _WIN32
-        CRITICAL_SECTION    TTLock;                  //synchronized access of PageTable obj
+        CRITICAL_SECTION    TTLock;                  //synchronized access of PageTable obj (L3/dummy tables, L1Slab)
+        CRITICAL_SECTION    L2Lock[PAGETABLE_L2_LOCKS]; //synchronized access of L2 table (ie L3e) and its L1 tables
 #elif defined __linux__
         pthread_mutex_t TTLock;
+        pthread_mutex_t L2Lock[PAGETABLE_L2_LOCKS];
 #endif
 
         GmmPageTableMgr*  PageTableMgr;
@@ -459,6 +585,10 @@ namespace GmmLib
             PageTableMgr = NULL;
             pClientContext = NULL;
             InitializeCriticalSection(&TTLock);
+            for (int i = 0; i < PAGETABLE_L2_LOCKS; i++)
+            {
+                InitializeCriticalSection(&L2Lock[i]);
+            }
 
             pTTL2 = new MidLevelTable[NumL3e];
         }
@@ -467,9 +597,17 @@ namespace GmmLib
         {
             delete[] pTTL2;
 
+            for (int i = 0; i < PAGETABLE_L2_LOCKS; i++)
+            {
+                DeleteCriticalSection(&L2Lock[i]);
+            }
             DeleteCriticalSection(&TTLock);
         }
 
+        //Lock order: PageTableMgr's FlushLock, L2Lock, TTLock, then PageTableMgr's PoolLock
+        void EnterL2CriticalSection(GMM_GFX_SIZE_T L3eIdx) { EnterCriticalSection(&L2Lock[L3eIdx % PAGETABLE_L2_LOCKS]); }
+        void LeaveL2CriticalSection(GMM_GFX_SIZE_T L3eIdx) { LeaveCriticalSection(&L2Lock[L3eIdx % PAGETABLE_L2_LOCKS]); }
+
 	inline GMM_LIB_CONTEXT* GetGmmLibContext()
         {
             return pClientContext->GetLibContext();
@@ -486,6 +624,83 @@ namespace GmmLib
         HANDLE GetL3Handle() { return TTL3.L3Handle; }
     };
 
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// Contains functions and members for TableEntryWriter.
+    /// Queues GPU (async) table-entry writes for one TT update (or one flushed batch of queued
+    /// Aux-TT updates), coalescing runs of consecutive
+    /// entries into pfWriteL2L3Entries/pfFillL2L3Entries calls when the client provides them,
+    /// else writing one entry per pfWriteL2L3Entry call. Writes are issued in request order.
+    /////////////////////////////////////////////////////////////////////////////////////////////
+    class TableEntryWriter
+    {
+    private:
+        GMM_TRANSLATIONTABLE_CALLBACKS &    TTCb;
+        GMM_TRANSLATIONTABLE_CALLBACKS_EXT &TTCbExt;
+        void *                              pCommandQueueHandle;
+        GMM_GFX_ADDRESS                     StartGfxAddress;     //adr of first pending entry
+        uint32_t                            NumEntries;          //pending entries
+        uint64_t                            Entries[GMM_TT_ENTRY_WRITE_BATCH];
+
+    public:
+        TableEntryWriter(GMM_TRANSLATIONTABLE_CALLBACKS &Callbacks, GMM_TRANSLATIONTABLE_CALLBACKS_EXT &CallbacksExt, void *CmdQHandle) :
+            TTCb(Callbacks),
+            TTCbExt(CallbacksExt),
+            pCommandQueueHandle(CmdQHandle),
+            StartGfxAddress(0),
+            NumEntries(0)
+        {
+        }
+        ~TableEntryWriter()
+        {
+            Flush();
+        }
+
+        void Write(GMM_GFX_ADDRESS GfxAddress, uint64_t Data);
+        void Fill(GMM_GFX_ADDRESS GfxAddress, uint32_t Count, uint64_t Data);
+        void Flush();
+    };
+
+    // CPU (DoNotWait) bulk writes of 64-bit table entries, for whole-table init and runs
+    // of entries within one table. Kept as plain unrolled loops over the CPU-visible pool
+    // mapping, so compilers emit wide vector stores without per-ISA code paths.
+    static inline void FillTableEntries(GMM_GFX_ADDRESS CPUAddress, uint32_t Count, uint64_t Data)
+    {
+        uint64_t *pEntry = (uint64_t *)CPUAddress;
+        uint32_t  i      = 0;
+
+        for(; i + 4 <= Count; i += 4)
+        {
+            pEntry[i]     = Data;
+            pEntry[i + 1] = Data;
+            pEntry[i + 2] = Data;
+            pEntry[i + 3] = Data;
+        }
+        for(; i < Count; i++)
+        {
+            pEntry[i] = Data;
+        }
+    }
+
+    // Writes Data, Data + Step, Data + 2*Step... eg Aux L1 entries for linear CCS, where
+    // consecutive 64KB (16KB) main-surface tiles map consecutive 256B (64B) CCS chunks
+    static inline void FillTableEntriesLinear(GMM_GFX_ADDRESS CPUAddress, uint32_t Count, uint64_t Data, uint64_t Step)
+    {
+        uint64_t *pEntry = (uint64_t *)CPUAddress;
+        uint32_t  i      = 0;
+
+        for(; i + 4 <= Count; i += 4, Data += 4 * Step)
+        {
+            pEntry[i]     = Data;
+            pEntry[i + 1] = Data + Step;
+            pEntry[i + 2] = Data + 2 * Step;
+            pEntry[i + 3] = Data + 3 * Step;
+        }
+        for(; i < Count; i++, Data += Step)
+        {
+            pEntry[i] = Data;
+        }
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     /// Contains functions and members for AuxTable. 
     /// AuxTable defines PageTable for translating VA->AuxVA, ie defines page-walk to get address
@@ -498,6 +713,7 @@ namespace GmmLib
         Table* NullL2Table;
         Table* NullL1Table;
         GMM_GFX_ADDRESS NullCCSTile;
+        std::map<GMM_GFX_ADDRESS, GMM_AUXTT_MAPPING_INFO> Mappings; //mapped main-surface ranges by BaseGpuVA, non-overlapping (TTLock)
         AuxTable() : PageTable(8 * PAGE_SIZE, GMM_AUX_L3_SIZE, TT_TYPE::AUXTT),
             L1Size(2 * PAGE_SIZE)
         {
@@ -505,19 +721,54 @@ namespace GmmLib
             NullL1Table = nullptr;
             NullCCSTile = 0;
         }
-        GMM_STATUS InvalidateTable(GMM_UMD_SYNCCONTEXT * UmdContext, GMM_GFX_ADDRESS BaseAdr, GMM_GFX_SIZE_T Size, uint8_t DoNotWait);
+        GMM_STATUS InvalidateTable(GMM_UMD_SYNCCONTEXT * UmdContext, GMM_GFX_ADDRESS BaseAdr, GMM_GFX_SIZE_T Size, uint8_t DoNotWait,
+                                   TableEntryWriter *pBatchWriter = NULL);
 
         GMM_STATUS MapValidEntry(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX_ADDRESS BaseAdr, GMM_GFX_SIZE_T BaseSize,
-                                 GMM_RESOURCE_INFO* BaseResInfo, GMM_GFX_ADDRESS AuxVA, GMM_RESOURCE_INFO* AuxResInfo, uint64_t PartialData, uint8_t DoNotWait);
+                                 GMM_RESOURCE_INFO* BaseResInfo, GMM_GFX_ADDRESS AuxVA, GMM_RESOURCE_INFO* AuxResInfo, uint64_t PartialData, uint8_t DoNotWait,
+                                 TableEntryWriter *pBatchWriter = NULL);
 
         GMM_STATUS MapNullCCS(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX_ADDRESS BaseAdr, GMM_GFX_SIZE_T Size, uint64_t PartialL1e, uint8_t DoNotWait);
 
+        GMM_STATUS AddMapping(const GMM_AUXTT_MAPPING_INFO &Mapping);
+        bool FindMapping(GMM_GFX_ADDRESS GfxVA, GMM_AUXTT_MAPPING_INFO *pMapping);
+        void RemoveMappings(GMM_GFX_ADDRESS Start, GMM_GFX_ADDRESS End, std::vector<GMM_AUXTT_MAPPING_INFO> *pRemoved = NULL);
+
         GMM_AUXTTL1e CreateAuxL1Data(GMM_RESOURCE_INFO* BaseResInfo);
         GMM_GFX_ADDRESS GMM_INLINE __GetCCSCacheline(GMM_RESOURCE_INFO* BaseResInfo, GMM_GFX_ADDRESS BaseAdr, GMM_RESOURCE_INFO* AuxResInfo,
                                                      GMM_GFX_ADDRESS AuxVA, GMM_GFX_SIZE_T AdrOffset);
 
     };
 
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// Contains members for AuxTableUpdateQueue.
+    /// Holds UpdateAuxTable requests deferred by GmmPageTableMgr::QueueAuxTableUpdate until
+    /// FlushAuxTableUpdates applies them as one batch. Protected by GmmPageTableMgr::PoolLock,
+    /// batches are applied under GmmPageTableMgr::FlushLock.
+    /////////////////////////////////////////////////////////////////////////////////////////////
+    class AuxTableUpdateQueue : public GmmMemAllocator
+    {
+    public:
+        typedef struct QueuedUpdateRec
+        {
+            GMM_DDI_UPDATEAUXTABLE Req;
+            GMM_GFX_ADDRESS        Start;        //main-surface VA range [Start, End)
+            GMM_GFX_ADDRESS        End;
+            uint32_t               Seq;          //queuing order, kept for overlapping requests
+            uint8_t                Cancelled;    //map superseded by a later unmap in same batch
+        } QueuedUpdate;
+
+        std::vector<QueuedUpdate> Requests;
+        uint32_t                  NextSeq;
+        uint32_t                  Threshold;    //flush once this many requests are queued, 0: explicit flush only
+
+        AuxTableUpdateQueue() :
+            NextSeq(0),
+            Threshold(AUXTT_UPDATE_QUEUE_THRESHOLD)
+        {
+        }
+    };
+
 typedef struct _GMM_DEVICE_ALLOC {
     uint32_t            Size;
     uint32_t            Alignment;
@@ -0,0 +1,369 @@
+/*==============================================================================
+Copyright(c) 2019 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+#if defined (__linux__) && !defined(__i386__)
+
+#ifndef _ISOC11_SOURCE
+#define _ISOC11_SOURCE 1
+#endif
+
+#include "GmmAuxTableSim.h"
+#include <stdlib.h>
+
+// Command sizes (bytes) the callbacks stand for
+#define SIM_PIPE_CONTROL_SIZE   24          // Prolog/Epilog flush + TLB invalidate
+#define SIM_SDI_HEADER_SIZE     12          // MI_STORE_DATA_IMM header + address, data follows
+#define SIM_LRI_L3ADR_SIZE      20          // MI_LOAD_REGISTER_IMM of L3 adr register pair
+#define SIM_COPY_MEM_SIZE       20          // MI_COPY_MEM_MEM
+
+CAuxTableSimDevice::CAuxTableSimDevice()
+    : Stats(),
+      DeviceCb(),
+      SyncContext(),
+      SubmittedFence(0),
+      CompletedFence(0)
+{
+    DeviceCb.pBufMgr                   = this;
+    DeviceCb.DevCbPtrs_.pfnAllocate    = AllocCB;
+    DeviceCb.DevCbPtrs_.pfnDeallocate  = FreeCB;
+    DeviceCb.DevCbPtrs_.pfnWaitFromCpu = WaitFromCpuCB;
+
+    SyncContext.pCommandQueueHandle = this;
+    SyncContext.BBFenceObj          = this;
+}
+
+CAuxTableSimDevice::~CAuxTableSimDevice()
+{
+    // Page-table manager frees its buffers on destruction, anything left is leaked by it
+    for(auto &Entry : Buffers)
+    {
+        free(Entry.second->pCpu);
+        delete Entry.second;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Points the page-table manager's translation-table callbacks at the simulator.
+///
+/// @param[in]  pMgr: page-table manager created with GetDeviceCallbacks()
+/// @param[in]  Options: optional callbacks to install
+/////////////////////////////////////////////////////////////////////////////////////
+void CAuxTableSimDevice::Install(GmmLib::GmmPageTableMgr *pMgr, const SIM_OPTIONS &Options)
+{
+    GMM_TRANSLATIONTABLE_CALLBACKS &   TTCb    = pMgr->TTCb;
+    GMM_TRANSLATIONTABLE_CALLBACKS_EXT TTCbExt = {0};
+
+    TTCb.pfPrologTranslationTable = PrologCB;
+    TTCb.pfWriteL1Entries         = WriteL1EntriesCB;
+    TTCb.pfWriteL2L3Entry         = WriteL2L3EntryCB;
+    TTCb.pfWriteFenceID           = WriteFenceIDCB;
+    TTCb.pfEpilogTranslationTable = EpilogCB;
+    TTCb.pfCopyL1Entry            = CopyL1EntryCB;
+    TTCb.pfWriteL3Adr             = WriteL3AdrCB;
+
+    TTCbExt.pfWriteL2L3Entries = Options.RangedWrites ? WriteL2L3EntriesCB : NULL;
+    TTCbExt.pfFillL2L3Entries  = Options.Fill ? FillL2L3EntriesCB : NULL;
+    TTCbExt.pfIsBufferBusy     = Options.BusyQuery ? IsBufferBusyCB : NULL;
+    pMgr->SetTranslationTableCallbacksExt(&TTCbExt);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns sync context for Gpu updates recorded into the current batch
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_UMD_SYNCCONTEXT *CAuxTableSimDevice::GetSyncContext()
+{
+    std::lock_guard<std::mutex> Guard(Lock);
+
+    SyncContext.BBLastFence = SubmittedFence;
+    return &SyncContext;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Ends the batch being recorded and executes its writes, later writes go to the
+/// next batch. Writes to a buffer freed since they were recorded are dropped.
+/////////////////////////////////////////////////////////////////////////////////////
+void CAuxTableSimDevice::Submit()
+{
+    std::lock_guard<std::mutex> Guard(Lock);
+
+    for(const SimWrite &Write : Pending)
+    {
+        SimBuffer *pBuffer = FindBuffer(Write.GfxAddress, Write.Size);
+        SimBuffer *pSrc    = Write.SrcGfxAddress ? FindBuffer(Write.SrcGfxAddress, Write.Size) : NULL;
+
+        if(!pBuffer || (Write.SrcGfxAddress && !pSrc))
+        {
+            Stats.NumBadWrites++;
+            continue;
+        }
+
+        memcpy((void *)Write.GfxAddress, Write.SrcGfxAddress ? (const void *)Write.SrcGfxAddress : Write.Data.data(), Write.Size);
+    }
+    Pending.clear();
+
+    SubmittedFence++;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Completes all submitted batches
+/////////////////////////////////////////////////////////////////////////////////////
+void CAuxTableSimDevice::Retire()
+{
+    std::lock_guard<std::mutex> Guard(Lock);
+
+    CompletedFence = SubmittedFence;
+}
+
+uint32_t CAuxTableSimDevice::GetNumBuffers()
+{
+    std::lock_guard<std::mutex> Guard(Lock);
+
+    return (uint32_t)Buffers.size();
+}
+
+//=============================================================================
+//
+// Function: FindBuffer
+//
+// Desc: Returns live buffer holding [GfxAddress, GfxAddress + Size), NULL if
+//       range isn't fully inside one. Caller holds Lock.
+//
+//-----------------------------------------------------------------------------
+CAuxTableSimDevice::SimBuffer *CAuxTableSimDevice::FindBuffer(GMM_GFX_ADDRESS GfxAddress, size_t Size)
+{
+    auto It = Buffers.upper_bound(GfxAddress);
+    if(It == Buffers.begin())
+    {
+        return NULL;
+    }
+    --It;
+
+    return (GfxAddress + Size > It->first + It->second->Size) ? NULL : It->second;
+}
+
+//=============================================================================
+//
+// Function: RecordWrite
+//
+// Desc: Records a write of pData (or a copy from SrcGfxAddress) into the batch
+//       being recorded, tagging target buffer with the batch's fence. Writes
+//       not fully inside a live buffer are counted and dropped.
+//
+//-----------------------------------------------------------------------------
+void CAuxTableSimDevice::RecordWrite(GMM_GFX_ADDRESS GfxAddress, const void *pData, GMM_GFX_ADDRESS SrcGfxAddress, size_t Size)
+{
+    std::lock_guard<std::mutex> Guard(Lock);
+
+    SimBuffer *pBuffer = FindBuffer(GfxAddress, Size);
+    if(!pBuffer)
+    {
+        Stats.NumBadWrites++;
+        return;
+    }
+
+    SimWrite Write;
+    Write.GfxAddress    = GfxAddress;
+    Write.SrcGfxAddress = SrcGfxAddress;
+    Write.Size          = Size;
+    if(pData)
+    {
+        Write.Data.assign((const uint8_t *)pData, (const uint8_t *)pData + Size);
+    }
+    Pending.push_back(std::move(Write));
+
+    pBuffer->LastFence = SubmittedFence + 1;
+}
+
+void CAuxTableSimDevice::Emit(uint64_t NumEntries, uint64_t Bytes)
+{
+    std::lock_guard<std::mutex> Guard(Lock);
+
+    Stats.NumCommands++;
+    Stats.NumEntriesWritten += NumEntries;
+    Stats.CommandBytes += Bytes;
+}
+
+int CAuxTableSimDevice::AllocCB(void *bufMgr, size_t size, size_t alignment, void **bo, void **cpuAddr, uint64_t *gpuAddr)
+{
+    CAuxTableSimDevice *pSim    = FromHandle(bufMgr);
+    SimBuffer *         pBuffer = NULL;
+
+    if(!pSim || !bo || !cpuAddr || !gpuAddr)
+    {
+        return -1;
+    }
+
+    pBuffer       = new SimBuffer();
+    pBuffer->pSim = pSim;
+    pBuffer->Size = size;
+    pBuffer->pCpu = aligned_alloc(alignment, GFX_ALIGN(size, alignment));
+    if(!pBuffer->pCpu)
+    {
+        delete pBuffer;
+        return -2;
+    }
+
+    std::lock_guard<std::mutex> Guard(pSim->Lock);
+
+    pSim->Buffers[(uint64_t)pBuffer->pCpu] = pBuffer;
+    pSim->Stats.NumAllocs++;
+    pSim->Stats.AllocatedBytes += size;
+    pSim->Stats.PeakAllocatedBytes = GFX_MAX(pSim->Stats.PeakAllocatedBytes, pSim->Stats.AllocatedBytes);
+
+    *bo      = pBuffer;
+    *cpuAddr = pBuffer->pCpu;
+    *gpuAddr = (uint64_t)pBuffer->pCpu;
+
+    return 0;
+}
+
+void CAuxTableSimDevice::FreeCB(void *bo)
+{
+    SimBuffer *         pBuffer = static_cast<SimBuffer *>(bo);
+    CAuxTableSimDevice *pSim    = pBuffer->pSim;
+
+    {
+        std::lock_guard<std::mutex> Guard(pSim->Lock);
+
+        pSim->Stats.NumFrees++;
+        pSim->Stats.NumBadFrees += (pBuffer->LastFence > pSim->CompletedFence);
+        pSim->Stats.AllocatedBytes -= pBuffer->Size;
+        pSim->Buffers.erase((uint64_t)pBuffer->pCpu);
+    }
+
+    free(pBuffer->pCpu);
+    delete pBuffer;
+}
+
+void CAuxTableSimDevice::WaitFromCpuCB(void *bo)
+{
+    SimBuffer *         pBuffer = static_cast<SimBuffer *>(bo);
+    CAuxTableSimDevice *pSim    = pBuffer->pSim;
+
+    std::lock_guard<std::mutex> Guard(pSim->Lock);
+
+    pSim->Stats.NumWaits++;
+    if(pBuffer->LastFence > pSim->SubmittedFence)
+    {
+        pSim->Stats.NumBadWaits++; //would never signal
+    }
+    pSim->CompletedFence = GFX_MAX(pSim->CompletedFence, GFX_MIN(pBuffer->LastFence, pSim->SubmittedFence));
+}
+
+int CAuxTableSimDevice::IsBufferBusyCB(void *bo)
+{
+    SimBuffer *         pBuffer = static_cast<SimBuffer *>(bo);
+    CAuxTableSimDevice *pSim    = pBuffer->pSim;
+
+    std::lock_guard<std::mutex> Guard(pSim->Lock);
+
+    return pBuffer->LastFence > pSim->CompletedFence;
+}
+
+int CAuxTableSimDevice::PrologCB(void *pDeviceHandle)
+{
+    CAuxTableSimDevice *pSim = FromHandle(pDeviceHandle);
+
+    std::lock_guard<std::mutex> Guard(pSim->Lock);
+
+    pSim->Stats.NumPrologs++;
+    pSim->Stats.CommandBytes += SIM_PIPE_CONTROL_SIZE;
+    return 0;
+}
+
+int CAuxTableSimDevice::EpilogCB(void *pDeviceHandle, uint8_t ForceFlush)
+{
+    CAuxTableSimDevice *pSim = FromHandle(pDeviceHandle);
+
+    std::lock_guard<std::mutex> Guard(pSim->Lock);
+
+    pSim->Stats.NumEpilogs++;
+    pSim->Stats.CommandBytes += SIM_PIPE_CONTROL_SIZE;
+    return 0;
+}
+
+int CAuxTableSimDevice::WriteL1EntriesCB(void *pDeviceHandle, const uint32_t NumEntries, GMM_GFX_ADDRESS GfxAddress, uint32_t *Data)
+{
+    CAuxTableSimDevice *pSim = FromHandle(pDeviceHandle);
+
+    pSim->RecordWrite(GfxAddress, Data, 0, NumEntries * sizeof(uint32_t));
+    pSim->Emit(NumEntries, SIM_SDI_HEADER_SIZE + NumEntries * sizeof(uint32_t));
+    return 0;
+}
+
+int CAuxTableSimDevice::WriteL2L3EntryCB(void *pDeviceHandle, GMM_GFX_ADDRESS GfxAddress, uint64_t Data)
+{
+    CAuxTableSimDevice *pSim = FromHandle(pDeviceHandle);
+
+    pSim->RecordWrite(GfxAddress, &Data, 0, sizeof(Data));
+    pSim->Emit(1, SIM_SDI_HEADER_SIZE + sizeof(Data));
+    return 0;
+}
+
+int CAuxTableSimDevice::WriteFenceIDCB(void *pDeviceHandle, GMM_GFX_ADDRESS GfxAddress, uint64_t Data)
+{
+    CAuxTableSimDevice *pSim = FromHandle(pDeviceHandle);
+
+    pSim->RecordWrite(GfxAddress, &Data, 0, sizeof(Data));
+    pSim->Emit(0, SIM_SDI_HEADER_SIZE + sizeof(Data));
+    return 0;
+}
+
+int CAuxTableSimDevice::CopyL1EntryCB(void *pDeviceHandle, GMM_GFX_ADDRESS DstGfxAddress, GMM_GFX_ADDRESS SrcGfxAddress)
+{
+    CAuxTableSimDevice *pSim = FromHandle(pDeviceHandle);
+
+    pSim->RecordWrite(DstGfxAddress, NULL, SrcGfxAddress, sizeof(uint64_t));
+    pSim->Emit(1, SIM_COPY_MEM_SIZE);
+    return 0;
+}
+
+int CAuxTableSimDevice::WriteL3AdrCB(void *pDeviceHandle, GMM_GFX_ADDRESS L3GfxAddress, uint64_t RegOffset)
+{
+    CAuxTableSimDevice *pSim = FromHandle(pDeviceHandle);
+
+    pSim->Emit(0, SIM_LRI_L3ADR_SIZE);
+    return 0;
+}
+
+int CAuxTableSimDevice::WriteL2L3EntriesCB(void *pDeviceHandle, GMM_GFX_ADDRESS GfxAddress, const uint32_t NumEntries, const uint64_t *Data)
+{
+    CAuxTableSimDevice *pSim = FromHandle(pDeviceHandle);
+
+    pSim->RecordWrite(GfxAddress, Data, 0, NumEntries * sizeof(uint64_t));
+    pSim->Emit(NumEntries, SIM_SDI_HEADER_SIZE + NumEntries * sizeof(uint64_t));
+    return 0;
+}
+
+int CAuxTableSimDevice::FillL2L3EntriesCB(void *pDeviceHandle, GMM_GFX_ADDRESS GfxAddress, const uint32_t NumEntries, uint64_t Data)
+{
+    CAuxTableSimDevice *pSim = FromHandle(pDeviceHandle);
+
+    std::vector<uint64_t> Entries(NumEntries, Data);
+
+    pSim->RecordWrite(GfxAddress, Entries.data(), 0, NumEntries * sizeof(uint64_t));
+    // Emitted as one store of all entries
+    pSim->Emit(NumEntries, SIM_SDI_HEADER_SIZE + NumEntries * sizeof(uint64_t));
+    return 0;
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,138 @@
+/*==============================================================================
+Copyright(c) 2019 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+#pragma once
+
+#if defined (__linux__) && !defined(__i386__)
+
+#include "GmmCommonULT.h"
+#include <map>
+#include <mutex>
+#include <vector>
+
+//===========================================================================
+// typedef:
+//      GMM_AUXTT_SIM_STATS
+//
+// Description:
+//      Work a simulated device did on behalf of a GmmPageTableMgr. Command
+//      bytes are modelled on MI_STORE_DATA_IMM/MI_LOAD_REGISTER_IMM/PIPE_CONTROL.
+//----------------------------------------------------------------------------
+typedef struct GMM_AUXTT_SIM_STATS_REC
+{
+    uint64_t NumPrologs;            // pfPrologTranslationTable calls
+    uint64_t NumEpilogs;            // pfEpilogTranslationTable calls
+    uint64_t NumCommands;           // write/fill/copy/L3-adr callbacks
+    uint64_t NumEntriesWritten;     // table entries written through callbacks
+    uint64_t CommandBytes;          // command stream bytes the callbacks would emit
+    uint64_t NumAllocs;             // page-table buffers allocated
+    uint64_t NumFrees;
+    uint64_t NumWaits;              // CPU waits on a buffer
+    uint64_t AllocatedBytes;        // page-table memory currently allocated
+    uint64_t PeakAllocatedBytes;
+    uint64_t NumBadWrites;          // writes outside any live buffer (dropped)
+    uint64_t NumBadWaits;           // waits on work not yet submitted
+    uint64_t NumBadFrees;           // buffers freed while GPU may still access them
+} GMM_AUXTT_SIM_STATS;
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Simulated device backend for GmmPageTableMgr. Page-table buffers are host memory
+/// (GPU VA == CPU VA), translation-table callbacks record their writes into the
+/// current batch, and the work is counted in Stats.
+///
+/// Batches are modelled by fences: writes tag the buffer they land in with the
+/// fence of the batch being recorded, Submit() executes that batch, applying its
+/// writes to page-table memory in recording order (after any CPU update made
+/// meanwhile, as on the GPU), and Retire() marks all submitted batches complete.
+/// pfIsBufferBusy/pfnWaitFromCpu report and wait on those fences.
+/////////////////////////////////////////////////////////////////////////////////////
+class CAuxTableSimDevice
+{
+public:
+    typedef struct SIM_OPTIONS_REC
+    {
+        bool RangedWrites;          // install pfWriteL2L3Entries
+        bool Fill;                  // install pfFillL2L3Entries
+        bool BusyQuery;             // install pfIsBufferBusy
+    } SIM_OPTIONS;
+
+    CAuxTableSimDevice();
+    ~CAuxTableSimDevice();
+
+    GMM_DEVICE_CALLBACKS_INT *GetDeviceCallbacks() { return &DeviceCb; }
+    void                      Install(GmmLib::GmmPageTableMgr *pMgr, const SIM_OPTIONS &Options);
+    GMM_UMD_SYNCCONTEXT *     GetSyncContext();
+
+    void     Submit();
+    void     Retire();
+    uint32_t GetNumBuffers();
+
+    GMM_AUXTT_SIM_STATS Stats;
+
+private:
+    struct SimBuffer
+    {
+        CAuxTableSimDevice *pSim;
+        void *              pCpu;
+        size_t              Size;
+        uint64_t            LastFence;     // last batch writing the buffer
+    };
+
+    struct SimWrite
+    {
+        GMM_GFX_ADDRESS      GfxAddress;
+        GMM_GFX_ADDRESS      SrcGfxAddress; // copy source, 0 for a write of Data
+        size_t               Size;
+        std::vector<uint8_t> Data;
+    };
+
+    GMM_DEVICE_CALLBACKS_INT DeviceCb;
+    GMM_UMD_SYNCCONTEXT      SyncContext;
+    uint64_t                 SubmittedFence;
+    uint64_t                 CompletedFence;
+
+    std::mutex                         Lock;
+    std::map<uint64_t, SimBuffer *>    Buffers;   // by GPU VA
+    std::vector<SimWrite>              Pending;   // writes of the batch being recorded
+
+    SimBuffer *FindBuffer(GMM_GFX_ADDRESS GfxAddress, size_t Size);
+    void       RecordWrite(GMM_GFX_ADDRESS GfxAddress, const void *pData, GMM_GFX_ADDRESS SrcGfxAddress, size_t Size);
+    void Emit(uint64_t NumEntries, uint64_t Bytes);
+
+    static CAuxTableSimDevice *FromHandle(void *pDeviceHandle) { return static_cast<CAuxTableSimDevice *>(pDeviceHandle); }
+
+    static int  AllocCB(void *bufMgr, size_t size, size_t alignment, void **bo, void **cpuAddr, uint64_t *gpuAddr);
+    static void FreeCB(void *bo);
+    static void WaitFromCpuCB(void *bo);
+    static int  IsBufferBusyCB(void *bo);
+
+    static int PrologCB(void *pDeviceHandle);
+    static int EpilogCB(void *pDeviceHandle, uint8_t ForceFlush);
+    static int WriteL1EntriesCB(void *pDeviceHandle, const uint32_t NumEntries, GMM_GFX_ADDRESS GfxAddress, uint32_t *Data);
+    static int WriteL2L3EntryCB(void *pDeviceHandle, GMM_GFX_ADDRESS GfxAddress, uint64_t Data);
+    static int WriteFenceIDCB(void *pDeviceHandle, GMM_GFX_ADDRESS GfxAddress, uint64_t Data);
+    static int CopyL1EntryCB(void *pDeviceHandle, GMM_GFX_ADDRESS DstGfxAddress, GMM_GFX_ADDRESS SrcGfxAddress);
+    static int WriteL3AdrCB(void *pDeviceHandle, GMM_GFX_ADDRESS L3GfxAddress, uint64_t RegOffset);
+    static int WriteL2L3EntriesCB(void *pDeviceHandle, GMM_GFX_ADDRESS GfxAddress, const uint32_t NumEntries, const uint64_t *Data);
+    static int FillL2L3EntriesCB(void *pDeviceHandle, GMM_GFX_ADDRESS GfxAddress, const uint32_t NumEntries, uint64_t Data);
+};
+
+#endif /* __linux__ */
@@ -23,6 +23,8 @@ OTHER DEALINGS IN THE SOFTWARE.
 #if defined (__linux__) && !defined(__i386__)
 
 #include "GmmAuxTableULT.h"
+#include "GmmAuxTableSim.h"
+#include "../TranslationTable/GmmUmdTranslationTable.h"
 
 using namespace std;
 using namespace GmmLib;
@@ -262,4 +264,1035 @@ TEST_F(CTestAuxTable, TestAuxTableContent)
     pGmmULTClientContext->DestroyPageTblMgrObject(mgr);
 }
 
+// Maps one surface at many addresses, each covered by its own L1 table and 64 of
+// them per L2 table, then unmaps them all, twice. Checks pool nodes are packed, ie
+// a new pool is only allocated when all pools of its type are full, and released
+// nodes are reused. Timed in GMMBench (CBenchAuxTable.Gen12L1Tables).
+TEST_F(CTestAuxTable, TestAuxTablePoolAllocation)
+{
+    const uint32_t        NumMappings = 4096;
+    const uint32_t        NumRounds   = 2;
+    const uint32_t        L1PerL2     = 64;
+    const GMM_GFX_ADDRESS BaseVA      = 1ULL << 44;
+    const GMM_GFX_SIZE_T  L1Coverage  = 1ULL << GMM_AUX_L2_LOW_BIT; // VA range of one L1/L2 table
+    const GMM_GFX_SIZE_T  L2Coverage  = 1ULL << GMM_AUX_L3_LOW_BIT;
+
+    GmmPageTableMgr *mgr = pGmmULTClientContext->CreatePageTblMgrObject(&DeviceCBInt, TT_TYPE::AUXTT);
+
+    ASSERT_TRUE(mgr != NULL);
+
+    Surface *surf = new Surface(720, 480);
+
+    ASSERT_TRUE(surf != NULL && surf->init());
+
+    GMM_DDI_UPDATEAUXTABLE updateReq = {0};
+    updateReq.BaseResInfo            = surf->getGMMResourceInfo();
+
+    for(uint32_t Round = 0; Round < NumRounds; Round++)
+    {
+        updateReq.Map = 1;
+        for(uint32_t i = 0; i < NumMappings; i++)
+        {
+            updateReq.BaseGpuVA = BaseVA + (i / L1PerL2) * L2Coverage + (i % L1PerL2) * L1Coverage;
+            ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+        }
+
+        // L3 table, 64 Aux-L2 and 256 Aux-L1 tables per pool
+        EXPECT_EQ((int)(1 + NumMappings / L1PerL2 / (PAGETABLE_POOL_MAX_NODES / AUX_L2TABLE_SIZE_IN_POOLNODES) +
+                        NumMappings / (PAGETABLE_POOL_MAX_NODES / AUX_L1TABLE_SIZE_IN_POOLNODES)),
+                  mgr->GetNumOfPageTableBOs(TT_TYPE::AUXTT));
+
+        GMM_GFX_ADDRESS LastVA = BaseVA + ((NumMappings - 1) / L1PerL2) * L2Coverage + ((NumMappings - 1) % L1PerL2) * L1Coverage;
+        Walker          walker(LastVA, LastVA + surf->getGMMResourceInfo()->GetUnifiedAuxSurfaceOffset(GMM_AUX_CCS), mgr->GetAuxL3TableAddr());
+        EXPECT_EQ(walker.expected(LastVA), walker.walk(LastVA));
+
+        updateReq.Map = 0;
+        for(uint32_t i = 0; i < NumMappings; i++)
+        {
+            updateReq.BaseGpuVA = BaseVA + (i / L1PerL2) * L2Coverage + (i % L1PerL2) * L1Coverage;
+            ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+        }
+    }
+
+    delete surf;
+    pGmmULTClientContext->DestroyPageTblMgrObject(mgr);
+}
+
+// Maps one surface at every L1-table granule of a single L2 table, so all L1 tables
+// hang off one L2 table, then unmaps them in reverse. Checks the L1 tables are
+// packed into pools and every quarter of the L2 table walks to its mapping. Timed
+// in GMMBench (CBenchAuxTable.Gen12L1Tables).
+TEST_F(CTestAuxTable, TestAuxTableDenseL1Lookup)
+{
+    const uint32_t        NumMappings = GMM_AUX_L2_SIZE;
+    const GMM_GFX_ADDRESS BaseVA      = 1ULL << 44;
+    const GMM_GFX_SIZE_T  L1Coverage  = 1ULL << GMM_AUX_L2_LOW_BIT;
+
+    GmmPageTableMgr *mgr = pGmmULTClientContext->CreatePageTblMgrObject(&DeviceCBInt, TT_TYPE::AUXTT);
+
+    ASSERT_TRUE(mgr != NULL);
+
+    Surface *surf = new Surface(720, 480);
+
+    ASSERT_TRUE(surf != NULL && surf->init());
+
+    GMM_DDI_UPDATEAUXTABLE updateReq = {0};
+    updateReq.BaseResInfo            = surf->getGMMResourceInfo();
+
+    updateReq.Map = 1;
+    for(uint32_t i = 0; i < NumMappings; i++)
+    {
+        updateReq.BaseGpuVA = BaseVA + i * L1Coverage;
+        ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+    }
+
+    // L3 table, one Aux-L2 pool and 256 Aux-L1 tables per pool
+    EXPECT_EQ((int)(1 + 1 + NumMappings / (PAGETABLE_POOL_MAX_NODES / AUX_L1TABLE_SIZE_IN_POOLNODES)),
+              mgr->GetNumOfPageTableBOs(TT_TYPE::AUXTT));
+
+    for(uint32_t i = 0; i < NumMappings; i += NumMappings / 4 - 1)
+    {
+        GMM_GFX_ADDRESS VA = BaseVA + i * L1Coverage;
+        Walker          walker(VA, VA + surf->getGMMResourceInfo()->GetUnifiedAuxSurfaceOffset(GMM_AUX_CCS), mgr->GetAuxL3TableAddr());
+        EXPECT_EQ(walker.expected(VA), walker.walk(VA));
+    }
+
+    updateReq.Map = 0;
+    for(uint32_t i = NumMappings; i > 0; i--)
+    {
+        updateReq.BaseGpuVA = BaseVA + (i - 1) * L1Coverage;
+        ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+    }
+
+    delete surf;
+    pGmmULTClientContext->DestroyPageTblMgrObject(mgr);
+}
+
+// Aux-TT write callbacks for GPU (async) updates, ULT's table GfxVA is its CPU VA
+// so entries are written directly.
+static uint32_t NumWriteEntryCalls, NumWriteEntriesCalls, NumEntriesWritten;
+static uint32_t NumPrologCalls, NumEpilogCalls;
+
+static int PrologTTCB(void *pDeviceHandle)
+{
+    NumPrologCalls++;
+    return 0;
+}
+
+static int EpilogTTCB(void *pDeviceHandle, uint8_t ForceFlush)
+{
+    NumEpilogCalls++;
+    return 0;
+}
+
+static int WriteL2L3EntryCB(void *pDeviceHandle, GMM_GFX_ADDRESS GfxAddress, uint64_t Data)
+{
+    *(uint64_t *)GfxAddress = Data;
+    NumWriteEntryCalls++;
+    NumEntriesWritten++;
+    return 0;
+}
+
+static int WriteL2L3EntriesCB(void *pDeviceHandle, GMM_GFX_ADDRESS GfxAddress, const uint32_t NumEntries, const uint64_t *Data)
+{
+    memcpy((void *)GfxAddress, Data, NumEntries * sizeof(uint64_t));
+    NumWriteEntriesCalls++;
+    NumEntriesWritten += NumEntries;
+    return 0;
+}
+
+// Maps two surfaces sharing an L1 table, then GPU-unmaps the first with and without
+// the ranged write callback. Checks both invalidate the same entries, and the ranged
+// callback coalesces them. Also checks per-table BB info is only kept by pools whose
+// tables were released with Gpu updates pending.
+TEST_F(CTestAuxTable, TestAuxTableBatchedGpuUpdate)
+{
+    const GMM_GFX_ADDRESS BaseVA = 1ULL << 44;
+
+    GmmPageTableMgr *mgr = pGmmULTClientContext->CreatePageTblMgrObject(&DeviceCBInt, TT_TYPE::AUXTT);
+
+    ASSERT_TRUE(mgr != NULL);
+
+    mgr->TTCb.pfPrologTranslationTable = PrologTTCB;
+    mgr->TTCb.pfEpilogTranslationTable = EpilogTTCB;
+    mgr->TTCb.pfWriteL2L3Entry         = WriteL2L3EntryCB;
+
+    Surface *surfA = new Surface(7680, 4320);
+    Surface *surfB = new Surface(720, 480);
+
+    ASSERT_TRUE(surfA != NULL && surfA->init());
+    ASSERT_TRUE(surfB != NULL && surfB->init());
+
+    // B placed 1MB into an L1 table, A's main surface ends in same L1 table
+    GMM_GFX_ADDRESS VA_B  = BaseVA + 8 * (1ULL << GMM_AUX_L2_LOW_BIT) + GMM_MBYTE(1);
+    GMM_GFX_ADDRESS VA_A  = VA_B - GFX_ALIGN(surfA->getGMMResourceInfo()->GetSizeSurface(), GMM_KBYTE(64));
+    GMM_GFX_ADDRESS LastA = VA_A + GFX_ALIGN_FLOOR(surfA->getGMMResourceInfo()->GetSizeMainSurface() - 1, GMM_KBYTE(64));
+    ASSERT_EQ(LastA >> GMM_AUX_L2_LOW_BIT, VA_B >> GMM_AUX_L2_LOW_BIT);
+
+    GMM_UMD_SYNCCONTEXT UmdContext = {0};
+    UmdContext.pCommandQueueHandle = (void *)0x1;
+    UmdContext.BBFenceObj          = (void *)0x2;
+
+    uint32_t                 EntriesWritten[2] = {0};
+    GMM_PAGETABLE_POOL_STATS CpuOnlyStats      = {0};
+    GMM_PAGETABLE_POOL_STATS Stats             = {0};
+
+    for(uint32_t Ranged = 0; Ranged < 2; Ranged++)
+    {
+        GMM_DDI_UPDATEAUXTABLE             updateReq = {0};
+        GMM_TRANSLATIONTABLE_CALLBACKS_EXT TTCbExt   = {0};
+
+        TTCbExt.pfWriteL2L3Entries = Ranged ? WriteL2L3EntriesCB : NULL;
+        mgr->SetTranslationTableCallbacksExt(&TTCbExt);
+
+        updateReq.Map         = 1;
+        updateReq.DoNotWait   = 1;
+        updateReq.BaseResInfo = surfA->getGMMResourceInfo();
+        updateReq.BaseGpuVA   = VA_A;
+        ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+        updateReq.BaseResInfo = surfB->getGMMResourceInfo();
+        updateReq.BaseGpuVA   = VA_B;
+        ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+
+        if(!Ranged)
+        {
+            ASSERT_EQ(GMM_SUCCESS, mgr->GetPageTablePoolStats(&CpuOnlyStats));
+        }
+
+        NumWriteEntryCalls = NumWriteEntriesCalls = NumEntriesWritten = 0;
+
+        updateReq.Map         = 0;
+        updateReq.DoNotWait   = 0;
+        updateReq.UmdContext  = &UmdContext;
+        updateReq.BaseResInfo = surfA->getGMMResourceInfo();
+        updateReq.BaseGpuVA   = VA_A;
+        ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+
+        EntriesWritten[Ranged] = NumEntriesWritten;
+        if(Ranged)
+        {
+            EXPECT_EQ(0u, NumWriteEntryCalls);
+            EXPECT_LT(NumWriteEntriesCalls * 16, NumEntriesWritten);
+        }
+        else
+        {
+            EXPECT_EQ(NumEntriesWritten, NumWriteEntryCalls);
+        }
+
+        // Surface B still mapped, A's entries in shared L1 table invalidated
+        Walker walkerB(VA_B, VA_B + surfB->getGMMResourceInfo()->GetUnifiedAuxSurfaceOffset(GMM_AUX_CCS), mgr->GetAuxL3TableAddr());
+        EXPECT_EQ(walkerB.expected(VA_B), walkerB.walk(VA_B));
+
+        Walker walkerA(VA_A, VA_A + surfA->getGMMResourceInfo()->GetUnifiedAuxSurfaceOffset(GMM_AUX_CCS), mgr->GetAuxL3TableAddr());
+        EXPECT_EQ((GMM_INVALID_AUX_ENTRY & 0x0000ffffffffff00), walkerA.walk(LastA));
+
+        updateReq.BaseResInfo = surfB->getGMMResourceInfo();
+        updateReq.BaseGpuVA   = VA_B;
+        ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+    }
+
+    EXPECT_EQ(EntriesWritten[0], EntriesWritten[1]);
+
+    // 256 Aux-L1 tables per pool
+    ASSERT_EQ(GMM_SUCCESS, mgr->GetPageTablePoolStats(&Stats));
+    EXPECT_LT(CpuOnlyStats.MetadataSize[POOL_TYPE_AUXTTL1], 256 * sizeof(SyncInfo));
+    EXPECT_GE(Stats.MetadataSize[POOL_TYPE_AUXTTL1], CpuOnlyStats.MetadataSize[POOL_TYPE_AUXTTL1] + 256 * sizeof(SyncInfo));
+    EXPECT_EQ(CpuOnlyStats.MetadataSize[POOL_TYPE_AUXTTL2], Stats.MetadataSize[POOL_TYPE_AUXTTL2]);
+
+    delete surfB;
+    delete surfA;
+    pGmmULTClientContext->DestroyPageTblMgrObject(mgr);
+}
+
+// Maps/unmaps adjacent surfaces directly, then through the update queue. Checks queued
+// updates are deferred until flush (explicit or at threshold), a flush brackets its GPU
+// updates with one Prolog/Epilog, merged unmaps write fewer entries, and a map unmapped
+// in the same batch never reaches the tables.
+TEST_F(CTestAuxTable, TestAuxTableQueuedUpdates)
+{
+    const uint32_t        NumSurfaces = 8;
+    const GMM_GFX_SIZE_T  L2Coverage  = 1ULL << GMM_AUX_L3_LOW_BIT;
+    const GMM_GFX_ADDRESS BaseVA      = 1ULL << 44;
+
+    GMM_TRANSLATIONTABLE_CALLBACKS_EXT TTCbExt = {0};
+    GmmPageTableMgr *                  mgr     = pGmmULTClientContext->CreatePageTblMgrObject(&DeviceCBInt, TT_TYPE::AUXTT);
+
+    ASSERT_TRUE(mgr != NULL);
+
+    mgr->TTCb.pfPrologTranslationTable = PrologTTCB;
+    mgr->TTCb.pfEpilogTranslationTable = EpilogTTCB;
+    mgr->TTCb.pfWriteL2L3Entry         = WriteL2L3EntryCB;
+    TTCbExt.pfWriteL2L3Entries         = WriteL2L3EntriesCB;
+    mgr->SetTranslationTableCallbacksExt(&TTCbExt);
+
+    Surface *surf = new Surface(720, 480);
+
+    ASSERT_TRUE(surf != NULL && surf->init());
+
+    GMM_RESOURCE_INFO *pResInfo = surf->getGMMResourceInfo();
+    // Aux data isn't accessed, so main surfaces are packed back to back to make their unmaps adjacent
+    GMM_GFX_SIZE_T     Stride   = GFX_ALIGN(pResInfo->GetSizeMainSurface(), GMM_KBYTE(64));
+    uint64_t *         L3Table  = (uint64_t *)mgr->GetAuxL3TableAddr();
+
+    GMM_UMD_SYNCCONTEXT UmdContext = {0};
+    UmdContext.pCommandQueueHandle = (void *)0x1;
+
+    GMM_DDI_UPDATEAUXTABLE updateReq = {0};
+    updateReq.BaseResInfo            = pResInfo;
+    updateReq.UmdContext             = &UmdContext;
+
+    uint32_t EntriesWritten[2] = {0};
+
+    // Direct updates in first L2, queued updates in second
+    for(uint32_t Queued = 0; Queued < 2; Queued++)
+    {
+        GMM_GFX_ADDRESS VA = BaseVA + Queued * L2Coverage;
+
+        mgr->SetAuxTableUpdateThreshold(0);
+
+        updateReq.Map       = 1;
+        updateReq.DoNotWait = 1;
+        for(uint32_t i = NumSurfaces; i-- > 0;)
+        {
+            updateReq.BaseGpuVA = VA + i * Stride;
+            ASSERT_EQ(GMM_SUCCESS, Queued ? mgr->QueueAuxTableUpdate(&updateReq) : mgr->UpdateAuxTable(&updateReq));
+        }
+
+        if(Queued)
+        {
+            // Map then unmap in same batch, in a third L2 that must stay unallocated
+            updateReq.BaseGpuVA = BaseVA + 2 * L2Coverage;
+            ASSERT_EQ(GMM_SUCCESS, mgr->QueueAuxTableUpdate(&updateReq));
+            updateReq.Map = 0;
+            ASSERT_EQ(GMM_SUCCESS, mgr->QueueAuxTableUpdate(&updateReq));
+
+            EXPECT_EQ(0u, L3Table[Walker::l3Index(VA)] & 1);
+            ASSERT_EQ(GMM_SUCCESS, mgr->FlushAuxTableUpdates(&UmdContext, 1));
+            EXPECT_EQ(0u, L3Table[Walker::l3Index(BaseVA + 2 * L2Coverage)] & 1);
+        }
+
+        for(uint32_t i = 0; i < NumSurfaces; i++)
+        {
+            GMM_GFX_ADDRESS SurfVA = VA + i * Stride;
+            Walker          walker(SurfVA, SurfVA + pResInfo->GetUnifiedAuxSurfaceOffset(GMM_AUX_CCS), mgr->GetAuxL3TableAddr());
+            EXPECT_EQ(walker.expected(SurfVA), walker.walk(SurfVA));
+        }
+
+        NumPrologCalls = NumEpilogCalls = NumEntriesWritten = 0;
+
+        updateReq.Map       = 0;
+        updateReq.DoNotWait = 0;
+        for(uint32_t i = NumSurfaces; i-- > 0;)
+        {
+            updateReq.BaseGpuVA = VA + i * Stride;
+            ASSERT_EQ(GMM_SUCCESS, Queued ? mgr->QueueAuxTableUpdate(&updateReq) : mgr->UpdateAuxTable(&updateReq));
+        }
+
+        if(Queued)
+        {
+            EXPECT_EQ(0u, NumPrologCalls);
+            ASSERT_EQ(GMM_SUCCESS, mgr->FlushAuxTableUpdates(&UmdContext, 0));
+        }
+
+        EXPECT_EQ(Queued ? 1u : NumSurfaces, NumPrologCalls);
+        EXPECT_EQ(NumPrologCalls, NumEpilogCalls);
+        EntriesWritten[Queued] = NumEntriesWritten;
+
+        // All surfaces unmapped, their L1 table is released
+        uint64_t *L2Table = (uint64_t *)((L3Table[Walker::l3Index(VA)] >> 15) << 15);
+        EXPECT_EQ(0u, L2Table[Walker::l2Index(VA)] & 1);
+    }
+
+    EXPECT_LT(EntriesWritten[1], EntriesWritten[0]);
+
+    // Threshold flush
+    GMM_GFX_ADDRESS VA = BaseVA + 3 * L2Coverage;
+
+    mgr->SetAuxTableUpdateThreshold(4);
+
+    updateReq.Map       = 1;
+    updateReq.DoNotWait = 1;
+    for(uint32_t i = 0; i < 4; i++)
+    {
+        EXPECT_EQ(0u, L3Table[Walker::l3Index(VA)] & 1);
+        updateReq.BaseGpuVA = VA + i * Stride;
+        ASSERT_EQ(GMM_SUCCESS, mgr->QueueAuxTableUpdate(&updateReq));
+    }
+
+    for(uint32_t i = 0; i < 4; i++)
+    {
+        GMM_GFX_ADDRESS SurfVA = VA + i * Stride;
+        Walker          walker(SurfVA, SurfVA + pResInfo->GetUnifiedAuxSurfaceOffset(GMM_AUX_CCS), mgr->GetAuxL3TableAddr());
+        EXPECT_EQ(walker.expected(SurfVA), walker.walk(SurfVA));
+    }
+
+    delete surf;
+    pGmmULTClientContext->DestroyPageTblMgrObject(mgr);
+}
+
+// Maps surfaces in three L1 tables and checks the mapped-range index: VA lookups,
+// rejected double-map, and bulk invalidation of a heap range holding two of them.
+TEST_F(CTestAuxTable, TestAuxTableMappingIndex)
+{
+    const GMM_GFX_ADDRESS BaseVA     = 1ULL << 44;
+    const GMM_GFX_SIZE_T  L1Coverage = 1ULL << GMM_AUX_L2_LOW_BIT;
+
+    GMM_TRANSLATIONTABLE_CALLBACKS_EXT TTCbExt = {0};
+    GmmPageTableMgr *                  mgr     = pGmmULTClientContext->CreatePageTblMgrObject(&DeviceCBInt, TT_TYPE::AUXTT);
+
+    ASSERT_TRUE(mgr != NULL);
+
+    mgr->TTCb.pfPrologTranslationTable = PrologTTCB;
+    mgr->TTCb.pfEpilogTranslationTable = EpilogTTCB;
+    mgr->TTCb.pfWriteL2L3Entry         = WriteL2L3EntryCB;
+    TTCbExt.pfWriteL2L3Entries         = WriteL2L3EntriesCB;
+    mgr->SetTranslationTableCallbacksExt(&TTCbExt);
+
+    Surface *surfA = new Surface(720, 480);
+    Surface *surfB = new Surface(1920, 1080);
+
+    ASSERT_TRUE(surfA != NULL && surfA->init());
+    ASSERT_TRUE(surfB != NULL && surfB->init());
+
+    GMM_RESOURCE_INFO *pResInfo[3] = {surfA->getGMMResourceInfo(), surfB->getGMMResourceInfo(), surfA->getGMMResourceInfo()};
+    GMM_GFX_ADDRESS    VA[3];
+
+    GMM_DDI_UPDATEAUXTABLE updateReq = {0};
+    GMM_AUXTT_MAPPING_INFO Mapping   = {0};
+
+    updateReq.Map       = 1;
+    updateReq.DoNotWait = 1;
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        VA[i]                 = BaseVA + i * L1Coverage;
+        updateReq.BaseResInfo = pResInfo[i];
+        updateReq.BaseGpuVA   = VA[i];
+        ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+    }
+
+    // Lookup within, and past end of, a mapped main surface
+    ASSERT_EQ(GMM_SUCCESS, mgr->GetAuxTableMapping(VA[1] + GMM_KBYTE(64), &Mapping));
+    EXPECT_EQ(VA[1], Mapping.BaseGpuVA);
+    EXPECT_EQ(pResInfo[1]->GetSizeMainSurface(), Mapping.Size);
+    EXPECT_EQ(VA[1] + pResInfo[1]->GetUnifiedAuxSurfaceOffset(GMM_AUX_CCS), Mapping.AuxSurfVA);
+    EXPECT_EQ(pResInfo[1], Mapping.BaseResInfo);
+    EXPECT_TRUE(Mapping.AuxResInfo == NULL);
+    EXPECT_EQ(GMM_ERROR, mgr->GetAuxTableMapping(VA[1] + pResInfo[1]->GetSizeMainSurface(), &Mapping));
+    EXPECT_EQ(GMM_ERROR, mgr->GetAuxTableMapping(BaseVA - 1, &Mapping));
+
+    // Double-map is rejected leaving existing mapping intact, identical remap is allowed
+    updateReq.BaseResInfo = pResInfo[1];
+    updateReq.BaseGpuVA   = VA[0] + GMM_KBYTE(64);
+    EXPECT_EQ(GMM_INVALIDPARAM, mgr->UpdateAuxTable(&updateReq));
+    updateReq.BaseResInfo = pResInfo[0];
+    updateReq.BaseGpuVA   = VA[0];
+    EXPECT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+
+    Walker walkerA(VA[0], VA[0] + pResInfo[0]->GetUnifiedAuxSurfaceOffset(GMM_AUX_CCS), mgr->GetAuxL3TableAddr());
+    EXPECT_EQ(walkerA.expected(VA[0] + GMM_KBYTE(64)), walkerA.walk(VA[0] + GMM_KBYTE(64)));
+
+    // Release heap holding first two surfaces
+    GMM_UMD_SYNCCONTEXT UmdContext = {0};
+    UmdContext.pCommandQueueHandle = (void *)0x1;
+
+    NumPrologCalls = NumEpilogCalls = 0;
+    ASSERT_EQ(GMM_SUCCESS, mgr->InvalidateAuxTableRange(&UmdContext, BaseVA, 2 * L1Coverage, 0));
+    EXPECT_EQ(1u, NumPrologCalls);
+    EXPECT_EQ(1u, NumEpilogCalls);
+
+    EXPECT_EQ(GMM_ERROR, mgr->GetAuxTableMapping(VA[0], &Mapping));
+    EXPECT_EQ(GMM_ERROR, mgr->GetAuxTableMapping(VA[1], &Mapping));
+    ASSERT_EQ(GMM_SUCCESS, mgr->GetAuxTableMapping(VA[2], &Mapping));
+    EXPECT_EQ(VA[2], Mapping.BaseGpuVA);
+
+    uint64_t *L3Table = (uint64_t *)mgr->GetAuxL3TableAddr();
+    uint64_t *L2Table = (uint64_t *)((L3Table[Walker::l3Index(BaseVA)] >> 15) << 15);
+    EXPECT_EQ(0u, L2Table[Walker::l2Index(VA[0])] & 1);
+    EXPECT_EQ(0u, L2Table[Walker::l2Index(VA[1])] & 1);
+
+    Walker walkerC(VA[2], VA[2] + pResInfo[2]->GetUnifiedAuxSurfaceOffset(GMM_AUX_CCS), mgr->GetAuxL3TableAddr());
+    EXPECT_EQ(walkerC.expected(VA[2]), walkerC.walk(VA[2]));
+
+    // Unmapped range can be mapped again
+    updateReq.BaseResInfo = pResInfo[1];
+    updateReq.BaseGpuVA   = VA[0] + GMM_KBYTE(64);
+    EXPECT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+
+    delete surfB;
+    delete surfA;
+    pGmmULTClientContext->DestroyPageTblMgrObject(mgr);
+}
+
+// Page-table pool busy query for TestAuxTablePoolReclamation
+static int PoolsBusy;
+
+static int IsBufferBusyCB(void *bo)
+{
+    return PoolsBusy;
+}
+
+// Fills a dozen Aux-L1 pools, then unmaps everything, first with pools reported
+// idle and then busy. Checks unused pools are trimmed between the watermarks,
+// only busy pools are waited on, and pool footprint stats match the BO list.
+TEST_F(CTestAuxTable, TestAuxTablePoolReclamation)
+{
+    const uint32_t        L1PerPool   = 256;
+    const uint32_t        NumMappings = 12 * L1PerPool;
+    const GMM_GFX_ADDRESS BaseVA      = 1ULL << 44;
+    const GMM_GFX_SIZE_T  L1Coverage  = 1ULL << GMM_AUX_L2_LOW_BIT;
+    const GMM_GFX_SIZE_T  PoolSize    = GMM_MBYTE(2);
+
+    GMM_TRANSLATIONTABLE_CALLBACKS_EXT TTCbExt = {0};
+    GmmPageTableMgr *                  mgr     = pGmmULTClientContext->CreatePageTblMgrObject(&DeviceCBInt, TT_TYPE::AUXTT);
+
+    ASSERT_TRUE(mgr != NULL);
+
+    TTCbExt.pfIsBufferBusy = IsBufferBusyCB;
+    mgr->SetTranslationTableCallbacksExt(&TTCbExt);
+
+    Surface *surf = new Surface(720, 480);
+
+    ASSERT_TRUE(surf != NULL && surf->init());
+
+    GMM_DDI_UPDATEAUXTABLE   updateReq = {0};
+    GMM_PAGETABLE_POOL_STATS Stats     = {0};
+    updateReq.BaseResInfo              = surf->getGMMResourceInfo();
+    updateReq.DoNotWait                = 1;
+
+    for(PoolsBusy = 0; PoolsBusy < 2; PoolsBusy++)
+    {
+        GMM_PAGETABLE_POOL_STATS Prev = Stats;
+
+        updateReq.Map = 1;
+        for(uint32_t i = 0; i < NumMappings; i++)
+        {
+            updateReq.BaseGpuVA = BaseVA + i * L1Coverage;
+            ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+        }
+
+        ASSERT_EQ(GMM_SUCCESS, mgr->GetPageTablePoolStats(&Stats));
+        EXPECT_EQ(0u, Stats.NumUnusedPools);
+        EXPECT_GE(Stats.PeakFootprint, (NumMappings / L1PerPool + 1) * PoolSize);
+
+        updateReq.Map = 0;
+        for(uint32_t i = 0; i < NumMappings; i++)
+        {
+            updateReq.BaseGpuVA = BaseVA + i * L1Coverage;
+            ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+        }
+
+        ASSERT_EQ(GMM_SUCCESS, mgr->GetPageTablePoolStats(&Stats));
+        EXPECT_GT(Stats.NumPoolsReleased, Prev.NumPoolsReleased);
+        EXPECT_EQ(PoolsBusy ? Stats.NumPoolsReleased - Prev.NumPoolsReleased : 0, Stats.NumPoolWaits - Prev.NumPoolWaits);
+        EXPECT_LE(Stats.NumUnusedPools * PoolSize, GMM_MBYTE(16));
+        EXPECT_GE(Stats.NumUnusedPools * PoolSize, GMM_MBYTE(8));
+        EXPECT_EQ(Stats.NumPools * PoolSize, Stats.Footprint);
+        EXPECT_EQ((int)Stats.NumPools + 1, mgr->GetNumOfPageTableBOs(TT_TYPE::AUXTT));
+    }
+
+    delete surf;
+    pGmmULTClientContext->DestroyPageTblMgrObject(mgr);
+}
+
+// Per-thread input/result of TestAuxTableMultiThreaded
+typedef struct AuxTableThreadParams_Rec
+{
+    GmmPageTableMgr *mgr;
+    GMM_RESOURCE_INFO *pResInfo;
+    GMM_GFX_ADDRESS  BaseVA;      // first mapping
+    GMM_GFX_SIZE_T   Stride;      // VA distance between mappings
+    uint32_t         NumMappings;
+    uint32_t         NumRounds;
+    GMM_UMD_SYNCCONTEXT *pUmdContext; // Gpu unmaps on it if set, else Cpu unmaps
+    uint32_t         NumFailures;
+} AuxTableThreadParams;
+
+// Maps the surface at NumMappings addresses, checks each by a table walk, then
+// unmaps them, NumRounds times
+static void *AuxTableMapUnmapThread(void *pArgs)
+{
+    AuxTableThreadParams * pParams   = (AuxTableThreadParams *)pArgs;
+    GMM_DDI_UPDATEAUXTABLE updateReq = {0};
+    updateReq.BaseResInfo            = pParams->pResInfo;
+    updateReq.UmdContext             = pParams->pUmdContext;
+
+    for(uint32_t Round = 0; Round < pParams->NumRounds; Round++)
+    {
+        updateReq.Map       = 1;
+        updateReq.DoNotWait = 1;
+        for(uint32_t i = 0; i < pParams->NumMappings; i++)
+        {
+            updateReq.BaseGpuVA = pParams->BaseVA + i * pParams->Stride;
+            pParams->NumFailures += (pParams->mgr->UpdateAuxTable(&updateReq) != GMM_SUCCESS);
+        }
+
+        for(uint32_t i = 0; i < pParams->NumMappings; i++)
+        {
+            GMM_GFX_ADDRESS         VA = pParams->BaseVA + i * pParams->Stride;
+            CTestAuxTable::Walker walker(VA, VA + pParams->pResInfo->GetUnifiedAuxSurfaceOffset(GMM_AUX_CCS), pParams->mgr->GetAuxL3TableAddr());
+            pParams->NumFailures += (walker.expected(VA) != walker.walk(VA));
+        }
+
+        updateReq.Map       = 0;
+        updateReq.DoNotWait = !pParams->pUmdContext;
+        for(uint32_t i = 0; i < pParams->NumMappings; i++)
+        {
+            updateReq.BaseGpuVA = pParams->BaseVA + i * pParams->Stride;
+            pParams->NumFailures += (pParams->mgr->UpdateAuxTable(&updateReq) != GMM_SUCCESS);
+        }
+    }
+
+    return NULL;
+}
+
+// Maps/unmaps from several threads, each on its own L1 tables, both in disjoint
+// L2 tables and interleaved in one L2 table, on a simulated device. Half of the
+// threads unmap on the Gpu, updating pool fences while others release pools.
+// Every mapping is checked while the other threads update the tables.
+// Scaling with thread count is measured by GMMBench (CBenchAuxTable.Gen12Threads).
+TEST_F(CTestAuxTable, TestAuxTableMultiThreaded)
+{
+    const uint32_t        NumThreads  = 4;
+    const uint32_t        NumMappings = 64;
+    const uint32_t        NumRounds   = 4;
+    const GMM_GFX_ADDRESS BaseVA      = 1ULL << 44;
+    const GMM_GFX_SIZE_T  L1Coverage  = 1ULL << GMM_AUX_L2_LOW_BIT;
+    const GMM_GFX_SIZE_T  L2Coverage  = 1ULL << GMM_AUX_L3_LOW_BIT;
+
+    CAuxTableSimDevice              Sim;
+    CAuxTableSimDevice::SIM_OPTIONS Options = {true, true, true};
+    pthread_t                       thread_id[NumThreads];
+    AuxTableThreadParams            InParams[NumThreads];
+    uint32_t                        i, Status;
+
+    GmmPageTableMgr *mgr = pGmmULTClientContext->CreatePageTblMgrObject(Sim.GetDeviceCallbacks(), TT_TYPE::AUXTT);
+
+    ASSERT_TRUE(mgr != NULL);
+    Sim.Install(mgr, Options);
+
+    Surface *surf = new Surface(720, 480);
+
+    ASSERT_TRUE(surf != NULL && surf->init());
+
+    GMM_UMD_SYNCCONTEXT *pUmdContext = Sim.GetSyncContext();
+
+    for(uint32_t SharedL2 = 0; SharedL2 < 2; SharedL2++)
+    {
+        for(i = 0; i < NumThreads; i++)
+        {
+            InParams[i].mgr         = mgr;
+            InParams[i].pResInfo    = surf->getGMMResourceInfo();
+            InParams[i].BaseVA      = SharedL2 ? (BaseVA + i * L1Coverage) : (BaseVA + i * L2Coverage);
+            InParams[i].Stride      = SharedL2 ? (NumThreads * L1Coverage) : L1Coverage;
+            InParams[i].NumMappings = NumMappings;
+            InParams[i].NumRounds   = NumRounds;
+            InParams[i].pUmdContext = (i & 1) ? pUmdContext : NULL;
+            InParams[i].NumFailures = 0;
+        }
+
+        for(i = 0; i < NumThreads; i++)
+        {
+            Status = pthread_create(&thread_id[i], NULL, AuxTableMapUnmapThread, (void *)&InParams[i]);
+            ASSERT_TRUE((!Status));
+        }
+
+        for(i = 0; i < NumThreads; i++)
+        {
+            Status = pthread_join(thread_id[i], NULL);
+            ASSERT_TRUE((!Status));
+            EXPECT_EQ(0u, InParams[i].NumFailures);
+        }
+
+        Sim.Submit();
+        Sim.Retire();
+    }
+
+    EXPECT_GT(Sim.Stats.NumEntriesWritten, 0u);
+    EXPECT_EQ(0u, Sim.Stats.NumBadWrites);
+
+    // Tables left consistent, remap works
+    GMM_DDI_UPDATEAUXTABLE updateReq = {0};
+    updateReq.BaseResInfo            = surf->getGMMResourceInfo();
+    updateReq.BaseGpuVA              = BaseVA;
+    updateReq.Map                    = 1;
+    updateReq.DoNotWait              = 1;
+    ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+
+    Walker walker(BaseVA, BaseVA + surf->getGMMResourceInfo()->GetUnifiedAuxSurfaceOffset(GMM_AUX_CCS), mgr->GetAuxL3TableAddr());
+    EXPECT_EQ(walker.expected(BaseVA), walker.walk(BaseVA));
+
+    delete surf;
+    pGmmULTClientContext->DestroyPageTblMgrObject(mgr);
+
+    EXPECT_EQ(0u, Sim.Stats.NumBadFrees);
+}
+
+// Prolog for TestAuxTableMultiThreadedQueuedUpdates, lets other threads run (and
+// flush) while a batch is being applied, as they may on a loaded or single CPU
+static int YieldPrologTTCB(void *pDeviceHandle)
+{
+    sched_yield();
+    return 0;
+}
+
+static int NopEpilogTTCB(void *pDeviceHandle, uint8_t ForceFlush)
+{
+    return 0;
+}
+
+// Maps/unmaps the surface at NumMappings addresses through the update queue, flushing
+// (Gpu) after each. Yields before flushing, so batches holding this thread's requests
+// may be taken by other threads' flushes, and checks they are applied once its flush
+// returns. Ends with every other address mapped.
+static void *AuxTableQueueFlushThread(void *pArgs)
+{
+    AuxTableThreadParams * pParams   = (AuxTableThreadParams *)pArgs;
+    GMM_DDI_UPDATEAUXTABLE updateReq = {0};
+    GMM_AUXTT_MAPPING_INFO Mapping   = {0};
+    updateReq.BaseResInfo            = pParams->pResInfo;
+    updateReq.UmdContext             = pParams->pUmdContext;
+
+    for(uint32_t Round = 0; Round <= 2 * pParams->NumRounds; Round++)
+    {
+        uint32_t Step = (Round == 2 * pParams->NumRounds) ? 2 : 1;
+
+        updateReq.Map = !(Round & 1);
+        for(uint32_t i = 0; i < pParams->NumMappings; i += Step)
+        {
+            updateReq.BaseGpuVA = pParams->BaseVA + i * pParams->Stride;
+            pParams->NumFailures += (pParams->mgr->QueueAuxTableUpdate(&updateReq) != GMM_SUCCESS);
+        }
+        sched_yield();
+        pParams->NumFailures += (pParams->mgr->FlushAuxTableUpdates(pParams->pUmdContext, 0) != GMM_SUCCESS);
+
+        for(uint32_t i = 0; i < pParams->NumMappings; i += Step)
+        {
+            GMM_STATUS Status = pParams->mgr->GetAuxTableMapping(pParams->BaseVA + i * pParams->Stride, &Mapping);
+            pParams->NumFailures += (Status != (updateReq.Map ? GMM_SUCCESS : GMM_ERROR));
+        }
+    }
+
+    return NULL;
+}
+
+// Queues maps/unmaps of interleaved addresses in one L2 table from several threads,
+// each flushing after every round, with a Prolog that yields mid-flush. Checks
+// concurrent flushes apply batches in the order they were taken from the queue, ie
+// each address ends up in the state of its last queued request.
+TEST_F(CTestAuxTable, TestAuxTableMultiThreadedQueuedUpdates)
+{
+    const uint32_t        NumThreads  = 4;
+    const uint32_t        NumMappings = 32;
+    const uint32_t        NumRounds   = 16;
+    const GMM_GFX_ADDRESS BaseVA      = 1ULL << 44;
+    const GMM_GFX_SIZE_T  L1Coverage  = 1ULL << GMM_AUX_L2_LOW_BIT;
+
+    pthread_t            thread_id[NumThreads];
+    AuxTableThreadParams InParams[NumThreads];
+    uint32_t             i, Status;
+
+    GmmPageTableMgr *mgr = pGmmULTClientContext->CreatePageTblMgrObject(&DeviceCBInt, TT_TYPE::AUXTT);
+
+    ASSERT_TRUE(mgr != NULL);
+
+    mgr->TTCb.pfPrologTranslationTable = YieldPrologTTCB;
+    mgr->TTCb.pfEpilogTranslationTable = NopEpilogTTCB;
+    mgr->TTCb.pfWriteL2L3Entry         = WriteL2L3EntryCB;
+
+    Surface *surf = new Surface(720, 480);
+
+    ASSERT_TRUE(surf != NULL && surf->init());
+
+    GMM_RESOURCE_INFO * pResInfo   = surf->getGMMResourceInfo();
+    GMM_UMD_SYNCCONTEXT UmdContext = {0};
+    UmdContext.pCommandQueueHandle = (void *)0x1;
+
+    mgr->SetAuxTableUpdateThreshold(0);
+
+    for(i = 0; i < NumThreads; i++)
+    {
+        InParams[i].mgr         = mgr;
+        InParams[i].pResInfo    = pResInfo;
+        InParams[i].BaseVA      = BaseVA + i * L1Coverage;
+        InParams[i].Stride      = NumThreads * L1Coverage;
+        InParams[i].NumMappings = NumMappings;
+        InParams[i].NumRounds   = NumRounds;
+        InParams[i].pUmdContext = &UmdContext;
+        InParams[i].NumFailures = 0;
+    }
+
+    for(i = 0; i < NumThreads; i++)
+    {
+        Status = pthread_create(&thread_id[i], NULL, AuxTableQueueFlushThread, (void *)&InParams[i]);
+        ASSERT_TRUE((!Status));
+    }
+
+    for(i = 0; i < NumThreads; i++)
+    {
+        Status = pthread_join(thread_id[i], NULL);
+        ASSERT_TRUE((!Status));
+        EXPECT_EQ(0u, InParams[i].NumFailures);
+    }
+
+    // Unmapped addresses have no L1 table left
+    uint64_t *L3Table = (uint64_t *)mgr->GetAuxL3TableAddr();
+    uint64_t *L2Table = (uint64_t *)((L3Table[Walker::l3Index(BaseVA)] >> 15) << 15);
+
+    for(i = 0; i < NumThreads * NumMappings; i++)
+    {
+        GMM_GFX_ADDRESS        VA      = BaseVA + i * L1Coverage;
+        GMM_AUXTT_MAPPING_INFO Mapping = {0};
+
+        if((i / NumThreads) & 1)
+        {
+            EXPECT_EQ(GMM_ERROR, mgr->GetAuxTableMapping(VA, &Mapping));
+            EXPECT_EQ(0u, L2Table[Walker::l2Index(VA)] & 1);
+            continue;
+        }
+
+        ASSERT_EQ(GMM_SUCCESS, mgr->GetAuxTableMapping(VA, &Mapping));
+        EXPECT_EQ(VA, Mapping.BaseGpuVA);
+
+        Walker walker(VA, VA + pResInfo->GetUnifiedAuxSurfaceOffset(GMM_AUX_CCS), mgr->GetAuxL3TableAddr());
+        EXPECT_EQ(walker.expected(VA), walker.walk(VA));
+    }
+
+    delete surf;
+    pGmmULTClientContext->DestroyPageTblMgrObject(mgr);
+}
+
+// CPU-maps a surface spanning several L1 tables (starting mid-table) and a small one
+// sharing its last L1 table, then CPU-unmaps both. Checks bulk-filled L1 entries step
+// the CCS adr per tile, and ranged usage tracking frees each L1 table exactly when its
+// last mapping goes.
+TEST_F(CTestAuxTable, TestAuxTableBulkCpuUpdate)
+{
+    const GMM_GFX_ADDRESS BaseVA     = (1ULL << 44) + GMM_MBYTE(8);
+    const GMM_GFX_SIZE_T  L1Coverage = 1ULL << GMM_AUX_L2_LOW_BIT;
+
+    GmmPageTableMgr *mgr = pGmmULTClientContext->CreatePageTblMgrObject(&DeviceCBInt, TT_TYPE::AUXTT);
+
+    ASSERT_TRUE(mgr != NULL);
+
+    Surface *surfA = new Surface(7680, 4320);
+    Surface *surfB = new Surface(720, 480);
+
+    ASSERT_TRUE(surfA != NULL && surfA->init());
+    ASSERT_TRUE(surfB != NULL && surfB->init());
+
+    GMM_RESOURCE_INFO *pResA   = surfA->getGMMResourceInfo();
+    GMM_RESOURCE_INFO *pResB   = surfB->getGMMResourceInfo();
+    GMM_GFX_SIZE_T     SizeA   = pResA->GetSizeMainSurface();
+    GMM_GFX_ADDRESS    VA_B    = BaseVA + GFX_ALIGN(pResA->GetSizeSurface(), GMM_KBYTE(64));
+    GMM_GFX_ADDRESS    LastL1A = GFX_ALIGN_FLOOR(BaseVA + SizeA - 1, L1Coverage);
+
+    ASSERT_GT(LastL1A, BaseVA + L1Coverage);
+    ASSERT_EQ(LastL1A, GFX_ALIGN_FLOOR(VA_B, L1Coverage));
+
+    GMM_DDI_UPDATEAUXTABLE updateReq = {0};
+    updateReq.Map                    = 1;
+    updateReq.DoNotWait              = 1;
+    updateReq.BaseResInfo            = pResA;
+    updateReq.BaseGpuVA              = BaseVA;
+    ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+    updateReq.BaseResInfo = pResB;
+    updateReq.BaseGpuVA   = VA_B;
+    ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+
+    Walker walkerA(BaseVA, BaseVA + pResA->GetUnifiedAuxSurfaceOffset(GMM_AUX_CCS), mgr->GetAuxL3TableAddr());
+    Walker walkerB(VA_B, VA_B + pResB->GetUnifiedAuxSurfaceOffset(GMM_AUX_CCS), mgr->GetAuxL3TableAddr());
+
+    // Y and UV planes map to their own CCS
+    GMM_GFX_SIZE_T  SizeY   = surfA->getSurfaceSize(GMM_PLANE_Y);
+    GMM_GFX_ADDRESS AuxY    = walkerA.walk(BaseVA);
+    GMM_GFX_ADDRESS AuxUV   = walkerA.walk(BaseVA + SizeY);
+    EXPECT_EQ(walkerA.expected(BaseVA), AuxY);
+    EXPECT_EQ((BaseVA + pResA->GetUnifiedAuxSurfaceOffset(GMM_AUX_UV_CCS)) & ~0xFFULL, AuxUV);
+    for(GMM_GFX_SIZE_T Off = 0; Off < SizeA; Off += GMM_KBYTE(64))
+    {
+        GMM_GFX_ADDRESS Expected = (Off < SizeY) ? AuxY + (Off / GMM_KBYTE(64)) * GMM_BYTES(256) :
+                                                   AuxUV + ((Off - SizeY) / GMM_KBYTE(64)) * GMM_BYTES(256);
+        ASSERT_EQ(Expected, walkerA.walk(BaseVA + Off)) << "offset 0x" << std::hex << Off;
+    }
+    EXPECT_EQ(walkerB.expected(VA_B), walkerB.walk(VA_B));
+
+    // Unmap A: its own L1 tables go, the one shared with B stays
+    updateReq.Map         = 0;
+    updateReq.BaseResInfo = pResA;
+    updateReq.BaseGpuVA   = BaseVA;
+    ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+
+    uint64_t *L3Table = (uint64_t *)mgr->GetAuxL3TableAddr();
+    uint64_t *L2Table = (uint64_t *)((L3Table[Walker::l3Index(BaseVA)] >> 15) << 15);
+    for(GMM_GFX_ADDRESS L1VA = GFX_ALIGN_FLOOR(BaseVA, L1Coverage); L1VA < LastL1A; L1VA += L1Coverage)
+    {
+        EXPECT_EQ(0u, L2Table[Walker::l2Index(L1VA)] & 1);
+    }
+    EXPECT_EQ(1u, L2Table[Walker::l2Index(LastL1A)] & 1);
+    EXPECT_EQ((GMM_INVALID_AUX_ENTRY & 0x0000ffffffffff00), walkerA.walk(LastL1A));
+    EXPECT_EQ(walkerB.expected(VA_B), walkerB.walk(VA_B));
+
+    updateReq.BaseResInfo = pResB;
+    updateReq.BaseGpuVA   = VA_B;
+    ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+    EXPECT_EQ(0u, L2Table[Walker::l2Index(LastL1A)] & 1);
+
+    delete surfB;
+    delete surfA;
+    pGmmULTClientContext->DestroyPageTblMgrObject(mgr);
+}
+
+// Maps packed surfaces on a simulated device, GPU-unmaps them in two batches and
+// checks the unmaps land in the simulated page-table memory with no stray writes,
+// each batch is bracketed by Prolog/Epilog, and every buffer is freed idle.
+TEST_F(CTestAuxTable, TestAuxTableSimulatedDevice)
+{
+    const uint32_t        NumSurfaces = 8;
+    const GMM_GFX_ADDRESS BaseVA      = 1ULL << 44;
+
+    CAuxTableSimDevice                Sim;
+    CAuxTableSimDevice::SIM_OPTIONS   Options = {true, true, true};
+    GMM_PAGETABLE_POOL_STATS          Stats   = {0};
+
+    GmmPageTableMgr *mgr = pGmmULTClientContext->CreatePageTblMgrObject(Sim.GetDeviceCallbacks(), TT_TYPE::AUXTT);
+
+    ASSERT_TRUE(mgr != NULL);
+    Sim.Install(mgr, Options);
+
+    Surface *surf = new Surface(1920, 1080);
+
+    ASSERT_TRUE(surf != NULL && surf->init());
+
+    GMM_RESOURCE_INFO *    pResInfo  = surf->getGMMResourceInfo();
+    GMM_GFX_SIZE_T         Stride    = GFX_ALIGN(pResInfo->GetSizeSurface(), GMM_KBYTE(64));
+    GMM_DDI_UPDATEAUXTABLE updateReq = {0};
+
+    updateReq.BaseResInfo = pResInfo;
+    updateReq.Map         = 1;
+    updateReq.DoNotWait   = 1;
+    for(uint32_t i = 0; i < NumSurfaces; i++)
+    {
+        updateReq.BaseGpuVA = BaseVA + i * Stride;
+        ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+    }
+    EXPECT_EQ(0u, Sim.Stats.NumPrologs); //maps are CPU updates
+
+    Walker walker0(BaseVA, BaseVA + pResInfo->GetUnifiedAuxSurfaceOffset(GMM_AUX_CCS), mgr->GetAuxL3TableAddr());
+    EXPECT_EQ(walker0.expected(BaseVA), walker0.walk(BaseVA));
+
+    // First half shares its L1 table with the second, so the table outlives the batch
+    updateReq.Map       = 0;
+    updateReq.DoNotWait = 0;
+    for(uint32_t i = 0; i < NumSurfaces; i++)
+    {
+        if(i == NumSurfaces / 2)
+        {
+            EXPECT_EQ(NumSurfaces / 2, Sim.Stats.NumPrologs);
+            EXPECT_EQ(Sim.Stats.NumPrologs, Sim.Stats.NumEpilogs);
+            EXPECT_EQ(walker0.expected(BaseVA), walker0.walk(BaseVA)); //not executed yet
+            Sim.Submit();
+            EXPECT_EQ((GMM_INVALID_AUX_ENTRY & 0x0000ffffffffff00), walker0.walk(BaseVA));
+        }
+        updateReq.UmdContext = Sim.GetSyncContext();
+        updateReq.BaseGpuVA  = BaseVA + i * Stride;
+        ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+    }
+    Sim.Submit();
+
+    EXPECT_EQ(NumSurfaces, Sim.Stats.NumEpilogs);
+    EXPECT_GT(Sim.Stats.NumEntriesWritten, 0u);
+    EXPECT_GE(Sim.Stats.CommandBytes, Sim.Stats.NumEntriesWritten * sizeof(uint64_t));
+    EXPECT_EQ(0u, Sim.Stats.NumBadWrites);
+
+    // L3 table and pools are the simulator's only buffers
+    ASSERT_EQ(GMM_SUCCESS, mgr->GetPageTablePoolStats(&Stats));
+    EXPECT_EQ(Stats.NumPools + 1, Sim.GetNumBuffers());
+    EXPECT_EQ(Sim.Stats.NumAllocs, Sim.GetNumBuffers());
+
+    Sim.Retire();
+    delete surf;
+    pGmmULTClientContext->DestroyPageTblMgrObject(mgr);
+
+    EXPECT_EQ(0u, Sim.GetNumBuffers());
+    EXPECT_EQ(0u, Sim.Stats.AllocatedBytes);
+    EXPECT_EQ(0u, Sim.Stats.NumBadFrees);
+    EXPECT_EQ(0u, Sim.Stats.NumBadWaits);
+}
+
+// Flushes GPU maps and unmaps of one L2 table as a batch on a simulated device: an
+// unmap releasing an L1 table precedes a map reusing its slot. Checks the batch is
+// one Prolog/Epilog pair and its writes land in queuing order.
+TEST_F(CTestAuxTable, TestAuxTableBatchedMixedGpuUpdate)
+{
+    const GMM_GFX_ADDRESS BaseVA     = 1ULL << 44;
+    const GMM_GFX_SIZE_T  L1Coverage = 1ULL << GMM_AUX_L2_LOW_BIT;
+
+    CAuxTableSimDevice              Sim;
+    CAuxTableSimDevice::SIM_OPTIONS Options = {true, true, true};
+
+    GmmPageTableMgr *mgr = pGmmULTClientContext->CreatePageTblMgrObject(Sim.GetDeviceCallbacks(), TT_TYPE::AUXTT);
+
+    ASSERT_TRUE(mgr != NULL);
+    Sim.Install(mgr, Options);
+
+    Surface *surf = new Surface(1920, 1080);
+
+    ASSERT_TRUE(surf != NULL && surf->init());
+
+    GMM_RESOURCE_INFO *    pResInfo  = surf->getGMMResourceInfo();
+    GMM_DDI_UPDATEAUXTABLE updateReq = {0};
+
+    updateReq.BaseResInfo = pResInfo;
+    updateReq.UmdContext  = Sim.GetSyncContext();
+
+    // Surfaces alone in L1 slots 0 and 2 are mapped before the batch
+    updateReq.Map       = 1;
+    updateReq.DoNotWait = 1;
+    updateReq.BaseGpuVA = BaseVA;
+    ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+    updateReq.BaseGpuVA = BaseVA + 2 * L1Coverage;
+    ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+
+    // Batch: map slot 1, unmap slot 0 (frees its L1 table), remap slot 0, unmap slot 2
+    updateReq.DoNotWait = 0;
+    updateReq.Map       = 1;
+    updateReq.BaseGpuVA = BaseVA + L1Coverage;
+    ASSERT_EQ(GMM_SUCCESS, mgr->QueueAuxTableUpdate(&updateReq));
+    updateReq.Map       = 0;
+    updateReq.BaseGpuVA = BaseVA;
+    ASSERT_EQ(GMM_SUCCESS, mgr->QueueAuxTableUpdate(&updateReq));
+    updateReq.Map = 1;
+    ASSERT_EQ(GMM_SUCCESS, mgr->QueueAuxTableUpdate(&updateReq));
+    updateReq.Map       = 0;
+    updateReq.BaseGpuVA = BaseVA + 2 * L1Coverage;
+    ASSERT_EQ(GMM_SUCCESS, mgr->QueueAuxTableUpdate(&updateReq));
+
+    EXPECT_EQ(0u, Sim.Stats.NumPrologs);
+    ASSERT_EQ(GMM_SUCCESS, mgr->FlushAuxTableUpdates(Sim.GetSyncContext(), 0));
+    Sim.Submit();
+
+    EXPECT_EQ(1u, Sim.Stats.NumPrologs);
+    EXPECT_EQ(1u, Sim.Stats.NumEpilogs);
+    EXPECT_EQ(0u, Sim.Stats.NumBadWrites);
+
+    for(uint32_t Slot = 0; Slot < 2; Slot++)
+    {
+        GMM_GFX_ADDRESS SurfVA = BaseVA + Slot * L1Coverage;
+        Walker          walker(SurfVA, SurfVA + pResInfo->GetUnifiedAuxSurfaceOffset(GMM_AUX_CCS), mgr->GetAuxL3TableAddr());
+        EXPECT_EQ(walker.expected(SurfVA), walker.walk(SurfVA));
+    }
+
+    uint64_t *L3Table = (uint64_t *)mgr->GetAuxL3TableAddr();
+    uint64_t *L2Table = (uint64_t *)((L3Table[Walker::l3Index(BaseVA)] >> 15) << 15);
+    EXPECT_EQ(1u, L2Table[Walker::l2Index(BaseVA)] & 1);
+    EXPECT_EQ(1u, L2Table[Walker::l2Index(BaseVA + L1Coverage)] & 1);
+    EXPECT_EQ(0u, L2Table[Walker::l2Index(BaseVA + 2 * L1Coverage)] & 1);
+
+    Sim.Retire();
+    delete surf;
+    pGmmULTClientContext->DestroyPageTblMgrObject(mgr);
+
+    EXPECT_EQ(0u, Sim.Stats.NumBadFrees);
+}
+
 #endif /* __linux__ */
@@ -0,0 +1,1413 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+#include "GmmBench.h"
+#include "GmmAuxTableSim.h"
+#include "Internal/Common/GmmLayoutCache.h"
+#include <algorithm>
+#include <chrono>
+#if defined(__linux__)
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// @file GmmBench.cpp
+/// @brief Resource creation and query microbenchmarks, run per platform on the
+///        same contexts the ULT fixtures use, layout cache startups, adapter
+///        attach/detach under contention, and aux-table map/unmap throughput on a
+///        simulated device. Results are written as JSON:
+///
+///     GMMBench [--json=<file>] [--samples=<n>] [--gtest_filter=CBenchResource.Gen12*]
+/////////////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::pair<const GMM_BENCH_PLATFORM *, std::vector<GMM_BENCH_RESULT>>> CBenchResource::Results;
+std::vector<GMM_BENCH_AUXTT_RESULT>                                             CBenchResource::AuxTTResults;
+std::vector<GMM_BENCH_LAYOUT_CACHE_RESULT>                                      CBenchResource::LayoutCacheResults;
+std::vector<GMM_BENCH_ADAPTER_RESULT>                                           CBenchResource::AdapterResults;
+
+int    g_argc;
+char **g_argv;
+
+static uint32_t    BenchSamples  = 32;
+static const char *BenchJsonPath = "gmm_bench.json";
+
+static const GMM_BENCH_PLATFORM BenchPlatforms[] =
+{
+    {"Gen8", IGFX_BROADWELL, IGFX_GEN8_CORE, false, false},
+    {"Gen9", IGFX_SKYLAKE, IGFX_GEN9_CORE, false, false},
+    {"Gen10", IGFX_CANNONLAKE, IGFX_GEN10_CORE, false, false},
+    {"Gen11", IGFX_LAKEFIELD, IGFX_GEN11_CORE, false, false},
+    {"Gen12", IGFX_TIGERLAKE_LP, IGFX_GEN12_CORE, true, false},
+    {"Gen12dGPU", IGFX_XE_HP_SDV, IGFX_XE_HP_CORE, true, true},
+};
+
+static const struct
+{
+    const char *        Name;
+    GMM_RESOURCE_FORMAT Format;
+    bool                Planar;
+    bool                BlockCompressed;
+} BenchFormats[] =
+{
+    {"R8_UNORM", GMM_FORMAT_R8_UNORM, false, false},
+    {"B8G8R8A8_UNORM", GMM_FORMAT_B8G8R8A8_UNORM, false, false},
+    {"R16G16B16A16_FLOAT", GMM_FORMAT_R16G16B16A16_FLOAT, false, false},
+    {"R32G32B32A32_FLOAT", GMM_FORMAT_R32G32B32A32_FLOAT, false, false},
+    {"BC1_UNORM", GMM_FORMAT_BC1_UNORM, false, true},
+    {"NV12", GMM_FORMAT_NV12, true, false},
+};
+
+static const struct
+{
+    const char *      Name;
+    GMM_RESOURCE_TYPE Type;
+    uint32_t          Width;
+    uint32_t          Height;
+    uint32_t          Depth;
+    uint32_t          MaxLod;
+} BenchShapes[] =
+{
+    {"2D_64x64", RESOURCE_2D, 64, 64, 1, 0},
+    {"2D_1920x1080", RESOURCE_2D, 1920, 1080, 1, 0},
+    {"2D_4096x4096_mips", RESOURCE_2D, 4096, 4096, 1, 12},
+    {"3D_256x256x64_mips", RESOURCE_3D, 256, 256, 64, 8},
+    {"Cube_512_mips", RESOURCE_CUBE, 512, 512, 1, 9},
+};
+
+static const char *BenchTilings[] = {"Linear", "TileX", "TileY"};
+static const uint32_t BenchMSAA[] = {1, 4};
+
+// Distinct resources created per layout cache startup
+static const uint32_t BenchLayoutCacheResources = 512;
+
+// Adapters registered for the attach/detach bench, and threads attaching/detaching
+// clients across them, each spreading its attaches over all adapters
+static const uint32_t BenchAdapters                 = 4;
+static const uint32_t BenchAdapterThreads[]         = {1, 2, 4, 8};
+static const uint32_t BenchAdapterAttachesPerThread = 1024;
+
+// Compressed surfaces the aux-table mixes are made of
+static const struct
+{
+    const char *        Name;
+    GMM_RESOURCE_FORMAT Format;
+    uint32_t            Width;
+    uint32_t            Height;
+    bool                Media;          // media (MMC) vs render compression
+} BenchAuxTTSurfaces[] =
+{
+    {"NV12_720x480", GMM_FORMAT_NV12, 720, 480, true},
+    {"NV12_1920x1080", GMM_FORMAT_NV12, 1920, 1080, true},
+    {"NV12_3840x2160", GMM_FORMAT_NV12, 3840, 2160, true},
+    {"B8G8R8A8_256x256", GMM_FORMAT_B8G8R8A8_UNORM, 256, 256, false},
+    {"B8G8R8A8_1920x1080", GMM_FORMAT_B8G8R8A8_UNORM, 1920, 1080, false},
+    {"B8G8R8A8_4096x4096", GMM_FORMAT_B8G8R8A8_UNORM, 4096, 4096, false},
+};
+
+static const struct
+{
+    const char *Name;
+    uint32_t    SurfaceMask;            // BenchAuxTTSurfaces used, cycled through
+} BenchAuxTTMixes[] =
+{
+    {"media", 0x07},
+    {"render", 0x38},
+    {"mixed", 0x3f},
+};
+
+static const struct
+{
+    const char *                    Name;
+    CAuxTableSimDevice::SIM_OPTIONS Options;
+} BenchAuxTTConfigs[] =
+{
+    {"entry_writes", {false, false, true}},
+    {"ranged_writes", {true, true, true}},
+};
+
+// Maps of the mixes: CPU updates, or queued and flushed as one GPU batch
+static const struct
+{
+    const char *Name;
+    bool        QueuedGpu;
+} BenchAuxTTMapPaths[] =
+{
+    {"cpu_map", false},
+    {"queued_gpu_map", true},
+};
+
+static const uint32_t BenchAuxTTSurfacesPerSample = 256;
+
+// Threads mapping/unmapping concurrently, each on its own L1 tables; the mappings
+// of a sample are split between them
+static const uint32_t BenchAuxTTThreads[]      = {1, 4};
+static const uint32_t BenchAuxTTThreadMappings = 256;
+
+// Mappings on their own L1 table each, L1PerL2 of them per L2 table; table
+// lookup+assignment/release dominates. A full L2 table is unmapped in reverse,
+// so per-table cost must not grow with the number of L1 tables under it.
+static const struct
+{
+    const char *Name;
+    uint32_t    NumMappings;
+    uint32_t    L1PerL2;
+    bool        ReverseUnmap;
+} BenchAuxTTL1Layouts[] =
+{
+    {"l1_tables_64_per_l2", 4096, 64, false},
+    {"l1_tables_dense_l2", GMM_AUX_L2_SIZE, GMM_AUX_L2_SIZE, true},
+};
+
+// Multi-GB render-compressed surfaces, each mapped on its own
+static const struct
+{
+    const char *Name;
+    uint32_t    Width;
+    uint32_t    Height;
+    uint32_t    ArraySize;
+} BenchAuxTTLargeSurfaces[] =
+{
+    {"B8G8R8A8_16384x16384", 16384, 16384, 1},
+    {"B8G8R8A8_16384x16384x4", 16384, 16384, 4},
+    {"B8G8R8A8_16384x16384x16", 16384, 16384, 16},
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Fills in the ns/call distribution of a set of samples.
+///
+/// @param[in/out]  Samples: ns/call of each sample; sorted on return
+/// @param[out]     Result: result to fill in
+/////////////////////////////////////////////////////////////////////////////////////
+static void BenchSummarize(std::vector<double> &Samples, GMM_BENCH_RESULT &Result)
+{
+    double Sum = 0;
+
+    std::sort(Samples.begin(), Samples.end());
+    for(double Sample : Samples)
+    {
+        Sum += Sample;
+    }
+
+    auto Percentile = [&](double Q) { return Samples[std::min(Samples.size() - 1, (size_t)(Q * Samples.size()))]; };
+
+    Result.Samples = (uint32_t)Samples.size();
+    Result.MeanNs  = Sum / Samples.size();
+    Result.P50Ns   = Percentile(0.50);
+    Result.P90Ns   = Percentile(0.90);
+    Result.P99Ns   = Percentile(0.99);
+    Result.MaxNs   = Samples.back();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Times Fn over the configured number of samples, CallsPerSample calls each.
+///
+/// @return     ns/call of each sample
+/////////////////////////////////////////////////////////////////////////////////////
+template <typename Fn>
+static std::vector<double> BenchMeasure(uint32_t CallsPerSample, Fn Call)
+{
+    std::vector<double> Samples(BenchSamples);
+
+    for(uint32_t s = 0; s < BenchSamples; s++)
+    {
+        auto Start = std::chrono::steady_clock::now();
+        for(uint32_t c = 0; c < CallsPerSample; c++)
+        {
+            Call(c);
+        }
+        auto End = std::chrono::steady_clock::now();
+
+        Samples[s] = std::chrono::duration<double, std::nano>(End - Start).count() / CallsPerSample;
+    }
+
+    return Samples;
+}
+
+void CBenchResource::SetUpTestCase()
+{
+}
+
+void CBenchResource::TearDownTestCase()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Creates the global context for a platform, with the SKU features its ULT
+/// fixture uses.
+/////////////////////////////////////////////////////////////////////////////////////
+void CBenchResource::SetUpPlatform(const GMM_BENCH_PLATFORM &Platform)
+{
+    GfxPlatform.eProductFamily    = Platform.ProductFamily;
+    GfxPlatform.eRenderCoreFamily = Platform.RenderCoreFamily;
+
+    AllocateAdapterInfo();
+    if(pGfxAdapterInfo)
+    {
+        pGfxAdapterInfo->SkuTable.FtrLinearCCS             = Platform.Gen12SkuFeatures;
+        pGfxAdapterInfo->SkuTable.FtrE2ECompression        = Platform.Gen12SkuFeatures;
+        pGfxAdapterInfo->SkuTable.FtrStandardMipTailFormat = Platform.DGpuSkuFeatures;
+        CommonULT::SetUpTestCase();
+    }
+}
+
+void CBenchResource::TearDownPlatform()
+{
+    CommonULT::TearDownTestCase();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Runs every valid shape/format/tiling/MSAA/compression combination on the
+/// platform and records CreateResInfoObject(), GetOffset(), GetSizeAllocation(),
+/// CachePolicyGetMemoryObject(), GmmCachePolicyLookupMemoryObject(),
+/// EstimateResourceSize() and ImportResInfoObject() latencies.
+/////////////////////////////////////////////////////////////////////////////////////
+void CBenchResource::RunSweep(const GMM_BENCH_PLATFORM &Platform)
+{
+    const char *Apis[] = {"CreateResInfoObject", "GetOffset", "GetSizeAllocation", "CachePolicyGetMemoryObject",
+                          "CachePolicyLookupMemoryObject", "EstimateResourceSize", "ImportResInfoObject"};
+    const uint32_t NumApis = sizeof(Apis) / sizeof(Apis[0]);
+    std::vector<double>           All[NumApis];
+    std::vector<GMM_BENCH_RESULT> PlatformResults;
+
+    SetUpPlatform(Platform);
+    ASSERT_TRUE(pGmmULTClientContext);
+
+    for(const auto &Shape : BenchShapes)
+    for(const auto &Format : BenchFormats)
+    for(uint32_t Tiling = 0; Tiling < sizeof(BenchTilings) / sizeof(BenchTilings[0]); Tiling++)
+    for(uint32_t MSAA : BenchMSAA)
+    for(uint32_t Compressed = 0; Compressed < 2; Compressed++)
+    {
+        const bool Mipped = Shape.MaxLod > 0;
+
+        // Skip combinations the hardware doesn't support. Compression means
+        // lossless render compression, which starts with Gen12.
+        if((Format.Planar && (Shape.Type != RESOURCE_2D || Mipped || MSAA > 1 || Compressed)) ||
+           (Format.BlockCompressed && (MSAA > 1 || Compressed)) ||
+           (MSAA > 1 && (Shape.Type != RESOURCE_2D || Mipped || BenchTilings[Tiling] != BenchTilings[2] || Compressed)) ||
+           (Compressed && (Shape.Type != RESOURCE_2D || BenchTilings[Tiling] != BenchTilings[2] || !Platform.Gen12SkuFeatures)))
+        {
+            continue;
+        }
+
+        GMM_RESCREATE_PARAMS gmmParams = {};
+        gmmParams.Type                 = Shape.Type;
+        gmmParams.Format               = Format.Format;
+        gmmParams.BaseWidth64          = Shape.Width;
+        gmmParams.BaseHeight           = Shape.Height;
+        gmmParams.Depth                = Shape.Depth;
+        gmmParams.MaxLod               = Shape.MaxLod;
+        gmmParams.ArraySize            = 1;
+        gmmParams.NoGfxMemory          = 1;
+        gmmParams.MSAA.NumSamples      = MSAA;
+        gmmParams.Flags.Gpu.Texture    = 1;
+        gmmParams.Flags.Info.Linear    = (Tiling == 0);
+        gmmParams.Flags.Info.TiledX    = (Tiling == 1);
+        gmmParams.Flags.Info.TiledY    = (Tiling == 2);
+        if(MSAA > 1 || Compressed)
+        {
+            gmmParams.Flags.Gpu.RenderTarget = 1;
+        }
+        if(Compressed)
+        {
+            gmmParams.Flags.Gpu.CCS               = 1;
+            gmmParams.Flags.Gpu.UnifiedAuxSurface = 1;
+            gmmParams.Flags.Info.RenderCompressed = 1;
+        }
+
+        GMM_RESOURCE_INFO *ResInfo = NULL;
+        std::vector<double> Samples[NumApis];
+
+        Samples[0] = BenchMeasure(1, [&](uint32_t) {
+            GMM_RESCREATE_PARAMS Params = gmmParams;
+            if(ResInfo)
+            {
+                pGmmULTClientContext->DestroyResInfoObject(ResInfo);
+            }
+            ResInfo = pGmmULTClientContext->CreateResInfoObject(&Params);
+        });
+        ASSERT_TRUE(ResInfo) << Shape.Name << " " << Format.Name << " " << BenchTilings[Tiling];
+
+        Samples[1] = BenchMeasure(Shape.MaxLod + 1, [&](uint32_t Mip) {
+            GMM_REQ_OFFSET_INFO ReqInfo = {};
+            ReqInfo.ReqRender           = 1;
+            ReqInfo.MipLevel            = Mip;
+            ResInfo->GetOffset(ReqInfo);
+        });
+
+        volatile GMM_GFX_SIZE_T Size = 0;
+        Samples[2] = BenchMeasure(256, [&](uint32_t) { Size = ResInfo->GetSizeAllocation(); });
+
+        volatile uint32_t             MOCS  = 0;
+        const GMM_RESOURCE_USAGE_TYPE Usage = ResInfo->GetCachePolicyUsage();
+        Samples[3] = BenchMeasure(256, [&](uint32_t) {
+            MOCS = pGmmULTClientContext->CachePolicyGetMemoryObject(ResInfo, Usage).DwordValue;
+        });
+
+        const GMM_CACHE_POLICY_LOOKUP *pLookup = pGmmULTClientContext->GetCachePolicyLookup();
+        Samples[4] = BenchMeasure(256, [&](uint32_t) {
+            MOCS = GmmCachePolicyLookupMemoryObject(pLookup, Usage, Usage).DwordValue;
+        });
+
+        // Size-only query of the same request, compare with CreateResInfoObject
+        GMM_RESOURCE_SIZE_INFO SizeInfo = {};
+        Samples[5] = BenchMeasure(1, [&](uint32_t) {
+            GMM_RESCREATE_PARAMS Params = gmmParams;
+            pGmmULTClientContext->EstimateResourceSize(&Params, &SizeInfo);
+        });
+        EXPECT_EQ(ResInfo->GetSizeAllocation(), SizeInfo.SizeAllocation) << Shape.Name << " " << Format.Name << " " << BenchTilings[Tiling];
+
+        // Import+destroy of the exported layout, compare with CreateResInfoObject
+        std::vector<uint8_t> Blob(pGmmULTClientContext->SerializeResInfoObject(ResInfo, NULL, 0));
+        pGmmULTClientContext->SerializeResInfoObject(ResInfo, Blob.data(), (uint32_t)Blob.size());
+        pGmmULTClientContext->DestroyResInfoObject(ResInfo);
+
+        Samples[6] = BenchMeasure(1, [&](uint32_t) {
+            ResInfo = pGmmULTClientContext->ImportResInfoObject(Blob.data(), (uint32_t)Blob.size(), NULL);
+            pGmmULTClientContext->DestroyResInfoObject(ResInfo);
+        });
+        EXPECT_TRUE(ResInfo) << Shape.Name << " " << Format.Name << " " << BenchTilings[Tiling];
+
+        for(uint32_t a = 0; a < NumApis; a++)
+        {
+            GMM_BENCH_RESULT Result = {};
+            Result.Api              = Apis[a];
+            Result.Shape            = Shape.Name;
+            Result.Format           = Format.Name;
+            Result.Tiling           = BenchTilings[Tiling];
+            Result.MSAA             = MSAA;
+            Result.Compressed       = Compressed;
+            Result.CallsPerSample   = (a == 0 || a >= 5) ? 1 : (a == 1) ? Shape.MaxLod + 1 : 256;
+            All[a].insert(All[a].end(), Samples[a].begin(), Samples[a].end());
+            BenchSummarize(Samples[a], Result);
+            PlatformResults.push_back(Result);
+        }
+    }
+
+    for(uint32_t a = 0; a < NumApis; a++)
+    {
+        GMM_BENCH_RESULT Result = {};
+        Result.Api              = Apis[a];
+        Result.Shape = Result.Format = Result.Tiling = "all";
+        BenchSummarize(All[a], Result);
+        PlatformResults.push_back(Result);
+
+        printf("%-10s %-28s p50 %9.1f ns  p90 %9.1f ns  p99 %9.1f ns\n", Platform.Name, Apis[a],
+               Result.P50Ns, Result.P90Ns, Result.P99Ns);
+    }
+
+    Results.push_back(std::make_pair(&Platform, PlatformResults));
+
+    TearDownPlatform();
+}
+
+#ifdef GMM_LAYOUT_CACHE_SUPPORTED
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns Count distinct create requests: mipped 2D/3D/cube of a few formats,
+/// NV12, and some render-compressed 2D.
+/////////////////////////////////////////////////////////////////////////////////////
+static std::vector<GMM_RESCREATE_PARAMS> BenchLayoutCacheParams(uint32_t Count, bool Compression)
+{
+    const GMM_RESOURCE_FORMAT Formats[] = {GMM_FORMAT_R8G8B8A8_UNORM, GMM_FORMAT_R16G16B16A16_FLOAT, GMM_FORMAT_R8_UNORM,
+                                           GMM_FORMAT_NV12};
+    std::vector<GMM_RESCREATE_PARAMS> Params(Count);
+
+    for(uint32_t i = 0; i < Count; i++)
+    {
+        GMM_RESCREATE_PARAMS &Param = Params[i];
+        Param.Type                  = (i % 5 == 1) ? RESOURCE_3D : (i % 5 == 2) ? RESOURCE_CUBE : RESOURCE_2D;
+        Param.NoGfxMemory           = 1;
+        Param.Flags.Gpu.Texture     = 1;
+        Param.Flags.Info.TiledY     = 1;
+        Param.Format                = Formats[i % 4];
+        Param.BaseWidth64           = 64 + (17 * i) % 1984;
+        Param.BaseHeight            = (Param.Type == RESOURCE_CUBE) ? (uint32_t)Param.BaseWidth64 : 32 + (11 * i) % 2016;
+        Param.Depth                 = (Param.Type == RESOURCE_3D) ? 8 : 1;
+        Param.ArraySize             = 1;
+        Param.MaxLod                = (Param.Format == GMM_FORMAT_NV12) ? 0 : i % 6;
+        if(Param.Format == GMM_FORMAT_NV12)
+        {
+            Param.Type = RESOURCE_2D;
+        }
+        if(Compression && i % 7 == 3 && Param.Type == RESOURCE_2D && Param.Format != GMM_FORMAT_NV12)
+        {
+            Param.Flags.Gpu.UnifiedAuxSurface = 1;
+            Param.Flags.Gpu.CCS               = 1;
+            Param.Flags.Info.RenderCompressed = 1;
+        }
+    }
+
+    return Params;
+}
+
+// Returns the size of the one cache file in Dir and removes it if Remove is set.
+static uint64_t BenchLayoutCacheFile(const std::string &Dir, bool Remove)
+{
+    uint64_t Size = 0;
+    DIR *    pDir = opendir(Dir.c_str());
+    if(pDir)
+    {
+        for(struct dirent *pEntry = readdir(pDir); pEntry; pEntry = readdir(pDir))
+        {
+            if(strncmp(pEntry->d_name, "gmmlayout_", 10) == 0)
+            {
+                std::string Path = Dir + "/" + pEntry->d_name;
+                struct stat St;
+                Size += (stat(Path.c_str(), &St) == 0) ? St.st_size : 0;
+                if(Remove)
+                {
+                    unlink(Path.c_str());
+                }
+            }
+        }
+        closedir(pDir);
+    }
+    return Size;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Times one application startup: a new context on its own adapter creating and
+/// destroying every resource in Params, then torn down so the cache is flushed.
+///
+/// @return     startup time in us, 0 if the context couldn't be created
+/////////////////////////////////////////////////////////////////////////////////////
+static double BenchLayoutCacheStartup(PFNGMMINIT pfnInit, PFNGMMDESTROY pfnDestroy, ADAPTER_INFO *pAdapterInfo,
+                                      PLATFORM Platform, const std::vector<GMM_RESCREATE_PARAMS> &Params)
+{
+    GMM_INIT_IN_ARGS  InArgs  = {};
+    GMM_INIT_OUT_ARGS OutArgs = {};
+    InArgs.ClientType         = GMM_EXCITE_VISTA;
+    InArgs.pGtSysInfo         = &pAdapterInfo->SystemInfo;
+    InArgs.pSkuTable          = &pAdapterInfo->SkuTable;
+    InArgs.pWaTable           = &pAdapterInfo->WaTable;
+    InArgs.Platform           = Platform;
+    InArgs.FileDescriptor     = 0x300;
+
+    auto Start = std::chrono::steady_clock::now();
+
+    if(pfnInit(&InArgs, &OutArgs) != GMM_SUCCESS || !OutArgs.pGmmClientContext)
+    {
+        return 0;
+    }
+
+    for(const GMM_RESCREATE_PARAMS &Src : Params)
+    {
+        GMM_RESCREATE_PARAMS Param   = Src;
+        GMM_RESOURCE_INFO *  ResInfo = OutArgs.pGmmClientContext->CreateResInfoObject(&Param);
+        if(ResInfo)
+        {
+            OutArgs.pGmmClientContext->DestroyResInfoObject(ResInfo);
+        }
+    }
+
+    pfnDestroy(&OutArgs);
+
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - Start).count();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Compares application startups creating the same resources without the layout
+/// cache, with an empty cache directory and with the file the cold startup wrote.
+/////////////////////////////////////////////////////////////////////////////////////
+void CBenchResource::RunLayoutCacheStartup(const GMM_BENCH_PLATFORM &Platform)
+{
+    std::vector<GMM_RESCREATE_PARAMS> Params = BenchLayoutCacheParams(BenchLayoutCacheResources, Platform.Gen12SkuFeatures);
+    std::vector<double>               Off, Cold, Warm;
+    char                              Template[] = "/tmp/gmmbench_layout_XXXXXX";
+    uint64_t                          FileBytes  = 0;
+
+    SetUpPlatform(Platform);
+    ASSERT_TRUE(pGmmULTClientContext);
+    ASSERT_TRUE(mkdtemp(Template));
+
+    for(uint32_t s = 0; s < BenchSamples; s++)
+    {
+        unsetenv(GMM_LAYOUT_CACHE_DIR_ENV);
+        Off.push_back(BenchLayoutCacheStartup(pfnGmmInit, pfnGmmDestroy, pGfxAdapterInfo, GfxPlatform, Params));
+
+        setenv(GMM_LAYOUT_CACHE_DIR_ENV, Template, 1);
+        BenchLayoutCacheFile(Template, true);
+        Cold.push_back(BenchLayoutCacheStartup(pfnGmmInit, pfnGmmDestroy, pGfxAdapterInfo, GfxPlatform, Params));
+        FileBytes = BenchLayoutCacheFile(Template, false);
+        Warm.push_back(BenchLayoutCacheStartup(pfnGmmInit, pfnGmmDestroy, pGfxAdapterInfo, GfxPlatform, Params));
+        EXPECT_EQ(FileBytes, BenchLayoutCacheFile(Template, false)); // warm startup hits for everything
+    }
+
+    unsetenv(GMM_LAYOUT_CACHE_DIR_ENV);
+    BenchLayoutCacheFile(Template, true);
+    rmdir(Template);
+
+    EXPECT_GT(FileBytes, 0u);
+    std::sort(Off.begin(), Off.end());
+    std::sort(Cold.begin(), Cold.end());
+    std::sort(Warm.begin(), Warm.end());
+    EXPECT_GT(Off[0], 0);
+    EXPECT_GT(Cold[0], 0);
+    EXPECT_GT(Warm[0], 0);
+
+    GMM_BENCH_LAYOUT_CACHE_RESULT Result = {};
+    Result.Platform                      = Platform.Name;
+    Result.NumResources                  = BenchLayoutCacheResources;
+    Result.FileBytes                     = FileBytes;
+    Result.Samples                       = BenchSamples;
+    Result.OffUs                         = Off[Off.size() / 2];
+    Result.ColdUs                        = Cold[Cold.size() / 2];
+    Result.WarmUs                        = Warm[Warm.size() / 2];
+    LayoutCacheResults.push_back(Result);
+
+    printf("%-10s LayoutCache %u resources, file %llu bytes: no cache %9.1f us  cold %9.1f us  warm %9.1f us\n",
+           Platform.Name, Result.NumResources, (unsigned long long)Result.FileBytes, Result.OffUs, Result.ColdUs, Result.WarmUs);
+
+    TearDownPlatform();
+}
+#endif
+
+#if defined(__linux__)
+// Per-thread work of RunAdapterAttach, samples start/end together on pBarrier
+typedef struct GMM_BENCH_ADAPTER_THREAD_REC
+{
+    PFNGMMINIT              pfnInit;
+    PFNGMMDESTROY           pfnDestroy;
+    const GMM_INIT_IN_ARGS *pInArgs;        // BenchAdapters registered adapters
+    uint32_t                FirstAdapter;   // adapter of the thread's first attach
+    uint32_t                NumFailures;
+    pthread_barrier_t *     pBarrier;
+} GMM_BENCH_ADAPTER_THREAD;
+
+static void *BenchAdapterThread(void *pArgs)
+{
+    GMM_BENCH_ADAPTER_THREAD *pThread = (GMM_BENCH_ADAPTER_THREAD *)pArgs;
+
+    for(uint32_t s = 0; s < BenchSamples; s++)
+    {
+        pthread_barrier_wait(pThread->pBarrier);
+
+        for(uint32_t i = 0; i < BenchAdapterAttachesPerThread; i++)
+        {
+            GMM_INIT_IN_ARGS  InArgs  = pThread->pInArgs[(pThread->FirstAdapter + i) % BenchAdapters];
+            GMM_INIT_OUT_ARGS OutArgs = {};
+
+            if(pThread->pfnInit(&InArgs, &OutArgs) != GMM_SUCCESS || !OutArgs.pGmmClientContext)
+            {
+                pThread->NumFailures++;
+                continue;
+            }
+            pThread->pfnDestroy(&OutArgs);
+        }
+
+        pthread_barrier_wait(pThread->pBarrier);
+    }
+
+    return NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Registers BenchAdapters adapters by a first client each, then attaches and
+/// detaches further clients across them from 1 vs several threads. Every attach
+/// looks its adapter up and takes a reference, so scaling is bound by the adapter
+/// table. Records the cost of an attach+detach pair per thread, and attaches per
+/// second over all threads.
+/////////////////////////////////////////////////////////////////////////////////////
+void CBenchAdapter::RunAdapterAttach(const GMM_BENCH_PLATFORM &Platform)
+{
+    const uint32_t    MaxThreads = 8;
+    GMM_INIT_IN_ARGS  InArgs[BenchAdapters];
+    GMM_INIT_OUT_ARGS OutArgs[BenchAdapters];
+
+    SetUpPlatform(Platform);
+    ASSERT_TRUE(pGmmULTClientContext);
+
+    for(uint32_t a = 0; a < BenchAdapters; a++)
+    {
+        InArgs[a]                = {};
+        InArgs[a].ClientType     = GMM_EXCITE_VISTA;
+        InArgs[a].pGtSysInfo     = &pGfxAdapterInfo->SystemInfo;
+        InArgs[a].pSkuTable      = &pGfxAdapterInfo->SkuTable;
+        InArgs[a].pWaTable       = &pGfxAdapterInfo->WaTable;
+        InArgs[a].Platform       = GfxPlatform;
+        InArgs[a].FileDescriptor = 0x400 + a;
+
+        OutArgs[a] = {};
+        ASSERT_EQ(GMM_SUCCESS, pfnGmmInit(&InArgs[a], &OutArgs[a]));
+        ASSERT_TRUE(OutArgs[a].pGmmClientContext);
+    }
+
+    for(uint32_t Threads : BenchAdapterThreads)
+    {
+        GMM_BENCH_ADAPTER_THREAD Thread[MaxThreads];
+        pthread_t                ThreadId[MaxThreads];
+        pthread_barrier_t        Barrier;
+        std::vector<double>      Elapsed;
+
+        ASSERT_LE(Threads, MaxThreads);
+
+        pthread_barrier_init(&Barrier, NULL, Threads + 1);
+        for(uint32_t t = 0; t < Threads; t++)
+        {
+            Thread[t].pfnInit      = pfnGmmInit;
+            Thread[t].pfnDestroy   = pfnGmmDestroy;
+            Thread[t].pInArgs      = InArgs;
+            Thread[t].FirstAdapter = t % BenchAdapters;
+            Thread[t].NumFailures  = 0;
+            Thread[t].pBarrier     = &Barrier;
+            pthread_create(&ThreadId[t], NULL, BenchAdapterThread, &Thread[t]);
+        }
+
+        for(uint32_t s = 0; s < BenchSamples; s++)
+        {
+            pthread_barrier_wait(&Barrier);
+            auto Start = std::chrono::steady_clock::now();
+            pthread_barrier_wait(&Barrier);
+            auto End = std::chrono::steady_clock::now();
+
+            Elapsed.push_back(std::chrono::duration<double, std::nano>(End - Start).count());
+        }
+
+        for(uint32_t t = 0; t < Threads; t++)
+        {
+            pthread_join(ThreadId[t], NULL);
+            EXPECT_EQ(0u, Thread[t].NumFailures);
+        }
+        pthread_barrier_destroy(&Barrier);
+
+        std::sort(Elapsed.begin(), Elapsed.end());
+
+        GMM_BENCH_ADAPTER_RESULT Result = {};
+        Result.Platform                 = Platform.Name;
+        Result.NumAdapters              = BenchAdapters;
+        Result.NumThreads               = Threads;
+        Result.AttachesPerThread        = BenchAdapterAttachesPerThread;
+        Result.Samples                  = BenchSamples;
+        Result.AttachDetachNs           = Elapsed[Elapsed.size() / 2] / BenchAdapterAttachesPerThread;
+        Result.AttachesPerSec           = Threads * 1e9 / Result.AttachDetachNs;
+        AdapterResults.push_back(Result);
+
+        printf("%-10s Adapter attach/detach %u adapters %u thread(s)  %9.1f ns/pair  %9.0f attaches/s\n", Platform.Name,
+               BenchAdapters, Threads, Result.AttachDetachNs, Result.AttachesPerSec);
+    }
+
+    for(uint32_t a = 0; a < BenchAdapters; a++)
+    {
+        pfnGmmDestroy(&OutArgs[a]);
+    }
+
+    TearDownPlatform();
+}
+#endif
+
+#if defined(__linux__) && !defined(__i386__)
+/////////////////////////////////////////////////////////////////////////////////////
+/// Maps and unmaps each surface mix on a simulated device, for each callback
+/// config and map path. Maps are CPU updates, or queued and flushed as one GPU
+/// update; unmaps are recorded into the sample's batch behind them. Records
+/// maps/unmaps per second, TT callbacks and command bytes per map and per unmap,
+/// and peak page-table memory.
+/////////////////////////////////////////////////////////////////////////////////////
+void CBenchAuxTable::RunAuxTableMixes(const GMM_BENCH_PLATFORM &Platform)
+{
+    const GMM_GFX_ADDRESS BaseVA   = 1ULL << 44;
+    const uint32_t        NumSurfs = sizeof(BenchAuxTTSurfaces) / sizeof(BenchAuxTTSurfaces[0]);
+
+    GMM_RESOURCE_INFO *ResInfo[NumSurfs] = {};
+
+    SetUpPlatform(Platform);
+    ASSERT_TRUE(pGmmULTClientContext);
+
+    for(uint32_t i = 0; i < NumSurfs; i++)
+    {
+        GMM_RESCREATE_PARAMS gmmParams        = {};
+        gmmParams.Type                        = RESOURCE_2D;
+        gmmParams.Format                      = BenchAuxTTSurfaces[i].Format;
+        gmmParams.BaseWidth64                 = BenchAuxTTSurfaces[i].Width;
+        gmmParams.BaseHeight                  = BenchAuxTTSurfaces[i].Height;
+        gmmParams.Depth                       = 1;
+        gmmParams.ArraySize                   = 1;
+        gmmParams.NoGfxMemory                 = 1;
+        gmmParams.Flags.Info.TiledY           = 1;
+        gmmParams.Flags.Gpu.Texture           = 1;
+        gmmParams.Flags.Gpu.RenderTarget      = 1;
+        gmmParams.Flags.Gpu.UnifiedAuxSurface = 1;
+        if(BenchAuxTTSurfaces[i].Media)
+        {
+            gmmParams.Flags.Info.MediaCompressed = 1;
+            gmmParams.Flags.Gpu.MMC              = 1;
+            gmmParams.Flags.Gpu.Video            = 1;
+        }
+        else
+        {
+            gmmParams.Flags.Info.RenderCompressed = 1;
+            gmmParams.Flags.Gpu.CCS               = 1;
+        }
+
+        ResInfo[i] = pGmmULTClientContext->CreateResInfoObject(&gmmParams);
+        ASSERT_TRUE(ResInfo[i]) << BenchAuxTTSurfaces[i].Name;
+    }
+
+    for(const auto &Mix : BenchAuxTTMixes)
+    for(const auto &Config : BenchAuxTTConfigs)
+    for(const auto &MapPath : BenchAuxTTMapPaths)
+    {
+        std::vector<GMM_RESOURCE_INFO *> Surfaces;
+        std::vector<GMM_GFX_ADDRESS>     VAs;
+        std::vector<double>              MapRate, UnmapRate;
+        GMM_GFX_ADDRESS                  VA           = BaseVA;
+        uint64_t                         SurfaceBytes = 0;
+        GMM_AUXTT_SIM_STATS              MapStats     = {}; // work recorded by maps, summed over samples
+
+        // Mix surfaces cycled through, packed at 64KB granularity
+        for(uint32_t i = 0; Surfaces.size() < BenchAuxTTSurfacesPerSample; i = (i + 1) % NumSurfs)
+        {
+            if(Mix.SurfaceMask & (1 << i))
+            {
+                Surfaces.push_back(ResInfo[i]);
+                VAs.push_back(VA);
+                SurfaceBytes += ResInfo[i]->GetSizeMainSurface();
+                VA += GFX_ALIGN(ResInfo[i]->GetSizeSurface(), GMM_KBYTE(64));
+            }
+        }
+
+        CAuxTableSimDevice        Sim;
+        GmmLib::GmmPageTableMgr *mgr = pGmmULTClientContext->CreatePageTblMgrObject(Sim.GetDeviceCallbacks(), TT_TYPE::AUXTT);
+        ASSERT_TRUE(mgr);
+        Sim.Install(mgr, Config.Options);
+        mgr->SetAuxTableUpdateThreshold(0);
+
+        for(uint32_t s = 0; s < BenchSamples; s++)
+        {
+            GMM_DDI_UPDATEAUXTABLE updateReq = {};
+            GMM_AUXTT_SIM_STATS    PreMap    = Sim.Stats;
+
+            auto Start = std::chrono::steady_clock::now();
+
+            updateReq.Map        = 1;
+            updateReq.DoNotWait  = !MapPath.QueuedGpu;
+            updateReq.UmdContext = MapPath.QueuedGpu ? Sim.GetSyncContext() : NULL;
+            for(size_t i = 0; i < Surfaces.size(); i++)
+            {
+                updateReq.BaseResInfo = Surfaces[i];
+                updateReq.BaseGpuVA   = VAs[i];
+                ASSERT_EQ(GMM_SUCCESS, MapPath.QueuedGpu ? mgr->QueueAuxTableUpdate(&updateReq) : mgr->UpdateAuxTable(&updateReq));
+            }
+            if(MapPath.QueuedGpu)
+            {
+                ASSERT_EQ(GMM_SUCCESS, mgr->FlushAuxTableUpdates(updateReq.UmdContext, 0));
+            }
+
+            auto Mapped = std::chrono::steady_clock::now();
+
+            MapStats.NumPrologs += Sim.Stats.NumPrologs - PreMap.NumPrologs;
+            MapStats.NumEpilogs += Sim.Stats.NumEpilogs - PreMap.NumEpilogs;
+            MapStats.NumCommands += Sim.Stats.NumCommands - PreMap.NumCommands;
+            MapStats.CommandBytes += Sim.Stats.CommandBytes - PreMap.CommandBytes;
+
+            updateReq.Map        = 0;
+            updateReq.DoNotWait  = 0;
+            updateReq.UmdContext = Sim.GetSyncContext();
+            for(size_t i = 0; i < Surfaces.size(); i++)
+            {
+                updateReq.BaseResInfo = Surfaces[i];
+                updateReq.BaseGpuVA   = VAs[i];
+                ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+            }
+
+            auto Unmapped = std::chrono::steady_clock::now();
+
+            Sim.Submit();
+            Sim.Retire();
+
+            MapRate.push_back(Surfaces.size() / std::chrono::duration<double>(Mapped - Start).count());
+            UnmapRate.push_back(Surfaces.size() / std::chrono::duration<double>(Unmapped - Mapped).count());
+        }
+
+        pGmmULTClientContext->DestroyPageTblMgrObject(mgr);
+        EXPECT_EQ(0u, Sim.Stats.NumBadWrites);
+        EXPECT_EQ(0u, Sim.Stats.NumBadFrees);
+
+        std::sort(MapRate.begin(), MapRate.end());
+        std::sort(UnmapRate.begin(), UnmapRate.end());
+
+        const double NumMaps      = (double)BenchSamples * Surfaces.size();
+        const double MapCallbacks = (double)(MapStats.NumPrologs + MapStats.NumEpilogs + MapStats.NumCommands);
+        const double AllCallbacks = (double)(Sim.Stats.NumPrologs + Sim.Stats.NumEpilogs + Sim.Stats.NumCommands);
+
+        GMM_BENCH_AUXTT_RESULT Result = {};
+        Result.Mix                    = Mix.Name;
+        Result.Config                 = Config.Name;
+        Result.MapPath                = MapPath.Name;
+        Result.NumThreads             = 1;
+        Result.NumSurfaces            = (uint32_t)Surfaces.size();
+        Result.SurfaceBytes           = SurfaceBytes;
+        Result.Samples                = BenchSamples;
+        Result.MapsPerSec             = MapRate[MapRate.size() / 2];
+        Result.UnmapsPerSec           = UnmapRate[UnmapRate.size() / 2];
+        Result.CallbacksPerMap        = MapCallbacks / NumMaps;
+        Result.CallbacksPerUnmap      = (AllCallbacks - MapCallbacks) / NumMaps;
+        Result.CommandBytesPerMap     = MapStats.CommandBytes / NumMaps;
+        Result.CommandBytesPerUnmap   = (Sim.Stats.CommandBytes - MapStats.CommandBytes) / NumMaps;
+        Result.PeakPoolBytes          = Sim.Stats.PeakAllocatedBytes;
+        AuxTTResults.push_back(Result);
+
+        printf("%-10s AuxTT %-7s %-14s %-14s map %9.0f/s %6.1f callbacks %7.1f B  unmap %9.0f/s %6.1f callbacks %7.1f B  pools %6.1f MB\n",
+               Platform.Name, Mix.Name, Config.Name, MapPath.Name, Result.MapsPerSec, Result.CallbacksPerMap, Result.CommandBytesPerMap,
+               Result.UnmapsPerSec, Result.CallbacksPerUnmap, Result.CommandBytesPerUnmap, Result.PeakPoolBytes / (1024.0 * 1024.0));
+    }
+
+    for(uint32_t i = 0; i < NumSurfs; i++)
+    {
+        pGmmULTClientContext->DestroyResInfoObject(ResInfo[i]);
+    }
+
+    TearDownPlatform();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Maps and unmaps multi-GB render-compressed surfaces with CPU (DoNotWait) updates,
+/// ie whole L1 tables of linear-CCS entries per call. Records GB/s mapped/unmapped,
+/// via the maps/unmaps per second, and peak page-table memory.
+/////////////////////////////////////////////////////////////////////////////////////
+void CBenchAuxTable::RunAuxTableLargeSurfaces(const GMM_BENCH_PLATFORM &Platform)
+{
+    const GMM_GFX_ADDRESS BaseVA = 1ULL << 44;
+
+    SetUpPlatform(Platform);
+    ASSERT_TRUE(pGmmULTClientContext);
+
+    for(const auto &Large : BenchAuxTTLargeSurfaces)
+    {
+        GMM_RESCREATE_PARAMS gmmParams         = {};
+        gmmParams.Type                         = RESOURCE_2D;
+        gmmParams.Format                       = GMM_FORMAT_B8G8R8A8_UNORM;
+        gmmParams.BaseWidth64                  = Large.Width;
+        gmmParams.BaseHeight                   = Large.Height;
+        gmmParams.Depth                        = 1;
+        gmmParams.ArraySize                    = Large.ArraySize;
+        gmmParams.NoGfxMemory                  = 1;
+        gmmParams.Flags.Info.TiledY            = 1;
+        gmmParams.Flags.Info.RenderCompressed  = 1;
+        gmmParams.Flags.Gpu.Texture            = 1;
+        gmmParams.Flags.Gpu.RenderTarget       = 1;
+        gmmParams.Flags.Gpu.CCS                = 1;
+        gmmParams.Flags.Gpu.UnifiedAuxSurface  = 1;
+
+        GMM_RESOURCE_INFO *ResInfo = pGmmULTClientContext->CreateResInfoObject(&gmmParams);
+        ASSERT_TRUE(ResInfo) << Large.Name;
+
+        CAuxTableSimDevice                Sim;
+        CAuxTableSimDevice::SIM_OPTIONS   Options = {true, true, true};
+        std::vector<double>               MapRate, UnmapRate;
+        GmmLib::GmmPageTableMgr *         mgr     = pGmmULTClientContext->CreatePageTblMgrObject(Sim.GetDeviceCallbacks(), TT_TYPE::AUXTT);
+        ASSERT_TRUE(mgr);
+        Sim.Install(mgr, Options);
+
+        GMM_DDI_UPDATEAUXTABLE updateReq = {};
+        updateReq.BaseResInfo            = ResInfo;
+        updateReq.BaseGpuVA              = BaseVA;
+        updateReq.DoNotWait              = 1;
+
+        for(uint32_t s = 0; s < BenchSamples; s++)
+        {
+            auto Start = std::chrono::steady_clock::now();
+
+            updateReq.Map = 1;
+            ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+
+            auto Mapped = std::chrono::steady_clock::now();
+
+            updateReq.Map = 0;
+            ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+
+            auto Unmapped = std::chrono::steady_clock::now();
+
+            MapRate.push_back(1 / std::chrono::duration<double>(Mapped - Start).count());
+            UnmapRate.push_back(1 / std::chrono::duration<double>(Unmapped - Mapped).count());
+        }
+
+        pGmmULTClientContext->DestroyPageTblMgrObject(mgr);
+        EXPECT_EQ(0u, Sim.Stats.NumCommands); //CPU updates only
+
+        std::sort(MapRate.begin(), MapRate.end());
+        std::sort(UnmapRate.begin(), UnmapRate.end());
+
+        GMM_BENCH_AUXTT_RESULT Result = {};
+        Result.Mix                    = Large.Name;
+        Result.Config                 = "cpu_update";
+        Result.MapPath                = "cpu_map";
+        Result.NumThreads             = 1;
+        Result.NumSurfaces            = 1;
+        Result.SurfaceBytes           = ResInfo->GetSizeMainSurface();
+        Result.Samples                = BenchSamples;
+        Result.MapsPerSec             = MapRate[MapRate.size() / 2];
+        Result.UnmapsPerSec           = UnmapRate[UnmapRate.size() / 2];
+        Result.PeakPoolBytes          = Sim.Stats.PeakAllocatedBytes;
+        AuxTTResults.push_back(Result);
+
+        printf("%-10s AuxTT %-24s map %7.1f GB/s  unmap %7.1f GB/s  pools %6.1f MB\n", Platform.Name, Large.Name,
+               Result.MapsPerSec * Result.SurfaceBytes / (1ULL << 30), Result.UnmapsPerSec * Result.SurfaceBytes / (1ULL << 30),
+               Result.PeakPoolBytes / (1024.0 * 1024.0));
+
+        pGmmULTClientContext->DestroyResInfoObject(ResInfo);
+    }
+
+    TearDownPlatform();
+}
+
+// Per-thread work of RunAuxTableThreads, phases start/end together on pBarrier
+typedef struct GMM_BENCH_AUXTT_THREAD_REC
+{
+    GmmLib::GmmPageTableMgr *mgr;
+    GMM_RESOURCE_INFO *      pResInfo;
+    GMM_GFX_ADDRESS          BaseVA;     // first mapping
+    GMM_GFX_SIZE_T           Stride;     // VA distance between mappings
+    uint32_t                 NumMappings;
+    uint32_t                 NumFailures;
+    pthread_barrier_t *      pBarrier;
+} GMM_BENCH_AUXTT_THREAD;
+
+static void *BenchAuxTableThread(void *pArgs)
+{
+    GMM_BENCH_AUXTT_THREAD *pThread   = (GMM_BENCH_AUXTT_THREAD *)pArgs;
+    GMM_DDI_UPDATEAUXTABLE  updateReq = {};
+
+    updateReq.BaseResInfo = pThread->pResInfo;
+    updateReq.DoNotWait   = 1;
+
+    for(uint32_t s = 0; s < BenchSamples; s++)
+    {
+        pthread_barrier_wait(pThread->pBarrier);
+
+        updateReq.Map = 1;
+        for(uint32_t i = 0; i < pThread->NumMappings; i++)
+        {
+            updateReq.BaseGpuVA = pThread->BaseVA + i * pThread->Stride;
+            pThread->NumFailures += (pThread->mgr->UpdateAuxTable(&updateReq) != GMM_SUCCESS);
+        }
+
+        pthread_barrier_wait(pThread->pBarrier);
+
+        updateReq.Map = 0;
+        for(uint32_t i = 0; i < pThread->NumMappings; i++)
+        {
+            updateReq.BaseGpuVA = pThread->BaseVA + i * pThread->Stride;
+            pThread->NumFailures += (pThread->mgr->UpdateAuxTable(&updateReq) != GMM_SUCCESS);
+        }
+
+        pthread_barrier_wait(pThread->pBarrier);
+    }
+
+    return NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Maps and unmaps a surface on its own L1 table per mapping from 1 vs several
+/// threads, with per-thread L2 tables and with all threads in one L2 table. CPU
+/// (DoNotWait) updates, so scaling is bound by table locking. Records maps/unmaps
+/// per second over all threads.
+/////////////////////////////////////////////////////////////////////////////////////
+void CBenchAuxTable::RunAuxTableThreads(const GMM_BENCH_PLATFORM &Platform)
+{
+    const GMM_GFX_ADDRESS BaseVA     = 1ULL << 44;
+    const GMM_GFX_SIZE_T  L1Coverage = 1ULL << GMM_AUX_L2_LOW_BIT;
+    const GMM_GFX_SIZE_T  L2Coverage = 1ULL << GMM_AUX_L3_LOW_BIT;
+    const uint32_t        MaxThreads = 4;
+
+    SetUpPlatform(Platform);
+    ASSERT_TRUE(pGmmULTClientContext);
+
+    GMM_RESCREATE_PARAMS gmmParams        = {};
+    gmmParams.Type                        = RESOURCE_2D;
+    gmmParams.Format                      = GMM_FORMAT_B8G8R8A8_UNORM;
+    gmmParams.BaseWidth64                 = 1920;
+    gmmParams.BaseHeight                  = 1080;
+    gmmParams.Depth                       = 1;
+    gmmParams.ArraySize                   = 1;
+    gmmParams.NoGfxMemory                 = 1;
+    gmmParams.Flags.Info.TiledY           = 1;
+    gmmParams.Flags.Info.RenderCompressed = 1;
+    gmmParams.Flags.Gpu.Texture           = 1;
+    gmmParams.Flags.Gpu.RenderTarget      = 1;
+    gmmParams.Flags.Gpu.CCS               = 1;
+    gmmParams.Flags.Gpu.UnifiedAuxSurface = 1;
+
+    GMM_RESOURCE_INFO *ResInfo = pGmmULTClientContext->CreateResInfoObject(&gmmParams);
+    ASSERT_TRUE(ResInfo);
+
+    for(uint32_t SharedL2 = 0; SharedL2 < 2; SharedL2++)
+    for(uint32_t Threads : BenchAuxTTThreads)
+    {
+        CAuxTableSimDevice              Sim;
+        CAuxTableSimDevice::SIM_OPTIONS Options = {true, true, true};
+        GMM_BENCH_AUXTT_THREAD          Thread[MaxThreads];
+        pthread_t                       ThreadId[MaxThreads];
+        pthread_barrier_t               Barrier;
+        std::vector<double>             MapRate, UnmapRate;
+
+        ASSERT_LE(Threads, MaxThreads);
+
+        GmmLib::GmmPageTableMgr *mgr = pGmmULTClientContext->CreatePageTblMgrObject(Sim.GetDeviceCallbacks(), TT_TYPE::AUXTT);
+        ASSERT_TRUE(mgr);
+        Sim.Install(mgr, Options);
+
+        pthread_barrier_init(&Barrier, NULL, Threads + 1);
+        for(uint32_t t = 0; t < Threads; t++)
+        {
+            Thread[t].mgr         = mgr;
+            Thread[t].pResInfo    = ResInfo;
+            Thread[t].BaseVA      = SharedL2 ? (BaseVA + t * L1Coverage) : (BaseVA + t * L2Coverage);
+            Thread[t].Stride      = SharedL2 ? (Threads * L1Coverage) : L1Coverage;
+            Thread[t].NumMappings = BenchAuxTTThreadMappings / Threads;
+            Thread[t].NumFailures = 0;
+            Thread[t].pBarrier    = &Barrier;
+            pthread_create(&ThreadId[t], NULL, BenchAuxTableThread, &Thread[t]);
+        }
+
+        for(uint32_t s = 0; s < BenchSamples; s++)
+        {
+            pthread_barrier_wait(&Barrier);
+            auto Start = std::chrono::steady_clock::now();
+            pthread_barrier_wait(&Barrier);
+            auto Mapped = std::chrono::steady_clock::now();
+            pthread_barrier_wait(&Barrier);
+            auto Unmapped = std::chrono::steady_clock::now();
+
+            MapRate.push_back(BenchAuxTTThreadMappings / std::chrono::duration<double>(Mapped - Start).count());
+            UnmapRate.push_back(BenchAuxTTThreadMappings / std::chrono::duration<double>(Unmapped - Mapped).count());
+        }
+
+        for(uint32_t t = 0; t < Threads; t++)
+        {
+            pthread_join(ThreadId[t], NULL);
+            EXPECT_EQ(0u, Thread[t].NumFailures);
+        }
+        pthread_barrier_destroy(&Barrier);
+        pGmmULTClientContext->DestroyPageTblMgrObject(mgr);
+
+        std::sort(MapRate.begin(), MapRate.end());
+        std::sort(UnmapRate.begin(), UnmapRate.end());
+
+        GMM_BENCH_AUXTT_RESULT Result = {};
+        Result.Mix                    = SharedL2 ? "threads_shared_l2" : "threads_per_thread_l2";
+        Result.Config                 = "cpu_update";
+        Result.MapPath                = "cpu_map";
+        Result.NumThreads             = Threads;
+        Result.NumSurfaces            = BenchAuxTTThreadMappings;
+        Result.SurfaceBytes           = BenchAuxTTThreadMappings * ResInfo->GetSizeMainSurface();
+        Result.Samples                = BenchSamples;
+        Result.MapsPerSec             = MapRate[MapRate.size() / 2];
+        Result.UnmapsPerSec           = UnmapRate[UnmapRate.size() / 2];
+        Result.PeakPoolBytes          = Sim.Stats.PeakAllocatedBytes;
+        AuxTTResults.push_back(Result);
+
+        printf("%-10s AuxTT %-21s %u thread(s)  map %9.0f/s  unmap %9.0f/s\n", Platform.Name, Result.Mix, Threads,
+               Result.MapsPerSec, Result.UnmapsPerSec);
+    }
+
+    pGmmULTClientContext->DestroyResInfoObject(ResInfo);
+
+    TearDownPlatform();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Maps and unmaps a surface on its own L1 table per mapping, for each layout of
+/// L1 tables over L2 tables, with CPU (DoNotWait) updates. Pool nodes freed by a
+/// sample's unmaps are reused by the next one. Records maps/unmaps (ie L1 table
+/// assignments/releases) per second and peak page-table memory.
+/////////////////////////////////////////////////////////////////////////////////////
+void CBenchAuxTable::RunAuxTableL1Tables(const GMM_BENCH_PLATFORM &Platform)
+{
+    const GMM_GFX_ADDRESS BaseVA     = 1ULL << 44;
+    const GMM_GFX_SIZE_T  L1Coverage = 1ULL << GMM_AUX_L2_LOW_BIT;
+    const GMM_GFX_SIZE_T  L2Coverage = 1ULL << GMM_AUX_L3_LOW_BIT;
+
+    SetUpPlatform(Platform);
+    ASSERT_TRUE(pGmmULTClientContext);
+
+    GMM_RESCREATE_PARAMS gmmParams        = {};
+    gmmParams.Type                        = RESOURCE_2D;
+    gmmParams.Format                      = GMM_FORMAT_B8G8R8A8_UNORM;
+    gmmParams.BaseWidth64                 = 1920;
+    gmmParams.BaseHeight                  = 1080;
+    gmmParams.Depth                       = 1;
+    gmmParams.ArraySize                   = 1;
+    gmmParams.NoGfxMemory                 = 1;
+    gmmParams.Flags.Info.TiledY           = 1;
+    gmmParams.Flags.Info.RenderCompressed = 1;
+    gmmParams.Flags.Gpu.Texture           = 1;
+    gmmParams.Flags.Gpu.RenderTarget      = 1;
+    gmmParams.Flags.Gpu.CCS               = 1;
+    gmmParams.Flags.Gpu.UnifiedAuxSurface = 1;
+
+    GMM_RESOURCE_INFO *ResInfo = pGmmULTClientContext->CreateResInfoObject(&gmmParams);
+    ASSERT_TRUE(ResInfo);
+
+    for(const auto &Layout : BenchAuxTTL1Layouts)
+    {
+        CAuxTableSimDevice              Sim;
+        CAuxTableSimDevice::SIM_OPTIONS Options = {true, true, true};
+        std::vector<GMM_GFX_ADDRESS>    VAs;
+        std::vector<double>             MapRate, UnmapRate;
+
+        for(uint32_t i = 0; i < Layout.NumMappings; i++)
+        {
+            VAs.push_back(BaseVA + (i / Layout.L1PerL2) * L2Coverage + (i % Layout.L1PerL2) * L1Coverage);
+        }
+
+        GmmLib::GmmPageTableMgr *mgr = pGmmULTClientContext->CreatePageTblMgrObject(Sim.GetDeviceCallbacks(), TT_TYPE::AUXTT);
+        ASSERT_TRUE(mgr);
+        Sim.Install(mgr, Options);
+
+        GMM_DDI_UPDATEAUXTABLE updateReq = {};
+        updateReq.BaseResInfo            = ResInfo;
+        updateReq.DoNotWait              = 1;
+
+        for(uint32_t s = 0; s < BenchSamples; s++)
+        {
+            auto Start = std::chrono::steady_clock::now();
+
+            updateReq.Map = 1;
+            for(size_t i = 0; i < VAs.size(); i++)
+            {
+                updateReq.BaseGpuVA = VAs[i];
+                ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+            }
+
+            auto Mapped = std::chrono::steady_clock::now();
+
+            updateReq.Map = 0;
+            for(size_t i = 0; i < VAs.size(); i++)
+            {
+                updateReq.BaseGpuVA = Layout.ReverseUnmap ? VAs[VAs.size() - 1 - i] : VAs[i];
+                ASSERT_EQ(GMM_SUCCESS, mgr->UpdateAuxTable(&updateReq));
+            }
+
+            auto Unmapped = std::chrono::steady_clock::now();
+
+            MapRate.push_back(VAs.size() / std::chrono::duration<double>(Mapped - Start).count());
+            UnmapRate.push_back(VAs.size() / std::chrono::duration<double>(Unmapped - Mapped).count());
+        }
+
+        pGmmULTClientContext->DestroyPageTblMgrObject(mgr);
+        EXPECT_EQ(0u, Sim.Stats.NumCommands); //CPU updates only
+
+        std::sort(MapRate.begin(), MapRate.end());
+        std::sort(UnmapRate.begin(), UnmapRate.end());
+
+        GMM_BENCH_AUXTT_RESULT Result = {};
+        Result.Mix                    = Layout.Name;
+        Result.Config                 = "cpu_update";
+        Result.MapPath                = "cpu_map";
+        Result.NumThreads             = 1;
+        Result.NumSurfaces            = Layout.NumMappings;
+        Result.SurfaceBytes           = Layout.NumMappings * ResInfo->GetSizeMainSurface();
+        Result.Samples                = BenchSamples;
+        Result.MapsPerSec             = MapRate[MapRate.size() / 2];
+        Result.UnmapsPerSec           = UnmapRate[UnmapRate.size() / 2];
+        Result.PeakPoolBytes          = Sim.Stats.PeakAllocatedBytes;
+        AuxTTResults.push_back(Result);
+
+        printf("%-10s AuxTT %-21s map %9.1f ns/L1 table  unmap %9.1f ns/L1 table  pools %6.1f MB\n", Platform.Name,
+               Layout.Name, 1e9 / Result.MapsPerSec, 1e9 / Result.UnmapsPerSec, Result.PeakPoolBytes / (1024.0 * 1024.0));
+    }
+
+    pGmmULTClientContext->DestroyResInfoObject(ResInfo);
+
+    TearDownPlatform();
+}
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Writes all results collected so far.
+///
+/// @param[in]  pPath: output file
+/// @return     true on success
+/////////////////////////////////////////////////////////////////////////////////////
+bool CBenchResource::WriteJson(const char *pPath)
+{
+    FILE *pFile = fopen(pPath, "w");
+    if(!pFile)
+    {
+        return false;
+    }
+
+    fprintf(pFile, "{\n  \"gmmlib_version\": \"%s\",\n  \"samples\": %u,\n  \"platforms\": [", GMMLIB_VERSION_STRING, BenchSamples);
+    for(size_t p = 0; p < Results.size(); p++)
+    {
+        const GMM_BENCH_PLATFORM *pPlatform = Results[p].first;
+
+        fprintf(pFile, "%s\n    {\n      \"name\": \"%s\",\n      \"product_family\": %d,\n      \"render_core_family\": %d,\n      \"results\": [",
+                p ? "," : "", pPlatform->Name, pPlatform->ProductFamily, pPlatform->RenderCoreFamily);
+
+        for(size_t r = 0; r < Results[p].second.size(); r++)
+        {
+            const GMM_BENCH_RESULT &Result = Results[p].second[r];
+
+            fprintf(pFile, "%s\n        {\"api\": \"%s\", \"shape\": \"%s\", \"format\": \"%s\", \"tiling\": \"%s\", "
+                           "\"msaa\": %u, \"compressed\": %s, \"samples\": %u, \"calls_per_sample\": %u, "
+                           "\"mean_ns\": %.1f, \"p50_ns\": %.1f, \"p90_ns\": %.1f, \"p99_ns\": %.1f, \"max_ns\": %.1f}",
+                    r ? "," : "", Result.Api, Result.Shape, Result.Format, Result.Tiling, Result.MSAA,
+                    Result.Compressed ? "true" : "false", Result.Samples, Result.CallsPerSample,
+                    Result.MeanNs, Result.P50Ns, Result.P90Ns, Result.P99Ns, Result.MaxNs);
+        }
+        fprintf(pFile, "\n      ]\n    }");
+    }
+    fprintf(pFile, "\n  ],\n  \"aux_table\": [");
+    for(size_t r = 0; r < AuxTTResults.size(); r++)
+    {
+        const GMM_BENCH_AUXTT_RESULT &Result = AuxTTResults[r];
+
+        fprintf(pFile, "%s\n    {\"mix\": \"%s\", \"config\": \"%s\", \"map_path\": \"%s\", \"threads\": %u, \"surfaces\": %u, \"surface_bytes\": %llu, \"samples\": %u, "
+                       "\"maps_per_sec\": %.0f, \"unmaps_per_sec\": %.0f, \"callbacks_per_map\": %.2f, \"callbacks_per_unmap\": %.2f, "
+                       "\"command_bytes_per_map\": %.1f, \"command_bytes_per_unmap\": %.1f, \"peak_pool_bytes\": %llu}",
+                r ? "," : "", Result.Mix, Result.Config, Result.MapPath, Result.NumThreads, Result.NumSurfaces,
+                (unsigned long long)Result.SurfaceBytes, Result.Samples, Result.MapsPerSec, Result.UnmapsPerSec, Result.CallbacksPerMap,
+                Result.CallbacksPerUnmap, Result.CommandBytesPerMap, Result.CommandBytesPerUnmap, (unsigned long long)Result.PeakPoolBytes);
+    }
+    fprintf(pFile, "\n  ],\n  \"layout_cache\": [");
+    for(size_t r = 0; r < LayoutCacheResults.size(); r++)
+    {
+        const GMM_BENCH_LAYOUT_CACHE_RESULT &Result = LayoutCacheResults[r];
+
+        fprintf(pFile, "%s\n    {\"platform\": \"%s\", \"resources\": %u, \"file_bytes\": %llu, \"samples\": %u, "
+                       "\"off_us\": %.1f, \"cold_us\": %.1f, \"warm_us\": %.1f}",
+                r ? "," : "", Result.Platform, Result.NumResources, (unsigned long long)Result.FileBytes, Result.Samples,
+                Result.OffUs, Result.ColdUs, Result.WarmUs);
+    }
+    fprintf(pFile, "\n  ],\n  \"adapter_attach\": [");
+    for(size_t r = 0; r < AdapterResults.size(); r++)
+    {
+        const GMM_BENCH_ADAPTER_RESULT &Result = AdapterResults[r];
+
+        fprintf(pFile, "%s\n    {\"platform\": \"%s\", \"adapters\": %u, \"threads\": %u, \"attaches_per_thread\": %u, \"samples\": %u, "
+                       "\"attach_detach_ns\": %.1f, \"attaches_per_sec\": %.0f}",
+                r ? "," : "", Result.Platform, Result.NumAdapters, Result.NumThreads, Result.AttachesPerThread, Result.Samples,
+                Result.AttachDetachNs, Result.AttachesPerSec);
+    }
+    fprintf(pFile, "\n  ]\n}\n");
+
+    return fclose(pFile) == 0;
+}
+
+TEST_F(CBenchResource, Gen8)
+{
+    RunSweep(BenchPlatforms[0]);
+}
+
+TEST_F(CBenchResource, Gen9)
+{
+    RunSweep(BenchPlatforms[1]);
+}
+
+TEST_F(CBenchResource, Gen10)
+{
+    RunSweep(BenchPlatforms[2]);
+}
+
+TEST_F(CBenchResource, Gen11)
+{
+    RunSweep(BenchPlatforms[3]);
+}
+
+TEST_F(CBenchResource, Gen12)
+{
+    RunSweep(BenchPlatforms[4]);
+}
+
+TEST_F(CBenchResource, Gen12dGPU)
+{
+    RunSweep(BenchPlatforms[5]);
+}
+
+#ifdef GMM_LAYOUT_CACHE_SUPPORTED
+TEST_F(CBenchResource, Gen12LayoutCache)
+{
+    RunLayoutCacheStartup(BenchPlatforms[4]);
+}
+#endif
+
+#if defined(__linux__)
+TEST_F(CBenchAdapter, Gen12Attach)
+{
+    RunAdapterAttach(BenchPlatforms[4]);
+}
+#endif
+
+#if defined(__linux__) && !defined(__i386__)
+TEST_F(CBenchAuxTable, Gen12)
+{
+    RunAuxTableMixes(BenchPlatforms[4]);
+}
+
+TEST_F(CBenchAuxTable, Gen12LargeSurfaces)
+{
+    RunAuxTableLargeSurfaces(BenchPlatforms[4]);
+}
+
+TEST_F(CBenchAuxTable, Gen12Threads)
+{
+    RunAuxTableThreads(BenchPlatforms[4]);
+}
+
+TEST_F(CBenchAuxTable, Gen12L1Tables)
+{
+    RunAuxTableL1Tables(BenchPlatforms[4]);
+}
+#endif
+
+int main(int argc, char *argv[])
+{
+    int FailCount = 0;
+
+    testing::InitGoogleTest(&argc, argv);
+
+    g_argc = argc;
+    g_argv = argv;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(strncmp(argv[i], "--json=", 7) == 0)
+        {
+            BenchJsonPath = argv[i] + 7;
+        }
+        else if(strncmp(argv[i], "--samples=", 10) == 0)
+        {
+            BenchSamples = std::max(1, atoi(argv[i] + 10));
+        }
+    }
+
+    FailCount += RUN_ALL_TESTS();
+
+    if(!CBenchResource::WriteJson(BenchJsonPath))
+    {
+        printf("Failed to write %s\n", BenchJsonPath);
+        FailCount++;
+    }
+    else
+    {
+        printf("Results written to %s\n", BenchJsonPath);
+    }
+
+    return FailCount;
+}
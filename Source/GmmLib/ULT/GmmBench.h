@@ -0,0 +1,164 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+#pragma once
+
+#include "GmmCommonULT.h"
+#include <vector>
+
+//===========================================================================
+// typedef:
+//      GMM_BENCH_PLATFORM
+//
+// Description:
+//      Platform and SKU setup of a benchmarked context, matching the ULT
+//      fixture of the same generation.
+//----------------------------------------------------------------------------
+typedef struct GMM_BENCH_PLATFORM_REC
+{
+    const char *   Name;
+    PRODUCT_FAMILY ProductFamily;
+    GFXCORE_FAMILY RenderCoreFamily;
+    bool           Gen12SkuFeatures;     // FtrLinearCCS/FtrE2ECompression
+    bool           DGpuSkuFeatures;      // FtrStandardMipTailFormat
+} GMM_BENCH_PLATFORM;
+
+//===========================================================================
+// typedef:
+//      GMM_BENCH_RESULT
+//
+// Description:
+//      ns/call distribution of one API over one resource configuration.
+//----------------------------------------------------------------------------
+typedef struct GMM_BENCH_RESULT_REC
+{
+    const char *Api;
+    const char *Shape;            // e.g. 2D_1920x1080, or "all" for the per-API summary
+    const char *Format;
+    const char *Tiling;
+    uint32_t    MSAA;
+    bool        Compressed;
+    uint32_t    Samples;
+    uint32_t    CallsPerSample;
+    double      MeanNs;
+    double      P50Ns;
+    double      P90Ns;
+    double      P99Ns;
+    double      MaxNs;
+} GMM_BENCH_RESULT;
+
+//===========================================================================
+// typedef:
+//      GMM_BENCH_AUXTT_RESULT
+//
+// Description:
+//      Aux-table map/unmap throughput of one surface mix on the simulated
+//      device, per update config.
+//----------------------------------------------------------------------------
+typedef struct GMM_BENCH_AUXTT_RESULT_REC
+{
+    const char *Mix;
+    const char *Config;                 // TT callbacks installed, see BenchAuxTTConfigs
+    const char *MapPath;                // how surfaces are mapped, see BenchAuxTTMapPaths
+    uint32_t    NumThreads;             // threads mapping/unmapping concurrently
+    uint32_t    NumSurfaces;            // mapped per sample
+    uint64_t    SurfaceBytes;           // main-surface bytes mapped per sample
+    uint32_t    Samples;
+    double      MapsPerSec;             // p50 over samples
+    double      UnmapsPerSec;
+    double      CallbacksPerMap;        // TT callbacks per map
+    double      CallbacksPerUnmap;
+    double      CommandBytesPerMap;     // TT command bytes per map
+    double      CommandBytesPerUnmap;
+    uint64_t    PeakPoolBytes;          // page-table memory, incl. L3 table
+} GMM_BENCH_AUXTT_RESULT;
+
+//===========================================================================
+// typedef:
+//      GMM_BENCH_LAYOUT_CACHE_RESULT
+//
+// Description:
+//      Application startup creating the same resources on a new context,
+//      without the layout cache, with an empty cache and with a warm one.
+//----------------------------------------------------------------------------
+typedef struct GMM_BENCH_LAYOUT_CACHE_RESULT_REC
+{
+    const char *Platform;
+    uint32_t    NumResources;      // created per startup
+    uint64_t    FileBytes;         // cache file after the cold startup
+    uint32_t    Samples;
+    double      OffUs;             // p50 over samples, context init to destroy
+    double      ColdUs;
+    double      WarmUs;
+} GMM_BENCH_LAYOUT_CACHE_RESULT;
+
+//===========================================================================
+// typedef:
+//      GMM_BENCH_ADAPTER_RESULT
+//
+// Description:
+//      Cost of attaching and detaching a client to registered adapters from
+//      several threads at once.
+//----------------------------------------------------------------------------
+typedef struct GMM_BENCH_ADAPTER_RESULT_REC
+{
+    const char *Platform;
+    uint32_t    NumAdapters;       // registered by a first client for the run
+    uint32_t    NumThreads;        // threads attaching/detaching concurrently
+    uint32_t    AttachesPerThread; // per sample
+    uint32_t    Samples;
+    double      AttachDetachNs;    // p50 over samples, per attach+detach pair of one thread
+    double      AttachesPerSec;    // p50 over samples, over all threads
+} GMM_BENCH_ADAPTER_RESULT;
+
+class CBenchResource : public CommonULT
+{
+protected:
+    static std::vector<std::pair<const GMM_BENCH_PLATFORM *, std::vector<GMM_BENCH_RESULT>>> Results;
+    static std::vector<GMM_BENCH_AUXTT_RESULT>                                             AuxTTResults;
+    static std::vector<GMM_BENCH_LAYOUT_CACHE_RESULT>                                      LayoutCacheResults;
+    static std::vector<GMM_BENCH_ADAPTER_RESULT>                                           AdapterResults;
+
+    void SetUpPlatform(const GMM_BENCH_PLATFORM &Platform);
+    void TearDownPlatform();
+    void RunSweep(const GMM_BENCH_PLATFORM &Platform);
+    void RunLayoutCacheStartup(const GMM_BENCH_PLATFORM &Platform);
+
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    static bool WriteJson(const char *pPath);
+};
+
+class CBenchAuxTable : public CBenchResource
+{
+protected:
+    void RunAuxTableMixes(const GMM_BENCH_PLATFORM &Platform);
+    void RunAuxTableLargeSurfaces(const GMM_BENCH_PLATFORM &Platform);
+    void RunAuxTableThreads(const GMM_BENCH_PLATFORM &Platform);
+    void RunAuxTableL1Tables(const GMM_BENCH_PLATFORM &Platform);
+};
+
+class CBenchAdapter : public CBenchResource
+{
+protected:
+    void RunAdapterAttach(const GMM_BENCH_PLATFORM &Platform);
+};
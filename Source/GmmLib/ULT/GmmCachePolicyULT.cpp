@@ -143,3 +143,121 @@ TEST_F(CTestCachePolicy, TestLlcEdramCachePolicy)
 {
     CheckLlcEdramCachePolicy();
 }
+
+/// Cache policy tables are built on first use, platform info and texture calc
+/// are built with the context.
+TEST_F(CTestCachePolicy, TestLazyCachePolicyInit)
+{
+    GMM_LIB_INIT_STATS Stats = {};
+
+    EXPECT_EQ(GMM_SUCCESS, pGmmULTClientContext->GetLibInitStats(&Stats));
+    EXPECT_TRUE(Stats.InitializedMask & GMM_LIB_SUBSYSTEM_BIT(GMM_LIB_SUBSYSTEM_PLATFORM_INFO));
+    EXPECT_TRUE(Stats.InitializedMask & GMM_LIB_SUBSYSTEM_BIT(GMM_LIB_SUBSYSTEM_TEXTURE_CALC));
+    EXPECT_GT(Stats.LibContextNs, 0u);
+
+    // First use of the tables initializes the cache policy
+    GMM_CACHE_POLICY_ELEMENT ClientRequest = pGmmULTClientContext->GetCachePolicyElement(GMM_RESOURCE_USAGE_RENDER_TARGET);
+    EXPECT_TRUE(ClientRequest.Initialized);
+
+    EXPECT_EQ(GMM_SUCCESS, pGmmULTClientContext->GetLibInitStats(&Stats));
+    EXPECT_TRUE(Stats.InitializedMask & GMM_LIB_SUBSYSTEM_BIT(GMM_LIB_SUBSYSTEM_CACHE_POLICY));
+    EXPECT_GT(Stats.SubsystemNs[GMM_LIB_SUBSYSTEM_CACHE_POLICY], 0u);
+}
+
+// The precomputed lookup must give the same MOCS/PTE as the regular queries, for
+// every usage, with and without a resource.
+TEST_F(CTestCachePolicy, TestCachePolicyLookup)
+{
+    const GMM_RESOURCE_USAGE_TYPE ResUsages[] = {GMM_RESOURCE_USAGE_UNKNOWN,
+                                                 GMM_RESOURCE_USAGE_RENDER_TARGET,
+                                                 GMM_RESOURCE_USAGE_STAGING,
+                                                 GMM_RESOURCE_USAGE_OCL_BUFFER};
+
+    const GMM_CACHE_POLICY_LOOKUP *pLookup = pGmmULTClientContext->GetCachePolicyLookup();
+    ASSERT_TRUE(pLookup);
+
+    for(uint32_t Usage = GMM_RESOURCE_USAGE_UNKNOWN; Usage < GMM_RESOURCE_USAGE_MAX; Usage++)
+    {
+        if(!pGmmULTClientContext->GetCachePolicyElement((GMM_RESOURCE_USAGE_TYPE)Usage).Initialized)
+        {
+            continue;
+        }
+
+        EXPECT_EQ(pGmmULTClientContext->CachePolicyGetMemoryObject(NULL, (GMM_RESOURCE_USAGE_TYPE)Usage).DwordValue,
+                  GmmCachePolicyLookupMemoryObject(pLookup, GMM_CACHE_POLICY_LOOKUP_NO_RESOURCE, (GMM_RESOURCE_USAGE_TYPE)Usage).DwordValue)
+        << "Usage: " << Usage;
+        EXPECT_EQ(pGmmULTClientContext->CachePolicyGetPteType((GMM_RESOURCE_USAGE_TYPE)Usage).DwordValue,
+                  GmmCachePolicyLookupPteType(pLookup, (GMM_RESOURCE_USAGE_TYPE)Usage).DwordValue)
+        << "Usage: " << Usage;
+    }
+
+    for(uint32_t i = 0; i < sizeof(ResUsages) / sizeof(ResUsages[0]); i++)
+    {
+        GMM_RESCREATE_PARAMS gmmParams = {};
+        gmmParams.Type                 = RESOURCE_BUFFER;
+        gmmParams.Format               = GMM_FORMAT_GENERIC_8BIT;
+        gmmParams.BaseWidth64          = 0x1000;
+        gmmParams.BaseHeight           = 1;
+        gmmParams.Depth                = 1;
+        gmmParams.Flags.Gpu.Texture    = 1;
+        gmmParams.Flags.Info.Linear    = 1;
+        gmmParams.Usage                = ResUsages[i];
+
+        GMM_RESOURCE_INFO *ResInfo = pGmmULTClientContext->CreateResInfoObject(&gmmParams);
+        ASSERT_TRUE(ResInfo);
+
+        for(uint32_t Usage = GMM_RESOURCE_USAGE_UNKNOWN; Usage < GMM_RESOURCE_USAGE_MAX; Usage++)
+        {
+            if(!pGmmULTClientContext->GetCachePolicyElement((GMM_RESOURCE_USAGE_TYPE)Usage).Initialized)
+            {
+                continue;
+            }
+
+            EXPECT_EQ(pGmmULTClientContext->CachePolicyGetMemoryObject(ResInfo, (GMM_RESOURCE_USAGE_TYPE)Usage).DwordValue,
+                      GmmCachePolicyLookupMemoryObject(pLookup, ResUsages[i], (GMM_RESOURCE_USAGE_TYPE)Usage).DwordValue)
+            << "Resource usage: " << (uint32_t)ResUsages[i] << " Usage: " << Usage;
+        }
+
+        pGmmULTClientContext->DestroyResInfoObject(ResInfo);
+    }
+}
+
+// Counted queries must return the same MOCS/PTE and be counted per usage and
+// MOCS index; nothing is counted once counting is turned off.
+TEST_F(CTestCachePolicy, TestCachePolicyStats)
+{
+    GMM_CACHE_POLICY_STATS *pStats = new GMM_CACHE_POLICY_STATS;
+    const uint32_t          NumQueries = 5;
+
+    const GMM_CACHE_POLICY_LOOKUP *pLookup = pGmmULTClientContext->GetCachePolicyLookup();
+    ASSERT_TRUE(pLookup);
+
+    pGmmULTClientContext->EnableCachePolicyStats(1);
+
+    MEMORY_OBJECT_CONTROL_STATE MOCS = GmmCachePolicyLookupMemoryObject(pLookup, GMM_CACHE_POLICY_LOOKUP_NO_RESOURCE, GMM_RESOURCE_USAGE_RENDER_TARGET);
+    for(uint32_t i = 0; i < NumQueries; i++)
+    {
+        EXPECT_EQ(MOCS.DwordValue, pGmmULTClientContext->CachePolicyGetMemoryObject(NULL, GMM_RESOURCE_USAGE_RENDER_TARGET).DwordValue);
+    }
+    EXPECT_EQ(GmmCachePolicyLookupPteType(pLookup, GMM_RESOURCE_USAGE_STAGING).DwordValue,
+              pGmmULTClientContext->CachePolicyGetPteType(GMM_RESOURCE_USAGE_STAGING).DwordValue);
+    uint8_t Cached = pGmmULTClientContext->CachePolicyIsUsagePTECached(GMM_RESOURCE_USAGE_STAGING);
+
+    EXPECT_EQ(GMM_SUCCESS, pGmmULTClientContext->GetCachePolicyStats(pStats));
+    EXPECT_EQ(NumQueries, pStats->Usage[GMM_RESOURCE_USAGE_RENDER_TARGET].MocsQueries);
+    EXPECT_EQ(NumQueries, pStats->Usage[GMM_RESOURCE_USAGE_RENDER_TARGET].OverrideQueries);
+    EXPECT_EQ(0u, pStats->Usage[GMM_RESOURCE_USAGE_RENDER_TARGET].PteQueries);
+    EXPECT_EQ(NumQueries, pStats->MocsIndexQueries[MOCS.Gen9.Index]);
+    EXPECT_EQ(2u, pStats->Usage[GMM_RESOURCE_USAGE_STAGING].PteQueries);
+    EXPECT_EQ(Cached ? 2u : 0u, pStats->Usage[GMM_RESOURCE_USAGE_STAGING].PteCachedQueries);
+    EXPECT_EQ(0u, pStats->Usage[GMM_RESOURCE_USAGE_STAGING].MocsQueries);
+
+    pGmmULTClientContext->DumpCachePolicyStats();
+    pGmmULTClientContext->EnableCachePolicyStats(0);
+
+    pGmmULTClientContext->CachePolicyGetMemoryObject(NULL, GMM_RESOURCE_USAGE_RENDER_TARGET);
+    pGmmULTClientContext->GetCachePolicyStats(pStats);
+    EXPECT_EQ(NumQueries, pStats->Usage[GMM_RESOURCE_USAGE_RENDER_TARGET].MocsQueries);
+
+    delete pStats;
+}
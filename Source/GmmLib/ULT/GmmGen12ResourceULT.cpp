@@ -21,6 +21,14 @@ OTHER DEALINGS IN THE SOFTWARE.
 ============================================================================*/
 
 #include "GmmGen12ResourceULT.h"
+#include "Internal/Common/GmmLayoutCache.h"
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
@@ -2758,3 +2766,757 @@ TEST_F(CTestGen12Resource, TestColorMSAA)
 
     //Mip-mapped, MSAA case:
 }
+
+/// @brief ULT for size-only estimation matching full resource creation
+TEST_F(CTestGen12Resource, TestEstimateResourceSize)
+{
+    const TEST_TILE_TYPE TileTypes[] = {TEST_LINEAR, TEST_TILEX, TEST_TILEY, TEST_TILEYS};
+
+    GMM_RESCREATE_PARAMS gmmParams = {};
+    gmmParams.Type                 = RESOURCE_2D;
+    gmmParams.NoGfxMemory          = 1;
+    gmmParams.Flags.Gpu.Texture    = 1;
+    gmmParams.BaseWidth64          = 0x3E9;
+    gmmParams.BaseHeight           = 0x1F5;
+    gmmParams.MaxLod               = 9;
+    gmmParams.ArraySize            = 3;
+
+    for(uint32_t t = 0; t < sizeof(TileTypes) / sizeof(TileTypes[0]); t++)
+    {
+        for(uint32_t i = 0; i < TEST_BPP_MAX; i++)
+        {
+            for(uint32_t Compressed = 0; Compressed <= 1; Compressed++)
+            {
+                if(Compressed && TileTypes[t] != TEST_TILEY && TileTypes[t] != TEST_TILEYS)
+                {
+                    continue;
+                }
+
+                gmmParams.Flags.Info                  = {};
+                gmmParams.Flags.Gpu.UnifiedAuxSurface = Compressed;
+                gmmParams.Flags.Gpu.CCS               = Compressed;
+                gmmParams.Flags.Info.RenderCompressed = Compressed;
+                gmmParams.Format                      = SetResourceFormat(static_cast<TEST_BPP>(i));
+                SetTileFlag(gmmParams, TileTypes[t]);
+
+                GMM_RESCREATE_PARAMS   EstimateParams = gmmParams;
+                GMM_RESOURCE_SIZE_INFO SizeInfo       = {};
+                EXPECT_EQ(GMM_SUCCESS, pGmmULTClientContext->EstimateResourceSize(&EstimateParams, &SizeInfo));
+                EXPECT_EQ(0, memcmp(&EstimateParams, &gmmParams, sizeof(gmmParams))); // Caller's params untouched
+
+                GMM_RESOURCE_INFO *ResourceInfo = pGmmULTClientContext->CreateResInfoObject(&gmmParams);
+                ASSERT_TRUE(ResourceInfo);
+
+                EXPECT_EQ(ResourceInfo->GetSizeAllocation(), SizeInfo.SizeAllocation);
+                EXPECT_EQ(ResourceInfo->GetSizeMainSurface(), SizeInfo.SizeMainSurface);
+                EXPECT_EQ(ResourceInfo->GetSizeAuxSurface(GMM_AUX_SURF), SizeInfo.SizeAuxSurface);
+                EXPECT_EQ(ResourceInfo->GetBaseAlignment(), SizeInfo.BaseAlignment);
+
+                pGmmULTClientContext->DestroyResInfoObject(ResourceInfo);
+            }
+        }
+    }
+
+    // Internal size-only flag set by a client is ignored: the resource gets its mip offsets
+    gmmParams.Flags.Info                  = {};
+    gmmParams.Flags.Gpu.UnifiedAuxSurface = 0;
+    gmmParams.Flags.Gpu.CCS               = 0;
+    gmmParams.Format                      = SetResourceFormat(TEST_BPP_32);
+    SetTileFlag(gmmParams, TEST_TILEY);
+
+    GMM_RESCREATE_PARAMS Params = gmmParams;
+    GMM_RESOURCE_INFO *  Ref    = pGmmULTClientContext->CreateResInfoObject(&Params);
+    ASSERT_TRUE(Ref);
+
+    Params                          = gmmParams;
+    Params.Flags.Info.__SizeOnly    = 1;
+    GMM_RESOURCE_INFO *ResourceInfo = pGmmULTClientContext->CreateResInfoObject(&Params);
+    ASSERT_TRUE(ResourceInfo);
+    EXPECT_EQ(0u, ResourceInfo->GetResFlags().Info.__SizeOnly);
+
+    for(uint32_t Mip = 0; Mip <= gmmParams.MaxLod; Mip++)
+    {
+        GMM_REQ_OFFSET_INFO RefInfo = {}, ReqInfo = {};
+        RefInfo.ReqRender = ReqInfo.ReqRender = 1;
+        RefInfo.MipLevel = ReqInfo.MipLevel = Mip;
+        Ref->GetOffset(RefInfo);
+        ResourceInfo->GetOffset(ReqInfo);
+        EXPECT_EQ(RefInfo.Render.Offset64, ReqInfo.Render.Offset64) << "Mip " << Mip;
+    }
+
+    pGmmULTClientContext->DestroyResInfoObject(ResourceInfo);
+    pGmmULTClientContext->DestroyResInfoObject(Ref);
+}
+
+/// @brief Checks that a padding breakdown adds up to the resource's allocation.
+static void VerifyPaddingInfo(GMM_RESOURCE_INFO *ResourceInfo, GMM_RESOURCE_PADDING_INFO &PaddingInfo)
+{
+    ResourceInfo->GetPaddingInfo(PaddingInfo);
+
+    EXPECT_EQ(ResourceInfo->GetSizeAllocation(), PaddingInfo.AllocationSize);
+    EXPECT_EQ(ResourceInfo->GetSizeAuxSurface(GMM_AUX_SURF), PaddingInfo.Aux);
+    EXPECT_GT(PaddingInfo.LogicalSize, 0u);
+    EXPECT_EQ(PaddingInfo.AllocationSize, PaddingInfo.LogicalSize + PaddingInfo.TileAlignment + PaddingInfo.MipTail +
+                                          PaddingInfo.Page64KB + PaddingInfo.Aux + PaddingInfo.PlaneAlignment);
+}
+
+/// @brief ULT for per-resource padding breakdown and per-context padding stats
+TEST_F(CTestGen12Resource, TestResourcePaddingInfo)
+{
+    const TEST_TILE_TYPE       TileTypes[] = {TEST_LINEAR, TEST_TILEX, TEST_TILEY, TEST_TILEYS};
+    GMM_RESOURCE_PADDING_INFO  PaddingInfo = {};
+    GMM_RESOURCE_PADDING_INFO  Expected    = {};
+    GMM_RESOURCE_PADDING_STATS Stats       = {};
+    uint64_t                   Count       = 0;
+    GMM_RESOURCE_INFO *        ResourceInfo;
+
+    pGmmULTClientContext->EnablePaddingStats(1);
+
+    GMM_RESCREATE_PARAMS gmmParams = {};
+    gmmParams.Type                 = RESOURCE_2D;
+    gmmParams.NoGfxMemory          = 1;
+    gmmParams.Flags.Gpu.Texture    = 1;
+    gmmParams.BaseWidth64          = 0x3E9;
+    gmmParams.BaseHeight           = 0x1F5;
+    gmmParams.MaxLod               = 9;
+    gmmParams.ArraySize            = 3;
+
+    for(uint32_t t = 0; t < sizeof(TileTypes) / sizeof(TileTypes[0]); t++)
+    {
+        for(uint32_t i = 0; i < TEST_BPP_MAX; i++)
+        {
+            for(uint32_t Compressed = 0; Compressed <= 1; Compressed++)
+            {
+                if(Compressed && TileTypes[t] != TEST_TILEY && TileTypes[t] != TEST_TILEYS)
+                {
+                    continue;
+                }
+
+                gmmParams.Flags.Info                  = {};
+                gmmParams.Flags.Gpu.UnifiedAuxSurface = Compressed;
+                gmmParams.Flags.Gpu.CCS               = Compressed;
+                gmmParams.Flags.Info.RenderCompressed = Compressed;
+                gmmParams.Format                      = SetResourceFormat(static_cast<TEST_BPP>(i));
+                SetTileFlag(gmmParams, TileTypes[t]);
+
+                ResourceInfo = pGmmULTClientContext->CreateResInfoObject(&gmmParams);
+                ASSERT_TRUE(ResourceInfo);
+
+                VerifyPaddingInfo(ResourceInfo, PaddingInfo);
+                EXPECT_EQ(Compressed != 0, PaddingInfo.Aux != 0);
+                EXPECT_EQ(0u, PaddingInfo.PlaneAlignment);
+
+                Expected.LogicalSize += PaddingInfo.LogicalSize;
+                Expected.AllocationSize += PaddingInfo.AllocationSize;
+                Expected.Aux += PaddingInfo.Aux;
+                Count++;
+
+                pGmmULTClientContext->DestroyResInfoObject(ResourceInfo);
+            }
+        }
+    }
+
+    EXPECT_EQ(GMM_SUCCESS, pGmmULTClientContext->GetPaddingStats(&Stats));
+    EXPECT_EQ(Count, Stats.NumResources);
+    EXPECT_EQ(Expected.LogicalSize, Stats.Total.LogicalSize);
+    EXPECT_EQ(Expected.AllocationSize, Stats.Total.AllocationSize);
+    EXPECT_EQ(Expected.Aux, Stats.Total.Aux);
+    EXPECT_EQ(Stats.Total.AllocationSize, Stats.Total.LogicalSize + Stats.Total.TileAlignment + Stats.Total.MipTail +
+                                          Stats.Total.Page64KB + Stats.Total.Aux + Stats.Total.PlaneAlignment);
+    pGmmULTClientContext->DumpPaddingStats();
+
+    // Single linear texel: exactly one element of logical data
+    gmmParams                   = {};
+    gmmParams.Type              = RESOURCE_2D;
+    gmmParams.NoGfxMemory       = 1;
+    gmmParams.Flags.Gpu.Texture = 1;
+    gmmParams.Format            = SetResourceFormat(TEST_BPP_32);
+    gmmParams.BaseWidth64       = 0x1;
+    gmmParams.BaseHeight        = 0x1;
+    SetTileFlag(gmmParams, TEST_LINEAR);
+
+    ResourceInfo = pGmmULTClientContext->CreateResInfoObject(&gmmParams);
+    ASSERT_TRUE(ResourceInfo);
+    VerifyPaddingInfo(ResourceInfo, PaddingInfo);
+    EXPECT_EQ(4u, PaddingInfo.LogicalSize);
+    EXPECT_EQ(0u, PaddingInfo.MipTail);
+    pGmmULTClientContext->DestroyResInfoObject(ResourceInfo);
+
+    // 64KB-tiled mip chain small enough to fall into the packed mip tail
+    gmmParams.BaseWidth64 = 0x40;
+    gmmParams.BaseHeight  = 0x40;
+    gmmParams.MaxLod      = 6;
+    SetTileFlag(gmmParams, TEST_TILEYS);
+
+    ResourceInfo = pGmmULTClientContext->CreateResInfoObject(&gmmParams);
+    ASSERT_TRUE(ResourceInfo);
+    VerifyPaddingInfo(ResourceInfo, PaddingInfo);
+    EXPECT_GT(PaddingInfo.MipTail, 0u);
+    EXPECT_EQ(GMM_KBYTE(64), PaddingInfo.AllocationSize);
+    pGmmULTClientContext->DestroyResInfoObject(ResourceInfo);
+
+    // NV12 with a Y height off the tile grid: UV plane starts on the next tile row
+    gmmParams                   = {};
+    gmmParams.Type              = RESOURCE_2D;
+    gmmParams.NoGfxMemory       = 1;
+    gmmParams.Flags.Gpu.Texture = 1;
+    gmmParams.Flags.Info.TiledY = 1;
+    gmmParams.Format            = GMM_FORMAT_NV12;
+    gmmParams.BaseWidth64       = 0x100;
+    gmmParams.BaseHeight        = 0x102;
+
+    ResourceInfo = pGmmULTClientContext->CreateResInfoObject(&gmmParams);
+    ASSERT_TRUE(ResourceInfo);
+    VerifyPaddingInfo(ResourceInfo, PaddingInfo);
+    EXPECT_EQ(0x100u * (0x102 + 0x81), PaddingInfo.LogicalSize);
+    EXPECT_EQ((ResourceInfo->GetPlanarYOffset(GMM_PLANE_U) - 0x102) * ResourceInfo->GetRenderPitch(),
+              PaddingInfo.PlaneAlignment);
+    EXPECT_GT(PaddingInfo.PlaneAlignment, 0u);
+    pGmmULTClientContext->DestroyResInfoObject(ResourceInfo);
+
+    // Disabled accounting leaves the totals alone
+    pGmmULTClientContext->GetPaddingStats(&Stats);
+    EXPECT_EQ(Count + 3, Stats.NumResources);
+    pGmmULTClientContext->EnablePaddingStats(0);
+
+    ResourceInfo = pGmmULTClientContext->CreateResInfoObject(&gmmParams);
+    ASSERT_TRUE(ResourceInfo);
+    pGmmULTClientContext->DestroyResInfoObject(ResourceInfo);
+
+    GMM_RESOURCE_PADDING_STATS StatsAfter = {};
+    pGmmULTClientContext->GetPaddingStats(&StatsAfter);
+    EXPECT_EQ(0, memcmp(&Stats, &StatsAfter, sizeof(Stats)));
+}
+
+/// @brief Checks a tile-select result and creates the resource with the chosen tiling.
+static void VerifyTileSelection(GMM_CLIENT_CONTEXT *pClientContext, GMM_RESCREATE_PARAMS &Params, GMM_TILE_SELECT_RESULT &Result)
+{
+    ASSERT_GT(Result.NumCandidates, 0u);
+    ASSERT_LT(Result.Selected, Result.NumCandidates);
+
+    const GMM_TILE_SELECT_SCORE &Selected = Result.Candidates[Result.Selected];
+    EXPECT_TRUE(Selected.Valid);
+    for(uint32_t i = 0; i < Result.NumCandidates; i++)
+    {
+        if(Result.Candidates[i].Valid)
+        {
+            EXPECT_LE(Selected.Score, Result.Candidates[i].Score);
+        }
+    }
+
+    GMM_RESOURCE_INFO *ResourceInfo = pClientContext->CreateResInfoObject(&Params);
+    ASSERT_TRUE(ResourceInfo);
+    EXPECT_EQ(Selected.AllocationSize, ResourceInfo->GetSizeAllocation());
+    pClientContext->DestroyResInfoObject(ResourceInfo);
+}
+
+/// @brief ULT for the cost-model based "auto" tile-mode selector
+TEST_F(CTestGen12Resource, TestSelectTileMode)
+{
+    GMM_TILE_SELECT_RESULT Result    = {};
+    GMM_TILE_COST_MODEL    CostModel = {};
+
+    GMM_RESCREATE_PARAMS gmmParams    = {};
+    gmmParams.Type                    = RESOURCE_2D;
+    gmmParams.NoGfxMemory             = 1;
+    gmmParams.Flags.Gpu.Texture       = 1;
+    gmmParams.Flags.Gpu.RenderTarget  = 1;
+    gmmParams.Format                  = SetResourceFormat(TEST_BPP_32);
+    gmmParams.BaseWidth64             = 0x1000;
+    gmmParams.BaseHeight              = 0x1000;
+
+    // Large render target/texture: every tiling is a candidate, a Y-family tiling wins
+    GMM_RESCREATE_PARAMS Params = gmmParams;
+    ASSERT_EQ(GMM_SUCCESS, pGmmULTClientContext->SelectTileMode(&Params, NULL, &Result));
+    EXPECT_GE(Result.NumCandidates, (uint32_t)GMM_TILE_SELECT_TILINGS);
+    EXPECT_GE(Result.Candidates[Result.Selected].Tiling, GMM_TILE_SELECT_TILE_4KB);
+    EXPECT_EQ(1u, Params.Flags.Info.TiledY);
+    EXPECT_EQ(0u, Params.Flags.Info.Linear + Params.Flags.Info.TiledX);
+    VerifyTileSelection(pGmmULTClientContext, Params, Result);
+
+    // Tiny texture: 64KB tiles would be mostly padding
+    Params             = gmmParams;
+    Params.BaseWidth64 = 0x10;
+    Params.BaseHeight  = 0x10;
+    ASSERT_EQ(GMM_SUCCESS, pGmmULTClientContext->SelectTileMode(&Params, NULL, &Result));
+    EXPECT_NE(GMM_TILE_SELECT_TILE_64KB, Result.Candidates[Result.Selected].Tiling);
+    EXPECT_EQ(0u, Params.Flags.Info.TiledYs);
+    VerifyTileSelection(pGmmULTClientContext, Params, Result);
+
+    // Displayable surface: only display-capable tilings are considered
+    Params                     = gmmParams;
+    Params.Flags.Gpu.FlipChain = 1;
+    ASSERT_EQ(GMM_SUCCESS, pGmmULTClientContext->SelectTileMode(&Params, NULL, &Result));
+    for(uint32_t i = 0; i < Result.NumCandidates; i++)
+    {
+        EXPECT_NE(GMM_TILE_SELECT_TILEYF, Result.Candidates[i].Tiling);
+        EXPECT_NE(GMM_TILE_SELECT_TILE_64KB, Result.Candidates[i].Tiling);
+    }
+    VerifyTileSelection(pGmmULTClientContext, Params, Result);
+
+    // Compressed request keeps its aux on a tiling that can carry it
+    Params                             = gmmParams;
+    Params.Flags.Gpu.UnifiedAuxSurface = 1;
+    Params.Flags.Gpu.CCS               = 1;
+    Params.Flags.Info.RenderCompressed = 1;
+    ASSERT_EQ(GMM_SUCCESS, pGmmULTClientContext->SelectTileMode(&Params, NULL, &Result));
+    EXPECT_TRUE(Result.Candidates[Result.Selected].AuxEligible);
+    EXPECT_EQ(1u, Params.Flags.Info.RenderCompressed);
+    EXPECT_EQ(1u, Params.Flags.Gpu.UnifiedAuxSurface);
+    VerifyTileSelection(pGmmULTClientContext, Params, Result);
+
+    // CPU-only cost model picks Linear
+    Params = gmmParams;
+    pGmmULTClientContext->GetDefaultTileCostModel(&Params, &CostModel);
+    memset(CostModel.AccessWeight, 0, sizeof(CostModel.AccessWeight));
+    CostModel.AccessWeight[GMM_TILE_ACCESS_CPU] = 1;
+    ASSERT_EQ(GMM_SUCCESS, pGmmULTClientContext->SelectTileMode(&Params, &CostModel, &Result));
+    EXPECT_EQ(GMM_TILE_SELECT_LINEAR, Result.Candidates[Result.Selected].Tiling);
+    EXPECT_EQ(1u, Params.Flags.Info.Linear);
+    VerifyTileSelection(pGmmULTClientContext, Params, Result);
+
+    // Caller's size limit: candidates over it are invalid and never selected
+    Params             = gmmParams;
+    Params.BaseWidth64 = 0x3E9;
+    Params.BaseHeight  = 0x1F5;
+    GMM_RESCREATE_PARAMS Odd = Params;
+    ASSERT_EQ(GMM_SUCCESS, pGmmULTClientContext->SelectTileMode(&Params, NULL, &Result));
+    GMM_GFX_SIZE_T MinSize = Result.Candidates[Result.Selected].AllocationSize, MaxSize = 0;
+    for(uint32_t i = 0; i < Result.NumCandidates; i++)
+    {
+        MinSize = GFX_MIN(MinSize, Result.Candidates[i].AllocationSize);
+        MaxSize = GFX_MAX(MaxSize, Result.Candidates[i].AllocationSize);
+    }
+    ASSERT_LT(MinSize, MaxSize);
+
+    Params = Odd;
+    pGmmULTClientContext->GetDefaultTileCostModel(&Params, &CostModel);
+    CostModel.MaxAllocationSize = MinSize;
+    ASSERT_EQ(GMM_SUCCESS, pGmmULTClientContext->SelectTileMode(&Params, &CostModel, &Result));
+    for(uint32_t i = 0; i < Result.NumCandidates; i++)
+    {
+        EXPECT_EQ(Result.Candidates[i].AllocationSize <= MinSize, (bool)Result.Candidates[i].Valid) << "Candidate " << i;
+    }
+    EXPECT_EQ(MinSize, Result.Candidates[Result.Selected].AllocationSize);
+    VerifyTileSelection(pGmmULTClientContext, Params, Result);
+
+    // Caller's pitch limit below every layout: nothing is selected, request untouched
+    Params                      = Odd;
+    CostModel.MaxAllocationSize = 0;
+    CostModel.MaxPitch          = 0x3E9;
+    EXPECT_EQ(GMM_ERROR, pGmmULTClientContext->SelectTileMode(&Params, &CostModel, &Result));
+    EXPECT_EQ(0, memcmp(&Odd, &Params, sizeof(Params)));
+    for(uint32_t i = 0; i < Result.NumCandidates; i++)
+    {
+        EXPECT_FALSE(Result.Candidates[i].Valid) << "Candidate " << i;
+    }
+
+    // Fixed-tiling resources are rejected untouched
+    Params                   = gmmParams;
+    Params.Flags.Gpu.Depth   = 1;
+    Params.Flags.Info.TiledY = 1;
+    GMM_RESCREATE_PARAMS Rejected = Params;
+    EXPECT_EQ(GMM_INVALIDPARAM, pGmmULTClientContext->SelectTileMode(&Params, NULL, NULL));
+    EXPECT_EQ(0, memcmp(&Rejected, &Params, sizeof(Params)));
+}
+
+/// @brief Returns the main surface payload of a layout blob.
+static GMM_RESOURCE_LAYOUT_SURFACE *LayoutBlobMainSurface(std::vector<uint8_t> &Blob)
+{
+    GMM_RESOURCE_LAYOUT_HEADER *pHdr   = reinterpret_cast<GMM_RESOURCE_LAYOUT_HEADER *>(Blob.data());
+    uint32_t                    Offset = sizeof(*pHdr);
+
+    for(uint32_t i = 0; i < pHdr->NumSections; i++)
+    {
+        GMM_RESOURCE_LAYOUT_SECTION *pSect = reinterpret_cast<GMM_RESOURCE_LAYOUT_SECTION *>(Blob.data() + Offset);
+        if(pSect->Id == GMM_LAYOUT_SECTION_MAIN_SURF)
+        {
+            return reinterpret_cast<GMM_RESOURCE_LAYOUT_SURFACE *>(pSect + 1);
+        }
+        Offset += sizeof(*pSect) + ((pSect->Size + 7) & ~7u);
+    }
+
+    return NULL;
+}
+
+/// @brief Recomputes a layout blob's checksum after the test edited it, the same
+/// way GmmResourceLayout.cpp does (__GmmHash64 isn't exported by the library).
+static void LayoutBlobUpdateChecksum(std::vector<uint8_t> &Blob)
+{
+    GMM_RESOURCE_LAYOUT_HEADER *pHdr  = reinterpret_cast<GMM_RESOURCE_LAYOUT_HEADER *>(Blob.data());
+    const uint8_t *             pByte = Blob.data() + sizeof(*pHdr);
+    size_t                      Size  = pHdr->Size - sizeof(*pHdr);
+    uint64_t                    Hash  = GMM_RESOURCE_LAYOUT_VERSION ^ 0xcbf29ce484222325ull;
+
+    for(; Size >= sizeof(uint64_t); Size -= sizeof(uint64_t), pByte += sizeof(uint64_t))
+    {
+        uint64_t Qword;
+        memcpy(&Qword, pByte, sizeof(Qword));
+        Hash = (Hash ^ Qword) * 0x100000001b3ull;
+        Hash ^= Hash >> 29;
+    }
+    for(; Size; Size--, pByte++)
+    {
+        Hash = (Hash ^ *pByte) * 0x100000001b3ull;
+    }
+
+    pHdr->Checksum = (uint32_t)(Hash ^ (Hash >> 32));
+}
+
+/// @brief ULT for layout export/import round trip and blob validation
+TEST_F(CTestGen12Resource, TestResourceLayoutSerialization)
+{
+    GMM_RESCREATE_PARAMS Params[3] = {};
+
+    // Compressed mipped array with unified CCS
+    Params[0].Type                        = RESOURCE_2D;
+    Params[0].NoGfxMemory                 = 1;
+    Params[0].Flags.Gpu.Texture           = 1;
+    Params[0].Flags.Gpu.UnifiedAuxSurface = 1;
+    Params[0].Flags.Gpu.CCS               = 1;
+    Params[0].Flags.Info.RenderCompressed = 1;
+    Params[0].Format                      = SetResourceFormat(TEST_BPP_32);
+    Params[0].BaseWidth64                 = 0x3E9;
+    Params[0].BaseHeight                  = 0x1F5;
+    Params[0].MaxLod                      = 9;
+    Params[0].ArraySize                   = 3;
+    SetTileFlag(Params[0], TEST_TILEY);
+
+    // Planar
+    Params[1].Type              = RESOURCE_2D;
+    Params[1].NoGfxMemory       = 1;
+    Params[1].Flags.Gpu.Texture = 1;
+    Params[1].Format            = GMM_FORMAT_NV12;
+    Params[1].BaseWidth64       = 1920;
+    Params[1].BaseHeight        = 1080;
+    SetTileFlag(Params[1], TEST_TILEY);
+
+    // 3D mip chain
+    Params[2].Type              = RESOURCE_3D;
+    Params[2].NoGfxMemory       = 1;
+    Params[2].Flags.Gpu.Texture = 1;
+    Params[2].Format            = SetResourceFormat(TEST_BPP_64);
+    Params[2].BaseWidth64       = 0x80;
+    Params[2].BaseHeight        = 0x40;
+    Params[2].Depth             = 0x20;
+    Params[2].MaxLod            = 5;
+    SetTileFlag(Params[2], TEST_TILEY);
+
+    for(uint32_t p = 0; p < sizeof(Params) / sizeof(Params[0]); p++)
+    {
+        GMM_RESOURCE_INFO *ResourceInfo = pGmmULTClientContext->CreateResInfoObject(&Params[p]);
+        ASSERT_TRUE(ResourceInfo);
+
+        uint32_t BlobSize = pGmmULTClientContext->SerializeResInfoObject(ResourceInfo, NULL, 0);
+        ASSERT_GT(BlobSize, sizeof(GMM_RESOURCE_LAYOUT_HEADER));
+
+        std::vector<uint8_t> Blob(BlobSize);
+        EXPECT_EQ(BlobSize, pGmmULTClientContext->SerializeResInfoObject(ResourceInfo, Blob.data(), BlobSize));
+
+        GMM_RESOURCE_INFO *Imported = pGmmULTClientContext->ImportResInfoObject(Blob.data(), BlobSize, NULL);
+        ASSERT_TRUE(Imported);
+
+        EXPECT_EQ(ResourceInfo->GetSizeAllocation(), Imported->GetSizeAllocation());
+        EXPECT_EQ(ResourceInfo->GetSizeMainSurface(), Imported->GetSizeMainSurface());
+        EXPECT_EQ(ResourceInfo->GetRenderPitch(), Imported->GetRenderPitch());
+        EXPECT_EQ(ResourceInfo->GetQPitch(), Imported->GetQPitch());
+        EXPECT_EQ(ResourceInfo->GetMOCS().DwordValue, Imported->GetMOCS().DwordValue);
+        EXPECT_EQ(ResourceInfo->GetSizeAuxSurface(GMM_AUX_CCS), Imported->GetSizeAuxSurface(GMM_AUX_CCS));
+        EXPECT_EQ(ResourceInfo->GetUnifiedAuxSurfaceOffset(GMM_AUX_CCS), Imported->GetUnifiedAuxSurfaceOffset(GMM_AUX_CCS));
+        EXPECT_EQ(ResourceInfo->GetPlanarYOffset(GMM_PLANE_U), Imported->GetPlanarYOffset(GMM_PLANE_U));
+        EXPECT_EQ(0, memcmp(&ResourceInfo->GetResFlags(), &Imported->GetResFlags(), sizeof(GMM_RESOURCE_FLAG)));
+
+        // Flags are stored at fixed bit positions: Gpu.Texture is bit 34, Info.TiledY bit 36
+        EXPECT_EQ(1u << 2, LayoutBlobMainSurface(Blob)->FlagsGpu[1] & (1u << 2));
+        EXPECT_EQ(1u << 4, LayoutBlobMainSurface(Blob)->FlagsInfo[1] & (1u << 4));
+
+        for(uint32_t Mip = 0; Mip <= Params[p].MaxLod; Mip++)
+        {
+            GMM_REQ_OFFSET_INFO Expected = {}, Actual = {};
+            Expected.ReqRender = Actual.ReqRender = 1;
+            Expected.MipLevel = Actual.MipLevel = Mip;
+            ResourceInfo->GetOffset(Expected);
+            Imported->GetOffset(Actual);
+            EXPECT_EQ(Expected.Render.Offset64, Actual.Render.Offset64);
+            EXPECT_EQ(Expected.Render.XOffset, Actual.Render.XOffset);
+            EXPECT_EQ(Expected.Render.YOffset, Actual.Render.YOffset);
+        }
+
+        // Re-exporting the import must give the same blob
+        std::vector<uint8_t> Blob2(BlobSize);
+        EXPECT_EQ(BlobSize, pGmmULTClientContext->SerializeResInfoObject(Imported, Blob2.data(), BlobSize));
+        EXPECT_EQ(0, memcmp(Blob.data(), Blob2.data(), BlobSize));
+
+        // Import into caller provided memory
+        std::vector<uint8_t> Storage(sizeof(GMM_RESOURCE_INFO));
+        GMM_RESOURCE_INFO *  Placed = pGmmULTClientContext->ImportResInfoObject(Blob.data(), BlobSize, Storage.data());
+        ASSERT_TRUE(Placed);
+        EXPECT_EQ(ResourceInfo->GetSizeAllocation(), Placed->GetSizeAllocation());
+        pGmmULTClientContext->DestroyResInfoObject(Placed);
+
+        // Too small a destination writes nothing but reports the size
+        EXPECT_EQ(BlobSize, pGmmULTClientContext->SerializeResInfoObject(ResourceInfo, Blob2.data(), BlobSize - 1));
+
+        pGmmULTClientContext->DestroyResInfoObject(Imported);
+        pGmmULTClientContext->DestroyResInfoObject(ResourceInfo);
+
+        // Rejected blobs: truncated, corrupted payload, wrong version, wrong platform
+        EXPECT_EQ(NULL, pGmmULTClientContext->ImportResInfoObject(Blob.data(), BlobSize - 8, NULL));
+
+        std::vector<uint8_t> Bad = Blob;
+        Bad[BlobSize / 2] ^= 0x1;
+        EXPECT_EQ(NULL, pGmmULTClientContext->ImportResInfoObject(Bad.data(), BlobSize, NULL));
+
+        Bad = Blob;
+        reinterpret_cast<GMM_RESOURCE_LAYOUT_HEADER *>(Bad.data())->Version++;
+        EXPECT_EQ(NULL, pGmmULTClientContext->ImportResInfoObject(Bad.data(), BlobSize, NULL));
+
+        Bad = Blob;
+        reinterpret_cast<GMM_RESOURCE_LAYOUT_HEADER *>(Bad.data())->ProductFamily = IGFX_SKYLAKE;
+        EXPECT_EQ(NULL, pGmmULTClientContext->ImportResInfoObject(Bad.data(), BlobSize, NULL));
+
+        // Well-formed blobs with out of range surface fields
+        for(uint32_t Case = 0; Case < 5; Case++)
+        {
+            Bad = Blob;
+
+            GMM_RESOURCE_LAYOUT_SURFACE *pSurf = LayoutBlobMainSurface(Bad);
+            ASSERT_TRUE(pSurf);
+            switch(Case)
+            {
+                case 0: pSurf->MaxLod = GMM_MAX_MIPMAP; break;
+                case 1: pSurf->ArraySize = 0x10000; break;
+                case 2: pSurf->Size = ~0ull; break;
+                case 3: // Last mip of the 2D/3D view, last aligned plane height of the planar one
+                    pSurf->MaxLod = (Params[p].Format == GMM_FORMAT_NV12) ? 0 : GMM_MAX_MIPMAP - 1;
+                    pSurf->OffsetInfo[(Params[p].Type == RESOURCE_3D) ? GMM_MAX_MIPMAP : GMM_MAX_MIPMAP + 1] = pSurf->Size + 1;
+                    break;
+                default: pSurf->OffsetInfo[2] = pSurf->Size + 1; break; // Mip 0 / plane X
+            }
+            LayoutBlobUpdateChecksum(Bad);
+
+            EXPECT_EQ(NULL, pGmmULTClientContext->ImportResInfoObject(Bad.data(), BlobSize, NULL)) << "Case " << Case;
+        }
+    }
+}
+
+#ifdef GMM_LAYOUT_CACHE_SUPPORTED
+/////////////////////////////////////////////////////////////////////////////////////
+/// Layout cache helpers: a scratch cache directory, and a run that creates
+/// resources on a context of its own so the cache is opened and flushed.
+/////////////////////////////////////////////////////////////////////////////////////
+class CLayoutCacheDir
+{
+public:
+    std::string Dir;
+
+    CLayoutCacheDir()
+    {
+        char Template[] = "/tmp/gmmult_layout_XXXXXX";
+        if(mkdtemp(Template))
+        {
+            Dir = Template;
+            setenv(GMM_LAYOUT_CACHE_DIR_ENV, Dir.c_str(), 1);
+        }
+    }
+
+    ~CLayoutCacheDir()
+    {
+        unsetenv(GMM_LAYOUT_CACHE_DIR_ENV);
+        Clear();
+        rmdir(Dir.c_str());
+    }
+
+    // Returns the path of the one cache file, empty if there's none.
+    std::string File()
+    {
+        std::string Path;
+        DIR *       pDir = opendir(Dir.c_str());
+        if(pDir)
+        {
+            for(struct dirent *pEntry = readdir(pDir); pEntry; pEntry = readdir(pDir))
+            {
+                if(strncmp(pEntry->d_name, "gmmlayout_", 10) == 0)
+                {
+                    Path = Dir + "/" + pEntry->d_name;
+                }
+            }
+            closedir(pDir);
+        }
+        return Path;
+    }
+
+    size_t FileSize()
+    {
+        struct stat St;
+        return stat(File().c_str(), &St) == 0 ? St.st_size : 0;
+    }
+
+    void Clear()
+    {
+        std::string Path;
+        while(!(Path = File()).empty() && unlink(Path.c_str()) == 0)
+        {
+        }
+    }
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Creates every resource in Params on a new context and appends what the layout
+/// looks like to Layout.
+/////////////////////////////////////////////////////////////////////////////////////
+static void RunLayoutCacheContext(PFNGMMINIT pfnInit, PFNGMMDESTROY pfnDestroy, ADAPTER_INFO *pAdapterInfo, PLATFORM Platform,
+                                  const std::vector<GMM_RESCREATE_PARAMS> &Params, std::vector<uint64_t> &Layout)
+{
+    GMM_INIT_IN_ARGS  InArgs  = {};
+    GMM_INIT_OUT_ARGS OutArgs = {};
+    InArgs.ClientType         = GMM_EXCITE_VISTA;
+    InArgs.pGtSysInfo         = &pAdapterInfo->SystemInfo;
+    InArgs.pSkuTable          = &pAdapterInfo->SkuTable;
+    InArgs.pWaTable           = &pAdapterInfo->WaTable;
+    InArgs.Platform           = Platform;
+    InArgs.FileDescriptor     = 0x300;
+    ASSERT_EQ(GMM_SUCCESS, pfnInit(&InArgs, &OutArgs));
+    GMM_CLIENT_CONTEXT *pClientContext = OutArgs.pGmmClientContext;
+    ASSERT_TRUE(pClientContext);
+
+    for(const GMM_RESCREATE_PARAMS &Src : Params)
+    {
+        GMM_RESCREATE_PARAMS Param        = Src;
+        GMM_RESOURCE_INFO *  ResourceInfo = pClientContext->CreateResInfoObject(&Param);
+        ASSERT_TRUE(ResourceInfo);
+
+        Layout.push_back(ResourceInfo->GetSizeAllocation());
+        Layout.push_back(ResourceInfo->GetSizeMainSurface());
+        Layout.push_back(ResourceInfo->GetRenderPitch());
+        Layout.push_back(ResourceInfo->GetQPitch());
+        Layout.push_back(ResourceInfo->GetBaseAlignment());
+        Layout.push_back(ResourceInfo->GetMOCS().DwordValue);
+        Layout.push_back(ResourceInfo->GetSizeAuxSurface(GMM_AUX_CCS));
+        Layout.push_back(ResourceInfo->GetPlanarYOffset(GMM_PLANE_U));
+        Layout.push_back(Param.Flags.Info.TiledY);
+        for(uint32_t Mip = 0; Mip <= Src.MaxLod; Mip++)
+        {
+            GMM_REQ_OFFSET_INFO ReqInfo = {};
+            ReqInfo.ReqRender           = 1;
+            ReqInfo.MipLevel            = Mip;
+            ResourceInfo->GetOffset(ReqInfo);
+            Layout.push_back(ReqInfo.Render.Offset64);
+            Layout.push_back(ReqInfo.Render.XOffset);
+            Layout.push_back(ReqInfo.Render.YOffset);
+        }
+        pClientContext->DestroyResInfoObject(ResourceInfo);
+    }
+
+    pfnDestroy(&OutArgs);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns a set of distinct create requests for the layout cache tests.
+/////////////////////////////////////////////////////////////////////////////////////
+static std::vector<GMM_RESCREATE_PARAMS> LayoutCacheParams(uint32_t Count)
+{
+    const GMM_RESOURCE_FORMAT Formats[] = {GMM_FORMAT_R8G8B8A8_UNORM, GMM_FORMAT_R16G16B16A16_FLOAT, GMM_FORMAT_R8_UNORM,
+                                           GMM_FORMAT_NV12};
+    std::vector<GMM_RESCREATE_PARAMS> Params(Count);
+
+    for(uint32_t i = 0; i < Count; i++)
+    {
+        GMM_RESCREATE_PARAMS &Param = Params[i];
+        Param.Type                  = (i % 5 == 1) ? RESOURCE_3D : (i % 5 == 2) ? RESOURCE_CUBE : RESOURCE_2D;
+        Param.NoGfxMemory           = 1;
+        Param.Flags.Gpu.Texture     = 1;
+        Param.Flags.Info.TiledY     = 1;
+        Param.Format                = Formats[i % 4];
+        Param.BaseWidth64           = 64 + (17 * i) % 1984;
+        Param.BaseHeight            = (Param.Type == RESOURCE_CUBE) ? (uint32_t)Param.BaseWidth64 : 32 + (11 * i) % 2016;
+        Param.Depth                 = (Param.Type == RESOURCE_3D) ? 8 : 1;
+        Param.ArraySize             = 1;
+        Param.MaxLod                = (Param.Format == GMM_FORMAT_NV12) ? 0 : i % 6;
+        if(Param.Format == GMM_FORMAT_NV12)
+        {
+            Param.Type = RESOURCE_2D;
+        }
+        if(i % 7 == 3 && Param.Type == RESOURCE_2D && Param.Format != GMM_FORMAT_NV12)
+        {
+            Param.Flags.Gpu.UnifiedAuxSurface = 1;
+            Param.Flags.Gpu.CCS               = 1;
+            Param.Flags.Info.RenderCompressed = 1;
+        }
+    }
+
+    return Params;
+}
+
+/// @brief ULT for the persistent layout cache: warm runs reuse the file and give
+/// the same layouts as cold runs, and damaged or stale files fall back to texture calc
+TEST_F(CTestGen12Resource, TestLayoutCache)
+{
+    std::vector<GMM_RESCREATE_PARAMS> Params = LayoutCacheParams(64);
+    std::vector<uint64_t>             Expected, Layout;
+    CLayoutCacheDir                   Cache;
+    ASSERT_FALSE(Cache.Dir.empty());
+
+    // Reference without caching
+    unsetenv(GMM_LAYOUT_CACHE_DIR_ENV);
+    RunLayoutCacheContext(pfnGmmInit, pfnGmmDestroy, pGfxAdapterInfo, GfxPlatform, Params, Expected);
+    EXPECT_TRUE(Cache.File().empty());
+    setenv(GMM_LAYOUT_CACHE_DIR_ENV, Cache.Dir.c_str(), 1);
+
+    // Cold run writes one record per resource
+    RunLayoutCacheContext(pfnGmmInit, pfnGmmDestroy, pGfxAdapterInfo, GfxPlatform, Params, Layout);
+    EXPECT_EQ(Expected, Layout);
+    size_t ColdSize = Cache.FileSize();
+    EXPECT_GT(ColdSize, sizeof(GMM_LAYOUT_CACHE_FILE_HEADER) + Params.size() * sizeof(GMM_LAYOUT_CACHE_RECORD));
+
+    // Warm run hits for everything, so nothing gets appended
+    Layout.clear();
+    RunLayoutCacheContext(pfnGmmInit, pfnGmmDestroy, pGfxAdapterInfo, GfxPlatform, Params, Layout);
+    EXPECT_EQ(Expected, Layout);
+    EXPECT_EQ(ColdSize, Cache.FileSize());
+
+    // Corrupt a record in the middle: records from there on are recomputed and rewritten
+    {
+        std::string Path = Cache.File();
+        FILE *      pFile = fopen(Path.c_str(), "r+b");
+        ASSERT_TRUE(pFile);
+        fseek(pFile, (long)(ColdSize / 2), SEEK_SET);
+        int Byte = fgetc(pFile);
+        fseek(pFile, (long)(ColdSize / 2), SEEK_SET);
+        fputc(Byte ^ 0x5A, pFile);
+        fclose(pFile);
+    }
+    Layout.clear();
+    RunLayoutCacheContext(pfnGmmInit, pfnGmmDestroy, pGfxAdapterInfo, GfxPlatform, Params, Layout);
+    EXPECT_EQ(Expected, Layout);
+    EXPECT_EQ(ColdSize, Cache.FileSize());
+
+    Layout.clear();
+    RunLayoutCacheContext(pfnGmmInit, pfnGmmDestroy, pGfxAdapterInfo, GfxPlatform, Params, Layout);
+    EXPECT_EQ(Expected, Layout);
+    EXPECT_EQ(ColdSize, Cache.FileSize());
+
+    // Truncated file and stale header
+    ASSERT_EQ(0, truncate(Cache.File().c_str(), ColdSize - 100));
+    Layout.clear();
+    RunLayoutCacheContext(pfnGmmInit, pfnGmmDestroy, pGfxAdapterInfo, GfxPlatform, Params, Layout);
+    EXPECT_EQ(Expected, Layout);
+    EXPECT_EQ(ColdSize, Cache.FileSize());
+
+    {
+        std::string Path  = Cache.File();
+        FILE *      pFile = fopen(Path.c_str(), "r+b");
+        ASSERT_TRUE(pFile);
+        GMM_LAYOUT_CACHE_FILE_HEADER Hdr;
+        ASSERT_EQ(1u, fread(&Hdr, sizeof(Hdr), 1, pFile));
+        Hdr.LayoutVersion++;
+        fseek(pFile, 0, SEEK_SET);
+        fwrite(&Hdr, sizeof(Hdr), 1, pFile);
+        fclose(pFile);
+    }
+    Layout.clear();
+    RunLayoutCacheContext(pfnGmmInit, pfnGmmDestroy, pGfxAdapterInfo, GfxPlatform, Params, Layout);
+    EXPECT_EQ(Expected, Layout);
+    EXPECT_EQ(ColdSize, Cache.FileSize());
+}
+#endif
@@ -246,6 +246,57 @@ void *Thread1(void *lpParam)
     pthread_exit(NULL);
 }
 
+// Attaches and detaches a client to an adapter MA_LOOKUP_ITERATIONS times and counts
+// the attaches that resolved to the right LibContext. If the adapter has a first client
+// registered, every attach must resolve to its LibContext; otherwise the threads of the
+// adapter keep registering and releasing it, and the LibContext only has to belong to
+// the adapter's platform.
+void *ThreadLookup(void *lpParam)
+{
+    ThreadInParams *  pInParams  = (ThreadInParams *)(lpParam);
+    uint32_t          AdapterIdx = pInParams->AdapterIdx;
+    GMM_INIT_IN_ARGS  InArgs     = MACommonULT::InArgs[AdapterIdx][0];
+    GMM_INIT_OUT_ARGS OutArgs    = {0};
+    GMM_STATUS        Status     = GMM_SUCCESS;
+
+    InArgs.ClientType = MACommonULT::GetClientType(pInParams->CountIdx);
+
+    for(uint32_t i = 0; i < MA_LOOKUP_ITERATIONS; i++)
+    {
+        Status = MACommonULT::pfnGmmInit[AdapterIdx][0](&InArgs, &OutArgs);
+        EXPECT_EQ(Status, GMM_SUCCESS);
+        if(Status != GMM_SUCCESS || !OutArgs.pGmmClientContext)
+        {
+            break;
+        }
+
+        // Lookups must always resolve to the LibContext registered for the adapter
+        GMM_LIB_CONTEXT *pLibContext = OutArgs.pGmmClientContext->GetLibContext();
+        if(MACommonULT::pLibContext[AdapterIdx][0])
+        {
+            EXPECT_EQ(pLibContext, MACommonULT::pLibContext[AdapterIdx][0]);
+            if(pLibContext == MACommonULT::pLibContext[AdapterIdx][0])
+            {
+                pInParams->NumAttached++;
+            }
+        }
+        else
+        {
+            EXPECT_TRUE(pLibContext);
+            if(pLibContext &&
+               pLibContext->GetPlatformInfo().Platform.eProductFamily == MACommonULT::GetProductFamily(AdapterIdx))
+            {
+                pInParams->NumAttached++;
+            }
+        }
+
+        MACommonULT::pfnGmmDestroy[AdapterIdx][0](&OutArgs);
+        OutArgs.pGmmClientContext = NULL;
+    }
+
+    pthread_exit(NULL);
+}
+
 
 #if GMM_LIB_DLL_MA
 /*
@@ -527,5 +578,234 @@ TEST_F(CTestMA, TestMTLoadMultipleAdaptersMultipleTimes)
     CreateMAThread(MAX_NUM_ADAPTERS * MAX_COUNT_PER_ADAPTER);
 }
 
+// Adapter lookup under contention.
+// All adapters but one stay registered by a first client, while
+// MAX_NUM_ADAPTERS * MAX_COUNT_PER_ADAPTER threads keep attaching and detaching
+// further clients across the adapters. The first client of the churn adapter is
+// detached up front, so its threads keep releasing and re-registering the adapter
+// while the lock-free lookups of the other adapters run. Every attach must resolve to
+// the adapter's own LibContext.
+// Attach/detach cost vs thread count is measured by GMMBench (CBenchAdapter.Gen12Attach).
+TEST_F(CTestMA, TestMTAdapterLookupContention)
+{
+    const uint32_t ChurnAdapter = 2;
+    uint32_t       AdapterCount = 0;
+    uint32_t       i            = 0;
+    uint32_t       ThreadCount  = MAX_NUM_ADAPTERS * MAX_COUNT_PER_ADAPTER;
+    int            Status;
+    pthread_t      thread_id[MAX_NUM_ADAPTERS * MAX_COUNT_PER_ADAPTER];
+
+    for(AdapterCount = 0; AdapterCount < MAX_NUM_ADAPTERS; AdapterCount++)
+    {
+        LoadGmmDll(AdapterCount, 0);
+        GmmInitModule(AdapterCount, 0);
+    }
+
+    // Release the churn adapter, keeping its adapter info for the threads' InArgs
+    OutArgs[ChurnAdapter][0].pGmmClientContext = pGmmULTClientContext[ChurnAdapter][0];
+    pfnGmmDestroy[ChurnAdapter][0](&OutArgs[ChurnAdapter][0]);
+    pGmmULTClientContext[ChurnAdapter][0] = NULL;
+    pLibContext[ChurnAdapter][0]          = NULL;
+
+    memset(InParams, 0, sizeof(InParams));
+
+    // Interleave the threads across adapters so neighbouring threads hit different adapters
+    for(i = 0; i < ThreadCount; i++)
+    {
+        InParams[i].AdapterIdx = i % MAX_NUM_ADAPTERS;
+        InParams[i].CountIdx   = i / MAX_NUM_ADAPTERS;
+    }
+
+    for(i = 0; i < ThreadCount; i++)
+    {
+        Status = pthread_create(&thread_id[i], NULL, ThreadLookup, (void *)&InParams[i]);
+        ASSERT_TRUE((!Status));
+    }
+
+    for(i = 0; i < ThreadCount; i++)
+    {
+        Status = pthread_join(thread_id[i], NULL);
+        ASSERT_TRUE((!Status));
+    }
+
+    for(i = 0; i < ThreadCount; i++)
+    {
+        EXPECT_EQ(InParams[i].NumAttached, MA_LOOKUP_ITERATIONS) << "Thread " << i << ", adapter " << InParams[i].AdapterIdx;
+    }
+
+    // The first client of every adapter must still resolve to the same LibContext
+    for(AdapterCount = 0; AdapterCount < MAX_NUM_ADAPTERS; AdapterCount++)
+    {
+        if(AdapterCount != ChurnAdapter)
+        {
+            EXPECT_EQ(pGmmULTClientContext[AdapterCount][0]->GetLibContext(), pLibContext[AdapterCount][0]);
+        }
+    }
+
+    // The churn adapter is released again and must register cleanly in its old slot
+    GmmInitModule(ChurnAdapter, 0);
+    EXPECT_EQ(pLibContext[ChurnAdapter][0]->GetPlatformInfo().Platform.eProductFamily, GetProductFamily(ChurnAdapter));
+
+    for(AdapterCount = 0; AdapterCount < MAX_NUM_ADAPTERS; AdapterCount++)
+    {
+        GmmDestroyModule(AdapterCount, 0);
+        UnLoadGmmDll(AdapterCount, 0);
+    }
+}
+
+// Adapters with identical platform tables must share one copy of them, while
+// different platforms keep their own. Adapters 3 and 4 are both DG2 with the same
+// SKU/WA, adapters 0 and 1 are DG1 and ICL.
+TEST_F(CTestMA, TestSharedPlatformTables)
+{
+    const uint32_t Adapters[] = {0, 1, 3, 4};
+    uint32_t       i          = 0;
+
+    for(i = 0; i < sizeof(Adapters) / sizeof(Adapters[0]); i++)
+    {
+        LoadGmmDll(Adapters[i], 0);
+        GmmInitModule(Adapters[i], 0);
+    }
+
+    EXPECT_NE(pLibContext[3][0], pLibContext[4][0]);
+    EXPECT_EQ(&pGmmULTClientContext[3][0]->GetSkuTable(), &pGmmULTClientContext[4][0]->GetSkuTable());
+    EXPECT_EQ(pGmmULTClientContext[3][0]->GetCachePolicyUsage(), pGmmULTClientContext[4][0]->GetCachePolicyUsage());
+
+    EXPECT_NE(&pGmmULTClientContext[0][0]->GetSkuTable(), &pGmmULTClientContext[1][0]->GetSkuTable());
+    EXPECT_NE(pGmmULTClientContext[0][0]->GetCachePolicyUsage(), pGmmULTClientContext[1][0]->GetCachePolicyUsage());
+    EXPECT_NE(pGmmULTClientContext[0][0]->GetCachePolicyUsage(), pGmmULTClientContext[3][0]->GetCachePolicyUsage());
+
+    // The shared tables must outlive the adapter that interned them first
+    GmmDestroyModule(3, 0);
+    UnLoadGmmDll(3, 0);
+    EXPECT_TRUE(pGmmULTClientContext[4][0]->GetSkuTable().FtrLocalMemory ==
+                pGfxAdapterInfo[4][0]->SkuTable.FtrLocalMemory);
+    EXPECT_TRUE(pGmmULTClientContext[4][0]->GetCachePolicyUsage()[GMM_RESOURCE_USAGE_UNKNOWN].Initialized);
+
+    for(i = 0; i < sizeof(Adapters) / sizeof(Adapters[0]); i++)
+    {
+        if(Adapters[i] != 3)
+        {
+            GmmDestroyModule(Adapters[i], 0);
+            UnLoadGmmDll(Adapters[i], 0);
+        }
+    }
+}
+
+// A context whose platform and SKU/WA/GT system info match an earlier one must
+// load the cache policy tables that one generated instead of building its own.
+TEST_F(CTestMA, TestCachePolicyTablesReuse)
+{
+    GMM_LIB_INIT_STATS Stats = {};
+
+    LoadGmmDll(3, 0);
+    GmmInitModule(3, 0);
+    EXPECT_TRUE(pGmmULTClientContext[3][0]->GetCachePolicyUsage()[GMM_RESOURCE_USAGE_UNKNOWN].Initialized);
+
+    LoadGmmDll(4, 0);
+    GmmInitModule(4, 0);
+
+    // Loaded at context creation, before any cache policy query
+    EXPECT_EQ(GMM_SUCCESS, pGmmULTClientContext[4][0]->GetLibInitStats(&Stats));
+    EXPECT_TRUE(Stats.ReusedMask & GMM_LIB_SUBSYSTEM_BIT(GMM_LIB_SUBSYSTEM_CACHE_POLICY));
+    EXPECT_TRUE(Stats.InitializedMask & GMM_LIB_SUBSYSTEM_BIT(GMM_LIB_SUBSYSTEM_CACHE_POLICY));
+
+    EXPECT_EQ(pGmmULTClientContext[3][0]->GetCachePolicyUsage(), pGmmULTClientContext[4][0]->GetCachePolicyUsage());
+    EXPECT_EQ(pGmmULTClientContext[3][0]->GetCachePolicyLookup(), pGmmULTClientContext[4][0]->GetCachePolicyLookup());
+    EXPECT_EQ(pGmmULTClientContext[3][0]->CachePolicyGetMaxMocsIndex(), pGmmULTClientContext[4][0]->CachePolicyGetMaxMocsIndex());
+    EXPECT_EQ(pGmmULTClientContext[3][0]->CachePolicyGetMaxL1HdcMocsIndex(), pGmmULTClientContext[4][0]->CachePolicyGetMaxL1HdcMocsIndex());
+    EXPECT_EQ(pGmmULTClientContext[3][0]->CachePolicyGetMaxSpecialMocsIndex(), pGmmULTClientContext[4][0]->CachePolicyGetMaxSpecialMocsIndex());
+    EXPECT_EQ(pGmmULTClientContext[3][0]->CachePolicyGetMemoryObject(NULL, GMM_RESOURCE_USAGE_RENDER_TARGET).DwordValue,
+              pGmmULTClientContext[4][0]->CachePolicyGetMemoryObject(NULL, GMM_RESOURCE_USAGE_RENDER_TARGET).DwordValue);
+
+    GmmDestroyModule(3, 0);
+    UnLoadGmmDll(3, 0);
+    GmmDestroyModule(4, 0);
+    UnLoadGmmDll(4, 0);
+}
+
+#ifdef GMM_CACHE_POLICY_FILE_OVERRIDE_SUPPORTED
+// Overrides from GMM_CACHE_POLICY_OVERRIDE_FILE are validated against the fields
+// the platform defines, and MOCS are selected from the overridden usages. The
+// overridden tables must not be shared with contexts that have none, and a file
+// with an invalid line fails context creation. Adapters 3 and 5 have no local
+// memory, so they use the Gen12 cache policy.
+static void WriteCachePolicyOverrideFile(char *pPath, const char *pText)
+{
+    int   Fd    = mkstemp(pPath);
+    FILE *pFile = (Fd >= 0) ? fdopen(Fd, "w") : NULL;
+
+    ASSERT_TRUE(pFile != NULL);
+    fputs(pText, pFile);
+    fclose(pFile);
+}
+
+TEST_F(CTestMA, TestCachePolicyOverrideFile)
+{
+    char               Path[]    = "/tmp/GmmCachePolicyOverrideXXXXXX";
+    char               BadPath[] = "/tmp/GmmCachePolicyOverrideXXXXXX";
+    GMM_LIB_INIT_STATS Stats     = {};
+    GMM_INIT_IN_ARGS   BadInArgs;
+    GMM_INIT_OUT_ARGS  BadOutArgs = {0};
+
+    WriteCachePolicyOverrideFile(Path, "# Uncached render targets\n"
+                                       "RENDER_TARGET LLC=0 ELLC=0 L3=0 Age=0 L3Eviction=0\n"
+                                       "GMM_RESOURCE_USAGE_STAGING LLC=0 ELLC=0 L3=0 Age=0 L3Eviction=0\n");
+
+    LoadGmmDll(3, 0);
+    GmmInitModule(3, 0);
+    EXPECT_TRUE(pGmmULTClientContext[3][0]->GetCachePolicyUsage()[GMM_RESOURCE_USAGE_RENDER_TARGET].L3);
+
+    setenv(GMM_CACHE_POLICY_OVERRIDE_FILE_ENV, Path, 1);
+    LoadGmmDll(5, 0);
+    GmmInitModule(5, 0);
+    unsetenv(GMM_CACHE_POLICY_OVERRIDE_FILE_ENV);
+    unlink(Path);
+
+    // Built at context creation rather than loaded from adapter 3
+    EXPECT_EQ(GMM_SUCCESS, pGmmULTClientContext[5][0]->GetLibInitStats(&Stats));
+    EXPECT_TRUE(Stats.InitializedMask & GMM_LIB_SUBSYSTEM_BIT(GMM_LIB_SUBSYSTEM_CACHE_POLICY));
+    EXPECT_FALSE(Stats.ReusedMask & GMM_LIB_SUBSYSTEM_BIT(GMM_LIB_SUBSYSTEM_CACHE_POLICY));
+
+    const GMM_CACHE_POLICY_ELEMENT *pUsage = pGmmULTClientContext[5][0]->GetCachePolicyUsage();
+    EXPECT_EQ(0u, pUsage[GMM_RESOURCE_USAGE_RENDER_TARGET].LLC);
+    EXPECT_EQ(0u, pUsage[GMM_RESOURCE_USAGE_RENDER_TARGET].L3);
+    EXPECT_EQ(0u, pUsage[GMM_RESOURCE_USAGE_RENDER_TARGET].AGE);
+    EXPECT_EQ(1u, pUsage[GMM_RESOURCE_USAGE_RENDER_TARGET].IsOverridenByRegkey);
+    EXPECT_EQ(0u, pUsage[GMM_RESOURCE_USAGE_STAGING].L3);
+    EXPECT_EQ(1u, pUsage[GMM_RESOURCE_USAGE_TILED_RENDER_TARGET].L3);
+    EXPECT_EQ(0u, pUsage[GMM_RESOURCE_USAGE_TILED_RENDER_TARGET].IsOverridenByRegkey);
+
+    EXPECT_NE(pGmmULTClientContext[3][0]->GetCachePolicyUsage(), pUsage);
+    EXPECT_NE(pGmmULTClientContext[3][0]->CachePolicyGetMemoryObject(NULL, GMM_RESOURCE_USAGE_RENDER_TARGET).DwordValue,
+              pGmmULTClientContext[5][0]->CachePolicyGetMemoryObject(NULL, GMM_RESOURCE_USAGE_RENDER_TARGET).DwordValue);
+
+    GmmDestroyModule(5, 0);
+    UnLoadGmmDll(5, 0);
+
+    // Any invalid line fails context creation and leaves the adapter unregistered
+    WriteCachePolicyOverrideFile(BadPath, "RENDER_TARGET LLC=0 ELLC=0 L3=0 Age=0 L3Eviction=0\n"
+                                          "STAGING GlbGo=1          # not a Gen12 field\n"
+                                          "TILED_RENDER_TARGET L3=2 # out of range\n"
+                                          "NOT_A_USAGE L3=0\n");
+    BadInArgs                = InArgs[3][0];
+    BadInArgs.FileDescriptor = GetAdapterBDF(5).Data;
+
+    setenv(GMM_CACHE_POLICY_OVERRIDE_FILE_ENV, BadPath, 1);
+    EXPECT_EQ(GMM_ERROR, pfnGmmInit[3][0](&BadInArgs, &BadOutArgs));
+    EXPECT_TRUE(BadOutArgs.pGmmClientContext == NULL);
+    unsetenv(GMM_CACHE_POLICY_OVERRIDE_FILE_ENV);
+    unlink(BadPath);
+
+    EXPECT_EQ(GMM_SUCCESS, pfnGmmInit[3][0](&BadInArgs, &BadOutArgs));
+    ASSERT_TRUE(BadOutArgs.pGmmClientContext != NULL);
+    EXPECT_TRUE(BadOutArgs.pGmmClientContext->GetCachePolicyUsage()[GMM_RESOURCE_USAGE_RENDER_TARGET].L3);
+    pfnGmmDestroy[3][0](&BadOutArgs);
+
+    GmmDestroyModule(3, 0);
+    UnLoadGmmDll(3, 0);
+}
+#endif
+
 #endif // GMM_LIB_DLL_MA
 
@@ -27,6 +27,9 @@ OTHER DEALINGS IN THE SOFTWARE.
 
 #define MAX_COUNT_PER_ADAPTER       3
 
+// Client attach/detach iterations per thread for the adapter lookup contention ULT
+#define MA_LOOKUP_ITERATIONS        2000
+
 #ifdef _WIN32
 #define GMM_DLL_HANDLE      HINSTANCE
 #else
@@ -37,6 +40,7 @@ typedef struct ThreadInParams_Rec
 {
     uint32_t AdapterIdx;
     uint32_t CountIdx;
+    uint32_t NumAttached;   // Attaches that resolved to the adapter's LibContext
 } ThreadInParams;
 
 class MACommonULT : public testing::Test
@@ -198,6 +202,8 @@ public:
 
 #ifdef _WIN32
     DWORD WINAPI Thread1(LPVOID lpParam);
+    DWORD WINAPI ThreadLookup(LPVOID lpParam);
 #else
     void *Thread1(void *lpParam);
+    void *ThreadLookup(void *lpParam);
 #endif
@@ -3493,3 +3493,45 @@ TEST_F(CTestResource, TestCompressedSurface)
 
     pGmmULTClientContext->DestroyResInfoObject(ResourceInfo);
 }
+
+/// @brief ULT for format predicates and per-format traits
+TEST_F(CTestResource, TestFormatTraits)
+{
+    GMM_PLATFORM_INFO &PlatformInfo = pGmmULTClientContext->GetPlatformInfo();
+
+    for(uint32_t i = GMM_FORMAT_INVALID + 1; i < GMM_RESOURCE_FORMATS; i++)
+    {
+        GMM_RESOURCE_FORMAT Format = static_cast<GMM_RESOURCE_FORMAT>(i);
+
+        EXPECT_EQ(PlatformInfo.FormatTable[Format].SurfaceStateFormat, pGmmULTClientContext->GetSurfaceStateFormat(Format));
+        EXPECT_EQ(PlatformInfo.FormatTable[Format].Compressed, pGmmULTClientContext->IsCompressed(Format));
+
+        // Hybrid UV packed formats are treated as planar, and P0xx are UV packed
+        if(pGmmULTClientContext->IsUVPacked(Format))
+        {
+            EXPECT_EQ(1, pGmmULTClientContext->IsPlanar(Format));
+        }
+        if(pGmmULTClientContext->IsP0xx(Format))
+        {
+            EXPECT_EQ(1, pGmmULTClientContext->IsUVPacked(Format));
+        }
+    }
+
+    EXPECT_EQ(1, pGmmULTClientContext->IsPlanar(GMM_FORMAT_NV12));
+    EXPECT_EQ(1, pGmmULTClientContext->IsPlanar(GMM_FORMAT_RGBP));
+    EXPECT_EQ(0, pGmmULTClientContext->IsPlanar(GMM_FORMAT_YUY2));
+    EXPECT_EQ(1, pGmmULTClientContext->IsUVPacked(GMM_FORMAT_P016));
+    EXPECT_EQ(0, pGmmULTClientContext->IsUVPacked(GMM_FORMAT_YV12));
+    EXPECT_EQ(1, pGmmULTClientContext->IsYUVPacked(GMM_FORMAT_YUY2));
+    EXPECT_EQ(1, pGmmULTClientContext->IsYUVPacked(GMM_FORMAT_Y416));
+    EXPECT_EQ(0, pGmmULTClientContext->IsYUVPacked(GMM_FORMAT_NV12));
+    EXPECT_EQ(1, pGmmULTClientContext->IsP0xx(GMM_FORMAT_P010));
+    EXPECT_EQ(0, pGmmULTClientContext->IsP0xx(GMM_FORMAT_P208));
+    EXPECT_EQ(1, pGmmULTClientContext->IsCompressed(GMM_FORMAT_BC1_UNORM));
+    EXPECT_EQ(0, pGmmULTClientContext->IsCompressed(GMM_FORMAT_R8G8B8A8_UNORM));
+
+    // Out-of-range formats
+    EXPECT_EQ(0, pGmmULTClientContext->IsPlanar(GMM_FORMAT_INVALID));
+    EXPECT_EQ(0, pGmmULTClientContext->IsPlanar(GMM_RESOURCE_FORMATS));
+    EXPECT_EQ(GMM_SURFACESTATE_FORMAT_INVALID, pGmmULTClientContext->GetSurfaceStateFormat(GMM_RESOURCE_FORMATS));
+}
@@ -61,6 +61,124 @@ extern const SWIZZLE_DESCRIPTOR INTEL_64KB_UNDEFINED_16_32bpp  = {0x3E0F, 0xC1F0
 extern const SWIZZLE_DESCRIPTOR INTEL_64KB_UNDEFINED_64_128bpp = {0x7E0F, 0x81F0, 0};
 //#############################################################################
 
+//=============================================================================
+// Format class membership. Evaluated at compile time only, to generate the
+// Class/NumPlanes columns of __GmmFormatTraits.
+//-----------------------------------------------------------------------------
+#define GMM_FORMAT_IS(Name) (Format == GMM_FORMAT_##Name)
+
+static constexpr bool __GmmIsPlanar3Format(GMM_RESOURCE_FORMAT Format)
+{
+    // YUV Planar Formats
+    return GMM_FORMAT_IS(BGRP) || GMM_FORMAT_IS(IMC1) || GMM_FORMAT_IS(IMC2) ||
+           GMM_FORMAT_IS(IMC3) || GMM_FORMAT_IS(IMC4) || GMM_FORMAT_IS(I420) || //Same as IYUV.
+           GMM_FORMAT_IS(IYUV) || GMM_FORMAT_IS(MFX_JPEG_YUV411) || GMM_FORMAT_IS(MFX_JPEG_YUV411R) ||
+           GMM_FORMAT_IS(MFX_JPEG_YUV420) || GMM_FORMAT_IS(MFX_JPEG_YUV422H) ||
+           GMM_FORMAT_IS(MFX_JPEG_YUV422V) || GMM_FORMAT_IS(MFX_JPEG_YUV444) ||
+           GMM_FORMAT_IS(RGBP) || GMM_FORMAT_IS(YV12) || GMM_FORMAT_IS(YVU9);
+}
+
+static constexpr bool __GmmIsUVPackedFormat(GMM_RESOURCE_FORMAT Format)
+{
+    // YUV Hybrid Formats - GMM treats as Planar
+    return GMM_FORMAT_IS(NV11) || GMM_FORMAT_IS(NV12) || GMM_FORMAT_IS(NV21) ||
+           GMM_FORMAT_IS(P010) || GMM_FORMAT_IS(P012) || GMM_FORMAT_IS(P016) ||
+           GMM_FORMAT_IS(P208) || GMM_FORMAT_IS(P216);
+}
+
+static constexpr bool __GmmIsYUVPackedFormat(GMM_RESOURCE_FORMAT Format)
+{
+    // YCRCB_xxx Format Supported by the Sampler...
+    return GMM_FORMAT_IS(YUY2) || GMM_FORMAT_IS(YVYU) || GMM_FORMAT_IS(UYVY) ||
+           GMM_FORMAT_IS(VYUY) || GMM_FORMAT_IS(YUY2_2x1) || GMM_FORMAT_IS(YVYU_2x1) ||
+           GMM_FORMAT_IS(UYVY_2x1) || GMM_FORMAT_IS(VYUY_2x1) || GMM_FORMAT_IS(Y210) ||
+           GMM_FORMAT_IS(Y212) || GMM_FORMAT_IS(Y216) || GMM_FORMAT_IS(Y410) ||
+           GMM_FORMAT_IS(Y412) || GMM_FORMAT_IS(Y416) || GMM_FORMAT_IS(AYUV);
+}
+
+static constexpr bool __GmmIsP0xxFormat(GMM_RESOURCE_FORMAT Format)
+{
+    return GMM_FORMAT_IS(P010) || GMM_FORMAT_IS(P012) || GMM_FORMAT_IS(P016);
+}
+
+static constexpr bool __GmmIsReconstructableFormat(GMM_RESOURCE_FORMAT Format)
+{
+    return GMM_FORMAT_IS(AYUV) || GMM_FORMAT_IS(P010) || GMM_FORMAT_IS(P012) ||
+           GMM_FORMAT_IS(P016) || GMM_FORMAT_IS(Y210) || GMM_FORMAT_IS(Y216) ||
+           GMM_FORMAT_IS(Y212) || GMM_FORMAT_IS(Y410) || GMM_FORMAT_IS(Y416) ||
+           GMM_FORMAT_IS(P8) || GMM_FORMAT_IS(NV12) || GMM_FORMAT_IS(YUY2_2x1) ||
+           GMM_FORMAT_IS(YUY2);
+}
+
+static constexpr bool __GmmIsLCUAlignedFormat(GMM_RESOURCE_FORMAT Format)
+{
+    return GMM_FORMAT_IS(NV12) || GMM_FORMAT_IS(P010) || GMM_FORMAT_IS(P016) ||
+           GMM_FORMAT_IS(YUY2) || GMM_FORMAT_IS(Y210) || GMM_FORMAT_IS(Y410) ||
+           GMM_FORMAT_IS(Y216) || GMM_FORMAT_IS(Y416) || GMM_FORMAT_IS(AYUV);
+}
+
+#undef GMM_FORMAT_IS
+
+static constexpr uint8_t __GmmFormatClass(GMM_RESOURCE_FORMAT Format, uint32_t Width, uint32_t Height, uint32_t Depth)
+{
+    return (__GmmIsPlanar3Format(Format) || __GmmIsUVPackedFormat(Format) ? GMM_FORMAT_CLASS_PLANAR : 0) |
+           (__GmmIsUVPackedFormat(Format) ? GMM_FORMAT_CLASS_UV_PACKED : 0) |
+           (__GmmIsYUVPackedFormat(Format) ? GMM_FORMAT_CLASS_YUV_PACKED : 0) |
+           (__GmmIsP0xxFormat(Format) ? GMM_FORMAT_CLASS_P0XX : 0) |
+           (__GmmIsReconstructableFormat(Format) ? GMM_FORMAT_CLASS_RECONSTRUCTABLE : 0) |
+           (__GmmIsLCUAlignedFormat(Format) ? GMM_FORMAT_CLASS_LCU_ALIGNED : 0) |
+           (((Width > 1) || (Height > 1) || (Depth > 1)) ? GMM_FORMAT_CLASS_BLOCK_COMPRESSED : 0);
+}
+
+static constexpr uint8_t __GmmFormatNumPlanes(GMM_RESOURCE_FORMAT Format)
+{
+    return __GmmIsPlanar3Format(Format) ? 3 : __GmmIsUVPackedFormat(Format) ? 2 : 1;
+}
+
+// Each column is generated by re-including GmmFormatTable.h; entry zero is
+// GMM_FORMAT_INVALID.
+extern constexpr GMM_FORMAT_TRAITS __GmmFormatTraits =
+{
+    // BitsPerElement
+    {0,
+#define GMM_FORMAT(Name, bpe, Width, Height, Depth, IsRT, IsASTC, RcsSurfaceFormat, SSCompressionFmt, Availability) (bpe),
+#include "External/Common/GmmFormatTable.h"
+    },
+    // BlockWidth
+    {1,
+#define GMM_FORMAT(Name, bpe, Width, Height, Depth, IsRT, IsASTC, RcsSurfaceFormat, SSCompressionFmt, Availability) (Width),
+#include "External/Common/GmmFormatTable.h"
+    },
+    // BlockHeight
+    {1,
+#define GMM_FORMAT(Name, bpe, Width, Height, Depth, IsRT, IsASTC, RcsSurfaceFormat, SSCompressionFmt, Availability) (Height),
+#include "External/Common/GmmFormatTable.h"
+    },
+    // BlockDepth
+    {1,
+#define GMM_FORMAT(Name, bpe, Width, Height, Depth, IsRT, IsASTC, RcsSurfaceFormat, SSCompressionFmt, Availability) (Depth),
+#include "External/Common/GmmFormatTable.h"
+    },
+    // Class
+    {0,
+#define GMM_FORMAT(Name, bpe, Width, Height, Depth, IsRT, IsASTC, RcsSurfaceFormat, SSCompressionFmt, Availability) \
+    __GmmFormatClass(GMM_FORMAT_##Name, (Width), (Height), (Depth)),
+#include "External/Common/GmmFormatTable.h"
+    },
+    // NumPlanes
+    {1,
+#define GMM_FORMAT(Name, bpe, Width, Height, Depth, IsRT, IsASTC, RcsSurfaceFormat, SSCompressionFmt, Availability) \
+    __GmmFormatNumPlanes(GMM_FORMAT_##Name),
+#include "External/Common/GmmFormatTable.h"
+    },
+    // SurfaceStateFormat
+    {GMM_SURFACESTATE_FORMAT_INVALID,
+#define GMM_FORMAT(Name, bpe, Width, Height, Depth, IsRT, IsASTC, RcsSurfaceFormat, SSCompressionFmt, Availability) \
+    ((GMM_SURFACESTATE_FORMAT)(RcsSurfaceFormat)),
+#include "External/Common/GmmFormatTable.h"
+    },
+};
+
 //=============================================================================
 // Function:
 //    GmmIsRedecribedPlanes
@@ -115,25 +233,7 @@ uint8_t GMM_STDCALL GmmGetLosslessCompressionType(void *pLibContext, GMM_RESOURC
 uint8_t GMM_STDCALL GmmIsUVPacked(GMM_RESOURCE_FORMAT Format)
 {
     GMM_DPF_ENTER;
-    uint8_t Status = 0;
-
-    switch(Format)
-    {
-        case GMM_FORMAT_NV11:
-        case GMM_FORMAT_NV12:
-        case GMM_FORMAT_NV21:
-        case GMM_FORMAT_P010:
-        case GMM_FORMAT_P012:
-        case GMM_FORMAT_P016:
-        case GMM_FORMAT_P208:
-        case GMM_FORMAT_P216:
-            Status = 1;
-            break;
-        default:
-            Status = 0;
-            break;
-    }
-    return Status;
+    return GMM_FORMAT_HAS_CLASS(Format, GMM_FORMAT_CLASS_UV_PACKED);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -146,26 +246,7 @@ uint8_t GMM_STDCALL GmmIsUVPacked(GMM_RESOURCE_FORMAT Format)
 bool GMM_STDCALL GmmIsYUVFormatLCUAligned(GMM_RESOURCE_FORMAT Format)
 {
     GMM_DPF_ENTER;
-    bool Status = 0;
-
-    switch(Format)
-    {
-        case GMM_FORMAT_NV12:
-        case GMM_FORMAT_P010:
-        case GMM_FORMAT_P016:
-        case GMM_FORMAT_YUY2:
-        case GMM_FORMAT_Y210:
-        case GMM_FORMAT_Y410:
-        case GMM_FORMAT_Y216:
-        case GMM_FORMAT_Y416:
-        case GMM_FORMAT_AYUV:
-            Status = true;
-            break;
-        default:
-            Status = false;
-            break;
-    }
-    return Status;
+    return GMM_FORMAT_HAS_CLASS(Format, GMM_FORMAT_CLASS_LCU_ALIGNED);
 }
 
 //=============================================================================
@@ -183,33 +264,7 @@ bool GMM_STDCALL GmmIsYUVFormatLCUAligned(GMM_RESOURCE_FORMAT Format)
 uint8_t GMM_STDCALL GmmIsYUVPacked(GMM_RESOURCE_FORMAT Format)
 {
     GMM_DPF_ENTER;
-    uint8_t Status = 0;
-
-    switch(Format)
-    {
-        // YCRCB_xxx Format Supported by the Sampler...
-        case GMM_FORMAT_YUY2:
-        case GMM_FORMAT_YVYU:
-        case GMM_FORMAT_UYVY:
-        case GMM_FORMAT_VYUY:
-        case GMM_FORMAT_YUY2_2x1:
-        case GMM_FORMAT_YVYU_2x1:
-        case GMM_FORMAT_UYVY_2x1:
-        case GMM_FORMAT_VYUY_2x1:
-        case GMM_FORMAT_Y210:
-        case GMM_FORMAT_Y212:
-        case GMM_FORMAT_Y216:
-        case GMM_FORMAT_Y410:
-        case GMM_FORMAT_Y412:
-        case GMM_FORMAT_Y416:
-        case GMM_FORMAT_AYUV:
-            Status = 1;
-            break;
-        default:
-            Status = 0;
-            break;
-    }
-    return Status;
+    return GMM_FORMAT_HAS_CLASS(Format, GMM_FORMAT_CLASS_YUV_PACKED);
 }
 
 //=============================================================================
@@ -227,43 +282,7 @@ uint8_t GMM_STDCALL GmmIsYUVPacked(GMM_RESOURCE_FORMAT Format)
 uint8_t GMM_STDCALL GmmIsPlanar(GMM_RESOURCE_FORMAT Format)
 {
     GMM_DPF_ENTER;
-    uint8_t Status = 0;
-
-    switch(Format)
-    {
-        // YUV Planar Formats
-        case GMM_FORMAT_BGRP:
-        case GMM_FORMAT_IMC1:
-        case GMM_FORMAT_IMC2:
-        case GMM_FORMAT_IMC3:
-        case GMM_FORMAT_IMC4:
-        case GMM_FORMAT_I420: //Same as IYUV.
-        case GMM_FORMAT_IYUV:
-        case GMM_FORMAT_MFX_JPEG_YUV411:
-        case GMM_FORMAT_MFX_JPEG_YUV411R:
-        case GMM_FORMAT_MFX_JPEG_YUV420:
-        case GMM_FORMAT_MFX_JPEG_YUV422H:
-        case GMM_FORMAT_MFX_JPEG_YUV422V:
-        case GMM_FORMAT_MFX_JPEG_YUV444:
-        case GMM_FORMAT_RGBP:
-        case GMM_FORMAT_YV12:
-        case GMM_FORMAT_YVU9:
-        // YUV Hybrid Formats - GMM treats as Planar
-        case GMM_FORMAT_NV11:
-        case GMM_FORMAT_NV12:
-        case GMM_FORMAT_NV21:
-        case GMM_FORMAT_P010:
-        case GMM_FORMAT_P012:
-        case GMM_FORMAT_P016:
-        case GMM_FORMAT_P208:
-        case GMM_FORMAT_P216:
-            Status = 1;
-            break;
-        default:
-            Status = 0;
-            break;
-    }
-    return Status;
+    return GMM_FORMAT_HAS_CLASS(Format, GMM_FORMAT_CLASS_PLANAR);
 }
 
 //=============================================================================
@@ -281,30 +300,7 @@ uint8_t GMM_STDCALL GmmIsPlanar(GMM_RESOURCE_FORMAT Format)
 uint8_t GMM_STDCALL GmmIsReconstructableSurface(GMM_RESOURCE_FORMAT Format)
 {
     GMM_DPF_ENTER;
-    uint8_t Status = 0;
-
-    switch(Format)
-    {
-        case GMM_FORMAT_AYUV:
-        case GMM_FORMAT_P010:
-        case GMM_FORMAT_P012:
-        case GMM_FORMAT_P016:
-        case GMM_FORMAT_Y210:
-        case GMM_FORMAT_Y216:
-        case GMM_FORMAT_Y212:
-        case GMM_FORMAT_Y410:
-        case GMM_FORMAT_Y416:
-        case GMM_FORMAT_P8:
-        case GMM_FORMAT_NV12:
-        case GMM_FORMAT_YUY2_2x1:
-        case GMM_FORMAT_YUY2:
-            Status = 1;
-            break;
-        default:
-            Status = 0;
-            break;
-    }
-    return Status;
+    return GMM_FORMAT_HAS_CLASS(Format, GMM_FORMAT_CLASS_RECONSTRUCTABLE);
 }
 
 //=============================================================================
@@ -321,23 +317,8 @@ uint8_t GMM_STDCALL GmmIsReconstructableSurface(GMM_RESOURCE_FORMAT Format)
 //-----------------------------------------------------------------------------
 uint8_t GMM_STDCALL GmmIsP0xx(GMM_RESOURCE_FORMAT Format)
 {
-
     GMM_DPF_ENTER;
-    uint8_t Status = 0;
-
-    switch(Format)
-    {
-        case GMM_FORMAT_P010:
-        case GMM_FORMAT_P012:
-        case GMM_FORMAT_P016:
-            Status = 1;
-            break;
-        default:
-            Status = 0;
-            break;
-    }
-
-    return Status;
+    return GMM_FORMAT_HAS_CLASS(Format, GMM_FORMAT_CLASS_P0XX);
 }
 
 //=============================================================================
@@ -355,11 +336,9 @@ uint8_t GMM_STDCALL GmmIsP0xx(GMM_RESOURCE_FORMAT Format)
 uint8_t GMM_STDCALL GmmIsCompressed(void *pLibContext, GMM_RESOURCE_FORMAT Format)
 {
     GMM_DPF_ENTER;
-    GMM_LIB_CONTEXT *pGmmLibContext = (GMM_LIB_CONTEXT *)pLibContext;
+    GMM_UNREFERENCED_PARAMETER(pLibContext);
 
-    return (Format > GMM_FORMAT_INVALID) &&
-           (Format < GMM_RESOURCE_FORMATS) &&
-           pGmmLibContext->GetPlatformInfo().FormatTable[Format].Compressed;
+    return GMM_FORMAT_HAS_CLASS(Format, GMM_FORMAT_CLASS_BLOCK_COMPRESSED);
 }
 
 //=============================================================================
@@ -410,45 +389,7 @@ namespace GmmLib
         uint32_t GMM_STDCALL GmmGetNumPlanes(GMM_RESOURCE_FORMAT Format)
         {
             GMM_DPF_ENTER;
-            uint32_t Planes = 1;
-
-            switch(Format)
-            {
-                // YUV Planar Formats
-                case GMM_FORMAT_BGRP:
-                case GMM_FORMAT_IMC1:
-                case GMM_FORMAT_IMC2:
-                case GMM_FORMAT_IMC3:
-                case GMM_FORMAT_IMC4:
-                case GMM_FORMAT_I420:
-                case GMM_FORMAT_IYUV:
-                case GMM_FORMAT_MFX_JPEG_YUV411:
-                case GMM_FORMAT_MFX_JPEG_YUV411R:
-                case GMM_FORMAT_MFX_JPEG_YUV420:
-                case GMM_FORMAT_MFX_JPEG_YUV422H:
-                case GMM_FORMAT_MFX_JPEG_YUV422V:
-                case GMM_FORMAT_MFX_JPEG_YUV444:
-                case GMM_FORMAT_RGBP:
-                case GMM_FORMAT_YV12:
-                case GMM_FORMAT_YVU9:
-                    Planes = 3;
-                    break;
-                // YUV Hybrid Formats - GMM treats as Planar
-                case GMM_FORMAT_NV11:
-                case GMM_FORMAT_NV12:
-                case GMM_FORMAT_NV21:
-                case GMM_FORMAT_P010:
-                case GMM_FORMAT_P012:
-                case GMM_FORMAT_P016:
-                case GMM_FORMAT_P208:
-                case GMM_FORMAT_P216:
-                    Planes = 2;
-                    break;
-                default:
-                    Planes = 1;
-                    break;
-            }
-            return Planes;
+            return (((uint32_t)Format) < GMM_RESOURCE_FORMATS) ? __GmmFormatTraits.NumPlanes[Format] : 1;
         }
 
         //==============================================================================
@@ -645,6 +586,43 @@ uint32_t __GmmLog2(uint32_t Value)
     return FirstSetBit;
 };
 
+//=============================================================================
+//
+// Function: __GmmHash64
+//
+// Desc: FNV-1a style 64-bit hash, folded a qword at a time. Not cryptographic;
+//       meant for content keys and corruption checks on layout blobs/tables.
+//
+// Parameters:
+//      pData => Bytes to hash
+//      Size  => Number of bytes
+//      Seed  => Previous hash to chain from, or 0
+//
+// Returns:
+//      64-bit hash
+//-----------------------------------------------------------------------------
+uint64_t __GmmHash64(const void *pData, size_t Size, uint64_t Seed)
+{
+    const uint64_t Prime = 0x100000001b3ull;
+    const uint8_t *pByte = (const uint8_t *)pData;
+    uint64_t       Hash  = Seed ^ 0xcbf29ce484222325ull;
+
+    for(; Size >= sizeof(uint64_t); Size -= sizeof(uint64_t), pByte += sizeof(uint64_t))
+    {
+        uint64_t Qword;
+        memcpy(&Qword, pByte, sizeof(Qword));
+        Hash = (Hash ^ Qword) * Prime;
+        Hash ^= Hash >> 29;
+    }
+
+    for(; Size; Size--, pByte++)
+    {
+        Hash = (Hash ^ *pByte) * Prime;
+    }
+
+    return Hash;
+}
+
 // Table for converting the tile layout of DirectX tiled resources
 // to TileY.
 const uint32_t __GmmTileYConversionTable[5][2] =
@@ -37,6 +37,42 @@ namespace GmmLib
 }
 #endif
 
+//===========================================================================
+// typedef:
+//      GMM_FORMAT_TRAITS
+//
+// Description:
+//      Platform-independent per-format traits, generated at compile time from
+//      GmmFormatTable.h as a structure-of-arrays indexed by GMM_RESOURCE_FORMAT
+//      so the format predicates below are a single indexed load. SKU/WA
+//      dependent columns (availability, E2E compression format) stay in the
+//      per-context PlatformInfo FormatTable.
+//---------------------------------------------------------------------------
+#define GMM_FORMAT_CLASS_PLANAR                 0x01 // YUV/RGB planar and hybrid (treated as planar)
+#define GMM_FORMAT_CLASS_UV_PACKED              0x02 // Hybrid formats with interleaved UV plane
+#define GMM_FORMAT_CLASS_YUV_PACKED             0x04 // YCRCB_xxx formats supported by the sampler
+#define GMM_FORMAT_CLASS_P0XX                   0x08
+#define GMM_FORMAT_CLASS_RECONSTRUCTABLE        0x10
+#define GMM_FORMAT_CLASS_LCU_ALIGNED            0x20
+#define GMM_FORMAT_CLASS_BLOCK_COMPRESSED       0x40 // Element is larger than 1x1x1 pixels
+
+typedef struct GMM_FORMAT_TRAITS_REC
+{
+    uint16_t                BitsPerElement[GMM_RESOURCE_FORMATS];
+    uint8_t                 BlockWidth[GMM_RESOURCE_FORMATS];
+    uint8_t                 BlockHeight[GMM_RESOURCE_FORMATS];
+    uint8_t                 BlockDepth[GMM_RESOURCE_FORMATS];
+    uint8_t                 Class[GMM_RESOURCE_FORMATS];     // GMM_FORMAT_CLASS_xxx
+    uint8_t                 NumPlanes[GMM_RESOURCE_FORMATS];
+    GMM_SURFACESTATE_FORMAT SurfaceStateFormat[GMM_RESOURCE_FORMATS];
+} GMM_FORMAT_TRAITS;
+
+extern const GMM_FORMAT_TRAITS __GmmFormatTraits;
+
+// Out-of-range formats (including GMM_FORMAT_INVALID) have no class bits.
+#define GMM_FORMAT_HAS_CLASS(Format, ClassBits) \
+    ((((uint32_t)(Format)) < GMM_RESOURCE_FORMATS) ? ((__GmmFormatTraits.Class[(Format)] & (ClassBits)) != 0) : 0)
+
 #ifndef __GMM_KMD__
     #define GMM_MALLOC(size)    malloc(size)
     #define GMM_FREE(p)         free(p)
@@ -46,4 +82,5 @@ void GMM_STDCALL GmmGetCacheSizes(GMM_CACHE_SIZES* pCacheSizes);
 
 /* Internal functions */
 uint32_t   __GmmLog2(uint32_t Value);
+uint64_t   __GmmHash64(const void *pData, size_t Size, uint64_t Seed);
 
@@ -47,6 +47,17 @@ namespace GmmLib
                 return CurrentMaxSpecialMocsIndex;
             }
 
+            virtual void SaveState(uint32_t *pState)
+            {
+                GmmGen10CachePolicy::SaveState(pState);
+                pState[2] = CurrentMaxSpecialMocsIndex;
+            }
+            virtual void RestoreState(const uint32_t *pState)
+            {
+                GmmGen10CachePolicy::RestoreState(pState);
+                CurrentMaxSpecialMocsIndex = pState[2];
+            }
+
             int32_t IsSpecialMOCSUsage(GMM_RESOURCE_USAGE_TYPE Usage, bool &UpdateMOCS);
 
             /* Function prototypes */
@@ -44,6 +44,17 @@ namespace GmmLib
             {
             }
 
+            virtual void SaveState(uint32_t *pState)
+            {
+                pState[0] = CurrentMaxMocsIndex;
+                pState[1] = CurrentMaxL1HdcMocsIndex;
+            }
+            virtual void RestoreState(const uint32_t *pState)
+            {
+                CurrentMaxMocsIndex      = pState[0];
+                CurrentMaxL1HdcMocsIndex = pState[1];
+            }
+
             /* Function prototypes */
             GMM_STATUS InitCachePolicy();
             GMM_STATUS SetupPAT();
@@ -24,7 +24,10 @@ OTHER DEALINGS IN THE SOFTWARE.
 #ifdef __cplusplus
 extern "C" {
 #endif
+// GmmConst.h needed for GMM_MAX_NUMBER_MOCS_INDEXES
+#include "GmmConst.h"
 #include "GmmCachePolicyExt.h"
+#include "GmmUtil.h"
 
 #define ALWAYS_OVERRIDE 0xffffffff
 #define NEVER_OVERRIDE  0x0
@@ -70,6 +73,77 @@ typedef struct GMM_CACHE_POLICY_ELEMENT_REC
     uint32_t                                  IsOverridenByRegkey; // Flag to indicate If usage settings are overridden by regkey
 }GMM_CACHE_POLICY_ELEMENT;
 
+// Precomputed MOCS/PTE of one usage, see GmmCachePolicyLookupMemoryObject().
+// A lookup table holds GMM_CACHE_POLICY_LOOKUP_ENTRIES entries indexed by usage,
+// the last one standing for "no resource".
+typedef struct GMM_CACHE_POLICY_LOOKUP_REC
+{
+    MEMORY_OBJECT_CONTROL_STATE               MemoryObject[2];  // [0] no override, [1] override
+    GMM_PTE_CACHE_CONTROL_BITS                PTE;
+    uint64_t                                  OverrideMask;     // Override, plus the two bits below
+    uint64_t                                  IDCode;           // IDCode, plus GMM_CACHE_POLICY_LOOKUP_ANY_RESOURCE
+} GMM_CACHE_POLICY_LOOKUP;
+
+#define GMM_CACHE_POLICY_LOOKUP_NO_RESOURCE     GMM_RESOURCE_USAGE_MAX
+#define GMM_CACHE_POLICY_LOOKUP_ENTRIES         (GMM_RESOURCE_USAGE_MAX + 1)
+#define GMM_CACHE_POLICY_LOOKUP_ANY_RESOURCE    (1ull << 32)    // In OverrideMask of ALWAYS_OVERRIDE usages
+#define GMM_CACHE_POLICY_LOOKUP_NULL_RESOURCE   (1ull << 33)    // In every OverrideMask
+
+//===========================================================================
+// typedef:
+//      GMM_CACHE_POLICY_USAGE_STATS / GMM_CACHE_POLICY_STATS
+//
+// Description:
+//      Per-context counts of cache policy queries made while counting is
+//      enabled with GmmClientContext::EnableCachePolicyStats(). MOCS queries
+//      are CachePolicyGetMemoryObject() calls, PTE queries are
+//      CachePolicyGetPteType() and CachePolicyIsUsagePTECached() calls.
+//      Clients reading GetCachePolicyLookup() directly are not counted.
+//----------------------------------------------------------------------------
+typedef struct GMM_CACHE_POLICY_USAGE_STATS_REC
+{
+    uint64_t                                  MocsQueries;
+    uint64_t                                  OverrideQueries;  // MOCS queries answered with the override MOCS
+    uint64_t                                  PteQueries;
+    uint64_t                                  PteCachedQueries; // PTE queries of a usage with a cached PTE
+} GMM_CACHE_POLICY_USAGE_STATS;
+
+typedef struct GMM_CACHE_POLICY_STATS_REC
+{
+    GMM_CACHE_POLICY_USAGE_STATS              Usage[GMM_RESOURCE_USAGE_MAX];
+    uint64_t                                  MocsIndexQueries[GMM_MAX_NUMBER_MOCS_INDEXES]; // MOCS queries by returned index
+} GMM_CACHE_POLICY_STATS;
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Branchless equivalent of GmmCachePolicyGetMemoryObject() on a table returned by
+/// GmmClientContext::GetCachePolicyLookup(); no virtual call, no flag checks.
+/// @param[in]  pLookup: Cache policy lookup table of the lib context
+/// @param[in]  ResUsage: Usage the resource was created with, or
+///                       GMM_CACHE_POLICY_LOOKUP_NO_RESOURCE without a resource
+/// @param[in]  Usage: Current usage of the resource
+/// @return     MOCS for the given use
+/////////////////////////////////////////////////////////////////////////////////////
+static GMM_INLINE MEMORY_OBJECT_CONTROL_STATE GmmCachePolicyLookupMemoryObject(const GMM_CACHE_POLICY_LOOKUP *pLookup,
+                                                                               GMM_RESOURCE_USAGE_TYPE        ResUsage,
+                                                                               GMM_RESOURCE_USAGE_TYPE        Usage)
+{
+    const GMM_CACHE_POLICY_LOOKUP *pEntry = &pLookup[Usage];
+
+    return pEntry->MemoryObject[(pEntry->OverrideMask & pLookup[ResUsage].IDCode) != 0];
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Table lookup equivalent of GmmCachePolicyGetPteType().
+/// @param[in]  pLookup: Cache policy lookup table of the lib context
+/// @param[in]  Usage: Usage of the resource
+/// @return     PTE cache control bits
+/////////////////////////////////////////////////////////////////////////////////////
+static GMM_INLINE GMM_PTE_CACHE_CONTROL_BITS GmmCachePolicyLookupPteType(const GMM_CACHE_POLICY_LOOKUP *pLookup,
+                                                                        GMM_RESOURCE_USAGE_TYPE        Usage)
+{
+    return pLookup[Usage].PTE;
+}
+
 // One entry in the SKL/CNL cache lookup table
 typedef struct GMM_CACHE_POLICY_TBL_ELEMENT_REC {
     union {
@@ -361,6 +435,45 @@ typedef union GMM_PRIVATE_PAT_REC {
 
 #endif // #if _WIN32
 
+#if(!defined(_WIN32) && !defined(__GMM_KMD__))
+
+#define GMM_CACHE_POLICY_FILE_OVERRIDE_SUPPORTED 1
+
+// Text file of per-usage overrides applied by the cache policy init, see
+// GmmCachePolicyCommon::OverrideCachePolicyFromFile(). Off when not set.
+#define GMM_CACHE_POLICY_OVERRIDE_FILE_ENV      "GMM_CACHE_POLICY_OVERRIDE_FILE"
+#define GMM_CACHE_POLICY_OVERRIDE_MAX_LINE      512
+
+#endif
+
+//===========================================================================
+// typedef:
+//      GMM_CACHE_POLICY_FIELD
+//
+// Description:
+//      Bits naming the GMM_CACHE_POLICY_ELEMENT fields a generation defines
+//      its cache policy with, for validating overrides against.
+//----------------------------------------------------------------------------
+typedef enum GMM_CACHE_POLICY_FIELD_ENUM
+{
+    GMM_CACHE_POLICY_FIELD_LLC          = 0x0001,
+    GMM_CACHE_POLICY_FIELD_ELLC         = 0x0002,
+    GMM_CACHE_POLICY_FIELD_L3           = 0x0004,
+    GMM_CACHE_POLICY_FIELD_WT           = 0x0008,
+    GMM_CACHE_POLICY_FIELD_AGE          = 0x0010,
+    GMM_CACHE_POLICY_FIELD_AOM          = 0x0020,
+    GMM_CACHE_POLICY_FIELD_LECC_SCC     = 0x0040,
+    GMM_CACHE_POLICY_FIELD_L3_SCC       = 0x0080,
+    GMM_CACHE_POLICY_FIELD_SCF          = 0x0100,
+    GMM_CACHE_POLICY_FIELD_SSO          = 0x0200,
+    GMM_CACHE_POLICY_FIELD_COS          = 0x0400,
+    GMM_CACHE_POLICY_FIELD_HDCL1        = 0x0800,
+    GMM_CACHE_POLICY_FIELD_L3_EVICTION  = 0x1000,
+    GMM_CACHE_POLICY_FIELD_GLB_GO       = 0x2000,
+    GMM_CACHE_POLICY_FIELD_UC_LOOKUP    = 0x4000,
+    GMM_CACHE_POLICY_FIELD_L1CC         = 0x8000,
+} GMM_CACHE_POLICY_FIELD;
+
 #if __cplusplus
 #include "GmmCachePolicyCommon.h"
 #include "CachePolicy/GmmCachePolicyGen8.h"
@@ -60,6 +60,9 @@ namespace GmmLib
             #if _WIN32
             void OverrideCachePolicy();
             #endif
+            #ifdef GMM_CACHE_POLICY_FILE_OVERRIDE_SUPPORTED
+            GMM_STATUS OverrideCachePolicyFromFile(uint32_t Fields);
+            #endif
             GMM_GFX_MEMORY_TYPE GetWantedMemoryType(GMM_CACHE_POLICY_ELEMENT CachePolicy);
 
             #define DEFINE_CP_ELEMENT(Usage, llc, ellc, l3, wt, age, aom, lecc_scc, l3_scc, scf, sso, cos, hdcl1, l3evict, segov, glbgo, uclookup, l1cc)               \
@@ -87,6 +90,22 @@ namespace GmmLib
             MEMORY_OBJECT_CONTROL_STATE GMM_STDCALL CachePolicyGetOriginalMemoryObject(GMM_RESOURCE_INFO *pResInfo);
             MEMORY_OBJECT_CONTROL_STATE GMM_STDCALL CachePolicyGetMemoryObject(GMM_RESOURCE_INFO *pResInfo, GMM_RESOURCE_USAGE_TYPE Usage);
             GMM_PTE_CACHE_CONTROL_BITS GMM_STDCALL CachePolicyGetPteType(GMM_RESOURCE_USAGE_TYPE Usage);
+            void GMM_STDCALL InitCachePolicyLookup(GMM_CACHE_POLICY_LOOKUP *pLookup);
+            static const char *GMM_STDCALL GetUsageName(GMM_RESOURCE_USAGE_TYPE Usage);
+
+            /////////////////////////////////////////////////////////////////////
+            /// Saves/restores the object state InitCachePolicy() leaves behind,
+            /// so a context can load generated tables instead of running it.
+            /// @param  pState: GMM_CACHE_POLICY_STATE_SIZE words
+            /////////////////////////////////////////////////////////////////////
+            virtual void SaveState(uint32_t *pState)
+            {
+                GMM_UNREFERENCED_PARAMETER(pState);
+            }
+            virtual void RestoreState(const uint32_t *pState)
+            {
+                GMM_UNREFERENCED_PARAMETER(pState);
+            }
 
             /* Virtual functions prototype*/
             virtual uint8_t GMM_STDCALL CachePolicyIsUsagePTECached(GMM_RESOURCE_USAGE_TYPE Usage) = 0;
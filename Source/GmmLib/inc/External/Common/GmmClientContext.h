@@ -174,6 +174,19 @@ namespace GmmLib
 #ifndef __GMM_KMD__
         GMM_VIRTUAL GMM_RESOURCE_INFO *GMM_STDCALL      CreateCustomResInfoObject_2(GMM_RESCREATE_CUSTOM_PARAMS_2 *pCreateParams);
 #endif
+        GMM_VIRTUAL GMM_STATUS GMM_STDCALL              EstimateResourceSize(GMM_RESCREATE_PARAMS *pCreateParams, GMM_RESOURCE_SIZE_INFO *pSizeInfo);
+        GMM_VIRTUAL uint32_t GMM_STDCALL                SerializeResInfoObject(GMM_RESOURCE_INFO *pResInfo, void *pBlob, uint32_t BlobSize);
+        GMM_VIRTUAL GMM_RESOURCE_INFO *GMM_STDCALL      ImportResInfoObject(const void *pBlob, uint32_t BlobSize, void *pPreallocatedResInfo);
+        GMM_VIRTUAL void GMM_STDCALL                    EnablePaddingStats(uint8_t Enable);
+        GMM_VIRTUAL GMM_STATUS GMM_STDCALL              GetPaddingStats(GMM_RESOURCE_PADDING_STATS *pStats);
+        GMM_VIRTUAL void GMM_STDCALL                    DumpPaddingStats();
+        GMM_VIRTUAL void GMM_STDCALL                    GetDefaultTileCostModel(const GMM_RESCREATE_PARAMS *pCreateParams, GMM_TILE_COST_MODEL *pCostModel);
+        GMM_VIRTUAL GMM_STATUS GMM_STDCALL              SelectTileMode(GMM_RESCREATE_PARAMS *pCreateParams, const GMM_TILE_COST_MODEL *pCostModel, GMM_TILE_SELECT_RESULT *pResult);
+        GMM_VIRTUAL GMM_STATUS GMM_STDCALL              GetLibInitStats(GMM_LIB_INIT_STATS *pStats);
+        GMM_VIRTUAL const GMM_CACHE_POLICY_LOOKUP*      GMM_STDCALL GetCachePolicyLookup();
+        GMM_VIRTUAL void GMM_STDCALL                    EnableCachePolicyStats(uint8_t Enable);
+        GMM_VIRTUAL GMM_STATUS GMM_STDCALL              GetCachePolicyStats(GMM_CACHE_POLICY_STATS *pStats);
+        GMM_VIRTUAL void GMM_STDCALL                    DumpCachePolicyStats();
     };
 }
 
@@ -56,6 +56,107 @@ typedef struct GMM_UMD_CONTEXT_REC
 } GMM_UMD_CONTEXT;
 
 
+//===========================================================================
+// typedef:
+//      GMM_LIB_SUBSYSTEM
+//
+// Description:
+//      Subsystems of a GmmLib::Context. Platform info and texture calc are set up
+//      by InitContext, the others are initialized on first use.
+//----------------------------------------------------------------------------
+typedef enum GMM_LIB_SUBSYSTEM_REC
+{
+    GMM_LIB_SUBSYSTEM_PLATFORM_INFO,
+    GMM_LIB_SUBSYSTEM_CACHE_POLICY,
+    GMM_LIB_SUBSYSTEM_TEXTURE_CALC,
+    GMM_LIB_SUBSYSTEM_LAYOUT_CACHE,
+    GMM_LIB_SUBSYSTEMS
+} GMM_LIB_SUBSYSTEM;
+
+#define GMM_LIB_SUBSYSTEM_BIT(Subsystem)    (1u << (Subsystem))
+
+// Shared tables replaced by copy-on-write a context keeps inline, further ones
+// are chained in blocks of the same size, see GmmLib::Context::RetireTable()
+#define GMM_LIB_MAX_RETIRED_TABLES          8
+
+//===========================================================================
+// typedef:
+//      GMM_LIB_RETIRED_TABLES
+//
+// Description:
+//      Block of shared tables a context replaced by copy-on-write while other
+//      threads may still be reading them. Kept until the context is destroyed.
+//----------------------------------------------------------------------------
+typedef struct GMM_LIB_RETIRED_TABLES_REC
+{
+    const void                          *pTables[GMM_LIB_MAX_RETIRED_TABLES];
+    uint32_t                            NumTables;
+    struct GMM_LIB_RETIRED_TABLES_REC   *pNext;     // Older, full blocks
+} GMM_LIB_RETIRED_TABLES;
+
+//===========================================================================
+// typedef:
+//      GMM_LIB_INIT_STATS
+//
+// Description:
+//      Startup timings of a lib context in nanoseconds. A lazily initialized
+//      subsystem reports the time of its first use once it has been used.
+//----------------------------------------------------------------------------
+typedef struct GMM_LIB_INIT_STATS_REC
+{
+    uint64_t    MultiAdapterContextNs;                  // GmmCreateMultiAdapterContext, process wide
+    uint64_t    LibContextNs;                           // GmmCreateLibContext that created this context
+    uint64_t    SubsystemNs[GMM_LIB_SUBSYSTEMS];        // Per subsystem, indexed by GMM_LIB_SUBSYSTEM
+    uint32_t    InitializedMask;                        // GMM_LIB_SUBSYSTEM_BIT of initialized subsystems
+    uint32_t    ReusedMask;                             // GMM_LIB_SUBSYSTEM_BIT of subsystems loaded from tables
+                                                        // an earlier context generated for the same configuration
+} GMM_LIB_INIT_STATS;
+
+#define GMM_CACHE_POLICY_STATE_SIZE         4
+
+//===========================================================================
+// typedef:
+//      GMM_CACHE_POLICY_TABLES
+//
+// Description:
+//      Everything the cache policy init of a context produces. It depends on the
+//      platform and SKU/WA/GT system info only, so it is generated once per such
+//      configuration and later contexts load it instead of running the init.
+//----------------------------------------------------------------------------
+typedef struct GMM_CACHE_POLICY_TABLES_REC
+{
+    uint32_t                        State[GMM_CACHE_POLICY_STATE_SIZE];             // See GmmCachePolicyCommon::SaveState()
+    GMM_CACHE_POLICY_ELEMENT        CachePolicy[GMM_RESOURCE_USAGE_MAX];
+    GMM_CACHE_POLICY_TBL_ELEMENT    CachePolicyTbl[GMM_MAX_NUMBER_MOCS_INDEXES];
+    GMM_CACHE_POLICY_LOOKUP         Lookup[GMM_CACHE_POLICY_LOOKUP_ENTRIES];
+} GMM_CACHE_POLICY_TABLES;
+
+//===========================================================================
+// typedef:
+//      GMM_CACHE_POLICY_KEY
+//
+// Description:
+//      Inputs GMM_CACHE_POLICY_TABLES are derived from. Kept with the shared
+//      tables and compared in full when a later context looks them up.
+//----------------------------------------------------------------------------
+typedef struct GMM_CACHE_POLICY_KEY_REC
+{
+    PLATFORM                        Platform;
+    SKU_FEATURE_TABLE               SkuTable;
+    WA_TABLE                        WaTable;
+    GT_SYSTEM_INFO                  GtSysInfo;
+} GMM_CACHE_POLICY_KEY;
+
+// Threads count cache policy queries into GMM_CACHE_POLICY_STATS_SHARDS copies of
+// the counters, summed on read, so concurrent queries rarely share cache lines.
+#define GMM_CACHE_POLICY_STATS_SHARDS       16
+
+typedef struct GMM_CACHE_POLICY_STATS_SHARD_REC
+{
+    GMM_CACHE_POLICY_STATS          Stats;
+    uint8_t                         Pad[64];
+} GMM_CACHE_POLICY_STATS_SHARD;
+
 #if (!defined(__GMM_KMD__) && !defined(GMM_UNIFIED_LIB))
 #include "GmmClientContext.h"
 #endif
@@ -74,6 +175,11 @@ typedef struct GMM_UMD_CONTEXT_REC
 #ifdef __cplusplus
 #include "GmmMemAllocator.hpp"
 
+namespace GmmLib
+{
+    class LayoutCache;
+}
+
 namespace GmmLib
 {
     class NON_PAGED_SECTION Context : public GmmMemAllocator
@@ -86,9 +192,12 @@ namespace GmmLib
         GMM_PLATFORM_INFO_CLASS*         pPlatformInfo;
 
         GMM_TEXTURE_CALC*                pTextureCalc;
-        SKU_FEATURE_TABLE                SkuTable;
-        WA_TABLE                         WaTable;
-        GT_SYSTEM_INFO                   GtSysInfo;
+        LayoutCache*                     pLayoutCache;
+        // Interned with GmmLib::SharedTable, so adapters with identical tables share
+        // one read-only copy. Updates go through the *ForUpdate() accessors.
+        const SKU_FEATURE_TABLE          *pSkuTable;
+        const WA_TABLE                   *pWaTable;
+        const GT_SYSTEM_INFO             *pGtSysInfo;
 
     #if(defined(__GMM_KMD__))
         GMM_GTT_CONTEXT              GttContext;
@@ -99,8 +208,13 @@ namespace GmmLib
         void                             *pKmdHwDev;
         void                             *pUmdAdapter;
 
-        GMM_CACHE_POLICY_ELEMENT         CachePolicy[GMM_RESOURCE_USAGE_MAX];
-        GMM_CACHE_POLICY_TBL_ELEMENT     CachePolicyTbl[GMM_MAX_NUMBER_MOCS_INDEXES];
+        // Private while the cache policy is initialized, interned afterwards under
+        // pCachePolicyKey. The pointers below point into it.
+        const GMM_CACHE_POLICY_TABLES    *pCachePolicyTables;
+        GMM_CACHE_POLICY_KEY             *pCachePolicyKey;    // Private, until the tables are interned
+        GMM_CACHE_POLICY_ELEMENT         *pCachePolicy;       // [GMM_RESOURCE_USAGE_MAX]
+        GMM_CACHE_POLICY_TBL_ELEMENT     *pCachePolicyTbl;    // [GMM_MAX_NUMBER_MOCS_INDEXES]
+        const GMM_CACHE_POLICY_LOOKUP    *pCachePolicyLookup; // [GMM_CACHE_POLICY_LOOKUP_ENTRIES], NULL until initialized
         GMM_CACHE_POLICY                 *pGmmCachePolicy;
 
     #if(defined(__GMM_KMD__))
@@ -113,6 +227,26 @@ namespace GmmLib
         uint32_t               AllowedPaddingFor64KbPagesPercentage;
         uint64_t              InternalGpuVaMax;
         uint32_t               AllowedPaddingFor64KBTileSurf;
+
+        // Padding-waste accounting of created resources, off by default
+        uint8_t                          PaddingStatsEnabled;
+        GMM_RESOURCE_PADDING_STATS       PaddingStats;
+
+        // Cache policy query counters, off by default. Allocated on first enable.
+        uint8_t                          CachePolicyStatsEnabled;
+        GMM_CACHE_POLICY_STATS_SHARD     *pCachePolicyStats;    // [GMM_CACHE_POLICY_STATS_SHARDS]
+
+        // Subsystems initialized on first use, see EnsureSubsystem()
+        uint32_t                         SubsystemInitMask;     // GMM_LIB_SUBSYSTEM_BIT of completed subsystems
+        uint32_t                         SubsystemBusyMask;     // Subsystems being initialized, under SubsystemInitMutex
+        GMM_LIB_INIT_STATS               InitStats;
+#if(!defined(__GMM_KMD__))
+        GMM_MUTEX_HANDLE                 SubsystemInitMutex;    // Recursive, init may read its own tables back
+#endif
+
+        // Shared tables replaced by copy-on-write that other threads may still be
+        // reading, released by DestroyContext
+        GMM_LIB_RETIRED_TABLES           RetiredTables;
 #ifdef GMM_LIB_DLL
         // Mutex Object used for synchronization of ProcessSingleton Context
         static GMM_MUTEX_HANDLE           SingletonContextSyncMutex;
@@ -196,7 +330,8 @@ namespace GmmLib
         /////////////////////////////////////////////////////////////////////////
         GMM_INLINE GMM_CACHE_POLICY_ELEMENT*  GMM_STDCALL GetCachePolicyUsage()
         {
-            return (&CachePolicy[0]);
+            EnsureSubsystem(GMM_LIB_SUBSYSTEM_CACHE_POLICY);
+            return (pCachePolicy);
         }
 
         /////////////////////////////////////////////////////////////////////////
@@ -205,7 +340,19 @@ namespace GmmLib
         /////////////////////////////////////////////////////////////////////////
         GMM_INLINE GMM_CACHE_POLICY_TBL_ELEMENT*  GMM_STDCALL GetCachePolicyTlbElement()
         {
-            return (&CachePolicyTbl[0]);
+            EnsureSubsystem(GMM_LIB_SUBSYSTEM_CACHE_POLICY);
+            return (pCachePolicyTbl);
+        }
+
+        /////////////////////////////////////////////////////////////////////////
+        /// Returns the precomputed MOCS/PTE lookup table
+        /// @return   const lookup table ptr, NULL while the cache policy is
+        ///           being initialized
+        /////////////////////////////////////////////////////////////////////////
+        GMM_INLINE const GMM_CACHE_POLICY_LOOKUP*  GMM_STDCALL GetCachePolicyLookup()
+        {
+            EnsureSubsystem(GMM_LIB_SUBSYSTEM_CACHE_POLICY);
+            return (pCachePolicyLookup);
         }
 
         /////////////////////////////////////////////////////////////////////////
@@ -217,6 +364,16 @@ namespace GmmLib
             return (pTextureCalc);
         }
 
+        /////////////////////////////////////////////////////////////////////////
+        /// Returns the persistent layout cache object ptr
+        /// @return   LayoutCache ptr, NULL if layout caching is off
+        /////////////////////////////////////////////////////////////////////////
+        GMM_INLINE LayoutCache* GMM_STDCALL GetLayoutCache()
+        {
+            EnsureSubsystem(GMM_LIB_SUBSYSTEM_LAYOUT_CACHE);
+            return (pLayoutCache);
+        }
+
         /////////////////////////////////////////////////////////////////////////
         /// Returns the platform info class object ptr
         /// @return   PlatformInfo class object ptr
@@ -232,6 +389,7 @@ namespace GmmLib
         /////////////////////////////////////////////////////////////////////////
         GMM_INLINE GMM_CACHE_POLICY* GMM_STDCALL GetCachePolicyObj()
         {
+            EnsureSubsystem(GMM_LIB_SUBSYSTEM_CACHE_POLICY);
             return (pGmmCachePolicy);
         }
 
@@ -241,7 +399,7 @@ namespace GmmLib
         /////////////////////////////////////////////////////////////////////////
         GMM_INLINE const SKU_FEATURE_TABLE& GMM_STDCALL GetSkuTable()
         {
-            return (SkuTable);
+            return (*pSkuTable);
         }
 
         /////////////////////////////////////////////////////////////////////////
@@ -250,7 +408,7 @@ namespace GmmLib
         /////////////////////////////////////////////////////////////////////////
         GMM_INLINE const WA_TABLE& GMM_STDCALL GetWaTable()
         {
-            return (WaTable);
+            return (*pWaTable);
         }
 
         /////////////////////////////////////////////////////////////////////////
@@ -259,17 +417,12 @@ namespace GmmLib
         /////////////////////////////////////////////////////////////////////////
         GMM_INLINE const GT_SYSTEM_INFO* GMM_STDCALL GetGtSysInfoPtr()
         {
-            return (&GtSysInfo);
+            return (pGtSysInfo);
         }
 
-        /////////////////////////////////////////////////////////////////////////
-        /// Returns the GT system info ptr
-        /// @return   GtSysInfo ptr
-        /////////////////////////////////////////////////////////////////////////
-        GMM_INLINE GT_SYSTEM_INFO* GMM_STDCALL GetGtSysInfo()
-        {
-            return (&GtSysInfo);
-        }
+        GT_SYSTEM_INFO*    GMM_STDCALL GetGtSysInfo();
+        WA_TABLE*          GMM_STDCALL GetWaTableForUpdate();
+        SKU_FEATURE_TABLE* GMM_STDCALL GetSkuTableForUpdate();
 
         /////////////////////////////////////////////////////////////////////////
         /// Returns Cache policy element for a given usage type
@@ -277,7 +430,8 @@ namespace GmmLib
         ////////////////////////////////////////////////////////////////////////
         GMM_INLINE GMM_CACHE_POLICY_ELEMENT GetCachePolicyElement(GMM_RESOURCE_USAGE_TYPE Usage)
         {
-            return (CachePolicy[Usage]);
+            EnsureSubsystem(GMM_LIB_SUBSYSTEM_CACHE_POLICY);
+            return (pCachePolicy[Usage]);
         }
 
         /////////////////////////////////////////////////////////////////////////
@@ -309,6 +463,55 @@ namespace GmmLib
             AllowedPaddingFor64KBTileSurf = Value;
         }
 
+        /////////////////////////////////////////////////////////////////////////
+        /// Returns whether created resources are added to the padding stats
+        /////////////////////////////////////////////////////////////////////////
+        GMM_INLINE uint8_t IsPaddingStatsEnabled()
+        {
+            return (PaddingStatsEnabled);
+        }
+
+        void GMM_STDCALL EnablePaddingStats(uint8_t Enable);
+        void GMM_STDCALL AccountPadding(const GMM_RESOURCE_PADDING_INFO &PaddingInfo);
+        void GMM_STDCALL GetPaddingStats(GMM_RESOURCE_PADDING_STATS &Stats);
+        void GMM_STDCALL DumpPaddingStats();
+
+        /////////////////////////////////////////////////////////////////////////
+        /// Returns whether cache policy queries are counted
+        /////////////////////////////////////////////////////////////////////////
+        GMM_INLINE uint8_t IsCachePolicyStatsEnabled()
+        {
+            return (CachePolicyStatsEnabled);
+        }
+
+        void GMM_STDCALL EnableCachePolicyStats(uint8_t Enable);
+        void GMM_STDCALL CountMocsQuery(GMM_RESOURCE_USAGE_TYPE Usage, MEMORY_OBJECT_CONTROL_STATE MOCS, uint8_t Override);
+        void GMM_STDCALL CountPteQuery(GMM_RESOURCE_USAGE_TYPE Usage, uint8_t Cached);
+        void GMM_STDCALL GetCachePolicyStats(GMM_CACHE_POLICY_STATS &Stats);
+        void GMM_STDCALL DumpCachePolicyStats();
+
+        /////////////////////////////////////////////////////////////////////////
+        /// Initializes a subsystem on first use. Cheap once it is initialized.
+        /// @param[in]  Subsystem: subsystem about to be accessed
+        /////////////////////////////////////////////////////////////////////////
+        GMM_INLINE void EnsureSubsystem(GMM_LIB_SUBSYSTEM Subsystem)
+        {
+        #if defined(_WIN32)
+            uint32_t InitMask = *(volatile uint32_t *)&SubsystemInitMask;
+        #else
+            uint32_t InitMask = __atomic_load_n(&SubsystemInitMask, __ATOMIC_ACQUIRE);
+        #endif
+            if(!(InitMask & GMM_LIB_SUBSYSTEM_BIT(Subsystem)))
+            {
+                InitSubsystem(Subsystem);
+            }
+        }
+
+        GMM_STATUS GMM_STDCALL InitSubsystem(GMM_LIB_SUBSYSTEM Subsystem);
+        void GMM_STDCALL SetLibContextInitTime(uint64_t TimeNs);
+        void GMM_STDCALL GetInitStats(GMM_LIB_INIT_STATS &Stats);
+        void GMM_STDCALL DumpInitStats();
+
     #ifdef GMM_LIB_DLL
         ADAPTER_BDF             sBdf;
         #ifdef _WIN32
@@ -488,26 +691,12 @@ namespace GmmLib
         ////////////////////////////////////////////////////////////////////////
         GMM_INLINE GMM_CACHE_POLICY_TBL_ELEMENT GetCachePolicyTblElement(GMM_RESOURCE_USAGE_TYPE Usage)
         {
-            return (CachePolicyTbl[Usage]);
+            EnsureSubsystem(GMM_LIB_SUBSYSTEM_CACHE_POLICY);
+            return (pCachePolicyTbl[Usage]);
         }
 
-        /////////////////////////////////////////////////////////////////////////
-        /// Resets  the sku Table after  GmmInitContext() could have changed them
-        /// since original latching
-        ////////////////////////////////////////////////////////////////////////
-        GMM_INLINE void SetSkuTable(SKU_FEATURE_TABLE SkuTable)
-        {
-            this->SkuTable = SkuTable;
-        }
-
-        /////////////////////////////////////////////////////////////////////////
-        /// Resets  the Wa Table after  GmmInitContext() could have changed them
-        /// since original latching
-        ////////////////////////////////////////////////////////////////////////
-        GMM_INLINE void SetWaTable(WA_TABLE WaTable)
-        {
-            this->WaTable = WaTable;
-        }
+        void GMM_STDCALL SetSkuTable(SKU_FEATURE_TABLE SkuTable);
+        void GMM_STDCALL SetWaTable(WA_TABLE WaTable);
 
     #if(_DEBUG || _RELEASE_INTERNAL)
 
@@ -563,10 +752,28 @@ namespace GmmLib
     
     private: 
         void GMM_STDCALL OverrideSkuWa();
+        void GMM_STDCALL RetireTable(const void *pTable);
+        void GMM_STDCALL ReleaseTables();
+        void GMM_STDCALL SetCachePolicyTables(const GMM_CACHE_POLICY_TABLES *pTables);
+        void GMM_STDCALL LoadCachePolicyTables();
     };
 
 // Max number of Multi-Adapters allowed in the system
 #define MAX_NUM_ADAPTERS      9
+
+// Number of slots in the open-addressed adapter table. Must be a power of two and
+// at least twice MAX_NUM_ADAPTERS so that probe sequences stay short.
+#define GMM_ADAPTER_TABLE_SIZE          32
+
+// Adapter slot key states. A live slot's key is the packed Bus/Device/Function
+// with GMM_ADAPTER_SLOT_ACTIVE set; a released slot keeps the packed BDF with
+// GMM_ADAPTER_SLOT_TOMBSTONE set instead, so that probe sequences of the remaining
+// adapters stay intact and the adapter gets its own slot back when it returns.
+#define GMM_ADAPTER_SLOT_EMPTY          0x00000000
+#define GMM_ADAPTER_SLOT_ACTIVE         0x80000000
+#define GMM_ADAPTER_SLOT_TOMBSTONE      0x40000000
+#define GMM_ADAPTER_RELEASED_KEY(Key)   (((Key) & ~GMM_ADAPTER_SLOT_ACTIVE) | GMM_ADAPTER_SLOT_TOMBSTONE)
+
 //===========================================================================
 // typedef:
 //      _GMM_ADAPTER_INFO_
@@ -577,10 +784,10 @@ namespace GmmLib
 typedef struct _GMM_ADAPTER_INFO_
 {
     Context             *pGmmLibContext;                    // Gmm UMD Lib Context which is process Singleton
-    int32_t             RefCount;                           // Ref Count for the number of Gmm UMD Lib process Singleton Context created per Process
-    GMM_MUTEX_HANDLE    SyncMutex;                          // SyncMutex to protect access of Gmm UMD Lib process Singleton Context 
+    int32_t             RefCount;                           // Ref Count for the number of Gmm UMD Lib process Singleton Context created per Process, accessed atomically
+    GMM_MUTEX_HANDLE    SyncMutex;                          // SyncMutex to protect access of Gmm UMD Lib process Singleton Context, lives as long as the slot
     ADAPTER_BDF         sBdf;                               // Adpater's Bus, Device and Function info for which Gmm UMD Lib process Singleton Context is created
-    _GMM_ADAPTER_INFO_  *pNext;                             // Linked List Next pointer to point to the Next Adapter node in the List
+    uint32_t            Key;                                // Slot key (GMM_ADAPTER_SLOT_*), published last so lock-free readers see an initialized node
 
 }GMM_ADAPTER_INFO;
     
@@ -591,15 +798,21 @@ typedef struct _GMM_ADAPTER_INFO_
     class NON_PAGED_SECTION GmmMultiAdapterContext : public GmmMemAllocator
     {
     private:
-        GMM_ADAPTER_INFO                AdapterInfo[MAX_NUM_ADAPTERS];// For Static Initialization of adapter.
+        GMM_ADAPTER_INFO                AdapterInfo[GMM_ADAPTER_TABLE_SIZE];// Open-addressed adapter table, keyed by BDF.
+                                                                            // Lookups are lock-free; insertion and release are
+                                                                            // serialized by MAContextSyncMutex. Slots are never
+                                                                            // freed, and only rebound to another BDF once no
+                                                                            // lock-free lookup is in flight, so a reader can
+                                                                            // never observe a dangling or foreign node.
         GMM_MUTEX_HANDLE                MAContextSyncMutex;         // SyncMutex to protect access of GmmMultiAdpaterContext
         uint32_t                        NumAdapters;
+        uint32_t                        NumLockFreeLookups;         // IncrementRefCountIfRegistered calls in flight
 	void*                           pCpuReserveBase;
 	uint64_t                        CpuReserveSize;
-        GMM_ADAPTER_INFO                *pHeadNode;// For dynamic Initialization of adapter.
-                                                   // The Multi-Adapter Initialization is done dynamiclly using a Linked list Vector
-                                                   // pHeadNode points to the root node of the linked list and registers the first
-                                                   // adapter received from UMD.
+
+        static uint32_t GMM_STDCALL     GetAdapterKey(ADAPTER_BDF sBdf);
+        static uint32_t GMM_STDCALL     GetAdapterHash(uint32_t Key);
+        void GMM_STDCALL                WaitForLockFreeLookups();
     public:
         //Constructors and destructors
         GmmMultiAdapterContext();
@@ -617,9 +830,11 @@ typedef struct _GMM_ADAPTER_INFO_
         /* Fucntions that update AdapterInfo*/
         int32_t GMM_STDCALL             IncrementRefCount(ADAPTER_BDF sBdf);
         int32_t GMM_STDCALL             DecrementRefCount(ADAPTER_BDF sBdf);
+        bool GMM_STDCALL                IncrementRefCountIfRegistered(ADAPTER_BDF sBdf);
+        bool GMM_STDCALL                DecrementRefCountIfShared(ADAPTER_BDF sBdf);
         GMM_STATUS GMM_STDCALL          LockSingletonContextSyncMutex(ADAPTER_BDF sBdf);
         GMM_STATUS GMM_STDCALL          UnlockSingletonContextSyncMutex(ADAPTER_BDF sBdf);
-        void *GMM_STDCALL               GetAdapterNode(ADAPTER_BDF sBdf); // Replacemet for GetAdapterIndex, now get adapter info from a node in the linked list
+        void *GMM_STDCALL               GetAdapterNode(ADAPTER_BDF sBdf); // Lock-free lookup of the adapter's slot in the adapter table
     }; // GmmMultiAdapterContext
 
 } //namespace
@@ -672,8 +887,14 @@ extern "C" {
 }
 #endif /*__cplusplus*/
 
+#ifdef __cplusplus
+    // Resolved inline against the context; avoids an out-of-line C-wrapper call per use.
+    #define GMM_OVERRIDE_PLATFORM_INFO(pTexInfo,pGmmLibContext)    ((const GMM_PLATFORM_INFO *)&((pGmmLibContext)->GetPlatformInfo()))
+    #define GMM_OVERRIDE_TEXTURE_CALC(pTexInfo,pGmmLibContext)     ((pGmmLibContext)->GetTextureCalc())
+#else
     #define GMM_OVERRIDE_PLATFORM_INFO(pTexInfo,pGmmLibContext)    (GmmGetPlatformInfo(pGmmLibContext))
     #define GMM_OVERRIDE_TEXTURE_CALC(pTexInfo,pGmmLibContext)     (GmmGetTextureCalc(pGmmLibContext))
+#endif
 
 #ifdef __GMM_KMD__
     #define GMM_OVERRIDE_EXPORTED_PLATFORM_INFO(pTexInfo)    GMM_OVERRIDE_PLATFORM_INFO(pTexInfo)
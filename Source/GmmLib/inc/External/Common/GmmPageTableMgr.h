@@ -62,6 +62,29 @@ typedef struct __GMM_DDI_UPDATEAUXTABLE
     uint8_t DoNotWait;                    // [in]  specifies if PageTable update be done on CPU (true) or GPU (false)
 }GMM_DDI_UPDATEAUXTABLE;
 
+// Mapped resource, as recorded by UpdateAuxTable
+typedef struct __GMM_AUXTT_MAPPING_INFO
+{
+    GMM_GFX_ADDRESS BaseGpuVA;            // [out] GPUVA where compressed resource is mapped
+    GMM_GFX_SIZE_T  Size;                 // [out] main-surface size in bytes
+    GMM_GFX_ADDRESS AuxSurfVA;            // [out] GPUVA of its (unified or separate) Auxiliary surface
+    GMM_RESOURCE_INFO * BaseResInfo;      // [out] GmmResourceInfo ptr for compressed resource
+    GMM_RESOURCE_INFO * AuxResInfo;       // [out] GmmResourceInfo ptr for separate Auxiliary resource, NULL if unified
+}GMM_AUXTT_MAPPING_INFO;
+
+// Page-table pool footprint and reclamation counters
+typedef struct __GMM_PAGETABLE_POOL_STATS
+{
+    uint32_t       NumPools;              // page-table pools currently allocated
+    uint32_t       NumUnusedPools;        // pools with no table assigned
+    GMM_GFX_SIZE_T Footprint;             // bytes of allocated pools
+    GMM_GFX_SIZE_T PeakFootprint;         // max. Footprint since creation
+    uint64_t       NumPoolsReleased;      // unused pools freed by reclamation
+    uint64_t       NumPoolWaits;          // of which freed after CPU wait, being busy above high watermark
+    uint64_t       NumBusySkipped;        // reclamation candidates kept as GPU may still access them
+    GMM_GFX_SIZE_T MetadataSize[4];       // host bytes of pool bookkeeping, indexed by POOL_TYPE
+}GMM_PAGETABLE_POOL_STATS;
+
 #ifdef __cplusplus
 #include "GmmMemAllocator.hpp"
 
@@ -79,6 +102,7 @@ namespace GmmLib
 
      //Forward class declarations
      class AuxTable;
+     class AuxTableUpdateQueue;
      class GmmPageTablePool;
      typedef class GmmPageTablePool GMM_PAGETABLEPool;
 
@@ -88,6 +112,7 @@ namespace GmmLib
          POOL_TYPE_TRTTL2  = 1,
          POOL_TYPE_AUXTTL1 = 2,
          POOL_TYPE_AUXTTL2 = 3,
+         POOL_TYPE_MAX
      } POOL_TYPE;
 
     //////////////////////////////////////////////////////////////////////////////////////////////
@@ -116,6 +141,17 @@ namespace GmmLib
         GMM_DEVICE_CALLBACKS_INT DeviceCbInt;       //OS-specific defn: Will be used internally GMM lib
         GMM_TRANSLATIONTABLE_CALLBACKS TTCb; //OS-specific defn
         HANDLE hCsr;  // OCL per-device command stream receiver handle for aubcapture
+    private:
+        // State added after the 12.1 interface goes below, so the members above keep
+        // the offsets clients were built with (they write TTCb/hCsr directly).
+        GMM_PAGETABLEPool *pFreePool[POOL_TYPE_MAX]; //Per-PoolType list of pools that may have free nodes
+        AuxTableUpdateQueue *pUpdateQueue;           //Deferred Aux-TT updates, allocated on first use
+        uint64_t PoolUseStamp;                       //Last stamp given to pool on release of its node (LRU order)
+        GMM_PAGETABLE_POOL_STATS PoolStats;          //Footprint/reclamation counters (PoolLock)
+        GMM_TRANSLATIONTABLE_CALLBACKS_EXT TTCbExt;  //Optional TT callbacks, see SetTranslationTableCallbacksExt
+#if defined  __linux__
+        pthread_mutex_t FlushLock;                   //Serializes FlushAuxTableUpdates, taken before AuxTable/Pool locks
+#endif
     public:
         GmmPageTableMgr();
         GmmPageTableMgr(GMM_DEVICE_CALLBACKS_INT *, uint32_t TTFlags, GmmClientContext  *pClientContextIn); // Allocates memory for indicate TT’s root-tables, initializes common node-pool
@@ -132,6 +168,9 @@ namespace GmmLib
                                                                        //for given host page VA  when base/Aux surf is mapped/unmapped
         GMM_VIRTUAL void __ReleaseUnusedPool(GMM_UMD_SYNCCONTEXT *UmdContext);
         GMM_VIRTUAL GMM_PAGETABLEPool * __GetFreePoolNode(uint32_t * FreePoolNodeIdx, POOL_TYPE PoolType);
+        uint8_t __ReleasePoolNode(GMM_PAGETABLEPool *Pool, int NodeIdx, int PerTableNodes);
+        void __AddToFreeList(GMM_PAGETABLEPool *Pool);
+        void __RemoveFromFreeList(GMM_PAGETABLEPool *Pool);
 
 
 #if defined __linux__
@@ -154,8 +193,32 @@ namespace GmmLib
             return pClientContext;
         }
 
+        //Deferred Aux TT management API, queued requests are applied as one batch
+        GMM_VIRTUAL GMM_STATUS QueueAuxTableUpdate(const GMM_DDI_UPDATEAUXTABLE*);
+        GMM_VIRTUAL GMM_STATUS FlushAuxTableUpdates(GMM_UMD_SYNCCONTEXT *UmdContext, uint8_t DoNotWait);
+        GMM_VIRTUAL void SetAuxTableUpdateThreshold(uint32_t Threshold);      //0: flush on explicit FlushAuxTableUpdates only
+
+        //Mapped Aux-TT range queries
+        GMM_VIRTUAL GMM_STATUS GetAuxTableMapping(GMM_GFX_ADDRESS GfxVA, GMM_AUXTT_MAPPING_INFO *pMapping);
+        GMM_VIRTUAL GMM_STATUS InvalidateAuxTableRange(GMM_UMD_SYNCCONTEXT *UmdContext, GMM_GFX_ADDRESS GfxVA, GMM_GFX_SIZE_T Size, uint8_t DoNotWait);
+
+        GMM_VIRTUAL GMM_STATUS GetPageTablePoolStats(GMM_PAGETABLE_POOL_STATS *pStats);
+
+        //Optional TT callbacks (ranged entry writes, pool busy query), set before first TT update
+        GMM_VIRTUAL GMM_STATUS SetTranslationTableCallbacksExt(const GMM_TRANSLATIONTABLE_CALLBACKS_EXT *pTTCbExt);
+
+        /////////////////////////////////////////////////////////////////////////////////////
+        /// Returns optional TT callbacks set by client
+        /// @return ::GMM_TRANSLATIONTABLE_CALLBACKS_EXT
+        /////////////////////////////////////////////////////////////////////////////////////
+        GMM_INLINE GMM_TRANSLATIONTABLE_CALLBACKS_EXT &GetTranslationTableCallbacksExt()
+        {
+            return TTCbExt;
+        }
+
     private:
         GMM_PAGETABLEPool * __AllocateNodePool(uint32_t AddrAlignment, POOL_TYPE Type);
+        void __UnlinkPool(GMM_PAGETABLEPool *Pool);
 
         GMM_INLINE GMM_LIB_CONTEXT *GetLibContext() 
         {
@@ -134,6 +134,7 @@ typedef struct GMM_RESOURCE_FLAG_REC
         uint32_t __PreWddm2SVM             : 1; // Internal GMM flag--Clients don't set.
         uint32_t Tile4                     : 1; // XE-HP 4KB tile
         uint32_t Tile64                    : 1; // XE-HP 64KB tile
+        uint32_t __SizeOnly                : 1; // Internal GMM flag--Clients don't set. Skips per-mip offset fill for size estimation.
     } Info;
 
     // Wa: Any Surface specific Work Around will go in here
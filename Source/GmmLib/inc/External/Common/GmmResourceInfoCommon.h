@@ -1920,6 +1920,9 @@ namespace GmmLib
 #ifndef __GMM_KMD__
             GMM_VIRTUAL GMM_STATUS GMM_STDCALL CreateCustomRes_2(Context &GmmLibContext, GMM_RESCREATE_CUSTOM_PARAMS_2 &CreateParams);
 #endif
+            GMM_VIRTUAL uint32_t   GMM_STDCALL SerializeLayout(void *pBlob, uint32_t BlobSize);
+            GMM_VIRTUAL GMM_STATUS GMM_STDCALL CreateFromLayout(Context &GmmLibContext, const void *pBlob, uint32_t BlobSize);
+            GMM_VIRTUAL void       GMM_STDCALL GetPaddingInfo(GMM_RESOURCE_PADDING_INFO &PaddingInfo);
 
     };
 
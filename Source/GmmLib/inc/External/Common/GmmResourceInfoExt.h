@@ -384,6 +384,249 @@ typedef struct GMM_RESCREATE_CUSTOM_PARAMS_2_REC : public GMM_RESCREATE_CUSTOM_P
 }GMM_RESCREATE_CUSTOM_PARAMS_2;
 #endif
 
+//===========================================================================
+// typedef:
+//     GMM_RESOURCE_SIZE_INFO
+//
+// Description:
+//     Sizes and alignment of a hypothetical resource, as returned by
+//     GmmClientContext::EstimateResourceSize(). Values match what the
+//     corresponding GMM_RESOURCE_INFO getters would return had the resource
+//     been created with the same GMM_RESCREATE_PARAMS.
+//---------------------------------------------------------------------------
+typedef struct GMM_RESOURCE_SIZE_INFO_REC
+{
+    GMM_GFX_SIZE_T                      SizeAllocation;  // GetSizeAllocation()
+    GMM_GFX_SIZE_T                      SizeMainSurface; // GetSizeMainSurface()
+    GMM_GFX_SIZE_T                      SizeAuxSurface;  // GetSizeAuxSurface(GMM_AUX_SURF)
+    uint32_t                            BaseAlignment;   // GetBaseAlignment()
+}GMM_RESOURCE_SIZE_INFO;
+
+//===========================================================================
+// typedef:
+//     GMM_RESOURCE_PADDING_INFO
+//
+// Description:
+//     Breakdown of the bytes a resource allocates beyond its natural (densely
+//     packed) texel footprint, as returned by
+//     GmmResourceInfoCommon::GetPaddingInfo(). LogicalSize plus all cause
+//     fields always sums to AllocationSize. The totals are exact; the split of
+//     main-surface padding between TileAlignment, MipTail and PlaneAlignment
+//     is an estimate derived from the final layout.
+//---------------------------------------------------------------------------
+typedef struct GMM_RESOURCE_PADDING_INFO_REC
+{
+    uint64_t                            LogicalSize;    // Texel bytes over all mips/slices/samples/planes
+    uint64_t                            AllocationSize; // GetSizeAllocation()
+    uint64_t                            TileAlignment;  // Pitch/height/QPitch/mip alignment of the main surface
+    uint64_t                            MipTail;        // Unused bytes of the packed mip tail slots
+    uint64_t                            Page64KB;       // Rounding of the total to a 64KB page
+    uint64_t                            Aux;            // Aux and secondary aux surfaces (CCS/MCS/HiZ/...)
+    uint64_t                            PlaneAlignment; // Gaps between planes of planar formats
+}GMM_RESOURCE_PADDING_INFO;
+
+//===========================================================================
+// typedef:
+//     GMM_RESOURCE_PADDING_STATS
+//
+// Description:
+//     Per-context sum of GMM_RESOURCE_PADDING_INFO over every resource created
+//     through GmmClientContext::CreateResInfoObject() since accounting was
+//     enabled with GmmClientContext::EnablePaddingStats(). Destroying a
+//     resource does not subtract from the totals.
+//---------------------------------------------------------------------------
+typedef struct GMM_RESOURCE_PADDING_STATS_REC
+{
+    uint64_t                            NumResources;
+    GMM_RESOURCE_PADDING_INFO           Total;
+}GMM_RESOURCE_PADDING_STATS;
+
+//===========================================================================
+// typedef:
+//     GMM_TILE_COST_MODEL / GMM_TILE_SELECT_RESULT
+//
+// Description:
+//     Inputs and diagnostics of GmmClientContext::SelectTileMode(), the "auto"
+//     tiling policy. Every candidate layout the request is eligible for is
+//     laid out and scored (lower is better) as:
+//         PaddingCost * (percent of padding over the logical size)
+//       + AccessWeight-weighted average of AccessCost[Tiling][]
+//       + AuxLossCost if compression was requested but the tiling can't carry it
+//       + Page4KBCost if the platform has 64KB pages but the layout doesn't get them
+//     Candidates over the caller's MaxPitch/MaxAllocationSize, the platform's
+//     pitch and surface size limits or the request's BaseAlignment are not
+//     selected. GmmClientContext::GetDefaultTileCostModel() fills in the built-in
+//     model, deriving the access weights from the request's usage flags.
+//---------------------------------------------------------------------------
+typedef enum GMM_TILE_SELECT_TILING_ENUM
+{
+    GMM_TILE_SELECT_LINEAR = 0,
+    GMM_TILE_SELECT_TILEX,
+    GMM_TILE_SELECT_TILE_4KB,   // TileY, or Tile4 on platforms without TileY
+    GMM_TILE_SELECT_TILEYF,
+    GMM_TILE_SELECT_TILE_64KB,  // TileYs, or Tile64 on platforms without TileY
+    GMM_TILE_SELECT_TILINGS
+} GMM_TILE_SELECT_TILING;
+
+typedef enum GMM_TILE_ACCESS_ENUM
+{
+    GMM_TILE_ACCESS_RENDER = 0,
+    GMM_TILE_ACCESS_SAMPLE,
+    GMM_TILE_ACCESS_DISPLAY,
+    GMM_TILE_ACCESS_CPU,
+    GMM_TILE_ACCESS_PATTERNS
+} GMM_TILE_ACCESS;
+
+typedef struct GMM_TILE_COST_MODEL_REC
+{
+    uint32_t                            AccessWeight[GMM_TILE_ACCESS_PATTERNS];                          // Relative frequency of each access pattern
+    uint32_t                            AccessCost[GMM_TILE_SELECT_TILINGS][GMM_TILE_ACCESS_PATTERNS];   // Cost of an access pattern on a tiling
+    uint32_t                            PaddingCost;    // Per percent of padding over the logical size
+    uint32_t                            AuxLossCost;    // Requested compression dropped
+    uint32_t                            Page4KBCost;    // 64KB pages available but not used
+    GMM_GFX_SIZE_T                      MaxPitch;           // Caller's render pitch limit in bytes, 0 for none
+    GMM_GFX_SIZE_T                      MaxAllocationSize;  // Caller's allocation size limit in bytes, 0 for none
+}GMM_TILE_COST_MODEL;
+
+#define GMM_TILE_SELECT_MAX_CANDIDATES  (GMM_TILE_SELECT_TILINGS * 2)
+
+typedef struct GMM_TILE_SELECT_SCORE_REC
+{
+    GMM_TILE_SELECT_TILING              Tiling;
+    uint8_t                             Page64KB;       // Allocation padded to 64KB pages
+    uint8_t                             AuxEligible;    // Requested compression kept
+    uint8_t                             Valid;          // Laid out and within the caller's and platform's limits
+    uint64_t                            AllocationSize;
+    uint64_t                            PaddingSize;    // AllocationSize - GMM_RESOURCE_PADDING_INFO.LogicalSize
+    uint64_t                            Score;          // Only meaningful when Valid
+}GMM_TILE_SELECT_SCORE;
+
+typedef struct GMM_TILE_SELECT_RESULT_REC
+{
+    uint32_t                            NumCandidates;
+    uint32_t                            Selected;       // Index into Candidates
+    GMM_TILE_SELECT_SCORE               Candidates[GMM_TILE_SELECT_MAX_CANDIDATES];
+}GMM_TILE_SELECT_RESULT;
+
+//===========================================================================
+// typedef:
+//     GMM_RESOURCE_LAYOUT_HEADER / GMM_RESOURCE_LAYOUT_SECTION
+//
+// Description:
+//     Versioned binary form of a resource's computed layout, produced by
+//     GmmClientContext::SerializeResInfoObject() and consumed by
+//     GmmClientContext::ImportResInfoObject(). The blob holds no pointers or
+//     process-local addresses, so it can be handed to another process (or
+//     another gmmlib build of the same layout version) running on the same
+//     platform. It is a header followed by NumSections sections, each an
+//     8-byte aligned GMM_RESOURCE_LAYOUT_SECTION plus Size bytes of payload.
+//     Payloads only hold fixed-width fields without implicit padding, and
+//     GMM_RESOURCE_FLAG bits are stored at fixed positions rather than as the
+//     compiler lays out the bitfields, so the blob doesn't depend on the
+//     compiler's layout of gmmlib's own structs.
+//     Readers skip section Ids they don't know.
+//---------------------------------------------------------------------------
+#define GMM_RESOURCE_LAYOUT_MAGIC   0x4C4D4D47 // "GMML"
+#define GMM_RESOURCE_LAYOUT_VERSION 2          // Bump on any payload layout change
+
+typedef enum GMM_RESOURCE_LAYOUT_SECTION_ID_ENUM
+{
+    GMM_LAYOUT_SECTION_INVALID = 0,
+    GMM_LAYOUT_SECTION_RESOURCE,     // GMM_RESOURCE_LAYOUT_RESOURCE
+    GMM_LAYOUT_SECTION_MAIN_SURF,    // GMM_RESOURCE_LAYOUT_SURFACE, incl. mip/plane offsets
+    GMM_LAYOUT_SECTION_AUX_SURF,     // GMM_RESOURCE_LAYOUT_SURFACE
+    GMM_LAYOUT_SECTION_AUX_SEC_SURF, // GMM_RESOURCE_LAYOUT_SURFACE
+} GMM_RESOURCE_LAYOUT_SECTION_ID;
+
+typedef struct GMM_RESOURCE_LAYOUT_HEADER_REC
+{
+    uint32_t                            Magic;            // GMM_RESOURCE_LAYOUT_MAGIC
+    uint16_t                            Version;          // GMM_RESOURCE_LAYOUT_VERSION
+    uint16_t                            NumSections;
+    uint32_t                            Size;             // Total blob size incl. this header
+    uint32_t                            Checksum;         // Over all bytes following this header
+    uint32_t                            ProductFamily;    // PRODUCT_FAMILY the layout was computed for
+    uint32_t                            RenderCoreFamily; // GFXCORE_FAMILY the layout was computed for
+    uint64_t                            Reserved;
+}GMM_RESOURCE_LAYOUT_HEADER;
+
+typedef struct GMM_RESOURCE_LAYOUT_SECTION_REC
+{
+    uint32_t                            Id;   // GMM_RESOURCE_LAYOUT_SECTION_ID
+    uint32_t                            Size; // Payload bytes following this section header
+}GMM_RESOURCE_LAYOUT_SECTION;
+
+typedef struct GMM_RESOURCE_LAYOUT_RESOURCE_REC
+{
+    uint32_t                            RotateInfo;
+    uint32_t                            MOCS;          // MEMORY_OBJECT_CONTROL_STATE.DwordValue at export
+    uint8_t                             MultiTileEnable;
+    uint8_t                             MultiTileInstanced;
+    uint8_t                             GpuVaMappingSet;
+    uint8_t                             LocalMemEligibilitySet;
+    uint8_t                             LocalMemPreferredSet;
+    uint8_t                             Reserved[3];
+}GMM_RESOURCE_LAYOUT_RESOURCE;
+
+#define GMM_RESOURCE_LAYOUT_OFFSET_WORDS 17 // 64-bit words of GMM_OFFSET_INFO
+#define GMM_RESOURCE_LAYOUT_MMC_ENTRIES  64 // GMM_MAX_MMC_INDEX
+
+// Payload of the surface sections, one GMM_TEXTURE_INFO. Process-local fields
+// (ExistingSysMem, debug Platform) are not part of it.
+typedef struct GMM_RESOURCE_LAYOUT_SURFACE_REC
+{
+    uint64_t                            BaseWidth;
+    uint64_t                            Pitch;
+    uint64_t                            OverridePitch;
+    uint64_t                            Size;
+    uint64_t                            CCSize;
+    uint64_t                            UnpaddedSize;
+    uint64_t                            SizeReportToOS;
+    uint64_t                            OffsetInfo[GMM_RESOURCE_LAYOUT_OFFSET_WORDS]; // In Texture2DOffsetInfo order, the 3D and planar views alias these
+    uint32_t                            NoOfPlanes;                                   // OffsetInfo.Plane fields following the 64-bit words
+    uint32_t                            IsTileAlignedPlanes;
+    uint32_t                            Type;             // GMM_RESOURCE_TYPE
+    uint32_t                            Format;           // GMM_RESOURCE_FORMAT
+    uint32_t                            BitsPerPixel;
+    uint32_t                            FlagsGpu[2];      // GMM_RESOURCE_FLAG bits, at the positions listed in GmmResourceLayout.cpp
+    uint32_t                            FlagsInfo[2];
+    uint32_t                            FlagsWa[1];
+    uint32_t                            BaseHeight;
+    uint32_t                            Depth;
+    uint32_t                            MaxLod;
+    uint32_t                            ArraySize;
+    uint32_t                            CpTag;
+    uint32_t                            CachePolicyUsage; // GMM_RESOURCE_USAGE_TYPE
+    uint32_t                            MsaaSamplePattern;
+    uint32_t                            MsaaNumSamples;
+    uint32_t                            ArraySpacingSingleLod;
+    uint32_t                            BaseAlignment;
+    uint32_t                            HAlign;
+    uint32_t                            VAlign;
+    uint32_t                            DAlign;
+    uint32_t                            MipTailStartLod;
+    uint32_t                            PackedMipStartLod;
+    uint32_t                            PackedMipWidth;
+    uint32_t                            PackedMipHeight;
+    uint32_t                            QPitch;
+    uint32_t                            TileMode;         // GMM_TILE_MODE
+    uint32_t                            CCSModeAlign;
+    uint32_t                            LegacyFlags;
+    uint32_t                            S3dDisplayModeHeight;
+    uint32_t                            S3dNumBlankActiveLines;
+    uint32_t                            S3dRFrameOffset;
+    uint32_t                            S3dBlankAreaOffset;
+    uint32_t                            S3dTallBufferHeight;
+    uint32_t                            S3dTallBufferSize;
+    uint32_t                            S3dIsRFrame;
+    uint32_t                            MsFormat;         // LHDM only, 0 otherwise
+    uint32_t                            SegmentOverrideSeg1;
+    uint32_t                            SegmentOverrideEvict;
+    uint32_t                            MaximumRenamingListLength;
+    uint8_t                             MmcMode[GMM_RESOURCE_LAYOUT_MMC_ENTRIES];
+    uint8_t                             MmcHint[GMM_RESOURCE_LAYOUT_MMC_ENTRIES];
+}GMM_RESOURCE_LAYOUT_SURFACE;
+
 //===========================================================================
 // enum :
 //        GMM_UNIFIED_AUX_TYPE
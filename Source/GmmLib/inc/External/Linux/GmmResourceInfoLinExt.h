@@ -70,6 +70,28 @@ typedef struct GMM_TRANSLATIONTABLE_CALLBACKS_REC
                         uint64_t RegOffset);
 } GMM_TRANSLATIONTABLE_CALLBACKS;
 
+// Optional TT callbacks, kept apart from GMM_TRANSLATIONTABLE_CALLBACKS so its size
+// (and GmmPageTableMgr layout) stays as clients were built with.
+// Set through GmmPageTableMgr::SetTranslationTableCallbacksExt, NULL members are not used.
+typedef struct GMM_TRANSLATIONTABLE_CALLBACKS_EXT_REC
+{
+    // Ranged writes, NULL falls back to one pfWriteL2L3Entry per entry.
+    // Each 64-bit entry must still be updated atomically.
+    int (*pfWriteL2L3Entries)(void *pDeviceHandle,
+                              GMM_GFX_ADDRESS GfxAddress,      // adr of first entry
+                              const uint32_t NumEntries,       // consecutive 64-bit entries
+                              const uint64_t *Data);
+
+    int (*pfFillL2L3Entries)(void *pDeviceHandle,
+                             GMM_GFX_ADDRESS GfxAddress,       // adr of first entry
+                             const uint32_t NumEntries,        // consecutive 64-bit entries
+                             uint64_t Data);                   // value written to all entries
+
+    // Returns nonzero while GPU may still access given page-table pool BO.
+    // Lets unused pools be released without CPU wait; NULL treats pools as busy.
+    int (*pfIsBufferBusy)(void *bo);
+} GMM_TRANSLATIONTABLE_CALLBACKS_EXT;
+
 typedef struct _GMM_DEVICE_CALLBACKS
 {
     void *pBufferMgr;
@@ -0,0 +1,143 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+#pragma once
+
+#ifdef __cplusplus
+#if(!defined(_WIN32) && !defined(__GMM_KMD__))
+
+#define GMM_LAYOUT_CACHE_SUPPORTED 1
+
+#include <pthread.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// @file GmmLayoutCache.h
+/// @brief Persistent cache of resource layouts, so repeated application startups
+///        can skip texture calc for resources they have created before.
+/////////////////////////////////////////////////////////////////////////////////////
+
+// Directory holding the cache files. Caching is off when not set.
+#define GMM_LAYOUT_CACHE_DIR_ENV        "GMM_LAYOUT_CACHE_DIR"
+
+#define GMM_LAYOUT_CACHE_MAGIC          0x434C4D47 // 'GMLC'
+#define GMM_LAYOUT_CACHE_RECORD_MAGIC   0x524C4D47 // 'GMLR'
+#define GMM_LAYOUT_CACHE_VERSION        1
+#define GMM_LAYOUT_CACHE_MAX_FILE_SIZE  (32 * 1024 * 1024)
+
+//===========================================================================
+// typedef:
+//      GMM_LAYOUT_CACHE_FILE_HEADER
+//
+// Description:
+//      Starts every cache file. Key identifies the platform, SKU/WA tables,
+//      GT system info and gmmlib build the records were computed with; a
+//      file with any other header is ignored and rewritten.
+//----------------------------------------------------------------------------
+typedef struct GMM_LAYOUT_CACHE_FILE_HEADER_REC
+{
+    uint32_t Magic;
+    uint32_t Version;               // GMM_LAYOUT_CACHE_VERSION
+    uint64_t Key;
+    uint32_t ParamsSize;            // sizeof(GMM_RESCREATE_PARAMS)
+    uint32_t LayoutVersion;         // GMM_RESOURCE_LAYOUT_VERSION
+    uint64_t Reserved;
+} GMM_LAYOUT_CACHE_FILE_HEADER;
+
+//===========================================================================
+// typedef:
+//      GMM_LAYOUT_CACHE_RECORD
+//
+// Description:
+//      One cached resource, appended after the file header. Followed by
+//      BlobSize bytes of GmmResourceInfoCommon::SerializeLayout() output and
+//      padded to 8 bytes. Checksum covers everything from Params onwards.
+//----------------------------------------------------------------------------
+typedef struct GMM_LAYOUT_CACHE_RECORD_REC
+{
+    uint32_t             Magic;
+    uint32_t             Size;          // Whole record incl. blob and padding
+    uint64_t             Hash;          // Lookup hash of ClientType, ContextState and Params
+    uint64_t             Checksum;
+    uint64_t             ContextState;  // Runtime-adjustable Context knobs that affect layout
+    uint32_t             ClientType;
+    uint32_t             BlobSize;
+    GMM_RESCREATE_PARAMS Params;        // Normalized create params
+    GMM_RESCREATE_PARAMS OutParams;     // Params as adjusted by Create()
+} GMM_LAYOUT_CACHE_RECORD;
+
+namespace GmmLib
+{
+    class NON_PAGED_SECTION LayoutCache : public GmmMemAllocator
+    {
+        private:
+            Context                        *pGmmLibContext;
+            std::string                     Path;
+            uint64_t                        Key;
+
+            // Read-only mapping of the file as it was at context creation.
+            const uint8_t                  *pMapped;
+            size_t                          MappedSize;
+            size_t                          ValidSize;          ///< Bytes of pMapped that passed validation
+            std::unordered_map<uint64_t, const GMM_LAYOUT_CACHE_RECORD *> MappedIndex;
+
+            // Records computed by this process, queued for the writer thread.
+            pthread_mutex_t                 Mutex;
+            pthread_cond_t                  WorkCond;
+            pthread_cond_t                  IdleCond;
+            pthread_t                       Writer;
+            bool                            WriterStarted;
+            bool                            StopWriter;
+            bool                            Writing;
+            bool                            RewriteFile;        ///< File missing, stale or with a corrupt tail
+            size_t                          FileSize;
+            std::unordered_map<uint64_t, std::vector<uint8_t>> Added;
+            std::vector<const std::vector<uint8_t> *>          Pending;
+
+            LayoutCache(Context *pGmmLibContext, const char *pDir);
+
+            void                            Open();
+            uint64_t                        GetContextState();
+            bool                            ValidateRecord(const GMM_LAYOUT_CACHE_RECORD *pRecord, size_t Avail);
+            const GMM_LAYOUT_CACHE_RECORD  *Find(uint64_t Hash, uint64_t ContextState, GMM_CLIENT ClientType,
+                                                 const GMM_RESCREATE_PARAMS &Params);
+            int                             OpenForAppend();
+            void                            WriterLoop();
+            static void                    *WriterThread(void *pCache);
+
+        public:
+            ~LayoutCache();
+
+            static LayoutCache             *Create(Context *pGmmLibContext);
+
+            bool                            Lookup(GMM_CLIENT ClientType, GMM_RESCREATE_PARAMS &CreateParams,
+                                                   GmmResourceInfoCommon &ResInfo);
+            void                            Insert(GMM_CLIENT ClientType, const GMM_RESCREATE_PARAMS &CreateParams,
+                                                   const GMM_RESCREATE_PARAMS &OutParams, GmmResourceInfoCommon &ResInfo);
+            void                            Flush();
+    };
+} // namespace GmmLib
+
+#endif // !_WIN32 && !__GMM_KMD__
+#endif // __cplusplus
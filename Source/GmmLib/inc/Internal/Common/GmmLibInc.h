@@ -56,6 +56,7 @@ OTHER DEALINGS IN THE SOFTWARE.
 #include "Texture/GmmGen10TextureCalc.h"
 #include "Texture/GmmGen11TextureCalc.h"
 #include "Texture/GmmGen12TextureCalc.h"
+#include "Texture/GmmPlatformTextureCalc.h"
 #include "External/Common/GmmResourceInfo.h"
 #include "External/Common/GmmInfoExt.h"
 #include "External/Common/GmmInfo.h"
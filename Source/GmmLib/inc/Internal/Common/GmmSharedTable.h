@@ -0,0 +1,93 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+#pragma once
+
+#ifdef __cplusplus
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// @file GmmSharedTable.h
+/// @brief Process wide store of read-only platform tables (SKU/WA, GT system info,
+///        cache policy) interned by content, so adapters with identical tables
+///        share one copy.
+/////////////////////////////////////////////////////////////////////////////////////
+
+// Keyed tables the store keeps alive without any context referencing them
+#define GMM_SHARED_TABLE_MAX_KEPT   16
+
+namespace GmmLib
+{
+    /////////////////////////////////////////////////////////////////////////////////
+    /// A table is created private and writable with Alloc(), filled in, then handed
+    /// to Intern() which returns the shared copy. Shared copies are never written;
+    /// Unshare() gives the caller a private copy to modify (copy-on-write), which is
+    /// interned again once the update is done. Unshare() keeps the caller's reference
+    /// on the shared copy, since other threads may still be reading it; the caller
+    /// Release()s it once that can no longer happen.
+    ///
+    /// Tables derived from other tables can be interned under a key holding their
+    /// inputs and looked up by it with Find(), skipping the derivation. Keys are
+    /// private tables from Alloc(); the store keeps a copy and matches keys by
+    /// content. The store keeps such tables, up to GMM_SHARED_TABLE_MAX_KEPT, until
+    /// ReleaseKept().
+    /////////////////////////////////////////////////////////////////////////////////
+    class NON_PAGED_SECTION SharedTable
+    {
+    public:
+        static void *       GMM_STDCALL Alloc(const void *pData, size_t Size);
+        static const void * GMM_STDCALL Intern(void *pTable, const void *pKey = NULL);
+        static const void * GMM_STDCALL Find(const void *pKey, size_t Size);
+        static void *       GMM_STDCALL Unshare(const void *pTable);
+        static void         GMM_STDCALL Release(const void *pTable);
+        static void         GMM_STDCALL ReleaseKept();
+        static uint32_t     GMM_STDCALL GetNumShared();
+
+        /////////////////////////////////////////////////////////////////////////
+        /// Typed helpers for the above
+        /////////////////////////////////////////////////////////////////////////
+        template <typename T>
+        static T *Alloc(const T *pData, uint32_t Count = 1)
+        {
+            return (T *)Alloc((const void *)pData, sizeof(T) * Count);
+        }
+
+        template <typename T>
+        static const T *Intern(T *pTable, const void *pKey = NULL)
+        {
+            return (const T *)Intern((void *)pTable, pKey);
+        }
+
+        template <typename T>
+        static const T *Find(const void *pKey)
+        {
+            return (const T *)Find(pKey, sizeof(T));
+        }
+
+        template <typename T>
+        static T *Unshare(const T *pTable)
+        {
+            return (T *)Unshare((const void *)pTable);
+        }
+    };
+}
+
+#endif // __cplusplus
@@ -0,0 +1,68 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+
+#pragma once
+#ifdef __cplusplus
+#include "GmmGen12TextureCalc.h"
+/////////////////////////////////////////////////////////////////////////////////////
+/// @file GmmPlatformTextureCalc.h
+/// @brief This file contains the sealed, platform-specialized texture calc used
+///        when gmmlib is built with GMM_SPECIALIZED_TEXTURE_CALC.
+/////////////////////////////////////////////////////////////////////////////////////
+namespace GmmLib
+{
+    /////////////////////////////////////////////////////////////////////////
+    /// Seals a GmmGenXTextureCalc leaf so the AllocateTexture pipeline is
+    /// instantiated against the concrete platform class. Every stage called
+    /// from the pipeline (FillTex*, FillTexCCS, ...) is then bound statically
+    /// and can be inlined, instead of going through the vtable per create.
+    /// Calls made from inside the GenX stages keep their virtual dispatch, so
+    /// the class hierarchy remains the fallback for everything else.
+    /////////////////////////////////////////////////////////////////////////
+    template <class GenTextureCalc>
+    class NON_PAGED_SECTION GmmPlatformTextureCalc final :
+                                public GenTextureCalc
+    {
+        friend class GmmTextureCalc;
+
+        public:
+            /* Constructors */
+            GmmPlatformTextureCalc(Context *pGmmLibContext)
+                : GenTextureCalc(pGmmLibContext)
+            {
+
+            }
+
+            ~GmmPlatformTextureCalc()
+            {
+
+            }
+
+            /* Function prototypes */
+            virtual GMM_STATUS AllocateTexture(GMM_TEXTURE_INFO *pTexInfo)
+            {
+                return GmmTextureCalc::AllocateTextureT(this, pTexInfo);
+            }
+    };
+}
+#endif // #ifdef __cplusplus
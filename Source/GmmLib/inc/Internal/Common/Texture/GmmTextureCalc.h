@@ -63,6 +63,11 @@ namespace GmmLib
         protected:
 	    Context *pGmmLibContext;
 
+            template <class TextureCalcT>
+            static GMM_STATUS AllocateTextureT(
+                                TextureCalcT      *pTextureCalc,
+                                GMM_TEXTURE_INFO  *pTexInfo);
+
             /* Function prototypes */
 
 
@@ -177,7 +182,7 @@ namespace GmmLib
             }
             
 	    /* Function prototypes */
-            GMM_STATUS      AllocateTexture(GMM_TEXTURE_INFO *pTexInfo);
+            virtual GMM_STATUS      AllocateTexture(GMM_TEXTURE_INFO *pTexInfo);
             virtual GMM_STATUS      FillTexCCS(GMM_TEXTURE_INFO *pBaseSurf, GMM_TEXTURE_INFO *pTexInfo);
             uint8_t         SurfaceRequires64KBTileOptimization(
                                 GMM_TEXTURE_INFO *pTexInfo);